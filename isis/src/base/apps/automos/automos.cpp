@@ -28,6 +28,9 @@ namespace Isis {
     // Set the create flag-mosaic is always created in automos
     m.SetCreateFlag(true);
 
+    // Place all of the inputs in one pass over the mosaic when it is ended
+    m.SetCompositeFlag(true);
+
     // Get the Track Flag
     bool bTrack = ui.GetBoolean("TRACK");
     m.SetTrackFlag(bTrack);
@@ -0,0 +1,83 @@
+/** This is free and unencumbered software released into the public domain.
+The authors of ISIS do not claim copyright on the contents of this file.
+For more details about the LICENSE terms and the AUTHORS, you will
+find files of those names at the top level of this repository. **/
+
+/* SPDX-License-Identifier: CC0-1.0 */
+
+#include "cubeoverviews.h"
+
+#include "CubeOverview.h"
+#include "IException.h"
+#include "IString.h"
+#include "Progress.h"
+#include "PvlGroup.h"
+#include "PvlKeyword.h"
+
+using namespace std;
+
+namespace Isis {
+
+  void cubeoverviews(UserInterface &ui, Pvl *log) {
+    Cube cube;
+    cube.open(ui.GetCubeName("FROM"), "rw");
+
+    cubeoverviews(&cube, ui, log);
+    cube.close();
+  }
+
+
+  void cubeoverviews(Cube *cube, UserInterface &ui, Pvl *log) {
+    int minScale = ui.GetInteger("MINSCALE");
+    int minSize = ui.GetInteger("MINSIZE");
+
+    if (minScale < 2) {
+      QString msg = "MINSCALE must be at least 2, not [" + toString(minScale) + "]";
+      throw IException(IException::User, msg, _FILEINFO_);
+    }
+
+    if (minSize < 1) {
+      QString msg = "MINSIZE must be at least 1, not [" + toString(minSize) + "]";
+      throw IException(IException::User, msg, _FILEINFO_);
+    }
+
+    // Double the scale until the overview fits in MINSIZE pixels both ways
+    QList<int> scales;
+    for (int scale = minScale; ; scale *= 2) {
+      scales.append(scale);
+
+      int samples = (cube->sampleCount() + scale - 1) / scale;
+      int lines = (cube->lineCount() + scale - 1) / scale;
+      if ((samples <= minSize && lines <= minSize) ||
+          (samples == 1 && lines == 1)) {
+        break;
+      }
+    }
+
+    // Overviews of scales we are not rebuilding would be out of date
+    QList<int> oldScales = CubeOverview::scales(*cube);
+    for (int i = 0; i < oldScales.size(); i++) {
+      if (!scales.contains(oldScales[i])) {
+        cube->deleteBlob(CubeOverview::blobName(oldScales[i]), "Overview");
+      }
+    }
+
+    Progress progress;
+    progress.SetText("Building overviews");
+    QList<CubeOverview> overviews = CubeOverview::build(*cube, scales, &progress);
+
+    PvlKeyword scaleKeyword("Scales");
+    for (int i = 0; i < overviews.size(); i++) {
+      Blob overviewBlob = overviews[i].toBlob();
+      cube->write(overviewBlob);
+      scaleKeyword += toString(overviews[i].scale());
+    }
+
+    PvlGroup results("Results");
+    results += scaleKeyword;
+
+    if (log) {
+      log->addLogGroup(results);
+    }
+  }
+}
@@ -34,8 +34,14 @@ using namespace Isis;
 
 Isis::CubeCalculator c;
 
-// Prototypes
-void Evaluate(vector<Buffer *> &input, vector<Buffer *> &output);
+/**
+ * Applies the equation to the input buffers. Several threads can call it at
+ * once when the calculator is thread safe.
+ */
+class Evaluate {
+  public:
+    void operator()(vector<Buffer *> &input, vector<Buffer *> &output) const;
+};
 
 void IsisMain() {
   UserInterface &ui = Application::GetUserInterface();
@@ -89,7 +95,8 @@ void IsisMain() {
 
   CubeInfixToPostfix infixToPostfix;
   c.prepareCalculations(infixToPostfix.convert(ui.GetString("EQUATION")), cubes, outCube);
-  p.StartProcess(Evaluate);
+  // Equations with camera functions have to be evaluated one line at a time
+  p.ProcessCubes(Evaluate(), c.isThreadSafe());
   p.EndProcess();
 }
 
@@ -101,7 +108,7 @@ void IsisMain() {
  * @param input The input buffer vector
  * @param output The output buffer
  */
-void Evaluate(vector<Buffer *> &input, vector<Buffer *> &output) {
+void Evaluate::operator()(vector<Buffer *> &input, vector<Buffer *> &output) const {
   Buffer &outBuffer = *output[0];
 
   QVector<Buffer *> inputCopy;
@@ -0,0 +1,372 @@
+/** This is free and unencumbered software released into the public domain.
+The authors of ISIS do not claim copyright on the contents of this file.
+For more details about the LICENSE terms and the AUTHORS, you will
+find files of those names at the top level of this repository. **/
+
+/* SPDX-License-Identifier: CC0-1.0 */
+
+#include "isisd.h"
+
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+#include <QFile>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QTextStream>
+
+#include "FileName.h"
+#include "IException.h"
+#include "Preference.h"
+#include "PvlGroup.h"
+#include "PvlKeyword.h"
+#include "PvlObject.h"
+
+#include "cam2map.h"
+#include "caminfo.h"
+#include "campt.h"
+#include "camrange.h"
+#include "camstats.h"
+#include "cubeatt.h"
+#include "footprintinit.h"
+#include "spiceinit.h"
+#include "stats.h"
+
+using namespace std;
+
+namespace Isis {
+  //! An application callable from isisd
+  typedef std::function<void(UserInterface &ui, Pvl *log)> IsisdApplication;
+
+  static const map<QString, IsisdApplication> &applications();
+  static QStringList splitCommandLine(const QString &commandLine);
+  static QString responseText(const Pvl &response);
+  static bool respond(const QString &commandLine, QString &response);
+  static void serveStream(QTextStream &input, QTextStream &output);
+  static void serveSocket(const QString &socketName);
+
+  /**
+   * Turns the progress bar and the session log terminal output off while a command runs, so they
+   * are not mixed into the response, and puts the preferences back the way they were afterwards.
+   */
+  class QuietPreferences {
+    public:
+      QuietPreferences() {
+        PvlKeyword &progressBar = progressBarKeyword();
+        PvlKeyword &terminalOutput = terminalOutputKeyword();
+        m_progressBar = progressBar[0];
+        m_terminalOutput = terminalOutput[0];
+        progressBar.setValue("Off");
+        terminalOutput.setValue("Off");
+      }
+
+      ~QuietPreferences() {
+        progressBarKeyword().setValue(m_progressBar);
+        terminalOutputKeyword().setValue(m_terminalOutput);
+      }
+
+    private:
+      QuietPreferences(const QuietPreferences &other);
+      QuietPreferences &operator=(const QuietPreferences &other);
+
+      static PvlKeyword &progressBarKeyword() {
+        return Preference::Preferences().findGroup("UserInterface")["ProgressBar"];
+      }
+
+      static PvlKeyword &terminalOutputKeyword() {
+        return Preference::Preferences().findGroup("SessionLog")["TerminalOutput"];
+      }
+
+      QString m_progressBar;    //!< The ProgressBar preference before the command
+      QString m_terminalOutput; //!< The TerminalOutput preference before the command
+  };
+
+  /**
+   * Runs ISIS applications without starting a new process for each one. Commands are read from
+   * FROM, standard input, or a local socket and each one gets a Pvl response. The application XML,
+   * preferences, camera plugins and the rest of the process stay loaded between commands.
+   *
+   * @param ui The user interface to parse the parameters from.
+   */
+  void isisd(UserInterface &ui) {
+    if (ui.WasEntered("SOCKET")) {
+      serveSocket(ui.GetString("SOCKET"));
+      return;
+    }
+
+    QFile inputFile;
+    if (ui.WasEntered("FROM")) {
+      inputFile.setFileName(FileName(ui.GetFileName("FROM")).expanded());
+      if (!inputFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        QString msg = "Unable to open command file [" + ui.GetFileName("FROM") + "]";
+        throw IException(IException::Io, msg, _FILEINFO_);
+      }
+    }
+    else {
+      inputFile.open(stdin, QIODevice::ReadOnly | QIODevice::Text);
+    }
+
+    QFile outputFile;
+    if (ui.WasEntered("TO")) {
+      outputFile.setFileName(FileName(ui.GetFileName("TO")).expanded());
+      if (!outputFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        QString msg = "Unable to open response file [" + ui.GetFileName("TO") + "]";
+        throw IException(IException::Io, msg, _FILEINFO_);
+      }
+    }
+    else {
+      outputFile.open(stdout, QIODevice::WriteOnly | QIODevice::Text);
+    }
+
+    QTextStream input(&inputFile);
+    QTextStream output(&outputFile);
+    serveStream(input, output);
+  }
+
+
+  /**
+   * Runs one command and reports how it went. The command is the name of an application followed
+   * by its parameters, the same as on the command line. The response has an IsisdResult object
+   * with the application name, a Status of Success or Error, and either the groups the
+   * application logged or the error. The progress bar and the session log terminal output are
+   * off while the command runs and are restored to the user's preferences afterwards.
+   *
+   * @param commandLine The command to run.
+   *
+   * @return @b Pvl The response.
+   */
+  Pvl isisdCommand(const QString &commandLine) {
+    PvlObject result("IsisdResult");
+
+    QStringList tokens = splitCommandLine(commandLine);
+    QString appName = tokens.isEmpty() ? "" : FileName(tokens.takeFirst()).baseName();
+    result += PvlKeyword("Application", appName);
+
+    try {
+      QuietPreferences quiet;
+
+      const map<QString, IsisdApplication> &apps = applications();
+      map<QString, IsisdApplication>::const_iterator app = apps.find(appName);
+      if (app == apps.end()) {
+        QString msg = "Application [" + appName + "] can not be run by isisd. Use one of [" +
+                      isisdApplications().join(", ") + "]";
+        throw IException(IException::User, msg, _FILEINFO_);
+      }
+
+      QVector<QString> args = tokens.toVector();
+      UserInterface appUi(FileName("$ISISROOT/bin/xml/" + appName + ".xml").expanded(), args);
+
+      Pvl log;
+      app->second(appUi, &log);
+
+      result += PvlKeyword("Status", "Success");
+      for (int i = 0; i < log.groups(); i++) {
+        result.addGroup(log.group(i));
+      }
+      for (int i = 0; i < log.objects(); i++) {
+        result.addObject(log.object(i));
+      }
+    }
+    catch (IException &e) {
+      result += PvlKeyword("Status", "Error");
+      Pvl errors = e.toPvl();
+      for (int i = 0; i < errors.groups(); i++) {
+        result.addGroup(errors.group(i));
+      }
+    }
+    catch (std::exception &e) {
+      result += PvlKeyword("Status", "Error");
+      PvlGroup error("Error");
+      error += PvlKeyword("Message", e.what());
+      result.addGroup(error);
+    }
+
+    Pvl response;
+    response.addObject(result);
+    return response;
+  }
+
+
+  /**
+   * @return @b QStringList The names of the applications isisd can run.
+   */
+  QStringList isisdApplications() {
+    QStringList names;
+    for (map<QString, IsisdApplication>::const_iterator app = applications().begin();
+         app != applications().end(); ++app) {
+      names.append(app->first);
+    }
+    return names;
+  }
+
+
+  /**
+   * The applications isisd can run. An application can be added here once its IsisMain is a
+   * thin wrapper around a function that takes a UserInterface.
+   *
+   * @return @b map The applications by name.
+   */
+  static const map<QString, IsisdApplication> &applications() {
+    static const map<QString, IsisdApplication> apps = {
+      {"cam2map",       [](UserInterface &ui, Pvl *log) { cam2map(ui, log); }},
+      {"caminfo",       [](UserInterface &ui, Pvl *) { caminfo(ui); }},
+      {"campt",         [](UserInterface &ui, Pvl *log) { campt(ui, log); }},
+      {"camrange",      [](UserInterface &ui, Pvl *log) { camrange(ui, log); }},
+      {"camstats",      [](UserInterface &ui, Pvl *log) { camstats(ui, log); }},
+      {"cubeatt",       [](UserInterface &ui, Pvl *) { cubeatt(ui); }},
+      {"footprintinit", [](UserInterface &ui, Pvl *log) { footprintinit(ui, log); }},
+      {"spiceinit",     [](UserInterface &ui, Pvl *log) { spiceinit(ui, log); }},
+      {"stats",         [](UserInterface &ui, Pvl *) { stats(ui); }}
+    };
+    return apps;
+  }
+
+
+  /**
+   * Split a command line into words like a shell would. Words are separated by white space, and
+   * quotes keep white space in a word and are removed.
+   *
+   * @param commandLine The command line to split.
+   *
+   * @return @b QStringList The words in the command line.
+   */
+  static QStringList splitCommandLine(const QString &commandLine) {
+    QStringList words;
+    QString word;
+    bool inWord = false;
+    QChar quote;
+
+    for (int i = 0; i < commandLine.size(); i++) {
+      QChar c = commandLine[i];
+
+      if (!quote.isNull()) {
+        if (c == quote) {
+          quote = QChar();
+        }
+        else {
+          word += c;
+        }
+      }
+      else if (c == '"' || c == '\'') {
+        quote = c;
+        inWord = true;
+      }
+      else if (c.isSpace()) {
+        if (inWord) {
+          words.append(word);
+          word.clear();
+          inWord = false;
+        }
+      }
+      else {
+        word += c;
+        inWord = true;
+      }
+    }
+
+    if (inWord) {
+      words.append(word);
+    }
+
+    return words;
+  }
+
+
+  /**
+   * @param response A response from isisdCommand.
+   *
+   * @return @b QString The response as Pvl text. It ends with a line that only has End on it.
+   */
+  static QString responseText(const Pvl &response) {
+    stringstream stream;
+    stream << response << endl;
+    return QString::fromStdString(stream.str());
+  }
+
+
+  /**
+   * Respond to a line of input.
+   *
+   * @param commandLine The line.
+   * @param response Set to the response, empty for blank lines and comments.
+   *
+   * @return @b bool False if the line asks isisd to exit.
+   */
+  static bool respond(const QString &commandLine, QString &response) {
+    QString command = commandLine.trimmed();
+    response.clear();
+
+    if (command.compare("exit", Qt::CaseInsensitive) == 0) {
+      return false;
+    }
+
+    if (!command.isEmpty() && !command.startsWith("#")) {
+      response = responseText(isisdCommand(command));
+    }
+
+    return true;
+  }
+
+
+  /**
+   * Run the commands in a stream, one per line, until it ends or has an exit command.
+   *
+   * @param input The commands.
+   * @param output Where to write the responses.
+   */
+  static void serveStream(QTextStream &input, QTextStream &output) {
+    QString response;
+    while (!input.atEnd()) {
+      if (!respond(input.readLine(), response)) {
+        break;
+      }
+
+      if (!response.isEmpty()) {
+        output << response;
+        output.flush();
+      }
+    }
+  }
+
+
+  /**
+   * Run the commands sent to a local socket until a client sends an exit command. Clients are
+   * served one at a time, and each one can send as many commands as it wants.
+   *
+   * @param socketName The name of the socket to listen on.
+   */
+  static void serveSocket(const QString &socketName) {
+    QLocalServer::removeServer(socketName);
+
+    QLocalServer server;
+    if (!server.listen(socketName)) {
+      QString msg = "Unable to listen on socket [" + socketName + "]: " + server.errorString();
+      throw IException(IException::Io, msg, _FILEINFO_);
+    }
+
+    bool running = true;
+    while (running && server.waitForNewConnection(-1)) {
+      QLocalSocket *client = server.nextPendingConnection();
+
+      while (running && (client->canReadLine() || client->waitForReadyRead(-1))) {
+        while (running && client->canReadLine()) {
+          QString response;
+          running = respond(QString::fromUtf8(client->readLine()), response);
+
+          if (!response.isEmpty()) {
+            client->write(response.toUtf8());
+            client->waitForBytesWritten(-1);
+          }
+        }
+      }
+
+      client->disconnectFromServer();
+      delete client;
+    }
+
+    server.close();
+  }
+}
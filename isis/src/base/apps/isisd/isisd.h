@@ -0,0 +1,24 @@
+#ifndef isisd_h
+#define isisd_h
+
+/** This is free and unencumbered software released into the public domain.
+The authors of ISIS do not claim copyright on the contents of this file.
+For more details about the LICENSE terms and the AUTHORS, you will
+find files of those names at the top level of this repository. **/
+
+/* SPDX-License-Identifier: CC0-1.0 */
+
+#include <QString>
+#include <QStringList>
+
+#include "Pvl.h"
+#include "UserInterface.h"
+
+namespace Isis {
+  extern void isisd(UserInterface &ui);
+
+  extern Pvl isisdCommand(const QString &commandLine);
+  extern QStringList isisdApplications();
+}
+
+#endif
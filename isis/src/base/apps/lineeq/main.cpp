@@ -100,6 +100,8 @@ void IsisMain() {
 
   p.SetOutputCube("TO");
   p.Progress()->SetText("Applying Equalization");
+  // Only reads the averages, so lines can be equalized on several threads
+  p.SetReentrant(true);
   p.StartProcess(apply);
 
   for(int band = 0; band < icube->bandCount(); band ++) {
@@ -316,6 +316,10 @@ namespace Isis {
       mapData.addGroup(outMappingGrp);
     }
 
+    // Keep the unmodified mapping so the threaded warp can build identical
+    // output projections for each of its threads
+    Pvl workerMapData = mapData;
+
     // *NOTE: The UpperLeftX,UpperLeftY keywords will not be used in the CreateForCube
     //   method, and they will instead be recalculated. This is correct.
     TProjection *outproj = (TProjection *) ProjectionFactory::CreateForCube(mapData, samples, lines,
@@ -365,6 +369,26 @@ namespace Isis {
       throw IException(IException::Programmer, msg, _FILEINFO_);
     }
 
+    // Projections are not safe to share between threads, so give every thread
+    // its own input and output projections. These are built exactly the same
+    // way as the originals so the output does not depend on the thread count.
+    QList<Projection *> workerProjections;
+    bool matchMap = ui.GetBoolean("MATCHMAP");
+    bool trim = ui.GetBoolean("TRIM");
+    p.setTransformFactory([&]() -> Transform * {
+      int workerSamples, workerLines;
+      Pvl workerMap = workerMapData;
+      TProjection *workerOutproj = (TProjection *) ProjectionFactory::CreateForCube(
+          workerMap, workerSamples, workerLines, matchMap);
+      workerProjections.append(workerOutproj);
+
+      TProjection *workerInproj = (TProjection *) ProjectionFactory::CreateFromCube(*icube);
+      workerProjections.append(workerInproj);
+
+      return new Map2map(icube->sampleCount(), icube->lineCount(), workerInproj,
+                         samples, lines, workerOutproj, trim);
+    });
+
     // Warp the cube
     p.StartProcess(*transform, *interp);
     p.EndProcess();
@@ -376,6 +400,9 @@ namespace Isis {
     // Cleanup
     delete transform;
     delete interp;
+    foreach (Projection *workerProjection, workerProjections) {
+      delete workerProjection;
+    }
   }
 
   // Transform object constructor
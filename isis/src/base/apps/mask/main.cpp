@@ -1,6 +1,8 @@
 #include "Isis.h"
 
 #include <QDebug>
+#include <QMutex>
+#include <QMutexLocker>
 
 #include "ProcessByLine.h"
 #include "SpecialPixel.h"
@@ -20,6 +22,7 @@ enum range_preserve {INSIDE, OUTSIDE} preserve;
 double g_minimum, g_maximum;
 bool g_masked;
 double g_pixelsMasked;
+QMutex g_maskedMutex;
 
 void IsisMain() {
   // We will be processing by line
@@ -66,6 +69,7 @@ void IsisMain() {
   if(Spixels == "ALL") spixels = ALL;
 
   // Start the processing
+  p.SetReentrant(true);
   p.StartProcess(mask);
   p.EndProcess();
   
@@ -95,19 +99,18 @@ void mask(vector<Buffer *> &in,
   Buffer &inp = *in[0];
   Buffer &mask = *in[1];
   Buffer &outp = *out[0];
+  double pixelsMasked = 0;
 
   // Loop for each pixel in the line.
   for(int i = 0; i < inp.size(); i++) {
     if(IsSpecial(mask[i])) {
       if(spixels == ALL) {
         outp[i] = NULL8;
-        g_masked = true;
-        g_pixelsMasked++;
+        pixelsMasked++;
       }
       else if(spixels == NULLP && mask[i] == NULL8) {
         outp[i] = NULL8;
-        g_masked = true;
-        g_pixelsMasked++;
+        pixelsMasked++;
       }
       else {
         outp[i] = inp[i];
@@ -121,10 +124,15 @@ void mask(vector<Buffer *> &in,
         outp[i] = inp[i];
       else {
         outp[i] = NULL8;
-        g_masked = true;
-        g_pixelsMasked++;
+        pixelsMasked++;
       }
     }
   }
 
+  // Lines are masked on several threads
+  if (pixelsMasked > 0) {
+    QMutexLocker locker(&g_maskedMutex);
+    g_masked = true;
+    g_pixelsMasked += pixelsMasked;
+  }
 }
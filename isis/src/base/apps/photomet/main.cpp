@@ -1850,6 +1850,16 @@ void IsisMain() {
   pho = new Photometry(par);
   pho->SetPhotomWl(wl);
 
+  // Tabulate the models if the angles change from pixel to pixel
+  bool constantAngles = angleSource == "CENTER_FROM_IMAGE" ||
+                        angleSource == "CENTER_FROM_LABEL" ||
+                        angleSource == "CENTER_FROM_USER" ||
+                        (useBackplane && !usePhasefile && !useIncidencefile && !useEmissionfile);
+  double lookupTolerance = ui.GetDouble("LOOKUPTOLERANCE");
+  if (lookupTolerance > 0.0 && !constantAngles) {
+    pho->SetLookupTolerance(lookupTolerance);
+  }
+
   // Start the processing
   if (useBackplane) {
     p.StartProcess(photometWithBackplane);
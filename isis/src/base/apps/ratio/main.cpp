@@ -14,6 +14,7 @@ void IsisMain() {
   p.SetInputCube("NUMERATOR");
   p.SetInputCube("DENOMINATOR");
   p.SetOutputCube("TO");
+  p.SetReentrant(true);
   p.StartProcess(doRatio);
   p.EndProcess();
 }
@@ -38,7 +38,7 @@ namespace Isis {
    *          vectors
    *
    */
-  AtmosModel::AtmosModel(Pvl &pvl, PhotoModel &pmodel) {
+  AtmosModel::AtmosModel(Pvl &pvl, PhotoModel &pmodel) : p_atmosLookupTable(5) {
     p_atmosAlgorithmName = "Unknown";
     p_atmosPM = &pmodel;
 
@@ -483,8 +483,20 @@ namespace Isis {
     //  throw IException::Message(IException::Programmer,msg,_FILEINFO_);
     //}
 
-    // Apply atmospheric function
-    AtmosModelAlgorithm(pha, inc, ema);
+    // Interpolate the atmospheric function if it has been tabulated. Tau is different at
+    // standard conditions, so the table does not apply then.
+    double values[5];
+    if (!p_standardConditions && p_atmosLookupTable.interpolate(pha, inc, ema, values)) {
+      p_pstd = values[0];
+      p_trans = values[1];
+      p_trans0 = values[2];
+      p_sbar = values[3];
+      p_transs = values[4];
+    }
+    else {
+      // Apply atmospheric function
+      AtmosModelAlgorithm(pha, inc, ema);
+    }
     *pstd = p_pstd;
     *trans = p_trans;
     *trans0 = p_trans0;
@@ -492,6 +504,42 @@ namespace Isis {
     *transs = p_transs;
   }
 
+  /**
+   * Tabulates the atmospheric scattering effect with the current parameters so that
+   * CalcAtmEffect() can interpolate it. The table is sampled as CalcAtmEffect() meets new
+   * angles. This should be called once all of the parameters are set, and again if they are
+   * changed.
+   *
+   * @param tolerance The relative error each of the interpolated values is checked against,
+   *                  see PhotometricLookupTable. A tolerance of 0 discards the table.
+   *
+   * @throws IException::Programmer "The atmospheric effect lookup table can not be built at
+   *                                  standard conditions"
+   */
+  void AtmosModel::SetLookupTolerance(double tolerance) {
+    p_atmosLookupTable.clear();
+    if (tolerance <= 0.0) {
+      return;
+    }
+
+    if (p_standardConditions) {
+      QString msg = "The atmospheric effect lookup table can not be built at standard "
+                    "conditions";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
+
+    p_atmosLookupTable.build(
+        [this](double pha, double inc, double ema, double *values) {
+          AtmosModelAlgorithm(pha, inc, ema);
+          values[0] = p_pstd;
+          values[1] = p_trans;
+          values[2] = p_trans0;
+          values[3] = p_sbar;
+          values[4] = p_transs;
+        },
+        tolerance);
+  }
+
   /**
    * Used to calculate atmosphere at standard conditions
    */
@@ -56,6 +56,9 @@ namespace Isis {
    *           angle) value in the atmospheric classes. Added a setter method
    *           for setting the p_atmosEstTau variable which is used by the
    *           atmospheric classes.
+   *  @history 2026-10-16 ISIS Development Team - Added SetLookupTolerance(), which tabulates
+   *           the atmospheric scattering effect so CalcAtmEffect() can interpolate it
+   *           instead of evaluating the model for every pixel.
    */
   class AtmosModel {
     public:
@@ -72,6 +75,12 @@ namespace Isis {
                          double *trans, double *trans0, double *sbar, double *transs);
       // Used to calculate atmosphere at standard conditions
       virtual void SetStandardConditions(bool standard);
+      // Tabulate the atmospheric scattering effect
+      void SetLookupTolerance(double tolerance);
+      //! Return the tolerance of the atmospheric effect table, 0 if there is no table
+      double LookupTolerance() const {
+        return p_atmosLookupTable.tolerance();
+      };
       // Obtain hemispheric and bihemispheric albedo by integrating the photometric function
       void GenerateAhTable();
       // Perform integration for Hapke Henyey-Greenstein atmosphere correction
@@ -297,6 +306,9 @@ namespace Isis {
 
       double p_atmosTauold;
       double p_atmosWhaold;
+
+      //! Table of pstd, trans, trans0, sbar and transs, used when it has been built
+      PhotometricLookupTable p_atmosLookupTable;
       friend class NumericalAtmosApprox;
   };
 };
@@ -1046,23 +1046,32 @@ namespace Isis {
       }
     }
 
-    // Create a chip the same size as the pattern chip.
-    Chip subsearch(pChip.Samples(), pChip.Lines());
+    if(!MatchFits(sChip, pChip, fChip, startSamp, endSamp, startLine, endLine)) {
+      // Create a chip the same size as the pattern chip.
+      Chip subsearch(pChip.Samples(), pChip.Lines());
+
+      for(int line = startLine; line <= endLine; line++) {
+        for(int samp = startSamp; samp <= endSamp; samp++) {
+          // Extract the subsearch chip and make sure it has enough valid data
+          sChip.Extract(samp, line, subsearch);
+
+//          if(!subsearch.IsValid(p_patternValidPercent)) continue;
+          if(!subsearch.IsValid(p_subsearchValidPercent)) continue;
+
+          // Try to match the two subchips
+          double fit = MatchAlgorithm(pChip, subsearch);
+          if(fit != Isis::Null) {
+            fChip.SetValue(samp, line, fit);
+          }
+        }
+      }
+    }
 
+    // Save off information about the best fit
     for(int line = startLine; line <= endLine; line++) {
       for(int samp = startSamp; samp <= endSamp; samp++) {
-        // Extract the subsearch chip and make sure it has enough valid data
-        sChip.Extract(samp, line, subsearch);
-
-//        if(!subsearch.IsValid(p_patternValidPercent)) continue;
-        if(!subsearch.IsValid(p_subsearchValidPercent)) continue;
-
-        // Try to match the two subchips
-        double fit = MatchAlgorithm(pChip, subsearch);
-
-        // If we had a fit save off information about that fit
+        double fit = fChip.GetValue(samp, line);
         if(fit != Isis::Null) {
-          fChip.SetValue(samp, line, fit);
           if((p_bestFit == Isis::Null) || CompareFits(fit, p_bestFit)) {
             p_bestFit = fit;
             p_bestSamp = samp;
@@ -1074,6 +1083,32 @@ namespace Isis {
   }
 
 
+  /**
+   * Computes the goodness of fit at every search position from start sample to
+   * end sample and start line to end line at once. Algorithms that can do this
+   * faster than extracting a subsearch chip at every position and calling
+   * MatchAlgorithm override this method. A position is skipped, and left Null in
+   * the fit chip, if its subsearch chip does not meet the subsearch valid
+   * percent or MatchAlgorithm would return Null for it.
+   *
+   * @param sChip Search chip
+   * @param pChip Pattern chip
+   * @param fChip Fit chip, the same size as the search chip and filled with
+   *              nulls
+   * @param startSamp Start sample
+   * @param endSamp End sample
+   * @param startLine Start line
+   * @param endLine End line
+   *
+   * @return @b bool False if the fits were not computed and MatchAlgorithm
+   *         should be called at each position instead
+   */
+  bool AutoReg::MatchFits(Chip &sChip, Chip &pChip, Chip &fChip, int startSamp, int endSamp,
+                          int startLine, int endLine) {
+    return false;
+  }
+
+
   /**
    * Set the search chip sample and line to subpixel values if possible.  This
    * method uses a centroiding method to gravitate the whole pixel best fit to a
@@ -1206,6 +1241,29 @@ namespace Isis {
     return (AlgorithmStatistics(pvl));
   }
 
+  /**
+   * Adds the registration statistics accumulated by another AutoReg to this
+   * one, so registrations can be divided between several AutoReg objects (one
+   * per thread, for example) and RegistrationStatistics still reports all of
+   * them. Algorithms with statistics of their own override this to merge those
+   * too.
+   *
+   * @param other An AutoReg created from the same template
+   */
+  void AutoReg::MergeStatistics(const AutoReg &other) {
+    p_totalRegistrations += other.p_totalRegistrations;
+    p_pixelSuccesses += other.p_pixelSuccesses;
+    p_subpixelSuccesses += other.p_subpixelSuccesses;
+    p_patternChipNotEnoughValidDataCount += other.p_patternChipNotEnoughValidDataCount;
+    p_patternZScoreNotMetCount += other.p_patternZScoreNotMetCount;
+    p_fitChipNoDataCount += other.p_fitChipNoDataCount;
+    p_fitChipToleranceNotMetCount += other.p_fitChipToleranceNotMetCount;
+    p_surfaceModelNotEnoughValidDataCount += other.p_surfaceModelNotEnoughValidDataCount;
+    p_surfaceModelSolutionInvalidCount += other.p_surfaceModelSolutionInvalidCount;
+    p_surfaceModelDistanceInvalidCount += other.p_surfaceModelDistanceInvalidCount;
+  }
+
+
   /**
    * This function returns the keywords that this object was
    * created from.
@@ -163,6 +163,11 @@ namespace Isis {
    *                            caused the previous registration to be returned. If sub-pixel 
    *                            registration fails now it will return to the whole pixel 
    *                            registration values. Fixes #5248.
+   *    @history 2026-10-16 ISIS Development Team - Added the MatchFits virtual method so
+   *                            algorithms can fill the whole fit chip at once instead of
+   *                            having MatchAlgorithm called for every subsearch chip.
+   *                            Added MergeStatistics so registrations can be split between
+   *                            several AutoReg objects and still be reported together.
    */
   class AutoReg {
     public:
@@ -363,6 +368,7 @@ namespace Isis {
       }
 
       Pvl RegistrationStatistics();
+      virtual void MergeStatistics(const AutoReg &other);
 
       /**
        * Minimum tolerance specific to algorithm
@@ -445,6 +451,8 @@ namespace Isis {
        * @return double
        */
       virtual double MatchAlgorithm(Chip &pattern, Chip &subsearch) = 0;
+      virtual bool MatchFits(Chip &sChip, Chip &pChip, Chip &fChip, int startSamp,
+                             int endSamp, int startLine, int endLine);
 
       PvlObject p_template; //!< AutoRegistration object that created this projection
 
@@ -9,6 +9,7 @@ find files of those names at the top level of this repository. **/
 
 #include <iostream>
 #include <iomanip>
+#include <limits>
 #include <numeric>
 #include <sstream>
 
@@ -28,19 +29,51 @@ using namespace std;
 
 namespace Isis {
 
+  /**
+   * The name of the mesh caches of DSKs. The bounding volume hierarchy is
+   * stored the way Bullet keeps it in memory, which depends on the size of
+   * btScalar.
+   *
+   * @return @b QString The engine name for ShapeMeshCache
+   */
+  static QString meshCacheEngine() {
+    return QString("bullet%1").arg(sizeof(btScalar) * 8);
+  }
+
+
+  /**
+   * The version of Bullet, the layout of its hierarchy nodes can change
+   * between versions.
+   *
+   * @return @b QString The engine version for ShapeMeshCache
+   */
+  static QString meshCacheEngineVersion() {
+    return QString::number(btGetVersion());
+  }
+
+
   /**
    * Default empty constructor.
    */
-  BulletDskShape::BulletDskShape() :  m_mesh() { }
+  BulletDskShape::BulletDskShape() :  m_mesh(), m_meshCache() { }
 
 
   /**
-   * Construct a BulletDskShape from a DSK file.
+   * Construct a BulletDskShape from a DSK file. If the ShapeMeshCache
+   * preference allows it, the mesh and bounding volume hierarchy are used
+   * from the mesh cache of the DSK instead of being read and built again.
    *
    * @param dskfile The DSK file to load into a Bullet target shape.
    */
-  BulletDskShape::BulletDskShape(const QString &dskfile) : m_mesh()  {
-    loadFromDsk(dskfile);
+  BulletDskShape::BulletDskShape(const QString &dskfile) : m_mesh(), m_meshCache()  {
+    ShapeMeshCache::CacheMode cacheMode = ShapeMeshCache::preferredMode();
+    if (cacheMode == ShapeMeshCache::NoCache || !loadFromMeshCache(dskfile)) {
+      loadFromDsk(dskfile);
+
+      if (cacheMode == ShapeMeshCache::ReadWriteCache) {
+        writeMeshCache(dskfile);
+      }
+    }
     setMaximumDistance();
   }
 
@@ -49,8 +82,9 @@ namespace Isis {
    * Desctructor
    */
   BulletDskShape::~BulletDskShape() {
-    // Bullet does not clean up the mesh automatically, so we need to delete it manually
-    if (m_mesh) {
+    // Bullet does not clean up the mesh automatically, so we need to delete it manually.
+    // Meshes from a mesh cache point into the mapped file.
+    if (m_mesh && !m_meshCache) {
       for (int i = 0; i < m_mesh->getIndexedMeshArray().size(); i++) {
         btIndexedMesh &v_mesh = m_mesh->getIndexedMeshArray()[i];
         delete[] v_mesh.m_triangleIndexBase;
@@ -264,4 +298,132 @@ namespace Isis {
 
   }
 
+
+  /**
+   * Use the mesh and bounding volume hierarchy in the mesh cache of a DSK.
+   * The cache is mapped copy on write, because Bullet fixes up the pointers
+   * in the hierarchy in place. Only the pages it changes are copied, the
+   * vertices, plates and hierarchy nodes are shared with every other process
+   * using the same cache.
+   *
+   * @param dskfile The DSK file the cache was built from.
+   *
+   * @return @b bool True if the cache was current and complete. If it was
+   *                 not, nothing is changed.
+   */
+  bool BulletDskShape::loadFromMeshCache(const QString &dskfile) {
+    QScopedPointer<ShapeMeshCache> cache(new ShapeMeshCache(dskfile, meshCacheEngine(),
+                                                            meshCacheEngineVersion()));
+    if ( !cache->map(true) ) {
+      return false;
+    }
+
+    // Each segment is stored as its number of vertices and number of plates
+    qint64 segmentBytes = cache->blockSize("segments");
+    if ( segmentBytes <= 0 || segmentBytes % (2 * sizeof(qint32)) != 0 ) {
+      return false;
+    }
+    const qint32 *segments = (const qint32 *) cache->block("segments");
+    int numSegments = segmentBytes / (2 * sizeof(qint32));
+
+    QSharedPointer<btTriangleIndexVertexArray> mesh(new btTriangleIndexVertexArray());
+    for (int i = 0; i < numSegments; i++) {
+      int nvertices = segments[2 * i];
+      int nplates = segments[2 * i + 1];
+      QString vertexBlock = "vertices" + toString(i);
+      QString plateBlock = "plates" + toString(i);
+      if ( nvertices <= 0 || nplates <= 0 ||
+           cache->blockSize(vertexBlock) != (qint64) nvertices * 3 * sizeof(double) ||
+           cache->blockSize(plateBlock) != (qint64) nplates * 3 * sizeof(int) ) {
+        return false;
+      }
+
+      // A damaged cache must not send Bullet outside of the vertices
+      const int *pindex = (const int *) cache->block(plateBlock);
+      for (int j = 0 ; j < nplates * 3 ; j++) {
+        if ( pindex[j] < 0 || pindex[j] >= nvertices ) {
+          return false;
+        }
+      }
+
+      btIndexedMesh i_mesh;
+      i_mesh.m_numTriangles = nplates;
+      i_mesh.m_triangleIndexBase = cache->block(plateBlock);
+      i_mesh.m_triangleIndexStride = (sizeof(int) * 3);
+      i_mesh.m_numVertices = nvertices;
+      i_mesh.m_vertexBase = cache->block(vertexBlock);
+      i_mesh.m_vertexStride = (sizeof(double) * 3);
+      i_mesh.m_vertexType = PHY_DOUBLE;
+      mesh->addIndexedMesh(i_mesh, PHY_INTEGER);
+    }
+
+    qint64 bvhBytes = cache->blockSize("bvh");
+    if ( bvhBytes <= 0 || bvhBytes > std::numeric_limits<unsigned int>::max() ) {
+      return false;
+    }
+    btOptimizedBvh *bvh = (btOptimizedBvh *) btOptimizedBvh::deSerializeInPlace(cache->block("bvh"),
+                                                                                bvhBytes, false);
+    if ( !bvh ) {
+      return false;
+    }
+
+    bool useQuantizedAabbCompression = true;
+    bool buildBvh = false;
+    btBvhTriangleMeshShape *v_triShape = new btBvhTriangleMeshShape(mesh.data(),
+                                                                    useQuantizedAabbCompression,
+                                                                    buildBvh);
+    v_triShape->setOptimizedBvh(bvh);
+    v_triShape->setUserPointer(this);
+    btCollisionObject *vbody = new btCollisionObject();
+    vbody->setCollisionShape(v_triShape);
+
+    m_mesh = mesh;
+    m_meshCache.reset(cache.take());
+    setTargetBody(vbody);
+    return true;
+  }
+
+
+  /**
+   * Write the mesh and bounding volume hierarchy to the mesh cache of a DSK,
+   * so the next process that uses it does not have to read the DSK and build
+   * the hierarchy. Failing to write the cache is not an error.
+   *
+   * @param dskfile The DSK file the shape was loaded from.
+   */
+  void BulletDskShape::writeMeshCache(const QString &dskfile) const {
+    if ( !m_mesh || !body() ) {
+      return;
+    }
+
+    btBvhTriangleMeshShape *v_triShape = static_cast<btBvhTriangleMeshShape *>
+                                             (body()->getCollisionShape());
+    btOptimizedBvh *bvh = v_triShape->getOptimizedBvh();
+    if ( !bvh ) {
+      return;
+    }
+
+    ShapeMeshCache cache(dskfile, meshCacheEngine(), meshCacheEngineVersion());
+
+    QVector<qint32> segments;
+    for (int i = 0; i < m_mesh->getIndexedMeshArray().size(); i++) {
+      const btIndexedMesh &v_mesh = m_mesh->getIndexedMeshArray()[i];
+      segments << v_mesh.m_numVertices << v_mesh.m_numTriangles;
+      cache.addBlock("vertices" + toString(i), v_mesh.m_vertexBase,
+                     (qint64) v_mesh.m_numVertices * 3 * sizeof(double));
+      cache.addBlock("plates" + toString(i), v_mesh.m_triangleIndexBase,
+                     (qint64) v_mesh.m_numTriangles * 3 * sizeof(int));
+    }
+    cache.addBlock("segments", segments.constData(), segments.size() * sizeof(qint32));
+
+    // Bullet serializes the hierarchy the way it is laid out in memory
+    unsigned int bvhBytes = bvh->calculateSerializeBufferSize();
+    void *bvhData = btAlignedAlloc(bvhBytes, 16);
+    if ( bvhData && bvh->serialize(bvhData, bvhBytes, false) ) {
+      cache.addBlock("bvh", bvhData, bvhBytes);
+      cache.write();
+    }
+    btAlignedFree(bvhData);
+  }
+
 }  // namespace Isis
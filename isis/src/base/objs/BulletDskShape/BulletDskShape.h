@@ -13,6 +13,7 @@ find files of those names at the top level of this repository. **/
 
 #include "BulletTargetShape.h"
 #include "BulletClosestRayCallback.h"
+#include "ShapeMeshCache.h"
 
 namespace Isis {
 
@@ -22,6 +23,10 @@ namespace Isis {
  * @author 2017-03-17 Kris Becker
  * @internal
  *   @history 2017-03-17  Kris Becker  Original Version
+ *   @history 2026-10-16 ISIS Development Team - The mesh and its bounding volume
+ *                           hierarchy are read from a memory mapped ShapeMeshCache
+ *                           next to the DSK when one exists, and written to one
+ *                           when the ShapeMeshCache preference is ReadWrite.
  */
   class BulletDskShape : public BulletTargetShape {
     public:
@@ -42,9 +47,16 @@ namespace Isis {
                                                               except the DSK uses 1-based indexing
                                                               and this uses 0-based indexing. */
 
+      QScopedPointer<ShapeMeshCache> m_meshCache; /**! The mapped mesh cache the mesh and
+                                                       its bounding volume hierarchy are
+                                                       used from, if any. */
+
       // Custom DSK reader
       void loadFromDsk(const QString &dskfile);
 
+      bool loadFromMeshCache(const QString &dskfile);
+      void writeMeshCache(const QString &dskfile) const;
+
   };
 
 } // namespace Isis
@@ -315,12 +315,7 @@ namespace Isis {
    * Pops two elements, multiplies them, then pushes the product on the stack
    */
   void Calculator::Multiply() {
-    QVector<double> y = Pop();
-    QVector<double> x = Pop();
-    QVector<double> result;
-
-    PerformOperation(result, x.begin(), x.end(), y.begin(), y.end(), MultiplyOperator);
-    Push(result);
+    PerformBinaryOperation(MultiplyOperator);
   }
 
 
@@ -328,11 +323,7 @@ namespace Isis {
    * Pops two elements, adds them, then pushes the sum on the stack
    */
   void Calculator::Add() {
-    QVector<double> y = Pop();
-    QVector<double> x = Pop();
-    QVector<double> result;
-    PerformOperation(result, x.begin(), x.end(), y.begin(), y.end(), AddOperator);
-    Push(result);
+    PerformBinaryOperation(AddOperator);
   }
 
 
@@ -340,11 +331,7 @@ namespace Isis {
    * Pops two elements, subtracts them, then pushes the difference on the stack
    */
   void Calculator::Subtract() {
-    QVector<double> y = Pop();
-    QVector<double> x = Pop();
-    QVector<double> result;
-    PerformOperation(result, x.begin(), x.end(), y.begin(), y.end(), SubtractOperator);
-    Push(result);
+    PerformBinaryOperation(SubtractOperator);
   }
 
 
@@ -352,24 +339,14 @@ namespace Isis {
    * Pops two, divides them, then pushes the quotient on the stack
    */
   void Calculator::Divide() {
-    QVector<double> y = Pop();
-    QVector<double> x = Pop();
-    QVector<double> result;
-
-    PerformOperation(result, x.begin(), x.end(), y.begin(), y.end(), DivideOperator);
-    Push(result);
+    PerformBinaryOperation(DivideOperator);
   }
 
   /**
    * Pops two elements, mods them, then pushes the result on the stack
    */
   void Calculator::Modulus() {
-    QVector<double> y = Pop();
-    QVector<double> x = Pop();
-    QVector<double> result;
-
-    PerformOperation(result, x.begin(), x.end(), y.begin(), y.end(), ModulusOperator);
-    Push(result);
+    PerformBinaryOperation(ModulusOperator);
   }
 
 
@@ -380,12 +357,7 @@ namespace Isis {
    * @throws Isis::iException::Math
    */
   void Calculator::Exponent() {
-    QVector<double> exponent = Pop();
-    QVector<double> x = Pop();
-    QVector<double> result;
-
-    PerformOperation(result, x.begin(), x.end(), exponent.begin(), exponent.end(), pow);
-    Push(result);
+    PerformBinaryOperation(pow);
   }
 
 
@@ -585,13 +557,7 @@ namespace Isis {
    * than the other, then push the results on the stack.
    */
   void Calculator::GreaterThan() {
-    QVector<double> y = Pop();
-    QVector<double> x = Pop();
-    QVector<double> result;
-
-    PerformOperation(result, x.begin(), x.end(), y.begin(), y.end(),
-                     GreaterThanOperator);
-    Push(result);
+    PerformBinaryOperation(GreaterThanOperator);
   }
 
 
@@ -600,13 +566,7 @@ namespace Isis {
    * than the other, then push the results on the stack.
    */
   void Calculator::LessThan() {
-    QVector<double> y = Pop();
-    QVector<double> x = Pop();
-    QVector<double> result;
-
-    PerformOperation(result, x.begin(), x.end(), y.begin(), y.end(),
-                     LessThanOperator);
-    Push(result);
+    PerformBinaryOperation(LessThanOperator);
   }
 
 
@@ -615,13 +575,7 @@ namespace Isis {
    * to the other, then push the results on the stack.
    */
   void Calculator::Equal() {
-    QVector<double> y = Pop();
-    QVector<double> x = Pop();
-    QVector<double> result;
-
-    PerformOperation(result, x.begin(), x.end(), y.begin(), y.end(),
-                     EqualOperator);
-    Push(result);
+    PerformBinaryOperation(EqualOperator);
   }
 
 
@@ -630,13 +584,7 @@ namespace Isis {
    * than or equal to the other, then push the results on the stack.
    */
   void Calculator::GreaterThanOrEqual() {
-    QVector<double> y = Pop();
-    QVector<double> x = Pop();
-    QVector<double> result;
-
-    PerformOperation(result, x.begin(), x.end(), y.begin(), y.end(),
-                     GreaterThanOrEqualOperator);
-    Push(result);
+    PerformBinaryOperation(GreaterThanOrEqualOperator);
   }
 
 
@@ -645,13 +593,7 @@ namespace Isis {
    * than or equal to the other, then push the results on the stack.
    */
   void Calculator::LessThanOrEqual() {
-    QVector<double> y = Pop();
-    QVector<double> x = Pop();
-    QVector<double> result;
-
-    PerformOperation(result, x.begin(), x.end(), y.begin(), y.end(),
-                     LessThanOrEqualOperator);
-    Push(result);
+    PerformBinaryOperation(LessThanOrEqualOperator);
   }
 
 
@@ -660,13 +602,7 @@ namespace Isis {
    * equal to the other, then push the results on the stack.
    */
   void Calculator::NotEqual() {
-    QVector<double> y = Pop();
-    QVector<double> x = Pop();
-    QVector<double> result;
-
-    PerformOperation(result, x.begin(), x.end(), y.begin(), y.end(),
-                     NotEqualOperator);
-    Push(result);
+    PerformBinaryOperation(NotEqualOperator);
   }
 
 
@@ -677,13 +613,7 @@ namespace Isis {
    * Pop two elements, AND them, then push the result on the stack
    */
   void Calculator::And() {
-    QVector<double> y = Pop();
-    QVector<double> x = Pop();
-    QVector<double> result;
-
-    PerformOperation(result, x.begin(), x.end(), y.begin(), y.end(),
-                     BitwiseAndOperator);
-    Push(result);
+    PerformBinaryOperation(BitwiseAndOperator);
   }
 
 
@@ -691,13 +621,7 @@ namespace Isis {
    * Pop two elements, OR them, then push the result on the stack
    */
   void Calculator::Or() {
-    QVector<double> y = Pop();
-    QVector<double> x = Pop();
-    QVector<double> result;
-
-    PerformOperation(result, x.begin(), x.end(), y.begin(), y.end(),
-                     BitwiseOrOperator);
-    Push(result);
+    PerformBinaryOperation(BitwiseOrOperator);
   }
 
 
@@ -825,12 +749,7 @@ namespace Isis {
    * Pops two elements  and push the arctangent
    */
   void Calculator::Arctangent2() {
-    QVector<double> y = Pop();
-    QVector<double> x = Pop();
-    QVector<double> result;
-
-    PerformOperation(result, x.begin(), x.end(), y.begin(), y.end(), atan2);
-    Push(result);
+    PerformBinaryOperation(atan2);
   }
 
 
@@ -1025,6 +944,30 @@ namespace Isis {
   }
 
 
+  /**
+   * Pops two elements, performs a mathematical operation on them, then pushes
+   * the result on the stack. The result is written over the first element
+   * when it is at least as long as the second one, so most operations do not
+   * allocate.
+   *
+   * @param operation The operation to perform on each pair of arguments
+   */
+  void Calculator::PerformBinaryOperation(double operation(double, double)) {
+    QVector<double> y = Pop();
+    QVector<double> x = Pop();
+
+    if (x.size() >= y.size()) {
+      PerformOperation(x, x.begin(), x.end(), y.begin(), y.end(), operation);
+      Push(x);
+    }
+    else {
+      QVector<double> result;
+      PerformOperation(result, x.begin(), x.end(), y.begin(), y.end(), operation);
+      Push(result);
+    }
+  }
+
+
   /**
    * Performs the mathematical operations on each argument.
    *
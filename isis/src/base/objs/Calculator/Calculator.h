@@ -51,6 +51,10 @@ namespace Isis {
    *                          to fix ambiguity error when using c++11. References #4809.
    *  @history 2018-09-27 Kaitlyn Lee - Fixed the cout in PrintTop() so that -nan is printed
    *                          as nan. Updated code up to standards. References #5520.
+   *  @history 2026-10-16 ISIS Development Team - Binary operations write their result over
+   *                          their first argument when they can instead of allocating.
+   *                          Declared the operator functions so CubeCalculator can compile
+   *                          equations with them.
    */
   class Calculator {
     public:
@@ -126,6 +130,7 @@ namespace Isis {
                             QVector<double>::iterator arg2Start,
                             QVector<double>::iterator arg2End,
                             double operation(double, double));
+      void PerformBinaryOperation(double operation(double, double));
 
       //! Returns the current stack size
       int StackSize();
@@ -134,6 +139,27 @@ namespace Isis {
       //! The current stack of arguments
       QStack< QVector<double> > * p_valStack;
   };
+
+  // These are global methods, outside of all classes.
+  double NegateOperator(double a);
+  double MultiplyOperator(double a, double b);
+  double DivideOperator(double a, double b);
+  double AddOperator(double a, double b);
+  double SubtractOperator(double a, double b);
+  double GreaterThanOperator(double a, double b);
+  double LessThanOperator(double a, double b);
+  double EqualOperator(double a, double b);
+  double GreaterThanOrEqualOperator(double a, double b);
+  double LessThanOrEqualOperator(double a, double b);
+  double NotEqualOperator(double a, double b);
+  double CosecantOperator(double a);
+  double SecantOperator(double a);
+  double CotangentOperator(double a);
+  double BitwiseAndOperator(double a, double b);
+  double BitwiseOrOperator(double a, double b);
+  double ModulusOperator(double a, double b);
+  double MaximumOperator(double a, double b);
+  double MinimumOperator(double a, double b);
 };
 
 #endif
@@ -15,6 +15,8 @@ find files of those names at the top level of this repository. **/
 
 #include <QDebug>
 #include <QList>
+#include <QMutex>
+#include <QMutexLocker>
 #include <QPair>
 #include <QString>
 #include <QTime>
@@ -447,6 +449,130 @@ namespace Isis {
   }
 
 
+  /**
+   * Maps many image coordinates to the ground in one call. Each point gives
+   *   exactly the same result as SetImage() followed by GetSurfacePoint().
+   *
+   * This is a convenience loop over SetImage(), not a stateless or parallel
+   *   mapping: the points are mapped one after another through this camera's
+   *   own state. Batch calls on the same camera run one at a time, and when
+   *   the call returns the camera is back at the image coordinate and surface
+   *   point it was at before, including a point set with SetGround(). The lock
+   *   only guards this camera, so it does not make the camera thread-safe.
+   *   The single point methods (SetImage(), SetGround(), ...) are not locked
+   *   and must not be used while another thread makes a batch call on the same
+   *   camera. Like the single point methods, cameras that call NAIF must not
+   *   be evaluated on several threads at once because NAIF is not reentrant,
+   *   whether or not they are the same camera.
+   *
+   * @param imagePoints The points to map, x is the sample and y is the line
+   *
+   * @return @b QVector<SurfacePoint> The surface point for each image point.
+   *           Points that do not intersect the target are not Valid().
+   */
+  QVector<SurfacePoint> Camera::imageToGround(const QVector<QPointF> &imagePoints) {
+    QMutexLocker locker(&m_batchMappingMutex);
+
+    double oldSample = p_childSample;
+    double oldLine = p_childLine;
+    bool oldPointComputed = p_pointComputed;
+    SurfacePoint oldSurfacePoint = currentSurfacePoint();
+
+    QVector<SurfacePoint> groundPoints(imagePoints.size());
+    for (int i = 0; i < imagePoints.size(); i++) {
+      if (SetImage(imagePoints[i].x(), imagePoints[i].y())) {
+        groundPoints[i] = GetSurfacePoint();
+      }
+    }
+
+    restorePosition(oldSample, oldLine, oldPointComputed, oldSurfacePoint);
+    return groundPoints;
+  }
+
+
+  /**
+   * Maps many ground points to image coordinates in one call. Each point gives
+   *   exactly the same result as SetGround() followed by Sample() and Line().
+   *
+   * Like imageToGround(), this is a loop over SetGround() serialized per
+   *   camera that leaves the camera where it was. See imageToGround() for what
+   *   this does and does not make safe across threads.
+   *
+   * @param groundPoints The points to map
+   *
+   * @return @b QVector<QPointF> The image coordinate of each ground point, x is
+   *           the sample and y is the line. Both are Null for points that are
+   *           not visible to the camera.
+   */
+  QVector<QPointF> Camera::groundToImage(const QVector<SurfacePoint> &groundPoints) {
+    QMutexLocker locker(&m_batchMappingMutex);
+
+    double oldSample = p_childSample;
+    double oldLine = p_childLine;
+    bool oldPointComputed = p_pointComputed;
+    SurfacePoint oldSurfacePoint = currentSurfacePoint();
+
+    QVector<QPointF> imagePoints(groundPoints.size(), QPointF(Null, Null));
+    for (int i = 0; i < groundPoints.size(); i++) {
+      if (SetGround(groundPoints[i])) {
+        imagePoints[i] = QPointF(Sample(), Line());
+      }
+    }
+
+    restorePosition(oldSample, oldLine, oldPointComputed, oldSurfacePoint);
+    return imagePoints;
+  }
+
+
+  /**
+   * Returns the surface point the camera is at.
+   *
+   * @return @b SurfacePoint The current intersection, or an invalid point if
+   *           there is none
+   */
+  SurfacePoint Camera::currentSurfacePoint() {
+    ShapeModel *shape = target()->shape();
+    if (shape->hasIntersection()) {
+      return *shape->surfaceIntersection();
+    }
+    return SurfacePoint();
+  }
+
+
+  /**
+   * Puts the camera back where it was before a batch call. The image
+   *   coordinate is set again to restore the time and look direction, and the
+   *   saved surface point is put back as it was, so a camera placed with
+   *   SetGround() does not end up at a point that went through the image and
+   *   back.
+   *
+   * @param sample The sample the camera was at
+   * @param line The line the camera was at
+   * @param pointComputed Whether the camera was at a point at all
+   * @param surfacePoint The surface point the camera was at, invalid if none
+   */
+  void Camera::restorePosition(double sample, double line, bool pointComputed,
+                               const SurfacePoint &surfacePoint) {
+    if (pointComputed) {
+      SetImage(sample, line);
+    }
+    else {
+      target()->shape()->clearSurfacePoint();
+      p_childSample = sample;
+      p_childLine = line;
+      p_pointComputed = false;
+    }
+
+    ShapeModel *shape = target()->shape();
+    if (!surfacePoint.Valid()) {
+      shape->clearSurfacePoint();
+    }
+    else if (!shape->hasIntersection() || !(*shape->surfaceIntersection() == surfacePoint)) {
+      shape->setSurfacePoint(surfacePoint);
+    }
+  }
+
+
   /**
    * Computes the image coordinate for the current universal ground point
    *
@@ -10,8 +10,10 @@ find files of those names at the top level of this repository. **/
 #include "Sensor.h"
 
 #include <QList>
+#include <QMutex>
 #include <QPointF>
 #include <QString>
+#include <QVector>
 
 #include "AlphaCube.h"
 
@@ -231,6 +233,14 @@ namespace Isis {
    *   @history 2021-03-04 Victor Silva - Made changes to GetLocalNormal to calculate local normal
    *                           accurately for LRO by changing 4 corner surrounding points from adding
    *                           0.5 to line and sample and wrapping value with nexttoward.Fixes #4018.
+   *   @history 2026-10-16 ISIS Development Team - Added the imageToGround() and groundToImage()
+   *                           batch methods, which can be called from any thread and leave the
+   *                           camera where it was.
+   *   @history 2026-10-17 ISIS Development Team - Batch calls are serialized per camera instead
+   *                           of across all cameras. Corrected their thread-safety documentation.
+   *   @history 2026-10-17 ISIS Development Team - The batch methods also put back the surface
+   *                           point the camera was at. Documented that they are serial loops
+   *                           over SetImage() and SetGround(), not a stateless parallel path.
    */
 
   class Camera : public Sensor {
@@ -253,6 +263,9 @@ namespace Isis {
       virtual bool SetGround(const SurfacePoint & surfacePt);
       virtual bool SetRightAscensionDeclination(const double ra, const double dec);
 
+      QVector<SurfacePoint> imageToGround(const QVector<QPointF> &imagePoints);
+      QVector<QPointF> groundToImage(const QVector<SurfacePoint> &groundPoints);
+
       void LocalPhotometricAngles(Angle & phase, Angle & incidence,
                                   Angle & emission, bool &success);
       void Slope(double &slope, bool &success);
@@ -510,6 +523,9 @@ namespace Isis {
       void ringRangeResolution();
       double ComputeAzimuth(const double lat, const double lon);
       bool RawFocalPlanetoImage();
+      SurfacePoint currentSurfacePoint();
+      void restorePosition(double sample, double line, bool pointComputed,
+                           const SurfacePoint &surfacePoint);
       // SetImage helper functions:
       // bool SetImageNoProjection(const double sample, const double line);
       bool SetImageMapProjection(const double sample, const double line, ShapeModel *shape);
@@ -573,6 +589,8 @@ namespace Isis {
       /** The ideal geometric tile size to end with when projecting*/
       int p_geometricTilingEndSize;
 
+      //! Serializes the batch mapping methods of this camera, not NAIF
+      QMutex m_batchMappingMutex;
   };
 };
 
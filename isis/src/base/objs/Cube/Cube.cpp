@@ -21,6 +21,7 @@ find files of those names at the top level of this repository. **/
 #include "CameraFactory.h"
 #include "CubeAttribute.h"
 #include "CubeBsqHandler.h"
+#include "CubeCompressedTileHandler.h"
 #include "CubeTileHandler.h"
 #include "CubeStretch.h"
 #include "Endian.h"
@@ -561,6 +562,10 @@ namespace Isis {
       m_ioHandler = new CubeBsqHandler(dataFile(), m_virtualBandList, realDataFileLabel(),
                                        dataAlreadyOnDisk);
     }
+    else if (m_format == CompressedTile) {
+      m_ioHandler = new CubeCompressedTileHandler(dataFile(), m_virtualBandList,
+                                                  realDataFileLabel(), dataAlreadyOnDisk);
+    }
     else {
       m_ioHandler = new CubeTileHandler(dataFile(), m_virtualBandList, realDataFileLabel(),
                                         dataAlreadyOnDisk);
@@ -756,11 +761,24 @@ namespace Isis {
       m_ioHandler = new CubeBsqHandler(dataFile(), m_virtualBandList,
           realDataFileLabel(), true);
     }
+    else if (m_format == CompressedTile) {
+      m_ioHandler = new CubeCompressedTileHandler(dataFile(), m_virtualBandList,
+          realDataFileLabel(), true);
+    }
     else {
       m_ioHandler = new CubeTileHandler(dataFile(), m_virtualBandList,
           realDataFileLabel(), true);
     }
 
+    // Memory mapped cube data is only used by concurrent reads
+    if (access == "r") {
+      PvlGroup &performancePrefs = Preference::Preferences().findGroup("Performance");
+      if (performancePrefs.hasKeyword("CubeMemoryMap") &&
+          QString(performancePrefs["CubeMemoryMap"][0]).toLower() == "readonly") {
+        m_ioHandler->setConcurrentReads(true);
+      }
+    }
+
     if (dataLabel.first) {
       delete dataLabel.second;
       dataLabel.second = NULL;
@@ -829,7 +847,8 @@ namespace Isis {
 
   /**
    * This method will read a buffer of data from the cube as specified by the
-   * contents of the Buffer object.
+   * contents of the Buffer object. Cubes with concurrent reads enabled may be
+   * read from several threads at once.
    *
    * @param bufferToFill Buffer to be loaded
    */
@@ -839,6 +858,11 @@ namespace Isis {
       throw IException(IException::Programmer, msg, _FILEINFO_);
     }
 
+    if (m_ioHandler->concurrentReads()) {
+      m_ioHandler->read(bufferToFill);
+      return;
+    }
+
     QMutexLocker locker(m_mutex);
     m_ioHandler->read(bufferToFill);
   }
@@ -1265,10 +1289,10 @@ namespace Isis {
 
   /**
    * Used prior to the Create method, this will specify the format of the cube,
-   * either band, sequential or tiled.
+   * either band sequential, tiled or compressed tiled.
    * If not invoked, a tiled file will be created.
    *
-   * @param format An enumeration of either Bsq or Tile.
+   * @param format An enumeration of either Bsq, Tile or CompressedTile.
    */
   void Cube::setFormat(Format format) {
     openCheck();
@@ -1920,7 +1944,8 @@ namespace Isis {
    *
    * RegionalCachingAlgorithm is the only initial caching algorithm and works
    *   well for most cases. The caching algorithm only apply to the opened Cube
-   *   and is reset by any changes to the open status of the Cube.
+   *   and is reset by any changes to the open status of the Cube. They are
+   *   not used while concurrent reads are enabled, see setConcurrentReads().
    *
    * This method takes ownership of algorithm.
    *
@@ -1937,6 +1962,42 @@ namespace Isis {
     }
   }
 
+  /**
+   * Enable or disable concurrent reads of a cube opened read-only. While they
+   *   are enabled, read(Buffer &) does not take the cube's mutex and any number
+   *   of threads may read the cube at once. Chunks are then kept in a least
+   *   recently used cache that grows to fit the largest buffer read instead of
+   *   being managed by the caching algorithms; algorithms added with
+   *   addCachingAlgorithm() apply again once concurrent reads are disabled.
+   *
+   * Concurrent reads are also enabled when a cube is opened read-only while
+   *   the Performance preference CubeMemoryMap is ReadOnly, because the mapped
+   *   data is read through them.
+   *
+   * @param concurrentReads True to allow reading from several threads at once
+   *
+   * @throws IException::Programmer "Cannot read a cube concurrently unless it
+   *                                 is opened read-only"
+   */
+  void Cube::setConcurrentReads(bool concurrentReads) {
+    if (!isOpen() || (concurrentReads && !isReadOnly())) {
+      QString msg = "Cannot read a cube concurrently unless it is opened read-only";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
+
+    QMutexLocker locker(m_mutex);
+    m_ioHandler->setConcurrentReads(concurrentReads);
+  }
+
+
+  /**
+   * @returns True if the cube may be read from several threads at once
+   */
+  bool Cube::concurrentReads() const {
+    return m_ioHandler && m_ioHandler->concurrentReads();
+  }
+
+
   /**
    * This will clear excess RAM used for quicker IO in the cube. This should
    *   only be called if you need hundreds of cubes opened simultaneously. The
@@ -2312,6 +2373,9 @@ namespace Isis {
       if ((QString) core["Format"] == "BandSequential") {
         m_format = Bsq;
       }
+      else if ((QString) core["Format"] == "CompressedTile") {
+        m_format = CompressedTile;
+      }
       else {
         m_format = Tile;
       }
@@ -164,6 +164,9 @@ namespace Isis {
    *   @history 2019-06-15 Kristin Berry - Added latLonRange method to return the valid lat/lon rage of the cube. The values in the mapping group are not sufficiently accurate for some purposes.
    *   @history 2021-02-17 Jesse Mapel - Added hasBlob method to check for any type of BLOB.
    *   @history 2021-10-18 Evin Dunn - Switch to single quotes for 'Environment and Preferences' in Cube::create() exception
+   *   @history 2026-10-17 ISIS Development Team - Added setConcurrentReads() and
+   *                           concurrentReads(). Concurrent reads are no longer enabled
+   *                           for every cube opened read-only.
    */
   class Cube {
     public:
@@ -230,7 +233,18 @@ namespace Isis {
          * The symbol '*' denotes tile boundaries.
          * The symbols '-' and '|' denote cube boundaries.
          */
-        Tile
+        Tile,
+        /**
+         * Cubes are stored in tiles laid out like the Tile format, but each
+         *   tile is compressed on its own and tiles that are entirely NULL are
+         *   not stored at all. A table at the start of the cube data holds the
+         *   position and size of every tile.
+         *
+         * This is intended for mosaics, DEMs and other cubes that are mostly
+         *   NULL fill. Random access stays cheap because only the tiles that
+         *   are touched get decompressed.
+         */
+        CompressedTile
       };
 
       void fromIsd(const FileName &fileName, Pvl &label, nlohmann::json &isd, QString access);
@@ -316,6 +330,8 @@ namespace Isis {
 
       void addCachingAlgorithm(CubeCachingAlgorithm *);
       void clearIoCache();
+      void setConcurrentReads(bool concurrentReads);
+      bool concurrentReads() const;
       bool deleteBlob(QString BlobName, QString BlobType);
       void deleteGroup(const QString &group);
       PvlGroup &group(const QString &group) const;
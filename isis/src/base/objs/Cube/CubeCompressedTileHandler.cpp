@@ -0,0 +1,552 @@
+/** This is free and unencumbered software released into the public domain.
+The authors of ISIS do not claim copyright on the contents of this file.
+For more details about the LICENSE terms and the AUTHORS, you will
+find files of those names at the top level of this repository. **/
+
+/* SPDX-License-Identifier: CC0-1.0 */
+
+#include "CubeCompressedTileHandler.h"
+
+#include <algorithm>
+#include <cerrno>
+
+#include <unistd.h>
+
+#include <QFile>
+#include <QMutexLocker>
+#include <QtEndian>
+
+#include "IException.h"
+#include "IString.h"
+#include "Pvl.h"
+#include "PvlObject.h"
+#include "PvlKeyword.h"
+#include "RawCubeChunk.h"
+
+using namespace std;
+
+namespace Isis {
+  //! The bytes in one tile table entry (offset and size)
+  static const int IndexEntryBytes = 16;
+
+  //! The zlib level used for tiles. Level 1 is much faster than the default
+  //!   and NULL fill compresses just as well either way.
+  static const int CompressionLevel = 1;
+
+  /**
+   * Construct a compressed tile handler. The tile table is read from the
+   *   data file if the cube is already on disk; otherwise space for it is
+   *   reserved and every tile starts out NULL.
+   *
+   * @param dataFile The file with cube DN data in it
+   * @param virtualBandList The mapping from virtual band to physical band, see
+   *          CubeIoHandler's description.
+   * @param labels The Pvl labels for the cube
+   * @param alreadyOnDisk True if the cube is allocated on the disk, false
+   *          otherwise
+   */
+  CubeCompressedTileHandler::CubeCompressedTileHandler(QFile * dataFile,
+      const QList<int> *virtualBandList, const Pvl &labels, bool alreadyOnDisk)
+      : CubeIoHandler(dataFile, virtualBandList, labels, alreadyOnDisk) {
+    m_dataEnd = 0;
+
+    const PvlObject &core = labels.findObject("IsisCube").findObject("Core");
+
+    if(core.hasKeyword("Format")) {
+      if(core.hasKeyword("Compression") &&
+         ((QString)core["Compression"]).toUpper() != "ZLIB") {
+        QString msg = "Compression [" + (QString)core["Compression"] + "] of the "
+            "cube data in [" + dataFile->fileName() + "] is not supported";
+        throw IException(IException::Io, msg, _FILEINFO_);
+      }
+
+      setChunkSizes(core["TileSamples"], core["TileLines"], 1);
+    }
+    else {
+      // Padding past the cube edges is NULL, so it costs nothing on disk. That
+      //   lets us use square tiles instead of hunting for an even divisor.
+      setChunkSizes(min(256, sampleCount()), min(256, lineCount()), 1);
+    }
+
+    m_tiles.resize(getChunkCount());
+    for(int i = 0; i < m_tiles.size(); i++) {
+      m_tiles[i].offset = 0;
+      m_tiles[i].bytes = 0;
+      m_tiles[i].capacity = 0;
+    }
+    m_dataEnd = getIndexBytes();
+
+    // The table of a new cube is written right away so that it is valid even
+    //   if no tile is ever written
+    if(alreadyOnDisk) {
+      readIndex(labels);
+    }
+    else {
+      writeIndex();
+    }
+
+    RawCubeChunk *nullTile = getNullChunk(0);
+    m_nullTileData = nullTile->getRawData();
+    delete nullTile;
+  }
+
+
+  /**
+   * Writes all data from memory to disk. The tile table is already up to date
+   *   on disk because every tile updates its entry as it is written.
+   */
+  CubeCompressedTileHandler::~CubeCompressedTileHandler() {
+    clearCache();
+  }
+
+
+  /**
+   * Update the cube labels so that this cube indicates what tile size and
+   *   compression it used.
+   *
+   * @param labels The "Core" object in this Pvl will be updated
+   */
+  void CubeCompressedTileHandler::updateLabels(Pvl &labels) {
+    PvlObject &core = labels.findObject("IsisCube").findObject("Core");
+    core.addKeyword(PvlKeyword("Format", "CompressedTile"),
+                    PvlContainer::Replace);
+    core.addKeyword(PvlKeyword("TileSamples", toString(getSampleCountInChunk())),
+                    PvlContainer::Replace);
+    core.addKeyword(PvlKeyword("TileLines", toString(getLineCountInChunk())),
+                    PvlContainer::Replace);
+    core.addKeyword(PvlKeyword("Compression", "Zlib"),
+                    PvlContainer::Replace);
+  }
+
+
+  /**
+   * @return The bytes used by the tile table and the compressed tiles written
+   *   so far. Anything written after the cube data (like blobs) goes after
+   *   this.
+   */
+  BigInt CubeCompressedTileHandler::getDataSize() const {
+    // This is called by setChunkSizes() before the tile table exists
+    if(m_tiles.isEmpty()) {
+      return getIndexBytes();
+    }
+
+    QMutexLocker locker(&m_tileMutex);
+    return m_dataEnd;
+  }
+
+
+  void CubeCompressedTileHandler::readRaw(RawCubeChunk &chunkToFill) {
+    TileLocation tile;
+    {
+      QMutexLocker locker(&m_tileMutex);
+      tile = m_tiles[getChunkIndex(chunkToFill)];
+    }
+
+    if(tile.bytes == 0) {
+      chunkToFill.setRawData(m_nullTileData);
+      return;
+    }
+
+    BigInt startByte = getDataStartByte() + tile.offset;
+    bool success = false;
+
+    QFile * dataFile = getDataFile();
+    if(dataFile->seek(startByte)) {
+      QByteArray compressed = dataFile->read(tile.bytes);
+
+      if(compressed.size() == tile.bytes) {
+        uncompressTile(compressed, chunkToFill);
+        success = true;
+      }
+    }
+
+    if(!success) {
+      IString msg = "Reading from the file [" + dataFile->fileName() + "] "
+          "failed with reading [" + QString::number(tile.bytes) +
+          "] bytes at position [" + QString::number(startByte) + "]";
+      throw IException(IException::Io, msg, _FILEINFO_);
+    }
+  }
+
+
+  /**
+   * Compress a tile and write it, followed by its entry in the tile table. A
+   *   tile that no longer fits in its space is written to the smallest free
+   *   extent it fits in, or after all of the other tiles, and its old space is
+   *   freed once its table entry points at the new space. The table on disk
+   *   therefore always points at complete tiles, even if the process dies
+   *   before the cube is closed.
+   *
+   * @param chunkToWrite The tile to write
+   */
+  void CubeCompressedTileHandler::writeRaw(const RawCubeChunk &chunkToWrite) {
+    QMutexLocker locker(&m_tileMutex);
+
+    int chunkIndex = getChunkIndex(chunkToWrite);
+    TileLocation &tile = m_tiles[chunkIndex];
+    QFile * dataFile = getDataFile();
+
+    if(chunkToWrite.getRawData() == m_nullTileData) {
+      if(tile.bytes != 0 || tile.capacity != 0) {
+        BigInt oldOffset = tile.offset;
+        BigInt oldCapacity = tile.capacity;
+        tile.offset = 0;
+        tile.bytes = 0;
+        tile.capacity = 0;
+        writeIndexEntry(chunkIndex);
+        releaseExtent(oldOffset, oldCapacity);
+      }
+      return;
+    }
+
+    QByteArray compressed = qCompress(chunkToWrite.getRawData(), CompressionLevel);
+
+    BigInt oldOffset = tile.offset;
+    BigInt oldCapacity = tile.capacity;
+    bool moved = (compressed.size() > tile.capacity);
+    if(moved) {
+      tile.offset = allocateExtent(compressed.size());
+      tile.capacity = compressed.size();
+    }
+    tile.bytes = compressed.size();
+
+    BigInt startByte = getDataStartByte() + tile.offset;
+    bool success = false;
+
+    if(dataFile->seek(startByte)) {
+      BigInt dataWritten = dataFile->write(compressed);
+
+      if(dataWritten == compressed.size()) {
+        success = true;
+      }
+    }
+
+    if(!success) {
+      IString msg = "Writing to the file [" + dataFile->fileName() + "] "
+          "failed with writing [" + QString::number(compressed.size()) +
+          "] bytes at position [" + QString::number(startByte) + "]";
+      throw IException(IException::Io, msg, _FILEINFO_);
+    }
+
+    writeIndexEntry(chunkIndex);
+
+    if(moved) {
+      releaseExtent(oldOffset, oldCapacity);
+    }
+  }
+
+
+  /**
+   * Read and uncompress a tile with pread() for concurrent reads. The tile
+   *   table is not modified while concurrent reads are enabled, so this reads
+   *   it without locking m_tileMutex.
+   *
+   * Ownership of the return value is given to the caller.
+   *
+   * @param chunkIndex The chunk number in the cube file
+   * @return The chunk at chunkIndex
+   */
+  RawCubeChunk *CubeCompressedTileHandler::readRawConcurrently(int chunkIndex) const {
+    int startSample;
+    int startLine;
+    int startBand;
+    int endSample;
+    int endLine;
+    int endBand;
+    getChunkPlacement(chunkIndex, startSample, startLine, startBand,
+                      endSample, endLine, endBand);
+
+    RawCubeChunk *chunk = new RawCubeChunk(startSample, startLine, startBand,
+                                           endSample, endLine, endBand,
+                                           getBytesPerChunk());
+
+    const TileLocation &tile = m_tiles[chunkIndex];
+    if(tile.bytes == 0) {
+      chunk->setRawData(m_nullTileData);
+      return chunk;
+    }
+
+    QByteArray compressed((int)tile.bytes, '\0');
+
+    QFile * dataFile = const_cast<CubeCompressedTileHandler *>(this)->getDataFile();
+    int fileDescriptor = dataFile->handle();
+    char *data = compressed.data();
+    BigInt bytesLeft = tile.bytes;
+    BigInt position = getDataStartByte() + tile.offset;
+    bool success = (fileDescriptor >= 0);
+
+    while(success && bytesLeft > 0) {
+      ssize_t bytesRead = ::pread(fileDescriptor, data, bytesLeft, position);
+
+      if(bytesRead < 0 && errno == EINTR) {
+        continue;
+      }
+
+      success = (bytesRead > 0);
+      if(success) {
+        data += bytesRead;
+        bytesLeft -= bytesRead;
+        position += bytesRead;
+      }
+    }
+
+    if(!success) {
+      delete chunk;
+
+      IString msg = "Reading from the file [" + dataFile->fileName() + "] "
+          "failed with reading [" + QString::number(tile.bytes) +
+          "] bytes at position [" +
+          QString::number(getDataStartByte() + tile.offset) + "]";
+      throw IException(IException::Io, msg, _FILEINFO_);
+    }
+
+    try {
+      uncompressTile(compressed, *chunk);
+    }
+    catch(IException &) {
+      delete chunk;
+      throw;
+    }
+
+    return chunk;
+  }
+
+
+  /**
+   * @return The size of the tile table at the start of the cube data
+   */
+  BigInt CubeCompressedTileHandler::getIndexBytes() const {
+    return (BigInt)getChunkCount() * IndexEntryBytes;
+  }
+
+
+  /**
+   * Read the tile table from the start of the cube data. The space after the
+   *   table that is not used by a tile or a blob is free for tiles written
+   *   later.
+   *
+   * @param labels The labels of the cube, used to find blobs that were
+   *               written in between the tiles
+   */
+  void CubeCompressedTileHandler::readIndex(const Pvl &labels) {
+    QFile * dataFile = getDataFile();
+    QByteArray index;
+
+    if(dataFile->seek(getDataStartByte())) {
+      index = dataFile->read(getIndexBytes());
+    }
+
+    if(index.size() != getIndexBytes()) {
+      IString msg = "Reading the tile table from the file [" +
+          dataFile->fileName() + "] failed with reading [" +
+          QString::number(getIndexBytes()) + "] bytes at position [" +
+          QString::number(getDataStartByte()) + "]";
+      throw IException(IException::Io, msg, _FILEINFO_);
+    }
+
+    QMap<BigInt, BigInt> usedExtents;
+
+    const uchar *entry = (const uchar *)index.constData();
+    for(int i = 0; i < m_tiles.size(); i++, entry += IndexEntryBytes) {
+      TileLocation &tile = m_tiles[i];
+      tile.offset = qFromLittleEndian<qint64>(entry);
+      tile.bytes = qFromLittleEndian<qint64>(entry + 8);
+      tile.capacity = tile.bytes;
+
+      if(tile.bytes != 0) {
+        m_dataEnd = max(m_dataEnd, tile.offset + tile.bytes);
+        usedExtents.insert(tile.offset, tile.bytes);
+      }
+    }
+
+    for(int i = 0; i < labels.objects(); i++) {
+      const PvlObject &object = labels.object(i);
+      if(object.hasKeyword("StartByte") && object.hasKeyword("Bytes")) {
+        BigInt blobStart = toBigInt(object["StartByte"][0]) - 1 - getDataStartByte();
+        BigInt blobBytes = toBigInt(object["Bytes"][0]);
+        if(blobStart + blobBytes > getIndexBytes()) {
+          usedExtents.insert(blobStart, blobBytes);
+        }
+      }
+    }
+
+    // Tiles that moved past a blob and were later NULLed leave free space all
+    //   the way to the end of the file
+    BigInt fileEnd = (BigInt)dataFile->size() - getDataStartByte();
+    usedExtents.insert(fileEnd, 0);
+
+    BigInt freeStart = getIndexBytes();
+    QMapIterator<BigInt, BigInt> it(usedExtents);
+    while(it.hasNext()) {
+      it.next();
+      if(it.key() > freeStart) {
+        releaseExtent(freeStart, min(it.key(), fileEnd) - freeStart);
+      }
+      freeStart = max(freeStart, it.key() + it.value());
+    }
+  }
+
+
+  /**
+   * Write the whole tile table to the start of the cube data.
+   */
+  void CubeCompressedTileHandler::writeIndex() {
+    QByteArray index(getIndexBytes(), '\0');
+
+    uchar *entry = (uchar *)index.data();
+    for(int i = 0; i < m_tiles.size(); i++, entry += IndexEntryBytes) {
+      const TileLocation &tile = m_tiles[i];
+      qToLittleEndian<qint64>(tile.bytes ? tile.offset : 0, entry);
+      qToLittleEndian<qint64>(tile.bytes, entry + 8);
+    }
+
+    QFile * dataFile = getDataFile();
+    bool success = false;
+
+    if(dataFile->seek(getDataStartByte())) {
+      success = (dataFile->write(index) == index.size());
+    }
+
+    if(!success) {
+      IString msg = "Writing the tile table to the file [" +
+          dataFile->fileName() + "] failed with writing [" +
+          QString::number(index.size()) + "] bytes at position [" +
+          QString::number(getDataStartByte()) + "]";
+      throw IException(IException::Io, msg, _FILEINFO_);
+    }
+  }
+
+
+  /**
+   * Write one entry of the tile table to the start of the cube data.
+   *
+   * @param chunkIndex The tile whose entry is written
+   */
+  void CubeCompressedTileHandler::writeIndexEntry(int chunkIndex) {
+    uchar entry[IndexEntryBytes];
+    const TileLocation &tile = m_tiles[chunkIndex];
+    qToLittleEndian<qint64>(tile.bytes ? tile.offset : 0, entry);
+    qToLittleEndian<qint64>(tile.bytes, entry + 8);
+
+    QFile * dataFile = getDataFile();
+    BigInt startByte = getDataStartByte() + (BigInt)chunkIndex * IndexEntryBytes;
+    bool success = false;
+
+    if(dataFile->seek(startByte)) {
+      success = (dataFile->write((const char *)entry, IndexEntryBytes) == IndexEntryBytes);
+    }
+
+    if(!success) {
+      IString msg = "Writing the tile table to the file [" +
+          dataFile->fileName() + "] failed with writing [" +
+          QString::number(IndexEntryBytes) + "] bytes at position [" +
+          QString::number(startByte) + "]";
+      throw IException(IException::Io, msg, _FILEINFO_);
+    }
+  }
+
+
+  /**
+   * Find space for a tile. The smallest free extent that is large enough is
+   *   used, and the rest of it stays free. If no extent is large enough the
+   *   tile goes after the last tile, or after the end of the file if blobs
+   *   were written there.
+   *
+   * @param bytes The size of the tile
+   * @return The offset of the space relative to the start of the cube data
+   */
+  BigInt CubeCompressedTileHandler::allocateExtent(BigInt bytes) {
+    QMultiMap<BigInt, BigInt>::iterator fit = m_freeExtentsBySize.lowerBound(bytes);
+
+    if(fit == m_freeExtentsBySize.end()) {
+      // Blobs may have been written after the cube data, never write over them
+      BigInt offset = max(m_dataEnd, (BigInt)getDataFile()->size() - getDataStartByte());
+      m_dataEnd = offset + bytes;
+      return offset;
+    }
+
+    BigInt offset = fit.value();
+    BigInt extentBytes = fit.key();
+    m_freeExtentsBySize.erase(fit);
+    m_freeExtents.remove(offset);
+
+    if(extentBytes > bytes) {
+      m_freeExtents.insert(offset + bytes, extentBytes - bytes);
+      m_freeExtentsBySize.insert(extentBytes - bytes, offset + bytes);
+    }
+
+    return offset;
+  }
+
+
+  /**
+   * Return the space of a tile to the free extents, merging it with the free
+   *   extents right before and after it.
+   *
+   * @param offset The start of the space relative to the start of the cube data
+   * @param bytes The size of the space
+   */
+  void CubeCompressedTileHandler::releaseExtent(BigInt offset, BigInt bytes) {
+    if(bytes <= 0) {
+      return;
+    }
+
+    QMap<BigInt, BigInt>::iterator next = m_freeExtents.lowerBound(offset);
+    if(next != m_freeExtents.begin()) {
+      QMap<BigInt, BigInt>::iterator previous = next - 1;
+      if(previous.key() + previous.value() == offset) {
+        offset = previous.key();
+        bytes += previous.value();
+        removeFreeExtent(previous.key(), previous.value());
+      }
+    }
+
+    next = m_freeExtents.find(offset + bytes);
+    if(next != m_freeExtents.end()) {
+      BigInt nextBytes = next.value();
+      removeFreeExtent(offset + bytes, nextBytes);
+      bytes += nextBytes;
+    }
+
+    m_freeExtents.insert(offset, bytes);
+    m_freeExtentsBySize.insert(bytes, offset);
+  }
+
+
+  /**
+   * Remove a free extent from both of the maps that track it.
+   *
+   * @param offset The start of the extent
+   * @param bytes The size of the extent
+   */
+  void CubeCompressedTileHandler::removeFreeExtent(BigInt offset, BigInt bytes) {
+    m_freeExtents.remove(offset);
+
+    QMultiMap<BigInt, BigInt>::iterator it = m_freeExtentsBySize.find(bytes, offset);
+    if(it != m_freeExtentsBySize.end()) {
+      m_freeExtentsBySize.erase(it);
+    }
+  }
+
+
+  /**
+   * Uncompress a tile into a chunk.
+   *
+   * @param compressed The tile as it is stored on disk
+   * @param chunk The chunk to fill with the tile's raw bytes
+   */
+  void CubeCompressedTileHandler::uncompressTile(const QByteArray &compressed,
+                                                 RawCubeChunk &chunk) const {
+    QByteArray rawData = qUncompress(compressed);
+
+    if(rawData.size() != getBytesPerChunk()) {
+      QString msg = "A compressed tile starting at sample [" +
+          toString(chunk.getStartSample()) + "], line [" +
+          toString(chunk.getStartLine()) + "], band [" +
+          toString(chunk.getStartBand()) + "] is corrupt";
+      throw IException(IException::Io, msg, _FILEINFO_);
+    }
+
+    chunk.setRawData(rawData);
+  }
+}
@@ -0,0 +1,124 @@
+#ifndef CubeCompressedTileHandler_h
+#define CubeCompressedTileHandler_h
+/** This is free and unencumbered software released into the public domain.
+The authors of ISIS do not claim copyright on the contents of this file.
+For more details about the LICENSE terms and the AUTHORS, you will
+find files of those names at the top level of this repository. **/
+
+/* SPDX-License-Identifier: CC0-1.0 */
+
+#include "CubeIoHandler.h"
+
+#include <QByteArray>
+#include <QMap>
+#include <QMultiMap>
+#include <QMutex>
+#include <QVector>
+
+namespace Isis {
+
+  /**
+   * @brief IO Handler for Isis Cubes using the compressed tile format.
+   *
+   * Tiles are chosen the same way as in the Tile format, but each tile is
+   *   compressed with zlib before it goes to disk and tiles that are all NULL
+   *   are not written at all. The cube data starts with a table that has one
+   *   entry per tile: the tile's position relative to the start of the cube
+   *   data and its compressed size, both as little endian 64 bit integers. A
+   *   size of 0 means the tile is NULL. The compressed tiles follow the table.
+   *
+   * A tile that grows when it is rewritten is moved to the smallest free space
+   *   it fits in, or to the end of the file. The space of tiles that moved or
+   *   became NULL is reused by later tiles, including space left free by an
+   *   earlier session. Each tile's table entry is written right after the
+   *   tile, and the old space is only freed after that, so the table on disk
+   *   always points at complete tiles.
+   *
+   * @ingroup LowLevelCubeIO
+   *
+   * @author 2026-10-16 ISIS Development Team
+   *
+   * @internal
+   *   @history 2026-10-17 ISIS Development Team - Reuse the space of tiles that
+   *                           moved or became NULL, write each table entry
+   *                           when its tile is written instead of when the
+   *                           cube is closed, and guard the tile table with a
+   *                           mutex.
+   */
+  class CubeCompressedTileHandler : public CubeIoHandler {
+    public:
+      CubeCompressedTileHandler(QFile * dataFile, const QList<int> *virtualBandList,
+          const Pvl &label, bool alreadyOnDisk);
+      ~CubeCompressedTileHandler();
+
+      void updateLabels(Pvl &label);
+
+      BigInt getDataSize() const;
+
+    protected:
+      virtual void readRaw(RawCubeChunk &chunkToFill);
+      virtual void writeRaw(const RawCubeChunk &chunkToWrite);
+      virtual RawCubeChunk *readRawConcurrently(int chunkIndex) const;
+
+    private:
+      /**
+       * Disallow copying of this object.
+       *
+       * @param other The object to copy.
+       */
+      CubeCompressedTileHandler(const CubeCompressedTileHandler &other);
+
+      /**
+       * Disallow assignments of this object
+       *
+       * @param other The CubeCompressedTileHandler on the right-hand side of
+       *              the assignment that we are copying into *this.
+       * @return A reference to *this.
+       */
+      CubeCompressedTileHandler &operator=(const CubeCompressedTileHandler &other);
+
+      /**
+       * Where a tile is in the cube data
+       */
+      struct TileLocation {
+        //! Start of the compressed tile relative to the start of the cube data
+        BigInt offset;
+        //! Size of the compressed tile, 0 if the tile is NULL
+        BigInt bytes;
+        //! Bytes available at offset for rewriting this tile in place
+        BigInt capacity;
+      };
+
+      BigInt getIndexBytes() const;
+      void readIndex(const Pvl &labels);
+      void writeIndex();
+      void writeIndexEntry(int chunkIndex);
+      BigInt allocateExtent(BigInt bytes);
+      void releaseExtent(BigInt offset, BigInt bytes);
+      void removeFreeExtent(BigInt offset, BigInt bytes);
+      void uncompressTile(const QByteArray &compressed, RawCubeChunk &chunk) const;
+
+      //! The location of every tile, by chunk index
+      QVector<TileLocation> m_tiles;
+
+      //! The end of the last tile relative to the start of the cube data
+      BigInt m_dataEnd;
+
+      //! Free space between the tiles, size by offset
+      QMap<BigInt, BigInt> m_freeExtents;
+
+      //! The same free space as m_freeExtents, offset by size
+      QMultiMap<BigInt, BigInt> m_freeExtentsBySize;
+
+      /**
+       * Guards m_tiles, m_dataEnd and the free space. This is not the write
+       *   thread mutex because writeRaw() is called with that one held.
+       */
+      mutable QMutex m_tileMutex;
+
+      //! The raw bytes of a tile that is all NULL
+      QByteArray m_nullTileData;
+  };
+}
+
+#endif
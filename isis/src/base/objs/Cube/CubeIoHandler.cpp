@@ -7,22 +7,31 @@ find files of those names at the top level of this repository. **/
 #include "CubeIoHandler.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cerrno>
 #include <cmath>
+#include <cstring>
 #include <iomanip>
+#include <list>
+
+#include <unistd.h>
 
 #include <QDebug>
 #include <QFile>
+#include <QHash>
 #include <QList>
 #include <QListIterator>
 #include <QMapIterator>
 #include <QMutex>
 #include <QPair>
 #include <QRect>
+#include <QSharedPointer>
 #include <QElapsedTimer>
 
 #include "Area3D.h"
 #include "Brick.h"
 #include "CubeCachingAlgorithm.h"
+#include "CubePixelConverter.h"
 #include "Displacement.h"
 #include "Distance.h"
 #include "Endian.h"
@@ -42,6 +51,179 @@ find files of those names at the top level of this repository. **/
 using namespace std;
 
 namespace Isis {
+
+  /**
+   * The chunk cache used while concurrent reads are enabled. Chunks are spread
+   *   over a fixed number of shards by a hash of their index so that readers
+   *   working on different parts of the cube rarely wait on each other, and so
+   *   that the chunks of a strided access, such as one chunk per band of a
+   *   band sequential cube, do not all land in the same shard. Each shard keeps
+   *   its chunks in least recently used order and drops the oldest ones once
+   *   it holds more than its share of the byte budget. Finding, inserting and
+   *   evicting a chunk are all constant time.
+   *
+   * The byte budget grows to fit the largest set of chunks a single read
+   *   needed, for every thread, so reads that touch many chunks at once, like
+   *   spectra of a band sequential cube, do not evict each other's chunks.
+   *
+   * Chunks in this cache are already in native byte order and are never
+   *   modified after they are inserted, so a reader can keep using a chunk
+   *   after another reader evicted it.
+   */
+  class CubeIoHandler::ConcurrentChunkCache {
+    public:
+      /**
+       * @param maxBytes The number of chunk bytes to keep in memory
+       * @param bytesPerChunk The size of one chunk
+       * @param threads The number of threads expected to read at once
+       */
+      ConcurrentChunkCache(BigInt maxBytes, BigInt bytesPerChunk, int threads) {
+        m_bytesPerChunk = bytesPerChunk;
+        m_threads = threads;
+        m_maxBytesPerShard = 0;
+        reserve(maxBytes);
+      }
+
+
+      /**
+       * Grow the byte budget so that every thread can keep the chunks of the
+       *   buffer it is reading and of the next one. The budget never shrinks.
+       *
+       * @param chunkCount The number of chunks one read needed
+       */
+      void reserveChunks(int chunkCount) {
+        reserve(2 * (BigInt)chunkCount * m_bytesPerChunk * m_threads);
+      }
+
+
+      /**
+       * Grow the byte budget so that it holds at least the given number of
+       *   bytes. The budget never shrinks.
+       *
+       * @param bytes The number of chunk bytes the cache should be able to hold
+       */
+      void reserve(BigInt bytes) {
+        // A shard gets one extra chunk because the hash does not spread a
+        //   handful of chunks perfectly evenly
+        BigInt bytesPerShard = bytes / ShardCount + m_bytesPerChunk;
+        BigInt current = m_maxBytesPerShard.load();
+        while (bytesPerShard > current &&
+               !m_maxBytesPerShard.compare_exchange_weak(current, bytesPerShard)) {
+        }
+      }
+
+
+      /**
+       * @param chunkIndex The chunk to look for
+       * @return The cached chunk, or a null pointer if it is not cached
+       */
+      QSharedPointer<RawCubeChunk> find(int chunkIndex) {
+        Shard &shard = shardOf(chunkIndex);
+        QMutexLocker locker(&shard.mutex);
+
+        QSharedPointer<RawCubeChunk> result;
+        QHash<int, CachedChunk>::iterator it = shard.chunks.find(chunkIndex);
+        if (it != shard.chunks.end()) {
+          shard.order.splice(shard.order.end(), shard.order, it->position);
+          result = it->chunk;
+        }
+
+        return result;
+      }
+
+
+      /**
+       * Cache a chunk that was just read. If another reader cached the same
+       *   chunk in the meantime, that chunk is kept and returned instead.
+       *
+       * @param chunkIndex The index of the chunk
+       * @param chunk The chunk that was read
+       * @return The chunk that is now cached at chunkIndex
+       */
+      QSharedPointer<RawCubeChunk> insert(int chunkIndex,
+                                          QSharedPointer<RawCubeChunk> chunk) {
+        Shard &shard = shardOf(chunkIndex);
+        QMutexLocker locker(&shard.mutex);
+
+        QHash<int, CachedChunk>::iterator it = shard.chunks.find(chunkIndex);
+        if (it != shard.chunks.end()) {
+          shard.order.splice(shard.order.end(), shard.order, it->position);
+          return it->chunk;
+        }
+
+        CachedChunk cached;
+        cached.chunk = chunk;
+        cached.position = shard.order.insert(shard.order.end(), chunkIndex);
+        shard.chunks.insert(chunkIndex, cached);
+        shard.bytes += chunk->getByteCount();
+
+        // The chunk we just inserted is the most recently used, so it is never
+        //   the one evicted here.
+        BigInt maxBytes = m_maxBytesPerShard.load();
+        while (shard.bytes > maxBytes && shard.chunks.size() > 1) {
+          it = shard.chunks.find(shard.order.front());
+          shard.bytes -= it->chunk->getByteCount();
+          shard.chunks.erase(it);
+          shard.order.pop_front();
+        }
+
+        return chunk;
+      }
+
+
+      //! Drop every cached chunk.
+      void clear() {
+        for (int i = 0; i < ShardCount; i++) {
+          QMutexLocker locker(&m_shards[i].mutex);
+          m_shards[i].chunks.clear();
+          m_shards[i].order.clear();
+          m_shards[i].bytes = 0;
+        }
+      }
+
+    private:
+      //! The number of independently locked parts of the cache
+      static const int ShardCount = 16;
+
+      //! A cached chunk and its place in the least recently used order
+      struct CachedChunk {
+        QSharedPointer<RawCubeChunk> chunk; //!< The chunk data, native byte order
+        std::list<int>::iterator position; //!< The chunk's entry in Shard::order
+      };
+
+      //! One independently locked part of the cache
+      struct Shard {
+        Shard() : bytes(0) {}
+
+        QMutex mutex; //!< Guards the rest of the shard
+        QHash<int, CachedChunk> chunks; //!< Chunk index to cached chunk
+        std::list<int> order; //!< Chunk indices, least recently used first
+        BigInt bytes; //!< The number of chunk bytes in this shard
+      };
+
+      /**
+       * @param chunkIndex A chunk index
+       * @return The shard that holds the chunk
+       */
+      Shard &shardOf(int chunkIndex) {
+        // Fibonacci hashing, the top bits of the product pick the shard
+        quint32 hash = (quint32)chunkIndex * 2654435761u;
+        return m_shards[hash >> 28];
+      }
+
+      //! The shards
+      Shard m_shards[ShardCount];
+
+      //! The size of one chunk
+      BigInt m_bytesPerChunk;
+
+      //! The number of threads expected to read at once
+      int m_threads;
+
+      //! The byte budget of each shard
+      std::atomic<BigInt> m_maxBytesPerShard;
+  };
+
   /**
    * Creates a new CubeIoHandler using a RegionalCachingAlgorithm. The chunk
    *   sizes must be set by a child in its constructor.
@@ -61,6 +243,7 @@ namespace Isis {
   CubeIoHandler::CubeIoHandler(QFile * dataFile,
       const QList<int> *virtualBandList, const Pvl &label, bool alreadyOnDisk) {
     m_byteSwapper = NULL;
+    m_pixelConverter = NULL;
     m_cachingAlgorithms = NULL;
     m_dataIsOnDiskMap = NULL;
     m_rawData = NULL;
@@ -70,6 +253,8 @@ namespace Isis {
     m_writeCache = NULL;
     m_ioThreadPool = NULL;
     m_writeThreadMutex = NULL;
+    m_concurrentCache = NULL;
+    m_mappedData = NULL;
 
     try {
       if (!dataFile) {
@@ -120,6 +305,8 @@ namespace Isis {
         m_byteSwapper = NULL;
       }
 
+      m_pixelConverter = new CubePixelConverter(m_pixelType, m_base, m_multiplier);
+
       const PvlGroup &dimensions = core.findGroup("Dimensions");
       m_numSamples = dimensions.findKeyword("Samples");
       m_numLines = dimensions.findKeyword("Lines");
@@ -154,6 +341,14 @@ namespace Isis {
    */
   CubeIoHandler::~CubeIoHandler() {
 
+    delete m_concurrentCache;
+    m_concurrentCache = NULL;
+
+    if (m_mappedData) {
+      m_dataFile->unmap(m_mappedData);
+      m_mappedData = NULL;
+    }
+
     if (m_ioThreadPool)
       m_ioThreadPool->waitForDone();
 
@@ -201,6 +396,9 @@ namespace Isis {
     delete m_byteSwapper;
     m_byteSwapper = NULL;
 
+    delete m_pixelConverter;
+    m_pixelConverter = NULL;
+
     delete m_virtualBands;
     m_virtualBands = NULL;
 
@@ -224,6 +422,11 @@ namespace Isis {
    * @param bufferToFill The buffer to populate with cube data.
    */
   void CubeIoHandler::read(Buffer &bufferToFill) const {
+    if (m_concurrentCache) {
+      concurrentRead(bufferToFill);
+      return;
+    }
+
     // We need to record the current chunk count size so we can use
     // it to evaluate if the cache should be minimized
     int lastChunkCount = m_rawData->size();
@@ -411,12 +614,18 @@ namespace Isis {
       delete m_lastProcessByLineChunks;
       m_lastProcessByLineChunks = NULL;
     }
+
+    if (m_concurrentCache) {
+      m_concurrentCache->clear();
+    }
   }
 
 
   /**
    * @return the number of bytes that the cube DNs will take up. This includes
    *   padding caused by the cube chunks not aligning with the cube dimensions.
+   *   Children with variable sized chunks override this to return the bytes
+   *   they currently use.
    */
   BigInt CubeIoHandler::getDataSize() const {
     return (BigInt)getChunkCountInSampleDimension() *
@@ -456,6 +665,76 @@ namespace Isis {
     return m_writeThreadMutex;
   }
 
+
+  /**
+   * Enable or disable concurrent reads. While enabled, read() does not lock
+   *   anything shared by all readers and may be called from any number of
+   *   threads at once; write() must not be called at all. The caching
+   *   algorithms are not consulted while concurrent reads are enabled, they
+   *   are kept for when they are disabled again. Chunks are kept in a least
+   *   recently used cache that starts out large enough for two rows of chunks
+   *   per thread in the global thread pool (at least 16MB) and grows to fit
+   *   the chunks of the largest buffer read, for every thread.
+   *
+   * If the Performance preference CubeMemoryMap is ReadOnly, the cube data is
+   *   memory mapped. Chunks in native byte order are then used straight from
+   *   the mapping, and the pages are shared with every other process reading
+   *   the same file.
+   *
+   * Only cubes that are already on disk can be read concurrently. Anything
+   *   cached so far is written out and freed.
+   *
+   * @param concurrentReads True to enable concurrent reads
+   */
+  void CubeIoHandler::setConcurrentReads(bool concurrentReads) {
+    if (concurrentReads == (m_concurrentCache != NULL)) {
+      return;
+    }
+
+    if (concurrentReads && m_dataIsOnDiskMap) {
+      IString msg = "Cannot read cube data concurrently before it is on disk";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
+
+    clearCache();
+
+    if (concurrentReads) {
+      BigInt chunkRowBytes = (BigInt)getChunkCountInSampleDimension() *
+                             getBytesPerChunk();
+      BigInt threads = max(QThreadPool::globalInstance()->maxThreadCount(), 1);
+      BigInt maxBytes = max(2 * chunkRowBytes * threads, (BigInt)16 * 1024 * 1024);
+
+      m_concurrentCache = new ConcurrentChunkCache(maxBytes, getBytesPerChunk(), (int)threads);
+
+      PvlGroup &performancePrefs =
+          Preference::Preferences().findGroup("Performance");
+      if (performancePrefs.hasKeyword("CubeMemoryMap")) {
+        IString memoryMapOpt = performancePrefs["CubeMemoryMap"][0];
+        if (memoryMapOpt.DownCase() == "readonly") {
+          // If the mapping fails we quietly fall back to positioned reads
+          m_mappedData = m_dataFile->map(getDataStartByte(), getDataSize());
+        }
+      }
+    }
+    else {
+      delete m_concurrentCache;
+      m_concurrentCache = NULL;
+
+      if (m_mappedData) {
+        m_dataFile->unmap(m_mappedData);
+        m_mappedData = NULL;
+      }
+    }
+  }
+
+
+  /**
+   * @return True if read() may be called from multiple threads at once
+   */
+  bool CubeIoHandler::concurrentReads() const {
+    return m_concurrentCache != NULL;
+  }
+
   /**
    * @return the number of physical bands in the cube.
    */
@@ -658,6 +937,79 @@ namespace Isis {
   }
 
 
+  /**
+   * Create a chunk holding the unswapped raw bytes of the chunk at chunkIndex
+   *   without touching any state shared with other readers. This is used
+   *   instead of readRaw() while concurrent reads are enabled.
+   *
+   * This implementation handles chunks stored uncompressed in chunk index
+   *   order, which is how both BandSequential and Tile cubes are laid out.
+   *   Memory mapped chunks are views of the mapping; otherwise the bytes are
+   *   read with pread(), which neither uses nor moves the shared file offset.
+   *
+   * Ownership of the return value is given to the caller.
+   *
+   * @param chunkIndex The chunk number in the cube file
+   * @return The chunk at chunkIndex
+   */
+  RawCubeChunk *CubeIoHandler::readRawConcurrently(int chunkIndex) const {
+    int startSample;
+    int startLine;
+    int startBand;
+    int endSample;
+    int endLine;
+    int endBand;
+    getChunkPlacement(chunkIndex, startSample, startLine, startBand,
+                      endSample, endLine, endBand);
+
+    BigInt startByte = getDataStartByte() + (BigInt)chunkIndex * getBytesPerChunk();
+
+    if (m_mappedData) {
+      return new RawCubeChunk(startSample, startLine, startBand,
+                              endSample, endLine, endBand,
+                              (const char *)m_mappedData + (startByte - getDataStartByte()),
+                              getBytesPerChunk());
+    }
+
+    RawCubeChunk *chunk = new RawCubeChunk(startSample, startLine, startBand,
+                                           endSample, endLine, endBand,
+                                           getBytesPerChunk());
+
+    int fileDescriptor = m_dataFile->handle();
+    char *data = chunk->getRawData().data();
+    BigInt bytesLeft = chunk->getByteCount();
+    BigInt position = startByte;
+    bool success = (fileDescriptor >= 0);
+
+    while (success && bytesLeft > 0) {
+      ssize_t bytesRead = ::pread(fileDescriptor, data, bytesLeft, position);
+
+      if (bytesRead < 0 && errno == EINTR) {
+        continue;
+      }
+
+      success = (bytesRead > 0);
+      if (success) {
+        data += bytesRead;
+        bytesLeft -= bytesRead;
+        position += bytesRead;
+      }
+    }
+
+    if (!success) {
+      delete chunk;
+
+      IString msg = "Reading from the file [" + m_dataFile->fileName() + "] "
+          "failed with reading [" +
+          QString::number(getBytesPerChunk()) +
+          "] bytes at position [" + QString::number(startByte) + "]";
+      throw IException(IException::Io, msg, _FILEINFO_);
+    }
+
+    return chunk;
+  }
+
+
   /**
    * This blocks (doesn't return) until the number of active runnables in the
    *   thread pool goes to 0. This uses the m_writeThreadMutex, because the
@@ -671,6 +1023,34 @@ namespace Isis {
   }
 
 
+  /**
+   * Read cube data into the buffer while concurrent reads are enabled. This
+   *   only touches the sharded chunk cache, so many threads can be in here at
+   *   once.
+   *
+   * @param bufferToFill The buffer to populate with cube data.
+   */
+  void CubeIoHandler::concurrentRead(Buffer &bufferToFill) const {
+    // We can't guarantee our cube chunks will encompass the buffer
+    //   if the buffer goes beyond the cube bounds.
+    for (int i = 0; i < bufferToFill.size(); i++) {
+      bufferToFill[i] = Null;
+    }
+
+    QPair< QList<int>, QList<int> > chunkInfo = findCubeChunkIndices(
+        bufferToFill.Sample(), bufferToFill.SampleDimension(),
+        bufferToFill.Line(), bufferToFill.LineDimension(),
+        bufferToFill.Band(), bufferToFill.BandDimension());
+
+    m_concurrentCache->reserveChunks(chunkInfo.first.size());
+
+    for (int i = 0; i < chunkInfo.first.size(); i++) {
+      QSharedPointer<RawCubeChunk> chunk = readConcurrentChunk(chunkInfo.first[i]);
+      writeIntoDouble(*chunk, bufferToFill, chunkInfo.second[i], false);
+    }
+  }
+
+
   /**
    * This is used for sorting buffers into the most efficient write order.
    *
@@ -730,7 +1110,34 @@ namespace Isis {
   QPair< QList<RawCubeChunk *>, QList<int> > CubeIoHandler::findCubeChunks(int startSample,
       int numSamples, int startLine, int numLines, int startBand,
       int numBands) const {
+    QPair< QList<int>, QList<int> > chunkIndices = findCubeChunkIndices(
+        startSample, numSamples, startLine, numLines, startBand, numBands);
+
     QList<RawCubeChunk *> results;
+    for (int i = 0; i < chunkIndices.first.size(); i++) {
+      results.append(getChunk(chunkIndices.first[i], true));
+    }
+
+    return QPair< QList<RawCubeChunk *>, QList<int> >(results, chunkIndices.second);
+  }
+
+
+  /**
+   * Get the indices of the cube chunks that correspond to the given cube area.
+   *   This does not read or cache anything.
+   *
+   * @param startSample The starting sample of the cube data
+   * @param numSamples The number of samples of cube data
+   * @param startLine The starting line of the cube data
+   * @param numLines The number of lines of cube data
+   * @param startBand The starting band of the cube data
+   * @param numBands The number of bands of cube data
+   * @return The chunk indices and the (virtual) band each one is used for
+   */
+  QPair< QList<int>, QList<int> > CubeIoHandler::findCubeChunkIndices(int startSample,
+      int numSamples, int startLine, int numLines, int startBand,
+      int numBands) const {
+    QList<int> results;
     QList<int> resultBands;
 /************************************************************************CHANGED THIS!!!!!!!!******/
     int lastBand = startBand + numBands - 1;
@@ -839,9 +1246,7 @@ namespace Isis {
               (chunkZPos * getChunkCountInSampleDimension() *
                           getChunkCountInLineDimension());
 
-          RawCubeChunk * newChunk = getChunk(chunkIndex, true);
-
-          results.append(newChunk);
+          results.append(chunkIndex);
           resultBands.append(band);
 
           chunkRect.moveLeft(chunkRect.right() + 1);
@@ -851,7 +1256,7 @@ namespace Isis {
       }
     }
 
-    return QPair< QList<RawCubeChunk *>, QList<int> >(results, resultBands);
+    return QPair< QList<int>, QList<int> >(results, resultBands);
   }
 
 
@@ -1176,6 +1581,37 @@ namespace Isis {
   }
 
 
+  /**
+   * Get a chunk for a concurrent read, reading it from disk if it isn't
+   *   cached. The disk read happens without holding any lock, so two threads
+   *   may occasionally read the same chunk; only one copy gets cached. The
+   *   returned chunk's data is in native byte order.
+   *
+   * @param chunkIndex The chunk number in the cube file
+   * @return The chunk at chunkIndex
+   */
+  QSharedPointer<RawCubeChunk> CubeIoHandler::readConcurrentChunk(int chunkIndex) const {
+    QSharedPointer<RawCubeChunk> chunk = m_concurrentCache->find(chunkIndex);
+
+    if (!chunk) {
+      chunk = QSharedPointer<RawCubeChunk>(readRawConcurrently(chunkIndex));
+
+      // The byte swapper is not safe to share between threads, so swap the
+      //   whole chunk once here instead of every pixel on every read. A memory
+      //   mapped chunk gets copied out of the mapping by this.
+      if (m_byteSwapper) {
+        char *data = chunk->getRawData().data();
+        m_pixelConverter->swapBytes(data, data, chunk->getByteCount() / SizeOf(m_pixelType));
+      }
+
+      chunk->setDirty(false);
+      chunk = m_concurrentCache->insert(chunkIndex, chunk);
+    }
+
+    return chunk;
+  }
+
+
   /**
    * Apply the caching algorithms and get rid of excess cube data in memory.
    *   This is intended to be called after every IO operation.
@@ -1348,15 +1784,14 @@ namespace Isis {
    * @param chunk The data source
    * @param output The data destination
    * @param index int
+   * @param swapBytes False if the chunk is already in native byte order
    */
   void CubeIoHandler::writeIntoDouble(const RawCubeChunk &chunk,
-                                      Buffer &output, int index) const {
-    // The code in this method is highly optimized. Even the order of the if
-    //   statements will have a significant impact on performance if changed.
-    //   Also, there is a lot of duplicate code in both writeIntoDouble(...) and
-    //   writeIntoRaw(...). This is needed for performance gain. Any function
-    //   or method calls from within the x loop cause significant performance
-    //   decreases.
+                                      Buffer &output, int index,
+                                      bool swapBytes) const {
+    // Each line of the intersection is contiguous in both the chunk and the
+    //   buffer, so the pixels are copied into the buffer's raw data, swapped
+    //   there if needed and converted a whole line at a time.
     int startX = 0;
     int startY = 0;
     int startZ = 0;
@@ -1366,6 +1801,9 @@ namespace Isis {
     int endZ = 0;
 
     findIntersection(chunk, output, startX, startY, startZ, endX, endY, endZ);
+    if(endX < startX) {
+      return;
+    }
 
     int bufferBand = output.Band();
     int bufferBands = output.BandDimension();
@@ -1374,16 +1812,16 @@ namespace Isis {
     int chunkStartBand = chunk.getStartBand();
     int chunkLineSize = chunk.sampleCount();
     int chunkBandSize = chunkLineSize * chunk.lineCount();
-    //double *buffersDoubleBuf = output.p_buf;
+    int pixelSize = SizeOf(m_pixelType);
+    int lineLength = endX - startX + 1;
     double *buffersDoubleBuf = output.DoubleBuffer();
-    const char *chunkBuf = chunk.getRawData().data();
+    const char *chunkBuf = chunk.getRawData().constData();
     char *buffersRawBuf = (char *)output.RawBuffer();
+    bool byteSwap = swapBytes && m_byteSwapper;
 
     for(int z = startZ; z <= endZ; z++) {
       const int &bandIntoChunk = z - chunkStartBand;
-      int virtualBand = z;
-
-      virtualBand = index;
+      int virtualBand = index;
 
       if(virtualBand != 0 && virtualBand >= bufferBand &&
          virtualBand <= bufferBand + bufferBands - 1) {
@@ -1391,151 +1829,22 @@ namespace Isis {
         for(int y = startY; y <= endY; y++) {
           const int &lineIntoChunk = y - chunkStartLine;
           int bufferIndex = output.Index(startX, y, virtualBand);
+          int chunkIndex = (startX - chunkStartSample) +
+              (chunkLineSize * lineIntoChunk) +
+              (chunkBandSize * bandIntoChunk);
+
+          const char *chunkLine = chunkBuf + (BigInt)chunkIndex * pixelSize;
+          char *bufferRawLine = buffersRawBuf + (BigInt)bufferIndex * pixelSize;
 
-          for(int x = startX; x <= endX; x++) {
-            const int &sampleIntoChunk = x - chunkStartSample;
-
-            const int &chunkIndex = sampleIntoChunk +
-                (chunkLineSize * lineIntoChunk) +
-                (chunkBandSize * bandIntoChunk);
-
-            double &bufferVal = buffersDoubleBuf[bufferIndex];
-
-            if(m_pixelType == Real) {
-              float raw = ((float *)chunkBuf)[chunkIndex];
-              if(m_byteSwapper)
-                raw = m_byteSwapper->Float(&raw);
-
-              if(raw >= VALID_MIN4) {
-                bufferVal = (double) raw;
-              }
-              else {
-                if(raw == NULL4)
-                  bufferVal = NULL8;
-                else if(raw == LOW_INSTR_SAT4)
-                  bufferVal = LOW_INSTR_SAT8;
-                else if(raw == LOW_REPR_SAT4)
-                  bufferVal = LOW_REPR_SAT8;
-                else if(raw == HIGH_INSTR_SAT4)
-                  bufferVal = HIGH_INSTR_SAT8;
-                else if(raw == HIGH_REPR_SAT4)
-                  bufferVal = HIGH_REPR_SAT8;
-                else
-                  bufferVal = LOW_REPR_SAT8;
-              }
-
-              ((float *)buffersRawBuf)[bufferIndex] = raw;
-            }
-
-            else if(m_pixelType == SignedWord) {
-              short raw = ((short *)chunkBuf)[chunkIndex];
-              if(m_byteSwapper)
-                raw = m_byteSwapper->ShortInt(&raw);
-
-              if(raw >= VALID_MIN2) {
-                bufferVal = (double) raw * m_multiplier + m_base;
-              }
-              else {
-                if(raw == NULL2)
-                  bufferVal = NULL8;
-                else if(raw == LOW_INSTR_SAT2)
-                  bufferVal = LOW_INSTR_SAT8;
-                else if(raw == LOW_REPR_SAT2)
-                  bufferVal = LOW_REPR_SAT8;
-                else if(raw == HIGH_INSTR_SAT2)
-                  bufferVal = HIGH_INSTR_SAT8;
-                else if(raw == HIGH_REPR_SAT2)
-                  bufferVal = HIGH_REPR_SAT8;
-                else
-                  bufferVal = LOW_REPR_SAT8;
-              }
-
-              ((short *)buffersRawBuf)[bufferIndex] = raw;
-            }
-
-
-            else if(m_pixelType == UnsignedWord) {
-              unsigned short raw = ((unsigned short *)chunkBuf)[chunkIndex];
-              if(m_byteSwapper)
-                raw = m_byteSwapper->UnsignedShortInt(&raw);
-
-              if(raw >= VALID_MINU2) {
-                bufferVal = (double) raw * m_multiplier + m_base;
-              }
-              else if (raw > VALID_MAXU2) {
-                if(raw == HIGH_INSTR_SATU2)
-                  bufferVal = HIGH_INSTR_SAT8;
-                else if(raw == HIGH_REPR_SATU2)
-                  bufferVal = HIGH_REPR_SAT8;
-                else
-                  bufferVal = LOW_REPR_SAT8;
-              }
-              else {
-                if(raw == NULLU2)
-                  bufferVal = NULL8;
-                else if(raw == LOW_INSTR_SATU2)
-                  bufferVal = LOW_INSTR_SAT8;
-                else if(raw == LOW_REPR_SATU2)
-                  bufferVal = LOW_REPR_SAT8;
-                else
-                  bufferVal = LOW_REPR_SAT8;
-              }
-
-              ((unsigned short *)buffersRawBuf)[bufferIndex] = raw;
-            }
-
-            else if(m_pixelType == UnsignedInteger) {
-
-              unsigned int raw = ((unsigned int *)chunkBuf)[chunkIndex];
-              if(m_byteSwapper)
-                raw = m_byteSwapper->Uint32_t(&raw);
-
-              if(raw >= VALID_MINUI4) {
-                bufferVal = (double) raw * m_multiplier + m_base;
-              }
-              else if (raw > VALID_MAXUI4) {
-                if(raw == HIGH_INSTR_SATUI4)
-                  bufferVal = HIGH_INSTR_SAT8;
-                else if(raw == HIGH_REPR_SATUI4)
-                  bufferVal = HIGH_REPR_SAT8;
-                else
-                  bufferVal = LOW_REPR_SAT8;
-              }
-              else {
-                if(raw == NULLUI4)
-                  bufferVal = NULL8;
-                else if(raw == LOW_INSTR_SATUI4)
-                  bufferVal = LOW_INSTR_SAT8;
-                else if(raw == LOW_REPR_SATUI4)
-                  bufferVal = LOW_REPR_SAT8;
-                else
-                  bufferVal = LOW_REPR_SAT8;
-              }
-
-              ((unsigned int *)buffersRawBuf)[bufferIndex] = raw;
-
-
-
-            }
-
-            else if(m_pixelType == UnsignedByte) {
-              unsigned char raw = ((unsigned char *)chunkBuf)[chunkIndex];
-
-              if(raw == NULL1) {
-                bufferVal = NULL8;
-              }
-              else if(raw == HIGH_REPR_SAT1) {
-                bufferVal = HIGH_REPR_SAT8;
-              }
-              else {
-                bufferVal = (double) raw * m_multiplier + m_base;
-              }
-
-              ((unsigned char *)buffersRawBuf)[bufferIndex] = raw;
-            }
-
-            bufferIndex ++;
+          if(byteSwap) {
+            m_pixelConverter->swapBytes(chunkLine, bufferRawLine, lineLength);
           }
+          else {
+            memcpy(bufferRawLine, chunkLine, (size_t)lineLength * pixelSize);
+          }
+
+          m_pixelConverter->toDouble(bufferRawLine, buffersDoubleBuf + bufferIndex,
+                                     lineLength);
         }
       }
     }
@@ -1551,12 +1860,8 @@ namespace Isis {
    */
   void CubeIoHandler::writeIntoRaw(const Buffer &buffer, RawCubeChunk &output, int index)
       const {
-    // The code in this method is highly optimized. Even the order of the if
-    //   statements will have a significant impact on performance if changed.
-    //   Also, there is a lot of duplicate code in both writeIntoDouble(...) and
-    //   writeIntoRaw(...). This is needed for performance gain. Any function
-    //   or method calls from within the x loop cause significant performance
-    //   decreases.
+    // Each line of the intersection is contiguous in both the buffer and the
+    //   chunk, so a whole line is converted and then swapped in place.
     int startX = 0;
     int startY = 0;
     int startZ = 0;
@@ -1567,6 +1872,9 @@ namespace Isis {
 
     output.setDirty(true);
     findIntersection(output, buffer, startX, startY, startZ, endX, endY, endZ);
+    if(endX < startX) {
+      return;
+    }
 
     int bufferBand = buffer.Band();
     int bufferBands = buffer.BandDimension();
@@ -1575,6 +1883,8 @@ namespace Isis {
     int outputStartBand = output.getStartBand();
     int lineSize = output.sampleCount();
     int bandSize = lineSize * output.lineCount();
+    int pixelSize = SizeOf(m_pixelType);
+    int lineLength = endX - startX + 1;
     double *buffersDoubleBuf = buffer.DoubleBuffer();
     char *chunkBuf = output.getRawData().data();
 
@@ -1593,231 +1903,14 @@ namespace Isis {
         for(int y = startY; y <= endY; y++) {
           const int &lineIntoChunk = y - outputStartLine;
           int bufferIndex = buffer.Index(startX, y, virtualBand);
+          int chunkIndex = (startX - outputStartSample) +
+              (lineSize * lineIntoChunk) + (bandSize * bandIntoChunk);
+
+          char *chunkLine = chunkBuf + (BigInt)chunkIndex * pixelSize;
+          m_pixelConverter->toRaw(buffersDoubleBuf + bufferIndex, chunkLine, lineLength);
 
-          for(int x = startX; x <= endX; x++) {
-            const int &sampleIntoChunk = x - outputStartSample;
-
-            const int &chunkIndex = sampleIntoChunk +
-                (lineSize * lineIntoChunk) + (bandSize * bandIntoChunk);
-
-            double bufferVal = buffersDoubleBuf[bufferIndex];
-
-            if(m_pixelType == Real) {
-              float raw = 0;
-
-              if(bufferVal >= VALID_MIN8) {
-                double filePixelValueDbl = (bufferVal - m_base) /
-                    m_multiplier;
-
-                if(filePixelValueDbl < (double) VALID_MIN4) {
-                  raw = LOW_REPR_SAT4;
-                }
-                else if(filePixelValueDbl > (double) VALID_MAX4) {
-                  raw = HIGH_REPR_SAT4;
-                }
-                else {
-                  raw = (float) filePixelValueDbl;
-                }
-              }
-              else {
-                if(bufferVal == NULL8)
-                  raw = NULL4;
-                else if(bufferVal == LOW_INSTR_SAT8)
-                  raw = LOW_INSTR_SAT4;
-                else if(bufferVal == LOW_REPR_SAT8)
-                  raw = LOW_REPR_SAT4;
-                else if(bufferVal == HIGH_INSTR_SAT8)
-                  raw = HIGH_INSTR_SAT4;
-                else if(bufferVal == HIGH_REPR_SAT8)
-                  raw = HIGH_REPR_SAT4;
-                else
-                  raw = LOW_REPR_SAT4;
-              }
-              ((float *)chunkBuf)[chunkIndex] =
-                  m_byteSwapper ? m_byteSwapper->Float(&raw) : raw;
-            }
-
-            else if(m_pixelType == SignedWord) {
-              short raw;
-
-              if(bufferVal >= VALID_MIN8) {
-                double filePixelValueDbl = (bufferVal - m_base) /
-                    m_multiplier;
-                if(filePixelValueDbl < VALID_MIN2 - 0.5) {
-                  raw = LOW_REPR_SAT2;
-                }
-                if(filePixelValueDbl > VALID_MAX2 + 0.5) {
-                  raw = HIGH_REPR_SAT2;
-                }
-                else {
-                  int filePixelValue = (int)round(filePixelValueDbl);
-
-                  if(filePixelValue < VALID_MIN2) {
-                    raw = LOW_REPR_SAT2;
-                  }
-                  else if(filePixelValue > VALID_MAX2) {
-                    raw = HIGH_REPR_SAT2;
-                  }
-                  else {
-                    raw = filePixelValue;
-                  }
-                }
-              }
-              else {
-                if(bufferVal == NULL8)
-                  raw = NULL2;
-                else if(bufferVal == LOW_INSTR_SAT8)
-                  raw = LOW_INSTR_SAT2;
-                else if(bufferVal == LOW_REPR_SAT8)
-                  raw = LOW_REPR_SAT2;
-                else if(bufferVal == HIGH_INSTR_SAT8)
-                  raw = HIGH_INSTR_SAT2;
-                else if(bufferVal == HIGH_REPR_SAT8)
-                  raw = HIGH_REPR_SAT2;
-                else
-                  raw = LOW_REPR_SAT2;
-              }
-
-              ((short *)chunkBuf)[chunkIndex] =
-                  m_byteSwapper ? m_byteSwapper->ShortInt(&raw) : raw;
-            }
-
-            else if(m_pixelType == UnsignedInteger) {
-
-              unsigned int raw;
-
-              if(bufferVal >= VALID_MINUI4) {
-                double filePixelValueDbl = (bufferVal - m_base) /
-                    m_multiplier;
-                if(filePixelValueDbl < VALID_MINUI4 - 0.5) {
-                  raw = LOW_REPR_SATUI4;
-                }
-                if(filePixelValueDbl > VALID_MAXUI4) {
-                  raw = HIGH_REPR_SATUI4;
-                }
-                else {
-                  unsigned int filePixelValue = (unsigned int)round(filePixelValueDbl);
-
-                  if(filePixelValue < VALID_MINUI4) {
-                    raw = LOW_REPR_SATUI4;
-                  }
-                  else if(filePixelValue > VALID_MAXUI4) {
-                    raw = HIGH_REPR_SATUI4;
-                  }
-                  else {
-                    raw = filePixelValue;
-                  }
-                }
-              }
-              else {
-                if(bufferVal == NULL8)
-                  raw = NULLUI4;
-                else if(bufferVal == LOW_INSTR_SAT8)
-                  raw = LOW_INSTR_SATUI4;
-                else if(bufferVal == LOW_REPR_SAT8)
-                  raw = LOW_REPR_SATUI4;
-                else if(bufferVal == HIGH_INSTR_SAT8)
-                  raw = HIGH_INSTR_SATUI4;
-                else if(bufferVal == HIGH_REPR_SAT8)
-                  raw = HIGH_REPR_SATUI4;
-                else
-                  raw = LOW_REPR_SATUI4;
-              }
-
-              ((unsigned int *)chunkBuf)[chunkIndex] =
-                  m_byteSwapper ? m_byteSwapper->Uint32_t(&raw) : raw;
-
-            }
-
-
-            else if(m_pixelType == UnsignedWord) {
-              unsigned short raw;
-
-              if(bufferVal >= VALID_MIN8) {
-                double filePixelValueDbl = (bufferVal - m_base) /
-                    m_multiplier;
-                if(filePixelValueDbl < VALID_MINU2 - 0.5) {
-                  raw = LOW_REPR_SATU2;
-                }
-                if(filePixelValueDbl > VALID_MAXU2 + 0.5) {
-                  raw = HIGH_REPR_SATU2;
-                }
-                else {
-                  int filePixelValue = (int)round(filePixelValueDbl);
-
-                  if(filePixelValue < VALID_MINU2) {
-                    raw = LOW_REPR_SATU2;
-                  }
-                  else if(filePixelValue > VALID_MAXU2) {
-                    raw = HIGH_REPR_SATU2;
-                  }
-                  else {
-                    raw = filePixelValue;
-                  }
-                }
-              }
-              else {
-                if(bufferVal == NULL8)
-                  raw = NULLU2;
-                else if(bufferVal == LOW_INSTR_SAT8)
-                  raw = LOW_INSTR_SATU2;
-                else if(bufferVal == LOW_REPR_SAT8)
-                  raw = LOW_REPR_SATU2;
-                else if(bufferVal == HIGH_INSTR_SAT8)
-                  raw = HIGH_INSTR_SATU2;
-                else if(bufferVal == HIGH_REPR_SAT8)
-                  raw = HIGH_REPR_SATU2;
-                else
-                  raw = LOW_REPR_SATU2;
-              }
-
-              ((unsigned short *)chunkBuf)[chunkIndex] =
-                  m_byteSwapper ? m_byteSwapper->UnsignedShortInt(&raw) : raw;
-            }
-            else if(m_pixelType == UnsignedByte) {
-              unsigned char raw;
-
-              if(bufferVal >= VALID_MIN8) {
-                double filePixelValueDbl = (bufferVal - m_base) /
-                    m_multiplier;
-                if(filePixelValueDbl < VALID_MIN1 - 0.5) {
-                  raw = LOW_REPR_SAT1;
-                }
-                else if(filePixelValueDbl > VALID_MAX1 + 0.5) {
-                  raw = HIGH_REPR_SAT1;
-                }
-                else {
-                  int filePixelValue = (int)(filePixelValueDbl + 0.5);
-                  if(filePixelValue < VALID_MIN1) {
-                    raw = LOW_REPR_SAT1;
-                  }
-                  else if(filePixelValue > VALID_MAX1) {
-                    raw = HIGH_REPR_SAT1;
-                  }
-                  else {
-                    raw = (unsigned char)(filePixelValue);
-                  }
-                }
-              }
-              else {
-                if(bufferVal == NULL8)
-                  raw = NULL1;
-                else if(bufferVal == LOW_INSTR_SAT8)
-                  raw = LOW_INSTR_SAT1;
-                else if(bufferVal == LOW_REPR_SAT8)
-                  raw = LOW_REPR_SAT1;
-                else if(bufferVal == HIGH_INSTR_SAT8)
-                  raw = HIGH_INSTR_SAT1;
-                else if(bufferVal == HIGH_REPR_SAT8)
-                  raw = HIGH_REPR_SAT1;
-                else
-                  raw = LOW_REPR_SAT1;
-              }
-
-              ((unsigned char *)chunkBuf)[chunkIndex] = raw;
-            }
-
-            bufferIndex ++;
+          if(m_byteSwapper) {
+            m_pixelConverter->swapBytes(chunkLine, chunkLine, lineLength);
           }
         }
       }
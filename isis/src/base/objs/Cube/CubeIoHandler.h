@@ -21,10 +21,12 @@ class QElapsedTimer;
 template <typename A> class QList;
 template <typename A, typename B> class QMap;
 template <typename A, typename B> struct QPair;
+template <typename A> class QSharedPointer;
 
 namespace Isis {
   class Buffer;
   class CubeCachingAlgorithm;
+  class CubePixelConverter;
   class EndianSwapper;
   class Pvl;
   class RawCubeChunk;
@@ -43,6 +45,18 @@ namespace Isis {
    *   guarantees that unwritten cube data ends up read and written as NULLs.
    *   The default caching algorithm is a RegionalCachingAlgorithm.
    *
+   * Read-only handlers can be switched into concurrent read mode with
+   *   setConcurrentReads(). In that mode read() may be called from any number of
+   *   threads at once: chunks are read with positioned reads that do not share a
+   *   file offset and are kept in a sharded least recently used cache, sized to
+   *   the buffers being read, instead of the caching algorithms. If the Performance preference CubeMemoryMap is
+   *   ReadOnly the cube data is memory mapped instead and chunks in native
+   *   byte order are used in place.
+   *
+   * Children that do not store chunks at a fixed size in chunk index order
+   *   (such as the compressed tile format) need to override getDataSize() and
+   *   readRawConcurrently() as well.
+   *
    * @author 2011-??-?? Jai Rideout and Steven Lambright
    *
    * @internal
@@ -105,6 +119,14 @@ namespace Isis {
    *                            References #971.
    *   @history 2018-08-13 Summer Stapleton - Fixed incoming buffer comparison values for 
    *                            unsigned int type in writeIntoRaw(...). 
+   *   @history 2026-10-16 ISIS Development Team - writeIntoDouble(...) and writeIntoRaw(...)
+   *                            convert and byte swap a line of pixels at a time with
+   *                            CubePixelConverter, which uses AVX2 when the processor has it.
+   *                            Unsigned integer pixels that scale below zero are written as Lrs
+   *                            instead of wrapping around.
+   *   @history 2026-10-17 ISIS Development Team - The concurrent read cache finds and evicts
+   *                            chunks in constant time, spreads strided chunk indices over its
+   *                            shards and grows to fit the chunks of the largest buffer read.
    */
   class CubeIoHandler {
     public:
@@ -117,7 +139,7 @@ namespace Isis {
 
       void addCachingAlgorithm(CubeCachingAlgorithm *algorithm);
       void clearCache(bool blockForWriteCache = true) const;
-      BigInt getDataSize() const;
+      virtual BigInt getDataSize() const;
       void setVirtualBands(const QList<int> *virtualBandList);
       /**
        * Function to update the labels with a Pvl object
@@ -128,6 +150,9 @@ namespace Isis {
 
       QMutex *dataFileMutex();
 
+      void setConcurrentReads(bool concurrentReads);
+      bool concurrentReads() const;
+
     protected:
       int bandCount() const;
       int getBandCountInChunk() const;
@@ -136,6 +161,10 @@ namespace Isis {
       int getChunkCountInLineDimension() const;
       int getChunkCountInSampleDimension() const;
       int getChunkIndex(const RawCubeChunk &)  const;
+      int getChunkCount() const;
+      void getChunkPlacement(int chunkIndex,
+        int &startSample, int &startLine, int &startBand,
+        int &endSample, int &endLine, int &endBand) const;
       BigInt getDataStartByte() const;
       QFile * getDataFile();
       int lineCount() const;
@@ -143,6 +172,7 @@ namespace Isis {
       PixelType pixelType() const;
       int sampleCount() const;
       int getSampleCountInChunk() const;
+      RawCubeChunk *getNullChunk(int chunkIndex) const;
 
       void setChunkSizes(int numSamples, int numLines, int numBands);
 
@@ -165,7 +195,11 @@ namespace Isis {
        */
       virtual void writeRaw(const RawCubeChunk &chunkToWrite) = 0;
 
+      virtual RawCubeChunk *readRawConcurrently(int chunkIndex) const;
+
     private:
+      class ConcurrentChunkCache;
+
       /**
        * This class is designed to handle write() asynchronously.
        *
@@ -231,12 +265,18 @@ namespace Isis {
 
       void blockUntilThreadPoolEmpty() const;
 
+      void concurrentRead(Buffer &bufferToFill) const;
+
       static bool bufferLessThan(Buffer * const &lhs, Buffer * const &rhs);
 
       QPair< QList<RawCubeChunk *>, QList<int> > findCubeChunks(int startSample, int numSamples,
                                                                 int startLine, int numLines,
                                                                 int startBand, int numBands) const;
 
+      QPair< QList<int>, QList<int> > findCubeChunkIndices(int startSample, int numSamples,
+                                                           int startLine, int numLines,
+                                                           int startBand, int numBands) const;
+
       void findIntersection(const RawCubeChunk &cube1,
           const Buffer &cube2, int &startX, int &startY, int &startZ,
           int &endX, int &endY, int &endZ) const;
@@ -247,20 +287,15 @@ namespace Isis {
 
       RawCubeChunk *getChunk(int chunkIndex, bool allocateIfNecessary) const;
 
-      int getChunkCount() const;
-
-      void getChunkPlacement(int chunkIndex,
-        int &startSample, int &startLine, int &startBand,
-        int &endSample, int &endLine, int &endBand) const;
-
-      RawCubeChunk *getNullChunk(int chunkIndex) const;
+      QSharedPointer<RawCubeChunk> readConcurrentChunk(int chunkIndex) const;
 
       void minimizeCache(const QList<RawCubeChunk *> &justUsed,
                          const Buffer &justRequested) const;
 
       void synchronousWrite(const Buffer &bufferToWrite);
 
-      void writeIntoDouble(const RawCubeChunk &chunk, Buffer &output, int startIndex) const;
+      void writeIntoDouble(const RawCubeChunk &chunk, Buffer &output, int startIndex,
+                           bool swapBytes = true) const;
 
       void writeIntoRaw(const Buffer &buffer, RawCubeChunk &output, int index) const;
 
@@ -292,6 +327,9 @@ namespace Isis {
       //! A helper that swaps byte order to and from file order.
       EndianSwapper * m_byteSwapper;
 
+      //! Converts lines of pixels between the raw and double buffers.
+      CubePixelConverter * m_pixelConverter;
+
       //! The number of samples in the cube.
       int m_numSamples;
 
@@ -360,6 +398,18 @@ namespace Isis {
 
       //! How many times the write cache has overflown in a row
       mutable int m_consecutiveOverflowCount;
+
+      /**
+       * The chunk cache used by concurrent reads. This is NULL unless
+       *   setConcurrentReads() enabled them.
+       */
+      ConcurrentChunkCache *m_concurrentCache;
+
+      /**
+       * The cube data mapped into memory for concurrent reads, starting at
+       *   m_startByte. This is NULL if the data is not memory mapped.
+       */
+      uchar *m_mappedData;
   };
 }
 
@@ -0,0 +1,590 @@
+/** This is free and unencumbered software released into the public domain.
+The authors of ISIS do not claim copyright on the contents of this file.
+For more details about the LICENSE terms and the AUTHORS, you will
+find files of those names at the top level of this repository. **/
+
+/* SPDX-License-Identifier: CC0-1.0 */
+#include "CubePixelConverter.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+#include "SpecialPixel.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define ISIS_CUBE_PIXEL_AVX2
+#include <immintrin.h>
+#endif
+
+namespace Isis {
+
+  // The conversion of a single pixel. These are the reference for the vector
+  //   kernels, which fall back to them for anything that is not a valid pixel.
+
+  static inline double realToDouble(float raw) {
+    if (raw >= VALID_MIN4) return (double) raw;
+    if (raw == NULL4) return NULL8;
+    if (raw == LOW_INSTR_SAT4) return LOW_INSTR_SAT8;
+    if (raw == LOW_REPR_SAT4) return LOW_REPR_SAT8;
+    if (raw == HIGH_INSTR_SAT4) return HIGH_INSTR_SAT8;
+    if (raw == HIGH_REPR_SAT4) return HIGH_REPR_SAT8;
+    return LOW_REPR_SAT8;
+  }
+
+
+  static inline double signedWordToDouble(short raw, double multiplier, double base) {
+    if (raw >= VALID_MIN2) return (double) raw * multiplier + base;
+    if (raw == NULL2) return NULL8;
+    if (raw == LOW_INSTR_SAT2) return LOW_INSTR_SAT8;
+    if (raw == LOW_REPR_SAT2) return LOW_REPR_SAT8;
+    if (raw == HIGH_INSTR_SAT2) return HIGH_INSTR_SAT8;
+    if (raw == HIGH_REPR_SAT2) return HIGH_REPR_SAT8;
+    return LOW_REPR_SAT8;
+  }
+
+
+  static inline double unsignedWordToDouble(unsigned short raw, double multiplier, double base) {
+    if (raw >= VALID_MINU2) return (double) raw * multiplier + base;
+    if (raw == NULLU2) return NULL8;
+    if (raw == LOW_INSTR_SATU2) return LOW_INSTR_SAT8;
+    return LOW_REPR_SAT8;
+  }
+
+
+  static inline double unsignedIntegerToDouble(unsigned int raw, double multiplier, double base) {
+    if (raw >= VALID_MINUI4) return (double) raw * multiplier + base;
+    if (raw == NULLUI4) return NULL8;
+    if (raw == LOW_INSTR_SATUI4) return LOW_INSTR_SAT8;
+    return LOW_REPR_SAT8;
+  }
+
+
+  static inline double unsignedByteToDouble(unsigned char raw, double multiplier, double base) {
+    if (raw == NULL1) return NULL8;
+    if (raw == HIGH_REPR_SAT1) return HIGH_REPR_SAT8;
+    return (double) raw * multiplier + base;
+  }
+
+
+  static inline float doubleToReal(double value, double multiplier, double base) {
+    if (value >= VALID_MIN8) {
+      double raw = (value - base) / multiplier;
+      if (raw < (double) VALID_MIN4) return LOW_REPR_SAT4;
+      if (raw > (double) VALID_MAX4) return HIGH_REPR_SAT4;
+      return (float) raw;
+    }
+    if (value == NULL8) return NULL4;
+    if (value == LOW_INSTR_SAT8) return LOW_INSTR_SAT4;
+    if (value == LOW_REPR_SAT8) return LOW_REPR_SAT4;
+    if (value == HIGH_INSTR_SAT8) return HIGH_INSTR_SAT4;
+    if (value == HIGH_REPR_SAT8) return HIGH_REPR_SAT4;
+    return LOW_REPR_SAT4;
+  }
+
+
+  static inline short doubleToSignedWord(double value, double multiplier, double base) {
+    if (value >= VALID_MIN8) {
+      double raw = (value - base) / multiplier;
+      if (raw < VALID_MIN2 - 0.5) return LOW_REPR_SAT2;
+      if (raw > VALID_MAX2 + 0.5) return HIGH_REPR_SAT2;
+
+      int rounded = (int) round(raw);
+      if (rounded < VALID_MIN2) return LOW_REPR_SAT2;
+      if (rounded > VALID_MAX2) return HIGH_REPR_SAT2;
+      return rounded;
+    }
+    if (value == NULL8) return NULL2;
+    if (value == LOW_INSTR_SAT8) return LOW_INSTR_SAT2;
+    if (value == LOW_REPR_SAT8) return LOW_REPR_SAT2;
+    if (value == HIGH_INSTR_SAT8) return HIGH_INSTR_SAT2;
+    if (value == HIGH_REPR_SAT8) return HIGH_REPR_SAT2;
+    return LOW_REPR_SAT2;
+  }
+
+
+  static inline unsigned short doubleToUnsignedWord(double value, double multiplier,
+                                                    double base) {
+    if (value >= VALID_MIN8) {
+      double raw = (value - base) / multiplier;
+      if (raw < VALID_MINU2 - 0.5) return LOW_REPR_SATU2;
+      if (raw > VALID_MAXU2 + 0.5) return HIGH_REPR_SATU2;
+
+      int rounded = (int) round(raw);
+      if (rounded < VALID_MINU2) return LOW_REPR_SATU2;
+      if (rounded > VALID_MAXU2) return HIGH_REPR_SATU2;
+      return rounded;
+    }
+    if (value == NULL8) return NULLU2;
+    if (value == LOW_INSTR_SAT8) return LOW_INSTR_SATU2;
+    if (value == LOW_REPR_SAT8) return LOW_REPR_SATU2;
+    if (value == HIGH_INSTR_SAT8) return HIGH_INSTR_SATU2;
+    if (value == HIGH_REPR_SAT8) return HIGH_REPR_SATU2;
+    return LOW_REPR_SATU2;
+  }
+
+
+  static inline unsigned int doubleToUnsignedInteger(double value, double multiplier,
+                                                     double base) {
+    if (value >= VALID_MINUI4) {
+      double raw = (value - base) / multiplier;
+      if (raw < VALID_MINUI4 - 0.5) return LOW_REPR_SATUI4;
+      if (raw > VALID_MAXUI4) return HIGH_REPR_SATUI4;
+
+      unsigned int rounded = (unsigned int) round(raw);
+      if (rounded < VALID_MINUI4) return LOW_REPR_SATUI4;
+      if (rounded > VALID_MAXUI4) return HIGH_REPR_SATUI4;
+      return rounded;
+    }
+    if (value == NULL8) return NULLUI4;
+    if (value == LOW_INSTR_SAT8) return LOW_INSTR_SATUI4;
+    if (value == LOW_REPR_SAT8) return LOW_REPR_SATUI4;
+    if (value == HIGH_INSTR_SAT8) return HIGH_INSTR_SATUI4;
+    if (value == HIGH_REPR_SAT8) return HIGH_REPR_SATUI4;
+    return LOW_REPR_SATUI4;
+  }
+
+
+  static inline unsigned char doubleToUnsignedByte(double value, double multiplier,
+                                                   double base) {
+    if (value >= VALID_MIN8) {
+      double raw = (value - base) / multiplier;
+      if (raw < VALID_MIN1 - 0.5) return LOW_REPR_SAT1;
+      if (raw > VALID_MAX1 + 0.5) return HIGH_REPR_SAT1;
+
+      int rounded = (int)(raw + 0.5);
+      if (rounded < VALID_MIN1) return LOW_REPR_SAT1;
+      if (rounded > VALID_MAX1) return HIGH_REPR_SAT1;
+      return (unsigned char) rounded;
+    }
+    if (value == NULL8) return NULL1;
+    if (value == LOW_INSTR_SAT8) return LOW_INSTR_SAT1;
+    if (value == LOW_REPR_SAT8) return LOW_REPR_SAT1;
+    if (value == HIGH_INSTR_SAT8) return HIGH_INSTR_SAT1;
+    if (value == HIGH_REPR_SAT8) return HIGH_REPR_SAT1;
+    return LOW_REPR_SAT1;
+  }
+
+
+  static void swapBytesScalar(const char *input, char *output, int count, int pixelSize) {
+    if (pixelSize == 2) {
+      for (int i = 0; i < count; i++) {
+        unsigned short pixel;
+        memcpy(&pixel, input + 2 * i, 2);
+        pixel = (unsigned short)((pixel >> 8) | (pixel << 8));
+        memcpy(output + 2 * i, &pixel, 2);
+      }
+    }
+    else if (pixelSize == 4) {
+      for (int i = 0; i < count; i++) {
+        unsigned int pixel;
+        memcpy(&pixel, input + 4 * i, 4);
+        pixel = (pixel >> 24) | ((pixel >> 8) & 0xFF00) | ((pixel << 8) & 0xFF0000) |
+                (pixel << 24);
+        memcpy(output + 4 * i, &pixel, 4);
+      }
+    }
+    else if (pixelSize == 1) {
+      if (input != output) {
+        memmove(output, input, count);
+      }
+    }
+    else {
+      char pixel[16];
+      for (int i = 0; i < count; i++) {
+        memcpy(pixel, input + i * pixelSize, pixelSize);
+        std::reverse_copy(pixel, pixel + pixelSize, output + i * pixelSize);
+      }
+    }
+  }
+
+
+#ifdef ISIS_CUBE_PIXEL_AVX2
+  // The AVX2 kernels. Each converts four pixels at a time, and any group of
+  //   four with a special pixel in it is converted one pixel at a time. The
+  //   multiply and add are kept separate so the results match the plain loops.
+
+  __attribute__((target("avx2")))
+  static inline __m256d scaleAvx2(__m256d raw, __m256d multiplier, __m256d base) {
+    return _mm256_add_pd(_mm256_mul_pd(raw, multiplier), base);
+  }
+
+
+  __attribute__((target("avx2")))
+  static void realToDoubleAvx2(const float *raw, double *doubles, int count) {
+    const __m128 lowestValid = _mm_set1_ps(VALID_MIN4);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+      __m128 pixels = _mm_loadu_ps(raw + i);
+      if (_mm_movemask_ps(_mm_cmp_ps(pixels, lowestValid, _CMP_GE_OQ)) == 0xF) {
+        _mm256_storeu_pd(doubles + i, _mm256_cvtps_pd(pixels));
+      }
+      else {
+        for (int j = i; j < i + 4; j++) {
+          doubles[j] = realToDouble(raw[j]);
+        }
+      }
+    }
+
+    for (; i < count; i++) {
+      doubles[i] = realToDouble(raw[i]);
+    }
+  }
+
+
+  __attribute__((target("avx2")))
+  static void signedWordToDoubleAvx2(const short *raw, double *doubles, int count,
+                                     double multiplier, double base) {
+    const __m128i belowValid = _mm_set1_epi32(VALID_MIN2 - 1);
+    const __m256d multipliers = _mm256_set1_pd(multiplier);
+    const __m256d bases = _mm256_set1_pd(base);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+      __m128i pixels = _mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i *)(raw + i)));
+      if (_mm_movemask_epi8(_mm_cmpgt_epi32(pixels, belowValid)) == 0xFFFF) {
+        _mm256_storeu_pd(doubles + i,
+                         scaleAvx2(_mm256_cvtepi32_pd(pixels), multipliers, bases));
+      }
+      else {
+        for (int j = i; j < i + 4; j++) {
+          doubles[j] = signedWordToDouble(raw[j], multiplier, base);
+        }
+      }
+    }
+
+    for (; i < count; i++) {
+      doubles[i] = signedWordToDouble(raw[i], multiplier, base);
+    }
+  }
+
+
+  __attribute__((target("avx2")))
+  static void unsignedWordToDoubleAvx2(const unsigned short *raw, double *doubles, int count,
+                                       double multiplier, double base) {
+    const __m128i belowValid = _mm_set1_epi32(VALID_MINU2 - 1);
+    const __m256d multipliers = _mm256_set1_pd(multiplier);
+    const __m256d bases = _mm256_set1_pd(base);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+      __m128i pixels = _mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i *)(raw + i)));
+      if (_mm_movemask_epi8(_mm_cmpgt_epi32(pixels, belowValid)) == 0xFFFF) {
+        _mm256_storeu_pd(doubles + i,
+                         scaleAvx2(_mm256_cvtepi32_pd(pixels), multipliers, bases));
+      }
+      else {
+        for (int j = i; j < i + 4; j++) {
+          doubles[j] = unsignedWordToDouble(raw[j], multiplier, base);
+        }
+      }
+    }
+
+    for (; i < count; i++) {
+      doubles[i] = unsignedWordToDouble(raw[i], multiplier, base);
+    }
+  }
+
+
+  __attribute__((target("avx2")))
+  static void unsignedIntegerToDoubleAvx2(const unsigned int *raw, double *doubles, int count,
+                                          double multiplier, double base) {
+    // There is no unsigned conversion, so the pixels are offset by 2^31 to
+    //   convert them as signed integers and the offset is added back exactly
+    //   as a double.
+    const __m128i signBit = _mm_set1_epi32(INT_MIN);
+    const __m128i belowValid = _mm_set1_epi32(INT_MIN + (int)(VALID_MINUI4 - 1));
+    const __m256d offset = _mm256_set1_pd(2147483648.0);
+    const __m256d multipliers = _mm256_set1_pd(multiplier);
+    const __m256d bases = _mm256_set1_pd(base);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+      __m128i pixels = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(raw + i)), signBit);
+      if (_mm_movemask_epi8(_mm_cmpgt_epi32(pixels, belowValid)) == 0xFFFF) {
+        __m256d values = _mm256_add_pd(_mm256_cvtepi32_pd(pixels), offset);
+        _mm256_storeu_pd(doubles + i, scaleAvx2(values, multipliers, bases));
+      }
+      else {
+        for (int j = i; j < i + 4; j++) {
+          doubles[j] = unsignedIntegerToDouble(raw[j], multiplier, base);
+        }
+      }
+    }
+
+    for (; i < count; i++) {
+      doubles[i] = unsignedIntegerToDouble(raw[i], multiplier, base);
+    }
+  }
+
+
+  __attribute__((target("avx2")))
+  static void unsignedByteToDoubleAvx2(const unsigned char *raw, double *doubles, int count,
+                                       double multiplier, double base) {
+    const __m128i nulls = _mm_set1_epi32(NULL1);
+    const __m128i highs = _mm_set1_epi32(HIGH_REPR_SAT1);
+    const __m256d multipliers = _mm256_set1_pd(multiplier);
+    const __m256d bases = _mm256_set1_pd(base);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+      int packed;
+      memcpy(&packed, raw + i, 4);
+      __m128i pixels = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(packed));
+      __m128i special = _mm_or_si128(_mm_cmpeq_epi32(pixels, nulls),
+                                     _mm_cmpeq_epi32(pixels, highs));
+      if (_mm_testz_si128(special, special)) {
+        _mm256_storeu_pd(doubles + i,
+                         scaleAvx2(_mm256_cvtepi32_pd(pixels), multipliers, bases));
+      }
+      else {
+        for (int j = i; j < i + 4; j++) {
+          doubles[j] = unsignedByteToDouble(raw[j], multiplier, base);
+        }
+      }
+    }
+
+    for (; i < count; i++) {
+      doubles[i] = unsignedByteToDouble(raw[i], multiplier, base);
+    }
+  }
+
+
+  /**
+   * Swaps the bytes of whole 32 byte blocks.
+   *
+   * @return The number of pixels that were swapped
+   */
+  __attribute__((target("avx2")))
+  static int swapBytesAvx2(const char *input, char *output, int count, int pixelSize) {
+    __m256i order;
+    if (pixelSize == 2) {
+      order = _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+                               1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    }
+    else if (pixelSize == 4) {
+      order = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                               3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    }
+    else {
+      return 0;
+    }
+
+    int pixelsPerBlock = 32 / pixelSize;
+    int i = 0;
+    for (; i + pixelsPerBlock <= count; i += pixelsPerBlock) {
+      __m256i block = _mm256_loadu_si256((const __m256i *)(input + i * pixelSize));
+      _mm256_storeu_si256((__m256i *)(output + i * pixelSize),
+                          _mm256_shuffle_epi8(block, order));
+    }
+    return i;
+  }
+#endif
+
+
+  /**
+   * @return True if the processor supports the vector kernels
+   */
+  static bool simdSupported() {
+#ifdef ISIS_CUBE_PIXEL_AVX2
+    static bool supported = []() {
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("avx2") != 0;
+    }();
+    return supported;
+#else
+    return false;
+#endif
+  }
+
+
+  /**
+   * Constructs a converter for the pixels of a cube.
+   *
+   * @param pixelType The type of the raw pixels
+   * @param base The additive offset of the raw pixels. It is not applied to
+   *             Real pixels when they are read.
+   * @param multiplier The multiplicative factor of the raw pixels. It is not
+   *             applied to Real pixels when they are read.
+   * @param useSimd Use the vector kernels if the processor supports them.
+   *             This is only turned off to compare the kernels.
+   */
+  CubePixelConverter::CubePixelConverter(PixelType pixelType, double base, double multiplier,
+                                         bool useSimd) {
+    m_pixelType = pixelType;
+    m_pixelSize = SizeOf(pixelType);
+    m_base = base;
+    m_multiplier = multiplier;
+    m_useSimd = useSimd && simdSupported();
+  }
+
+
+  /**
+   * Destroys the converter.
+   */
+  CubePixelConverter::~CubePixelConverter() {
+  }
+
+
+  /**
+   * @return The type of the raw pixels
+   */
+  PixelType CubePixelConverter::pixelType() const {
+    return m_pixelType;
+  }
+
+
+  /**
+   * @return True if the vector kernels are used
+   */
+  bool CubePixelConverter::usingSimd() const {
+    return m_useSimd;
+  }
+
+
+  /**
+   * Converts raw pixels in native byte order to doubles. Special pixels become
+   *   the matching 8 byte special pixels, and anything that looks special but
+   *   is not one of them becomes Lrs. Pixel types that cubes cannot be
+   *   read in are left alone.
+   *
+   * @param raw The raw pixels
+   * @param doubles The converted pixels
+   * @param count The number of pixels
+   */
+  void CubePixelConverter::toDouble(const char *raw, double *doubles, int count) const {
+#ifdef ISIS_CUBE_PIXEL_AVX2
+    if (m_useSimd) {
+      switch (m_pixelType) {
+        case Real:
+          realToDoubleAvx2((const float *) raw, doubles, count);
+          return;
+        case SignedWord:
+          signedWordToDoubleAvx2((const short *) raw, doubles, count, m_multiplier, m_base);
+          return;
+        case UnsignedWord:
+          unsignedWordToDoubleAvx2((const unsigned short *) raw, doubles, count,
+                                   m_multiplier, m_base);
+          return;
+        case UnsignedInteger:
+          unsignedIntegerToDoubleAvx2((const unsigned int *) raw, doubles, count,
+                                      m_multiplier, m_base);
+          return;
+        case UnsignedByte:
+          unsignedByteToDoubleAvx2((const unsigned char *) raw, doubles, count,
+                                   m_multiplier, m_base);
+          return;
+        default:
+          return;
+      }
+    }
+#endif
+
+    switch (m_pixelType) {
+      case Real:
+        for (int i = 0; i < count; i++) {
+          doubles[i] = realToDouble(((const float *) raw)[i]);
+        }
+        break;
+      case SignedWord:
+        for (int i = 0; i < count; i++) {
+          doubles[i] = signedWordToDouble(((const short *) raw)[i], m_multiplier, m_base);
+        }
+        break;
+      case UnsignedWord:
+        for (int i = 0; i < count; i++) {
+          doubles[i] = unsignedWordToDouble(((const unsigned short *) raw)[i],
+                                            m_multiplier, m_base);
+        }
+        break;
+      case UnsignedInteger:
+        for (int i = 0; i < count; i++) {
+          doubles[i] = unsignedIntegerToDouble(((const unsigned int *) raw)[i],
+                                               m_multiplier, m_base);
+        }
+        break;
+      case UnsignedByte:
+        for (int i = 0; i < count; i++) {
+          doubles[i] = unsignedByteToDouble(((const unsigned char *) raw)[i],
+                                            m_multiplier, m_base);
+        }
+        break;
+      default:
+        break;
+    }
+  }
+
+
+  /**
+   * Converts doubles to raw pixels in native byte order. The base and
+   *   multiplier are removed and the pixels are rounded, and anything outside
+   *   of the valid range of the pixel type is saturated to Lrs or Hrs.
+   *
+   * @param doubles The pixels to convert
+   * @param raw The raw pixels
+   * @param count The number of pixels
+   */
+  void CubePixelConverter::toRaw(const double *doubles, char *raw, int count) const {
+    switch (m_pixelType) {
+      case Real:
+        for (int i = 0; i < count; i++) {
+          ((float *) raw)[i] = doubleToReal(doubles[i], m_multiplier, m_base);
+        }
+        break;
+      case SignedWord:
+        for (int i = 0; i < count; i++) {
+          ((short *) raw)[i] = doubleToSignedWord(doubles[i], m_multiplier, m_base);
+        }
+        break;
+      case UnsignedWord:
+        for (int i = 0; i < count; i++) {
+          ((unsigned short *) raw)[i] = doubleToUnsignedWord(doubles[i], m_multiplier, m_base);
+        }
+        break;
+      case UnsignedInteger:
+        for (int i = 0; i < count; i++) {
+          ((unsigned int *) raw)[i] = doubleToUnsignedInteger(doubles[i], m_multiplier, m_base);
+        }
+        break;
+      case UnsignedByte:
+        for (int i = 0; i < count; i++) {
+          ((unsigned char *) raw)[i] = doubleToUnsignedByte(doubles[i], m_multiplier, m_base);
+        }
+        break;
+      default:
+        break;
+    }
+  }
+
+
+  /**
+   * Reverses the bytes of each pixel. The input and output can be the same to
+   *   swap the pixels in place, but must not otherwise overlap.
+   *
+   * @param input The pixels to swap
+   * @param output The swapped pixels
+   * @param count The number of pixels
+   */
+  void CubePixelConverter::swapBytes(const char *input, char *output, int count) const {
+    int swapped = 0;
+#ifdef ISIS_CUBE_PIXEL_AVX2
+    if (m_useSimd) {
+      swapped = swapBytesAvx2(input, output, count, m_pixelSize);
+    }
+#endif
+
+    swapBytesScalar(input + swapped * m_pixelSize, output + swapped * m_pixelSize,
+                    count - swapped, m_pixelSize);
+  }
+
+
+  /**
+   * @return The name of the vector instructions the kernels use on this
+   *         processor, or None
+   */
+  QString CubePixelConverter::simdInstructionSet() {
+    return simdSupported() ? "AVX2" : "None";
+  }
+}
@@ -0,0 +1,65 @@
+#ifndef CubePixelConverter_h
+#define CubePixelConverter_h
+/** This is free and unencumbered software released into the public domain.
+The authors of ISIS do not claim copyright on the contents of this file.
+For more details about the LICENSE terms and the AUTHORS, you will
+find files of those names at the top level of this repository. **/
+
+/* SPDX-License-Identifier: CC0-1.0 */
+
+#include <QString>
+
+#include "PixelType.h"
+
+namespace Isis {
+
+  /**
+   * @ingroup LowLevelCubeIO
+   * @brief Converts runs of raw cube pixels to and from doubles
+   *
+   * CubeIoHandler moves pixels between the raw chunks of a cube and the double
+   *   buffers of a Buffer one run of samples at a time through this class. The
+   *   pixel type is checked once per run instead of once per pixel, and special
+   *   pixels are mapped and the base and multiplier are applied the same way
+   *   for every pixel type.
+   *
+   * On x86-64 processors that support AVX2, raw to double conversion and byte
+   *   swapping work on several pixels per instruction. The instruction set is
+   *   picked when the program runs, other processors use the plain loops. Both
+   *   give the same pixels; runs with special pixels in them are converted one
+   *   pixel at a time.
+   *
+   * Converters do not change after they are constructed, so one converter can
+   *   be used by several threads at once.
+   *
+   * @author 2026-10-16 ISIS Development Team
+   *
+   * @internal
+   *   @history 2026-10-16 ISIS Development Team - Original version
+   */
+  class CubePixelConverter {
+    public:
+      CubePixelConverter(PixelType pixelType, double base, double multiplier,
+                         bool useSimd = true);
+      ~CubePixelConverter();
+
+      PixelType pixelType() const;
+      bool usingSimd() const;
+
+      void toDouble(const char *raw, double *doubles, int count) const;
+      void toRaw(const double *doubles, char *raw, int count) const;
+
+      void swapBytes(const char *input, char *output, int count) const;
+
+      static QString simdInstructionSet();
+
+    private:
+      PixelType m_pixelType; //!< The type of the raw pixels
+      int m_pixelSize;       //!< The size of a raw pixel in bytes
+      double m_base;         //!< The additive offset of the raw pixels
+      double m_multiplier;   //!< The multiplicative factor of the raw pixels
+      bool m_useSimd;        //!< Use the vector instructions of the processor
+  };
+}
+
+#endif
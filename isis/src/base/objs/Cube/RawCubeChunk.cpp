@@ -71,6 +71,37 @@ namespace Isis {
   }
 
 
+  /**
+   * This constructor creates a cube chunk that views existing raw data, such
+   *   as memory mapped cube data, instead of copying it. The raw data must
+   *   outlive the chunk. Reading the data through getRawData() is fine, but
+   *   the chunk must not be modified with setData(); modifying it through
+   *   getRawData() first copies the data into the chunk.
+   *
+   * @param startSample the starting sample of the chunk (inclusive)
+   * @param startLine the starting line of the chunk (inclusive)
+   * @param startBand the starting band of the chunk (inclusive)
+   * @param endSample the ending sample of the chunk (inclusive)
+   * @param endLine the ending line of the chunk (inclusive)
+   * @param endBand the ending band of the chunk (inclusive)
+   * @param rawData the raw data bytes to view
+   * @param numBytes the number of raw data bytes in the chunk
+   */
+  RawCubeChunk::RawCubeChunk(int startSample, int startLine, int startBand,
+                             int endSample, int endLine, int endBand,
+                             const char *rawData, int numBytes) {
+    m_dirty = false;
+    m_rawBuffer = new QByteArray(QByteArray::fromRawData(rawData, numBytes));
+    m_rawBufferInternalPtr = NULL;
+    m_sampleCount = endSample - startSample + 1;
+    m_lineCount = endLine - startLine + 1;
+    m_bandCount = endBand - startBand + 1;
+    m_startSample = startSample;
+    m_startLine = startLine;
+    m_startBand = startBand;
+  }
+
+
   /**
    * The destructor.
    */
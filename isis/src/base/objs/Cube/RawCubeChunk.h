@@ -29,6 +29,9 @@ namespace Isis {
       RawCubeChunk(const Area3D &placement, int numBytes);
       RawCubeChunk(int startSample, int startLine, int startBand,
                    int endSample, int endLine, int endBand, int numBytes);
+      RawCubeChunk(int startSample, int startLine, int startBand,
+                   int endSample, int endLine, int endBand,
+                   const char *rawData, int numBytes);
       virtual ~RawCubeChunk();
       bool isDirty() const;
 
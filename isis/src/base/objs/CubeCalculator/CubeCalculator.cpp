@@ -6,12 +6,18 @@ find files of those names at the top level of this repository. **/
 /* SPDX-License-Identifier: CC0-1.0 */
 #include "CubeCalculator.h"
 
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
 #include <QVector>
 
 #include "Angle.h"
 #include "Camera.h"
 #include "Distance.h"
+#include "IException.h"
 #include "IString.h"
+#include "SpecialPixel.h"
 #include "Statistics.h"
 
 using namespace std;
@@ -35,6 +41,8 @@ namespace Isis {
     m_cameraBuffers   = new QVector<CameraBuffers *>();
 
     m_outputSamples = 0;
+    m_registerSize = 0;
+    m_maxSize = 0;
   }
 
   
@@ -97,11 +105,17 @@ namespace Isis {
       }
       m_cameraBuffers->clear();
     }
+
+    m_program.clear();
+    m_registerSize = 0;
+    m_maxSize = 0;
   }
 
   
   /**
    * This method will execute the calculations built up when PrepareCalculations was called.
+   *   Equations that could be compiled run the compiled program, which may be run by several
+   *   threads at once if isThreadSafe() is true.
    *
    * @param cubeData The input cubes' data
    * @param curLine The current line in the output cube
@@ -114,6 +128,10 @@ namespace Isis {
   QVector<double> CubeCalculator::runCalculations(QVector<Buffer *> &cubeData,
                                                   int curLine, 
                                                   int curBand) {
+    if (!m_program.isEmpty()) {
+      return runProgram(cubeData, curLine, curBand);
+    }
+
     // For now we'll only process a single line in this method for our results. In order
     //    to do more powerful indexing, passing a list of cubes and the output cube will
     //    be necessary.
@@ -151,72 +169,8 @@ namespace Isis {
         else if (data.type() == DataValue::CubeData) {
           Push(*cubeData[data.cubeIndex()]);
         }
-        else if (data.type() == DataValue::InaData) {
-          Push(*((*m_cameraBuffers)[data.cubeIndex()]->inaBuffer(curLine,
-                                                                 m_outputSamples,
-                                                                 curBand)));
-        }
-        else if (data.type() == DataValue::EmaData) {
-          Push(*((*m_cameraBuffers)[data.cubeIndex()]->emaBuffer(curLine,
-                                                                 m_outputSamples,
-                                                                 curBand)));
-        }
-        else if (data.type() == DataValue::PhaData) {
-          Push(*((*m_cameraBuffers)[data.cubeIndex()]->phaBuffer(curLine,
-                                                                 m_outputSamples,
-                                                                 curBand)));
-        }
-        else if (data.type() == DataValue::InalData) {
-          Push(*((*m_cameraBuffers)[data.cubeIndex()]->inalBuffer(curLine,
-                                                                  m_outputSamples,
-                                                                  curBand)));
-        }
-        else if (data.type() == DataValue::EmalData) {
-          Push(*((*m_cameraBuffers)[data.cubeIndex()]->emalBuffer(curLine,
-                                                                  m_outputSamples,
-                                                                  curBand)));
-        }
-        else if (data.type() == DataValue::PhalData) {
-          Push(*((*m_cameraBuffers)[data.cubeIndex()]->phalBuffer(curLine,
-                                                                  m_outputSamples,
-                                                                  curBand)));
-        }
-        else if (data.type() == DataValue::LatData) {
-          Push(*((*m_cameraBuffers)[data.cubeIndex()]->latBuffer(curLine,
-                                                                 m_outputSamples,
-                                                                 curBand)));
-        }
-        else if (data.type() == DataValue::LonData) {
-          Push(*((*m_cameraBuffers)[data.cubeIndex()]->lonBuffer(curLine,
-                                                                 m_outputSamples,
-                                                                 curBand)));
-        }
-        else if (data.type() == DataValue::ResData) {
-          Push(*((*m_cameraBuffers)[data.cubeIndex()]->resBuffer(curLine,
-                                                                 m_outputSamples,
-                                                                 curBand)));
-        }
-        else if (data.type() == DataValue::RadiusData) {
-          Push(*((*m_cameraBuffers)[data.cubeIndex()]->radiusBuffer(curLine,
-                                                                    m_outputSamples,
-                                                                    curBand)));
-        }
-        else if (data.type() == DataValue::InacData) {
-          Push(*((*m_cameraBuffers)[data.cubeIndex()]->inacBuffer(curLine,
-                                                                  m_outputSamples,
-                                                                  curBand)));
-        }
-        else if (data.type() == DataValue::EmacData) {
-          Push(*((*m_cameraBuffers)[data.cubeIndex()]->emacBuffer(curLine,
-                                                                  m_outputSamples,
-                                                                  curBand)));
-        }
-        else if (data.type() == DataValue::PhacData) {
-          Push(*((*m_cameraBuffers)[data.cubeIndex()]->phacBuffer(curLine,
-                                                                  m_outputSamples,
-                                                                  curBand)));
-        }
         else {
+          Push(*cameraData(data.type(), data.cubeIndex(), curLine, curBand));
         }
 
         dataIndex ++;
@@ -681,6 +635,530 @@ namespace Isis {
         throw IException(IException::Unknown, msg, _FILEINFO_);
       }
     } // while loop
+
+    compile(inCubes);
+  }
+
+
+  /**
+   * Whether runCalculations can be called from several threads at once. This is true when the
+   *   equation was compiled and does not use any camera functions, since cameras can only be
+   *   used by one thread.
+   *
+   * @return @b bool True if runCalculations is thread safe
+   */
+  bool CubeCalculator::isThreadSafe() const {
+    return !m_program.isEmpty() && m_cameraBuffers->isEmpty();
+  }
+
+
+  /**
+   * Compiles the calculations built up by prepareCalculations into a program that works on
+   *   registers allocated once per call to runCalculations. The results are identical to
+   *   running the calculations on the Calculator stack. If the calculations would throw an
+   *   error on the stack, such as running out of operands, they are not compiled so the
+   *   error is reported the same way.
+   *
+   * @param inCubes The input cubes
+   */
+  void CubeCalculator::compile(QVector<Cube *> &inCubes) {
+    m_program.clear();
+    m_registerSize = 0;
+    m_maxSize = 0;
+
+    // The number of values in each entry on the stack and the most each slot ever holds
+    QVector<int> stackSizes;
+    QVector<int> slotSizes;
+    QVector<Instruction> program;
+
+    int methodIndex = 0;
+    int dataIndex = 0;
+
+    for (int currentCalculation = 0; currentCalculation < m_calculations->size();
+         currentCalculation++) {
+      Instruction instruction;
+      instruction.operation = LoadConstant;
+      instruction.result = 0;
+      instruction.resultSize = 1;
+      instruction.argument = 0;
+      instruction.firstSize = 0;
+      instruction.secondSize = 0;
+      instruction.constant = 0.0;
+      instruction.dataType = DataValue::Constant;
+      instruction.cubeIndex = -1;
+      instruction.unary = NULL;
+      instruction.binary = NULL;
+
+      int depth = stackSizes.size();
+
+      if ((*m_calculations)[currentCalculation] == PushNextData) {
+        DataValue &data = (*m_dataDefinitions)[dataIndex];
+        dataIndex++;
+
+        instruction.dataType = data.type();
+        instruction.cubeIndex = data.cubeIndex();
+
+        if (data.type() == DataValue::Constant) {
+          instruction.operation = LoadConstant;
+          instruction.constant = data.constant();
+        }
+        else if (data.type() == DataValue::Band) {
+          instruction.operation = LoadBand;
+        }
+        else if (data.type() == DataValue::Line) {
+          instruction.operation = LoadLine;
+        }
+        else if (data.type() == DataValue::Sample) {
+          instruction.operation = LoadSample;
+          instruction.resultSize = m_outputSamples;
+        }
+        else if (data.type() == DataValue::CubeData) {
+          instruction.operation = LoadCube;
+          instruction.resultSize = inCubes[data.cubeIndex()]->sampleCount();
+        }
+        else {
+          instruction.operation = LoadCamera;
+          instruction.resultSize = m_outputSamples;
+        }
+
+        instruction.result = depth;
+        instruction.argument = depth;
+        stackSizes.push_back(instruction.resultSize);
+      }
+      else {
+        void (Calculator::*method)() = (*m_methods)[methodIndex];
+        methodIndex++;
+
+        if (!compileMethod(method, instruction)) {
+          return;
+        }
+
+        bool unary = instruction.operation == UnaryFunction ||
+                     instruction.operation == LineMinimum ||
+                     instruction.operation == LineMaximum;
+        int arguments = unary ? 1 : 2;
+
+        // The stack runs out of operands
+        if (depth < arguments) {
+          return;
+        }
+
+        instruction.result = depth - arguments;
+        instruction.argument = depth - 1;
+        instruction.firstSize = stackSizes[depth - arguments];
+
+        if (unary) {
+          instruction.resultSize = instruction.operation == UnaryFunction ?
+                                   instruction.firstSize : 1;
+        }
+        else {
+          instruction.secondSize = stackSizes[depth - 1];
+
+          if (instruction.operation == ShiftLeft || instruction.operation == ShiftRight) {
+            // Shifting requires scalars
+            if (instruction.secondSize != 1) {
+              return;
+            }
+            instruction.resultSize = instruction.firstSize;
+          }
+          else {
+            // Vectors of differing sizes
+            if (instruction.firstSize != 1 && instruction.secondSize != 1 &&
+                instruction.firstSize != instruction.secondSize) {
+              return;
+            }
+            instruction.resultSize = max(instruction.firstSize, instruction.secondSize);
+          }
+
+          stackSizes.pop_back();
+        }
+
+        stackSizes.last() = instruction.resultSize;
+      }
+
+      while (slotSizes.size() <= instruction.result) {
+        slotSizes.push_back(1);
+      }
+      slotSizes[instruction.result] = max(slotSizes[instruction.result], instruction.resultSize);
+
+      program.push_back(instruction);
+    }
+
+    // Too many operands in the equation
+    if (stackSizes.size() != 1) {
+      return;
+    }
+
+    // Lay the registers out one after another in a single buffer
+    QVector<int> offsets;
+    int registerSize = 0;
+    int maxSize = 1;
+    for (int slot = 0; slot < slotSizes.size(); slot++) {
+      offsets.push_back(registerSize);
+      registerSize += slotSizes[slot];
+      maxSize = max(maxSize, slotSizes[slot]);
+    }
+
+    for (int i = 0; i < program.size(); i++) {
+      program[i].result = offsets[program[i].result];
+      program[i].argument = offsets[program[i].argument];
+    }
+
+    m_program = program;
+    m_registerSize = registerSize;
+    m_maxSize = maxSize;
+  }
+
+
+  /**
+   * Sets up an instruction for a Calculator method.
+   *
+   * @param method The Calculator method
+   * @param instruction The instruction to set the operation and function of
+   *
+   * @return @b bool False if the method can not be compiled
+   */
+  bool CubeCalculator::compileMethod(void (Calculator::*method)(void),
+                                     Instruction &instruction) {
+    instruction.operation = UnaryFunction;
+
+    if (method == &Calculator::Add) {
+      instruction.operation = AddValues;
+    }
+    else if (method == &Calculator::Subtract) {
+      instruction.operation = SubtractValues;
+    }
+    else if (method == &Calculator::Multiply) {
+      instruction.operation = MultiplyValues;
+    }
+    else if (method == &Calculator::Divide) {
+      instruction.operation = DivideValues;
+    }
+    else if (method == &Calculator::LeftShift) {
+      instruction.operation = ShiftLeft;
+    }
+    else if (method == &Calculator::RightShift) {
+      instruction.operation = ShiftRight;
+    }
+    else if (method == &Calculator::MinimumLine) {
+      instruction.operation = LineMinimum;
+    }
+    else if (method == &Calculator::MaximumLine) {
+      instruction.operation = LineMaximum;
+    }
+    // Calculator applies min and max to the top of the stack first
+    else if (method == &Calculator::MinimumPixel) {
+      instruction.operation = SwappedFunction;
+      instruction.binary = MinimumOperator;
+    }
+    else if (method == &Calculator::MaximumPixel) {
+      instruction.operation = SwappedFunction;
+      instruction.binary = MaximumOperator;
+    }
+    else if (method == &Calculator::Negative)      instruction.unary = NegateOperator;
+    else if (method == &Calculator::SquareRoot)    instruction.unary = sqrt;
+    else if (method == &Calculator::AbsoluteValue) instruction.unary = fabs;
+    else if (method == &Calculator::Log)           instruction.unary = log;
+    else if (method == &Calculator::Log10)         instruction.unary = log10;
+    else if (method == &Calculator::Sine)          instruction.unary = sin;
+    else if (method == &Calculator::Cosine)        instruction.unary = cos;
+    else if (method == &Calculator::Tangent)       instruction.unary = tan;
+    else if (method == &Calculator::Secant)        instruction.unary = SecantOperator;
+    else if (method == &Calculator::Cosecant)      instruction.unary = CosecantOperator;
+    else if (method == &Calculator::Cotangent)     instruction.unary = CotangentOperator;
+    else if (method == &Calculator::Arcsine)       instruction.unary = asin;
+    else if (method == &Calculator::Arccosine)     instruction.unary = acos;
+    else if (method == &Calculator::Arctangent)    instruction.unary = atan;
+    else if (method == &Calculator::SineH)         instruction.unary = sinh;
+    else if (method == &Calculator::CosineH)       instruction.unary = cosh;
+    else if (method == &Calculator::TangentH)      instruction.unary = tanh;
+    else if (method == &Calculator::ArcsineH)      instruction.unary = asinh;
+    else if (method == &Calculator::ArccosineH)    instruction.unary = acosh;
+    else if (method == &Calculator::ArctangentH)   instruction.unary = atanh;
+    else {
+      instruction.operation = BinaryFunction;
+
+      if (method == &Calculator::Modulus)                 instruction.binary = ModulusOperator;
+      else if (method == &Calculator::Exponent)           instruction.binary = pow;
+      else if (method == &Calculator::Arctangent2)        instruction.binary = atan2;
+      else if (method == &Calculator::GreaterThan)        instruction.binary = GreaterThanOperator;
+      else if (method == &Calculator::LessThan)           instruction.binary = LessThanOperator;
+      else if (method == &Calculator::Equal)              instruction.binary = EqualOperator;
+      else if (method == &Calculator::GreaterThanOrEqual) {
+        instruction.binary = GreaterThanOrEqualOperator;
+      }
+      else if (method == &Calculator::LessThanOrEqual)    instruction.binary = LessThanOrEqualOperator;
+      else if (method == &Calculator::NotEqual)           instruction.binary = NotEqualOperator;
+      else if (method == &Calculator::And)                instruction.binary = BitwiseAndOperator;
+      else if (method == &Calculator::Or)                 instruction.binary = BitwiseOrOperator;
+      else {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+
+  /**
+   * Applies a binary operation the way Calculator::PerformOperation does. An argument with a
+   *   single value is used with every value of the other argument. The result may be the same
+   *   register as either argument.
+   *
+   * @param result Where to put the results
+   * @param x The first arguments
+   * @param xSize The number of first arguments
+   * @param y The second arguments
+   * @param ySize The number of second arguments
+   * @param size The number of results
+   * @param operation The operation
+   */
+  template <typename Operation>
+  static void applyBinary(double *result, const double *x, int xSize,
+                          const double *y, int ySize, int size, Operation operation) {
+    if (xSize == ySize) {
+      for (int i = 0; i < size; i++) {
+        result[i] = operation(x[i], y[i]);
+      }
+    }
+    else if (ySize == 1) {
+      double yValue = y[0];
+      for (int i = 0; i < size; i++) {
+        result[i] = operation(x[i], yValue);
+      }
+    }
+    else {
+      double xValue = x[0];
+      for (int i = 0; i < size; i++) {
+        result[i] = operation(xValue, y[i]);
+      }
+    }
+  }
+
+
+  /**
+   * Runs the compiled equation. All of the registers are in one buffer, so this only allocates
+   *   that buffer and the results.
+   *
+   * @param cubeData The input cubes' data
+   * @param curLine The current line in the output cube
+   * @param curBand The current band in the output cube
+   *
+   * @return @b QVector<double> The results of the calculations (with Isis Special Pixels)
+   *
+   * @throws IException::Programmer "Input cube data does not have the expected size"
+   * @throws IException::Unknown "Shifting by this value would erase all of the data."
+   */
+  QVector<double> CubeCalculator::runProgram(QVector<Buffer *> &cubeData,
+                                             int curLine, int curBand) {
+    // Shifts copy their argument to the end of the buffer
+    QVector<double> registers(m_registerSize + m_maxSize);
+    double *scratch = registers.data() + m_registerSize;
+
+    for (int i = 0; i < m_program.size(); i++) {
+      const Instruction &instruction = m_program[i];
+      double *result = registers.data() + instruction.result;
+      const double *argument = registers.data() + instruction.argument;
+      int size = instruction.resultSize;
+
+      switch (instruction.operation) {
+        case LoadConstant:
+          result[0] = instruction.constant;
+          break;
+
+        case LoadBand:
+          result[0] = curBand;
+          break;
+
+        case LoadLine:
+          result[0] = curLine;
+          break;
+
+        case LoadSample:
+          for (int s = 0; s < size; s++) {
+            result[s] = s + 1;
+          }
+          break;
+
+        case LoadCube: {
+          const Buffer &buffer = *cubeData[instruction.cubeIndex];
+          if (buffer.size() != size) {
+            QString msg = "Input cube data does not have the expected size";
+            throw IException(IException::Programmer, msg, _FILEINFO_);
+          }
+
+          // Map special pixels to values like Calculator::Push(Buffer &)
+          const double *values = buffer.DoubleBuffer();
+          for (int s = 0; s < size; s++) {
+            double value = values[s];
+            if (IsSpecial(value)) {
+              if (IsNullPixel(value)) {
+                value = sqrt(-1.0);
+              }
+              else if (IsHrsPixel(value) || IsHisPixel(value)) {
+                value = DBL_MAX * 2;
+              }
+              else {
+                value = -DBL_MAX * 2;
+              }
+            }
+            result[s] = value;
+          }
+          break;
+        }
+
+        case LoadCamera: {
+          QVector<double> *values = cameraData(instruction.dataType, instruction.cubeIndex,
+                                               curLine, curBand);
+          std::copy(values->constBegin(), values->constBegin() + size, result);
+          break;
+        }
+
+        case AddValues:
+          applyBinary(result, result, instruction.firstSize, argument, instruction.secondSize,
+                      size, [](double a, double b) { return a + b; });
+          break;
+
+        case SubtractValues:
+          applyBinary(result, result, instruction.firstSize, argument, instruction.secondSize,
+                      size, [](double a, double b) { return a - b; });
+          break;
+
+        case MultiplyValues:
+          applyBinary(result, result, instruction.firstSize, argument, instruction.secondSize,
+                      size, [](double a, double b) { return a * b; });
+          break;
+
+        case DivideValues:
+          applyBinary(result, result, instruction.firstSize, argument, instruction.secondSize,
+                      size, [](double a, double b) { return a / b; });
+          break;
+
+        case BinaryFunction:
+          applyBinary(result, result, instruction.firstSize, argument, instruction.secondSize,
+                      size, instruction.binary);
+          break;
+
+        case SwappedFunction:
+          applyBinary(result, argument, instruction.secondSize, result, instruction.firstSize,
+                      size, instruction.binary);
+          break;
+
+        case UnaryFunction:
+          for (int s = 0; s < size; s++) {
+            result[s] = instruction.unary(result[s]);
+          }
+          break;
+
+        case ShiftLeft:
+        case ShiftRight: {
+          int shift = (int)argument[0];
+          if (shift > instruction.firstSize) {
+            QString direction = instruction.operation == ShiftLeft ? "left" : "right";
+            QString msg = "When trying to do a " + direction + " shift calculation, a shift "
+                          "value greater than the data size was encountered. "
+                          "Shifting by this value would erase all of the data.";
+            throw IException(IException::Unknown, msg, _FILEINFO_);
+          }
+
+          if (instruction.operation == ShiftRight) {
+            shift = -shift;
+          }
+
+          std::copy(result, result + size, scratch);
+          for (int s = 0; s < size; s++) {
+            if (s + shift < size && s + shift >= 0) {
+              result[s] = scratch[s + shift];
+            }
+            else {
+              result[s] = sqrt(-1.0); // create a NaN
+            }
+          }
+          break;
+        }
+
+        case LineMinimum:
+        case LineMaximum: {
+          double value = result[0];
+          for (int s = 0; s < instruction.firstSize; s++) {
+            if (!IsSpecial(result[s])) {
+              value = instruction.operation == LineMinimum ? min(value, result[s]) :
+                                                             max(value, result[s]);
+            }
+          }
+          result[0] = value;
+          break;
+        }
+      }
+    }
+
+    // Map the results back to special pixels like Calculator::Pop(true)
+    QVector<double> results(m_program.last().resultSize);
+    for (int i = 0; i < results.size(); i++) {
+      double value = registers[i];
+      if (std::isnan(value)) {
+        value = Isis::Null;
+      }
+      else if (value > DBL_MAX) {
+        value = Isis::Hrs;
+      }
+      else if (value < -DBL_MAX) {
+        value = Isis::Lrs;
+      }
+      results[i] = value;
+    }
+
+    return results;
+  }
+
+
+  /**
+   * Loads and returns one kind of camera data for a line.
+   *
+   * @param type The kind of camera data
+   * @param cubeIndex The input cube to get the camera data of
+   * @param curLine The current line in the output cube
+   * @param curBand The current band in the output cube
+   *
+   * @return @b QVector<double>* The camera data
+   */
+  QVector<double> *CubeCalculator::cameraData(DataValue::DataValueType type, int cubeIndex,
+                                              int curLine, int curBand) {
+    CameraBuffers *buffers = (*m_cameraBuffers)[cubeIndex];
+
+    switch (type) {
+      case DataValue::InaData:
+        return buffers->inaBuffer(curLine, m_outputSamples, curBand);
+      case DataValue::EmaData:
+        return buffers->emaBuffer(curLine, m_outputSamples, curBand);
+      case DataValue::PhaData:
+        return buffers->phaBuffer(curLine, m_outputSamples, curBand);
+      case DataValue::InalData:
+        return buffers->inalBuffer(curLine, m_outputSamples, curBand);
+      case DataValue::EmalData:
+        return buffers->emalBuffer(curLine, m_outputSamples, curBand);
+      case DataValue::PhalData:
+        return buffers->phalBuffer(curLine, m_outputSamples, curBand);
+      case DataValue::LatData:
+        return buffers->latBuffer(curLine, m_outputSamples, curBand);
+      case DataValue::LonData:
+        return buffers->lonBuffer(curLine, m_outputSamples, curBand);
+      case DataValue::ResData:
+        return buffers->resBuffer(curLine, m_outputSamples, curBand);
+      case DataValue::RadiusData:
+        return buffers->radiusBuffer(curLine, m_outputSamples, curBand);
+      case DataValue::InacData:
+        return buffers->inacBuffer(curLine, m_outputSamples, curBand);
+      case DataValue::EmacData:
+        return buffers->emacBuffer(curLine, m_outputSamples, curBand);
+      case DataValue::PhacData:
+        return buffers->phacBuffer(curLine, m_outputSamples, curBand);
+      default:
+        break;
+    }
+
+    QString msg = "Data type [" + toString(type) + "] is not camera data";
+    throw IException(IException::Programmer, msg, _FILEINFO_);
   }
 
 
@@ -16,9 +16,55 @@ class QString;
 template<class T> class QVector;
 
 namespace Isis {
-  class DataValue;
   class CameraBuffers;
 
+  /**
+   * This class is used to define what kind of data is being pushed onto the cube calculator
+   * @author ????-??-?? Unknown
+   *
+   * @internal
+   */
+  class DataValue {
+    public:
+      //! This is used to tell what kind of data to push onto the RPN calculator.
+      enum DataValueType {
+        Constant, //!< A single constant value.
+        Sample, //!< Current sample number.
+        Line, //!< Current line number.
+        Band, //!< Current band number.
+        CubeData, //!< A brick of cube data.
+        InaData, //!< Incidence camera data.
+        EmaData, //!< Emission camera data.
+        PhaData, //!< Phase camera data.
+        LatData, //!< Latitude camera data.
+        LonData, //!< Longitude camera data.
+        ResData, //!< Pixel resolution camera data.
+        RadiusData, //!< DEM radius.
+        InalData, //!< Local incidence camera data.
+        EmalData, //!< Local emission camera data.
+        PhalData, //!< Local phase camera data.
+        InacData, //!< Center incidence camera data.
+        EmacData, //!< Center emission camera data.
+        PhacData  //!< Center phase camera data.
+      };
+
+      DataValue();
+      DataValue(DataValueType type);
+      DataValue(DataValueType type, int cubeIndex);
+      DataValue(DataValueType type, double value);
+
+      DataValueType type();
+      int cubeIndex();
+      double constant();
+
+    private:
+      int m_cubeIndex;        //!< The index of the associated cube
+      double m_constantValue; //!< Stored constant value
+
+      DataValueType m_type;   //!< Type of data stored.
+  };
+
+
   /**
    * @brief Calculator for arrays
    *
@@ -53,6 +99,11 @@ namespace Isis {
    *                          changes for correctly calculating camera angles for band-dependent
    *                          images. Quick documentation and coding standards review (moved
    *                          inline implementations to cpp). Fixes #1301.
+   *  @history 2026-10-16 ISIS Development Team - prepareCalculations compiles the equation
+   *                          into a program that works on preallocated registers instead of
+   *                          pushing a new vector onto the stack for every operation.
+   *                          runCalculations can be called from several threads at once when
+   *                          isThreadSafe() is true.
    */
   class CubeCalculator : Calculator {
     public:
@@ -72,6 +123,8 @@ namespace Isis {
       QVector<double> runCalculations(QVector<Buffer *> &cubeData,
                                       int line, int band);
 
+      bool isThreadSafe() const;
+
     private:
       /**
        * This is used to define
@@ -85,8 +138,56 @@ namespace Isis {
         PushNextData
       };
 
+      /**
+       * The kinds of instructions in a compiled equation.
+       */
+      enum Operation {
+        LoadConstant,   //!< Load a constant into the result register
+        LoadBand,       //!< Load the band number into the result register
+        LoadLine,       //!< Load the line number into the result register
+        LoadSample,     //!< Load the sample numbers into the result register
+        LoadCube,       //!< Load input cube data, with special pixels mapped to NaN/infinity
+        LoadCamera,     //!< Load camera data from the camera buffers
+        AddValues,      //!< Add the second argument to the first
+        SubtractValues, //!< Subtract the second argument from the first
+        MultiplyValues, //!< Multiply the arguments
+        DivideValues,   //!< Divide the first argument by the second
+        UnaryFunction,  //!< Apply a function of one argument
+        BinaryFunction, //!< Apply a function of two arguments
+        SwappedFunction, //!< Apply a function of two arguments, the second argument first
+        ShiftLeft,      //!< Shift the first argument left by the second
+        ShiftRight,     //!< Shift the first argument right by the second
+        LineMinimum,    //!< The minimum valid value of the argument
+        LineMaximum     //!< The maximum valid value of the argument
+      };
+
+      /**
+       * One step of a compiled equation. Registers are the slots of the stack
+       *   the postfix equation would have used, so the result of an operation
+       *   goes where its first argument was.
+       */
+      struct Instruction {
+        Operation operation;     //!< What to do
+        int result;              //!< Offset of the result register, also the first argument
+        int resultSize;          //!< The number of values in the result
+        int argument;            //!< Offset of the second argument register
+        int firstSize;           //!< The number of values in the first argument
+        int secondSize;          //!< The number of values in the second argument
+        double constant;         //!< The value for LoadConstant
+        DataValue::DataValueType dataType; //!< The camera data for LoadCamera
+        int cubeIndex;           //!< The input cube for LoadCube and LoadCamera
+        double (*unary)(double); //!< The function for UnaryFunction
+        double (*binary)(double, double); //!< The function for the binary functions
+      };
+
       void addMethodCall(void (Calculator::*method)(void));
 
+      void compile(QVector<Cube *> &inCubes);
+      bool compileMethod(void (Calculator::*method)(void), Instruction &instruction);
+      QVector<double> runProgram(QVector<Buffer *> &cubeData, int line, int band);
+      QVector<double> *cameraData(DataValue::DataValueType type, int cubeIndex,
+                                  int line, int band);
+
       int lastPushToCubeStats(QVector<Cube *> &inCubes);
 
       int lastPushToCubeCameras(QVector<Cube *> &inCubes);
@@ -120,53 +221,13 @@ namespace Isis {
       QVector<CameraBuffers *> *m_cameraBuffers;
 
       int m_outputSamples; //!< Number of samples in the output cube.
-  };
-
 
-  /**
-   * This class is used to define what kind of data is being pushed onto the cube calculator
-   * @author ????-??-?? Unknown
-   *
-   * @internal
-   */
-  class DataValue {
-    public:
-      //! This is used to tell what kind of data to push onto the RPN calculator.
-      enum DataValueType {
-        Constant, //!< A single constant value.
-        Sample, //!< Current sample number.
-        Line, //!< Current line number.
-        Band, //!< Current band number.
-        CubeData, //!< A brick of cube data.
-        InaData, //!< Incidence camera data.
-        EmaData, //!< Emission camera data.
-        PhaData, //!< Phase camera data.
-        LatData, //!< Latitude camera data.
-        LonData, //!< Longitude camera data.
-        ResData, //!< Pixel resolution camera data.
-        RadiusData, //!< DEM radius.
-        InalData, //!< Local incidence camera data.
-        EmalData, //!< Local emission camera data.
-        PhalData, //!< Local phase camera data.
-        InacData, //!< Center incidence camera data.
-        EmacData, //!< Center emission camera data.
-        PhacData  //!< Center phase camera data.
-      };
-
-      DataValue();
-      DataValue(DataValueType type);
-      DataValue(DataValueType type, int cubeIndex);
-      DataValue(DataValueType type, double value);
-
-      DataValueType type();
-      int cubeIndex();
-      double constant();
-
-    private:
-      int m_cubeIndex;        //!< The index of the associated cube
-      double m_constantValue; //!< Stored constant value
-
-      DataValueType m_type;   //!< Type of data stored.
+      //! The compiled equation, empty if it could not be compiled
+      QVector<Instruction> m_program;
+      //! The number of values all of the registers of the compiled equation hold
+      int m_registerSize;
+      //! The longest vector in the compiled equation
+      int m_maxSize;
   };
 
 
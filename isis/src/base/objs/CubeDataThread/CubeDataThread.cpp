@@ -19,6 +19,7 @@ find files of those names at the top level of this repository. **/
 
 #include "Brick.h"
 #include "Cube.h"
+#include "CubeOverview.h"
 #include "FileName.h"
 #include "IException.h"
 #include "IString.h"
@@ -340,6 +341,28 @@ namespace Isis {
   }
 
 
+  /**
+   * Reads an overview from a managed cube. The overview is read while holding
+   *   the lock that brick reads hold, so it never interleaves with them.
+   *
+   * @param cubeId The Cube ID of the Cube to read the overview from
+   * @param scale The scale of the overview
+   *
+   * @return The overview, which the caller takes ownership of
+   */
+  CubeOverview *CubeDataThread::ReadOverview(int cubeId, int scale) {
+    QMutexLocker locker(p_threadSafeMutex);
+
+    if (!p_managedCubes->contains(cubeId)) {
+      throw IException(IException::Programmer,
+                       "Invalid Cube ID [" + IString(cubeId) + "]",
+                       _FILEINFO_);
+    }
+
+    return new CubeOverview(CubeOverview::read(*p_managedCubes->value(cubeId).second, scale));
+  }
+
+
   /**
    * Given a Cube pointer, return the cube ID associated with it.
    *
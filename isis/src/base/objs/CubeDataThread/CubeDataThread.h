@@ -19,6 +19,7 @@ class QMutex;
 
 namespace Isis {
   class Cube;
+  class CubeOverview;
   class FileName;
   class Brick;
   class UniversalGroundMap;
@@ -52,6 +53,8 @@ namespace Isis {
    *   @history 2012-02-27 Jai Rideout and Steven Lambright - Made
    *                           BricksInMemory() thread-safe. Fixes #733.
    *   @history 2016-06-21 Kris Becker - Properly forward declare QPair as struct not class
+   *   @history 2026-10-17 ISIS Development Team - Added ReadOverview() so that
+   *                           overviews are read under the same lock as bricks.
    *
    *   @todo Add state recording/reverting functionality
    *
@@ -79,6 +82,8 @@ namespace Isis {
       const Cube *GetCube(int cubeId) const;
       int FindCubeId(const Cube *) const;
 
+      CubeOverview *ReadOverview(int cubeId, int scale);
+
     public slots:
       void ReadCube(int cubeId, int startSample, int startLine,
                     int endSample, int endLine, int band, void *caller);
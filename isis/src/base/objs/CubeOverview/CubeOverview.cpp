@@ -0,0 +1,453 @@
+/** This is free and unencumbered software released into the public domain.
+The authors of ISIS do not claim copyright on the contents of this file.
+For more details about the LICENSE terms and the AUTHORS, you will
+find files of those names at the top level of this repository. **/
+
+/* SPDX-License-Identifier: CC0-1.0 */
+
+#include "CubeOverview.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+#include <QtEndian>
+
+#include "Cube.h"
+#include "IException.h"
+#include "IString.h"
+#include "LineManager.h"
+#include "Progress.h"
+#include "Pvl.h"
+#include "PvlGroup.h"
+#include "PvlObject.h"
+#include "SpecialPixel.h"
+
+using namespace std;
+
+namespace Isis {
+
+  /**
+   * Constructs an overview filled with NULLs.
+   *
+   * @param scale The cube pixels covered by one overview pixel in each direction
+   * @param samples The number of samples in the overview
+   * @param lines The number of lines in the overview
+   * @param bands The number of bands in the overview
+   */
+  CubeOverview::CubeOverview(int scale, int samples, int lines, int bands) {
+    if (scale < 2 || samples < 1 || lines < 1 || bands < 1) {
+      QString msg = "An overview with scale [" + toString(scale) + "] and "
+                    "dimensions [" + toString(samples) + ", " + toString(lines) +
+                    ", " + toString(bands) + "] is not valid";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
+
+    if ((BigInt)samples * lines * bands * (BigInt)sizeof(float) > INT_MAX) {
+      QString msg = "An overview with scale [" + toString(scale) + "] is too large "
+                    "to store in a cube. Use a larger scale";
+      throw IException(IException::User, msg, _FILEINFO_);
+    }
+
+    m_scale = scale;
+    m_samples = samples;
+    m_lines = lines;
+    m_bands = bands;
+    m_data.fill(NULL4, samples * lines * bands);
+  }
+
+
+  /**
+   * Constructs an overview from an Overview blob.
+   *
+   * @param blob The blob to read the overview from
+   */
+  CubeOverview::CubeOverview(Blob &blob) {
+    PvlObject &label = blob.Label();
+    m_scale = toInt(label["Scale"][0]);
+    m_samples = toInt(label["Samples"][0]);
+    m_lines = toInt(label["Lines"][0]);
+    m_bands = toInt(label["Bands"][0]);
+
+    int pixelCount = m_samples * m_lines * m_bands;
+    if (blob.Size() != pixelCount * (int)sizeof(float)) {
+      QString msg = "The overview [" + blob.Name() + "] has [" + toString(blob.Size()) +
+                    "] bytes but its dimensions require [" +
+                    toString(pixelCount * (int)sizeof(float)) + "] bytes";
+      throw IException(IException::Io, msg, _FILEINFO_);
+    }
+
+    m_data.resize(pixelCount);
+    const uchar *raw = (const uchar *)blob.getBuffer();
+    for (int i = 0; i < pixelCount; i++) {
+      quint32 bits = qFromLittleEndian<quint32>(raw + i * sizeof(float));
+      memcpy(&m_data[i], &bits, sizeof(float));
+    }
+  }
+
+
+  //! Destroys the overview
+  CubeOverview::~CubeOverview() {
+  }
+
+
+  /**
+   * Serialize the overview to a blob. The pixels are stored as little endian
+   *   32 bit floats in band sequential order.
+   *
+   * @return @b Blob a Blob containing the overview
+   */
+  Blob CubeOverview::toBlob() const {
+    Blob blob(blobName(m_scale), "Overview");
+    blob.Label() += PvlKeyword("Scale", toString(m_scale));
+    blob.Label() += PvlKeyword("Samples", toString(m_samples));
+    blob.Label() += PvlKeyword("Lines", toString(m_lines));
+    blob.Label() += PvlKeyword("Bands", toString(m_bands));
+    blob.Label() += PvlKeyword("ByteOrder", "Lsb");
+
+    int bytes = m_data.size() * sizeof(float);
+    char *raw = new char[bytes];
+    for (int i = 0; i < m_data.size(); i++) {
+      quint32 bits;
+      memcpy(&bits, &m_data[i], sizeof(float));
+      qToLittleEndian<quint32>(bits, raw + i * sizeof(float));
+    }
+    blob.takeData(raw, bytes);
+
+    return blob;
+  }
+
+
+  /**
+   * @return The cube pixels covered by one overview pixel in each direction
+   */
+  int CubeOverview::scale() const {
+    return m_scale;
+  }
+
+
+  /**
+   * @return The number of samples in the overview
+   */
+  int CubeOverview::sampleCount() const {
+    return m_samples;
+  }
+
+
+  /**
+   * @return The number of lines in the overview
+   */
+  int CubeOverview::lineCount() const {
+    return m_lines;
+  }
+
+
+  /**
+   * @return The number of bands in the overview
+   */
+  int CubeOverview::bandCount() const {
+    return m_bands;
+  }
+
+
+  /**
+   * Get an overview pixel.
+   *
+   * @param sample The one-based overview sample
+   * @param line The one-based overview line
+   * @param band The one-based physical band
+   *
+   * @return The pixel, or NULL if it is outside of the overview
+   */
+  double CubeOverview::value(int sample, int line, int band) const {
+    if (sample < 1 || sample > m_samples || line < 1 || line > m_lines ||
+        band < 1 || band > m_bands) {
+      return Null;
+    }
+
+    return TestPixel(m_data[((band - 1) * m_lines + (line - 1)) * m_samples + (sample - 1)]);
+  }
+
+
+  /**
+   * Get the overview pixel that covers a cube position.
+   *
+   * @param sample The cube sample, pixel centers are at whole numbers
+   * @param line The cube line, pixel centers are at whole numbers
+   * @param band The one-based physical band
+   *
+   * @return The overview pixel, or NULL if the position is outside of the cube
+   */
+  double CubeOverview::cubeValue(double sample, double line, int band) const {
+    if (sample < 0.5 || line < 0.5) {
+      return Null;
+    }
+
+    int cubeSample = (int)(sample + 0.5);
+    int cubeLine = (int)(line + 0.5);
+    return value((cubeSample - 1) / m_scale + 1, (cubeLine - 1) / m_scale + 1, band);
+  }
+
+
+  /**
+   * Set an overview pixel.
+   *
+   * @param sample The one-based overview sample
+   * @param line The one-based overview line
+   * @param band The one-based physical band
+   * @param dn The new pixel value
+   */
+  void CubeOverview::setValue(int sample, int line, int band, double dn) {
+    m_data[((band - 1) * m_lines + (line - 1)) * m_samples + (sample - 1)] = TestPixel(dn);
+  }
+
+
+  /**
+   * @param band The one-based physical band
+   *
+   * @return All of the pixels in a band, for computing statistics and
+   *   histograms
+   */
+  QVector<double> CubeOverview::bandValues(int band) const {
+    int bandSize = m_samples * m_lines;
+    QVector<double> result(bandSize);
+
+    const float *bandData = m_data.constData() + (band - 1) * bandSize;
+    for (int i = 0; i < bandSize; i++) {
+      result[i] = TestPixel(bandData[i]);
+    }
+
+    return result;
+  }
+
+
+  /**
+   * @param scale An overview scale
+   *
+   * @return The name of the Overview blob for the scale
+   */
+  QString CubeOverview::blobName(int scale) {
+    return "Overview" + toString(scale);
+  }
+
+
+  /**
+   * @param cube The cube to look in
+   *
+   * @return The scales of the overviews stored in the cube, finest first
+   */
+  QList<int> CubeOverview::scales(Cube &cube) {
+    QList<int> result;
+
+    Pvl *label = cube.label();
+    for (int i = 0; label && i < label->objects(); i++) {
+      const PvlObject &obj = label->object(i);
+      if (obj.isNamed("Overview") && obj.hasKeyword("Scale")) {
+        result.append(toInt(obj["Scale"][0]));
+      }
+    }
+
+    std::sort(result.begin(), result.end());
+    return result;
+  }
+
+
+  /**
+   * Pick the overview for drawing the cube at a zoom factor. This is the
+   *   coarsest overview that still has at least one pixel per screen pixel.
+   *
+   * @param cube The cube that will be drawn
+   * @param zoomFactor Screen pixels per cube pixel
+   *
+   * @return The overview scale, or 0 if the cube itself should be used
+   */
+  int CubeOverview::nearestScale(Cube &cube, double zoomFactor) {
+    int result = 0;
+
+    if (zoomFactor <= 0.0 || zoomFactor > 0.5) {
+      return result;
+    }
+
+    QList<int> available = scales(cube);
+    for (int i = 0; i < available.size(); i++) {
+      if (available[i] <= 1.0 / zoomFactor) {
+        result = available[i];
+      }
+    }
+
+    return result;
+  }
+
+
+  /**
+   * Pick the overview for sampling the cube's DNs, for example to compute a
+   *   histogram for a stretch. This is the finest overview with at most
+   *   maxPixels pixels per band, or the coarsest overview if they are all
+   *   larger.
+   *
+   * @param cube The cube to sample
+   * @param maxPixels The most pixels per band worth reading
+   *
+   * @return The overview scale, or 0 if the cube is small enough to read
+   *   directly or has no overviews
+   */
+  int CubeOverview::samplingScale(Cube &cube, int maxPixels) {
+    if ((BigInt)cube.sampleCount() * cube.lineCount() <= maxPixels) {
+      return 0;
+    }
+
+    QList<int> available = scales(cube);
+    for (int i = 0; i < available.size(); i++) {
+      BigInt samples = (cube.sampleCount() + available[i] - 1) / available[i];
+      BigInt lines = (cube.lineCount() + available[i] - 1) / available[i];
+      if (samples * lines <= maxPixels) {
+        return available[i];
+      }
+    }
+
+    return available.isEmpty() ? 0 : available.last();
+  }
+
+
+  /**
+   * Remove all of the overviews from a cube, for example because its DNs
+   *   changed and the overviews no longer match them.
+   *
+   * @param cube The cube to remove the overviews from
+   *
+   * @return The number of overviews that were removed
+   */
+  int CubeOverview::remove(Cube &cube) {
+    QList<int> available = scales(cube);
+    for (int i = 0; i < available.size(); i++) {
+      cube.deleteBlob(blobName(available[i]), "Overview");
+    }
+
+    return available.size();
+  }
+
+
+  /**
+   * Read an overview from a cube.
+   *
+   * @param cube The cube to read from
+   * @param scale The scale of the overview
+   *
+   * @return The overview
+   */
+  CubeOverview CubeOverview::read(Cube &cube, int scale) {
+    Blob overviewBlob(blobName(scale), "Overview");
+    try {
+      cube.read(overviewBlob);
+    }
+    catch (IException &e) {
+      QString msg = "Unable to read the scale [" + toString(scale) + "] overview "
+                    "from [" + cube.fileName() + "]";
+      throw IException(e, IException::User, msg, _FILEINFO_);
+    }
+
+    return CubeOverview(overviewBlob);
+  }
+
+
+  /**
+   * Build overviews of a cube. The cube is read once, line by line, for all
+   *   of the scales together. Overviews hold the physical bands of the cube,
+   *   so a cube opened with virtual bands has to select every physical band.
+   *
+   * @param cube The cube to build overviews of
+   * @param scales The scales of the overviews to build
+   * @param progress If not NULL, this reports one step per cube line
+   *
+   * @return The overviews, in the order of scales
+   */
+  QList<CubeOverview> CubeOverview::build(Cube &cube, const QList<int> &scales,
+                                          Progress *progress) {
+    int samples = cube.sampleCount();
+    int lines = cube.lineCount();
+    int bands = toInt(cube.label()->findObject("IsisCube").findObject("Core")
+                      .findGroup("Dimensions")["Bands"][0]);
+
+    QVector<bool> bandRead(bands, false);
+    for (int virtualBand = 1; virtualBand <= cube.bandCount(); virtualBand++) {
+      bandRead[cube.physicalBand(virtualBand) - 1] = true;
+    }
+
+    if (bandRead.contains(false)) {
+      QString msg = "Overviews of [" + cube.fileName() + "] need all of its [" +
+                    toString(bands) + "] bands, do not select bands when opening it";
+      throw IException(IException::User, msg, _FILEINFO_);
+    }
+
+    QList<CubeOverview> overviews;
+    // Running sums, valid pixel counts and fallback special pixel values for
+    //   the overview line being accumulated at each scale
+    QList< QVector<double> > sums;
+    QList< QVector<int> > counts;
+    QList< QVector<double> > specials;
+
+    for (int i = 0; i < scales.size(); i++) {
+      int scale = scales[i];
+      int overviewSamples = (samples + scale - 1) / scale;
+      overviews.append(CubeOverview(scale, overviewSamples,
+                                    (lines + scale - 1) / scale, bands));
+      sums.append(QVector<double>(overviewSamples, 0.0));
+      counts.append(QVector<int>(overviewSamples, 0));
+      specials.append(QVector<double>(overviewSamples, Null));
+    }
+
+    if (progress) {
+      progress->SetMaximumSteps(lines * cube.bandCount());
+      progress->CheckStatus();
+    }
+
+    LineManager line(cube);
+    for (line.begin(); !line.end(); line++) {
+      cube.read(line);
+      int cubeLine = line.Line();
+
+      for (int i = 0; i < overviews.size(); i++) {
+        int scale = overviews[i].scale();
+        QVector<double> &sum = sums[i];
+        QVector<int> &count = counts[i];
+        QVector<double> &special = specials[i];
+
+        bool firstLineOfBlock = ((cubeLine - 1) % scale == 0);
+        for (int sample = 0; sample < samples; sample++) {
+          int overviewSample = sample / scale;
+          double dn = line[sample];
+
+          if (firstLineOfBlock && sample % scale == 0) {
+            special[overviewSample] = dn;
+          }
+
+          if (IsValidPixel(dn)) {
+            sum[overviewSample] += dn;
+            count[overviewSample]++;
+          }
+        }
+
+        if (cubeLine % scale == 0 || cubeLine == lines) {
+          int overviewLine = (cubeLine - 1) / scale + 1;
+          for (int overviewSample = 0; overviewSample < sum.size(); overviewSample++) {
+            double dn = special[overviewSample];
+            if (count[overviewSample] > 0) {
+              dn = sum[overviewSample] / count[overviewSample];
+            }
+            overviews[i].setValue(overviewSample + 1, overviewLine,
+                                  cube.physicalBand(line.Band()), dn);
+          }
+
+          sum.fill(0.0);
+          count.fill(0);
+        }
+      }
+
+      if (progress) {
+        progress->CheckStatus();
+      }
+    }
+
+    return overviews;
+  }
+}
@@ -0,0 +1,91 @@
+#ifndef CubeOverview_h
+#define CubeOverview_h
+
+/** This is free and unencumbered software released into the public domain.
+The authors of ISIS do not claim copyright on the contents of this file.
+For more details about the LICENSE terms and the AUTHORS, you will
+find files of those names at the top level of this repository. **/
+
+/* SPDX-License-Identifier: CC0-1.0 */
+
+#include <QList>
+#include <QVector>
+
+#include "Blob.h"
+
+namespace Isis {
+  class Cube;
+  class Progress;
+
+  /**
+   * @brief A reduced resolution copy of a cube's DNs.
+   *
+   * An overview holds the cube at 1/scale of its resolution in each of the
+   *   sample and line directions. Each overview pixel is the average of the
+   *   valid cube pixels it covers. If it covers no valid pixels it gets the
+   *   special pixel value of its top left cube pixel.
+   *
+   * Overviews are stored in the cube as Overview blobs, one per scale, and
+   *   are built by the cubeoverviews application. Displays and samplers use
+   *   nearestScale() to pick the coarsest overview that still has enough
+   *   detail for what they need, and fall back to the cube itself when there
+   *   is none.
+   *
+   * The pixels are kept as 32 bit floats, so a scale 2 overview of a Real
+   *   cube uses a quarter of the cube's space. Each overview has to fit in a
+   *   single blob (2GB).
+   *
+   * Overviews are not updated when the cube's DNs change. Anything that edits
+   *   DNs in place should remove() them.
+   *
+   * @ingroup LowLevelCubeIO
+   *
+   * @author 2026-10-16 ISIS Development Team
+   *
+   * @internal
+   *   @history 2026-10-17 ISIS Development Team - build() stores virtual bands
+   *                           at their physical band. Added remove().
+   */
+  class CubeOverview {
+    public:
+      CubeOverview(int scale, int samples, int lines, int bands);
+      CubeOverview(Blob &blob);
+      ~CubeOverview();
+
+      Blob toBlob() const;
+
+      int scale() const;
+      int sampleCount() const;
+      int lineCount() const;
+      int bandCount() const;
+
+      double value(int sample, int line, int band) const;
+      double cubeValue(double sample, double line, int band) const;
+      void setValue(int sample, int line, int band, double dn);
+
+      QVector<double> bandValues(int band) const;
+
+      static QString blobName(int scale);
+      static QList<int> scales(Cube &cube);
+      static int nearestScale(Cube &cube, double zoomFactor);
+      static int samplingScale(Cube &cube, int maxPixels = 4 * 1024 * 1024);
+      static CubeOverview read(Cube &cube, int scale);
+      static int remove(Cube &cube);
+      static QList<CubeOverview> build(Cube &cube, const QList<int> &scales,
+                                       Progress *progress = NULL);
+
+    private:
+      //! The cube pixels covered by one overview pixel in each direction
+      int m_scale;
+      //! The number of samples in the overview
+      int m_samples;
+      //! The number of lines in the overview
+      int m_lines;
+      //! The number of physical bands in the overview
+      int m_bands;
+      //! The pixels, band sequential
+      QVector<float> m_data;
+  };
+}
+
+#endif
@@ -7,6 +7,7 @@ find files of those names at the top level of this repository. **/
 
 #include "EmbreeShapeModel.h"
 
+#include <limits>
 #include <numeric>
 #include <float.h>
 
@@ -351,6 +352,108 @@ namespace Isis {
   }
 
 
+  /**
+   * Compute the intersections of many look directions from one observer with
+   * the target shape. All of the rays are traced with one call, so Embree can
+   * trace them in packets. This is much faster than calling intersectSurface
+   * for each pixel of an image line.
+   *
+   * The intersection closest to the observer is found for each look
+   * direction. The internal surface point and normal are not changed.
+   *
+   * @param observerPos Position of the observer in body-fixed kilometers
+   * @param lookDirections Unit look directions from the observer
+   * @param[out] intersections The intersection and surface normal for each look
+   *                           direction. Entries for look directions that miss
+   *                           the target are left at their defaults.
+   *
+   * @return @b QVector<bool> If each look direction intersects the target
+   */
+  QVector<bool> EmbreeShapeModel::intersectSurfaces(const std::vector<double> &observerPos,
+                                                    const QVector< std::vector<double> > &lookDirections,
+                                                    QVector<RayHitInformation> &intersections) {
+    // Create a ray from the observer in each look direction
+    std::vector<RTCRayHit> rays(lookDirections.size());
+    for (int i = 0; i < lookDirections.size(); i++) {
+      RTCRayHit &ray = rays[i];
+      ray.ray.org_x = observerPos[0];
+      ray.ray.org_y = observerPos[1];
+      ray.ray.org_z = observerPos[2];
+      ray.ray.dir_x = lookDirections[i][0];
+      ray.ray.dir_y = lookDirections[i][1];
+      ray.ray.dir_z = lookDirections[i][2];
+      ray.ray.tnear = 0.0;
+      ray.ray.tfar = std::numeric_limits<float>::infinity();
+      ray.ray.mask = 0xFFFFFFFF;
+      ray.hit.instID[0] = RTC_INVALID_GEOMETRY_ID;
+      ray.hit.geomID = RTC_INVALID_GEOMETRY_ID;
+      ray.hit.primID = RTC_INVALID_GEOMETRY_ID;
+    }
+
+    m_targetShape->intersectRays(rays);
+
+    QVector<bool> hasIntersections(lookDirections.size(), false);
+    intersections.fill(RayHitInformation(), lookDirections.size());
+    for (int i = 0; i < lookDirections.size(); i++) {
+      if (rays[i].hit.geomID != RTC_INVALID_GEOMETRY_ID) {
+        intersections[i] = m_targetShape->getHitInformation(rays[i]);
+        hasIntersections[i] = true;
+      }
+    }
+
+    return hasIntersections;
+  }
+
+
+  /**
+   * Check if intersections are occluded from a position, such as the
+   * observer or the sun. Like the occlusion check in intersectSurface, a ray
+   * is cast from the position to each intersection and it is occluded if the
+   * ray hits any other plate before it gets there. All of the rays are traced
+   * with one call.
+   *
+   * @param position The position to check in body-fixed kilometers
+   * @param intersections Intersections found by intersectSurfaces
+   * @param hasIntersections If each intersection is valid. Intersections that
+   *                         are not valid are reported as occluded.
+   *
+   * @return @b QVector<bool> If each intersection is occluded from the position
+   */
+  QVector<bool> EmbreeShapeModel::isOccludedFrom(const std::vector<double> &position,
+                                                 const QVector<RayHitInformation> &intersections,
+                                                 const QVector<bool> &hasIntersections) {
+    LinearAlgebra::Vector positionVector = LinearAlgebra::vector(position[0],
+                                                                 position[1],
+                                                                 position[2]);
+
+    // Only trace rays from the valid intersections
+    QVector<int> rayIndices;
+    std::vector<RTCOcclusionRay> rays;
+    for (int i = 0; i < intersections.size(); i++) {
+      if ( !hasIntersections[i] ) {
+        continue;
+      }
+
+      LinearAlgebra::Vector toIntersection = intersections[i].intersection - positionVector;
+      RTCOcclusionRay ray(positionVector, LinearAlgebra::normalize(toIntersection));
+      // Stop at the intersection and ignore the intersected plate
+      ray.ray.tnear = 0.0;
+      ray.ray.tfar = LinearAlgebra::magnitude(toIntersection);
+      ray.ignorePrimID = intersections[i].primID;
+      rays.push_back(ray);
+      rayIndices.append(i);
+    }
+
+    std::vector<bool> rayOccluded = m_targetShape->isOccluded(rays);
+
+    QVector<bool> occluded(intersections.size(), true);
+    for (int i = 0; i < rayIndices.size(); i++) {
+      occluded[rayIndices[i]] = rayOccluded[i];
+    }
+    return occluded;
+  }
+
+
   /**
    * Update the ShapeModel given an intersection and normal.
    * 
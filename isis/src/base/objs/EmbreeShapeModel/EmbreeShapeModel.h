@@ -33,6 +33,12 @@ namespace Isis {
    *   @history 2017-04-22 Jesse Mapel and Jeannie Backer - Original Version
    *   @history 2018-05-01 Christopher Combs - Removed emissionAngle function to
    *                fix issues with using ellipsoids to find normals. Fixes #5387.
+   *   @history 2026-10-16 ISIS Development Team - Added intersectSurfaces and
+   *                isOccludedFrom, which trace many look directions at once, so
+   *                whole image lines can be traced in ray packets.
+   *   @history 2026-10-17 ISIS Development Team - isOccludedFrom casts its rays
+   *                from the position to the intersections, the same way the
+   *                occlusion check in intersectSurface does.
    */
   class EmbreeShapeModel : public ShapeModel {
     public:
@@ -56,6 +62,14 @@ namespace Isis {
                                     const std::vector<double> &observerPos,
                                     const bool &backCheck = true);
 
+      // Intersect many look directions at once
+      QVector<bool> intersectSurfaces(const std::vector<double> &observerPos,
+                                      const QVector< std::vector<double> > &lookDirections,
+                                      QVector<RayHitInformation> &intersections);
+      QVector<bool> isOccludedFrom(const std::vector<double> &position,
+                                   const QVector<RayHitInformation> &intersections,
+                                   const QVector<bool> &hasIntersections);
+
       virtual void clearSurfacePoint();
 
       virtual bool isDEM() const;
@@ -22,6 +22,16 @@ find files of those names at the top level of this repository. **/
 
 namespace Isis {
 
+  /**
+   * The version of Embree the mesh caches are written with.
+   *
+   * @return @b QString The engine version for ShapeMeshCache
+   */
+  static QString meshCacheEngineVersion() {
+    return QString(RTC_VERSION_STRING);
+  }
+
+
   /**
    * Default constructor for RTCMultiHitRay.
    */
@@ -190,6 +200,32 @@ namespace Isis {
   }
 
 
+  /**
+   * Constructs a context for tracing a single ray.
+   */
+  RTCRayStreamContext::RTCRayStreamContext()
+      : isStream(false),
+        occlusionRays(NULL) {
+    rtcInitIntersectContext(this);
+  }
+
+
+  /**
+   * Constructs a context for tracing a stream of rays. The rays of a stream
+   * usually come from one observer and neighboring pixels, so Embree is told
+   * that they are coherent.
+   *
+   * @param rays The stream of occlusion rays being traced, or NULL if the
+   *             stream is being intersected with the scene.
+   */
+  RTCRayStreamContext::RTCRayStreamContext(const RTCOcclusionRay *rays)
+      : isStream(true),
+        occlusionRays(rays) {
+    rtcInitIntersectContext(this);
+    flags = RTC_INTERSECT_CONTEXT_FLAG_COHERENT;
+  }
+
+
   /**
    * Default constructor for RayHitInformation
    */
@@ -224,8 +260,11 @@ namespace Isis {
    */
   EmbreeTargetShape::EmbreeTargetShape()
       : m_name(),
-        m_mesh(),
-        m_cloud(),
+        m_vertices(NULL),
+        m_triangles(NULL),
+        m_numVertices(0),
+        m_numTriangles(0),
+        m_meshCache(),
         m_device(rtcNewDevice(NULL)),
         m_scene(rtcNewScene(m_device)) 
   {
@@ -241,8 +280,11 @@ namespace Isis {
    */
   EmbreeTargetShape::EmbreeTargetShape(pcl::PolygonMesh::Ptr mesh, const QString &name)
       : m_name(name),
-        m_mesh(),
-        m_cloud(),
+        m_vertices(NULL),
+        m_triangles(NULL),
+        m_numVertices(0),
+        m_numTriangles(0),
+        m_meshCache(),
         m_device(rtcNewDevice(NULL)),
         m_scene(rtcNewScene(m_device))
   {
@@ -254,6 +296,10 @@ namespace Isis {
   /**
    * Constructs an EmbreeTargetShape from a file.
    * 
+   * If the ShapeMeshCache preference allows it, the vertices and triangles
+   * are shared from a mesh cache next to the file instead. Embree still builds
+   * its acceleration structure, it cannot be saved.
+   * 
    * @param dem The file to construct the target shape from. The file type is determined
    *            based on the file extension.
    * @param conf Pvl containing configuration settings for the target shape.
@@ -263,8 +309,11 @@ namespace Isis {
    */
   EmbreeTargetShape::EmbreeTargetShape(const QString &dem, const Pvl *conf)
       : m_name(),
-        m_mesh(),
-        m_cloud(),
+        m_vertices(NULL),
+        m_triangles(NULL),
+        m_numVertices(0),
+        m_numTriangles(0),
+        m_meshCache(),
         m_device(rtcNewDevice(NULL)),
         m_scene(rtcNewScene(m_device)) {
     rtcSetSceneFlags(m_scene, RTC_SCENE_FLAG_ROBUST | RTC_SCENE_FLAG_CONTEXT_FILTER_FUNCTION);
@@ -273,6 +322,15 @@ namespace Isis {
     pcl::PolygonMesh::Ptr mesh;
     m_name = file.baseName();
 
+    ShapeMeshCache::CacheMode cacheMode = ShapeMeshCache::preferredMode();
+    if (cacheMode != ShapeMeshCache::NoCache) {
+      m_meshCache.reset(new ShapeMeshCache(dem, "embree", meshCacheEngineVersion()));
+      if (m_meshCache->map() && initMesh(m_meshCache.data())) {
+        return;
+      }
+      m_meshCache.reset();
+    }
+
     try {
       // DEMs (ISIS cubes) TODO implement this
       if (file.extension() == "cub") {
@@ -294,6 +352,10 @@ namespace Isis {
       throw IException(e, IException::Io, msg, _FILEINFO_);
     }
     initMesh(mesh);
+
+    if (cacheMode == ShapeMeshCache::ReadWriteCache) {
+      writeMeshCache(dem);
+    }
   }
 
 
@@ -431,16 +493,15 @@ namespace Isis {
 
 
   /**
-   * Internalize a PointCloudLibrary polygon mesh in the target shape. The mesh
-   * itself is stored along with a duplicate of the vertex point cloud because
-   * the point cloud stored in the polygon mesh cannot be read without
-   * Robot Operating System routines. The mesh is loaded into the internal
-   * Embree scene and the scene is commited. Any changes made to the Embree
-   * scene after this method is called will not take effect until
+   * Internalize a PointCloudLibrary polygon mesh in the target shape. The
+   * vertices and polygons are copied into the Embree buffers, which are also
+   * used to compute intersections, so the mesh is not kept. The mesh is loaded
+   * into the internal Embree scene and the scene is commited. Any changes made
+   * to the Embree scene after this method is called will not take effect until
    * embree::rtcCommit is called again.
    * 
    * @note This method is NOT reentrant. Calling this again with a new mesh
-   *       will remove the PointCloudLibrary representation of the old mesh
+   *       will replace the vertices and triangles used for intersections
    *       but the Embree scene will contain all previous meshes along with
    *       the new mesh. Use embree::rtcDeleteGeometry to remove an old mesh
    *       from the scene.
@@ -448,37 +509,122 @@ namespace Isis {
    * @param mesh The mesh to be internalized.
    */
   void EmbreeTargetShape::initMesh(pcl::PolygonMesh::Ptr mesh) {
-    m_mesh = mesh;
+    if (!mesh) {
+      return;
+    }
 
     // The points are stored in a pcl::PCLPointCloud2 object that we cannot used.
     // So, convert them into a pcl::PointCloud<pcl::PointXYZ> object that we can use.
-    pcl::fromPCLPointCloud2(mesh->cloud, m_cloud);
+    pcl::PointCloud<pcl::PointXYZ> cloud;
+    pcl::fromPCLPointCloud2(mesh->cloud, cloud);
+    int numVertices = mesh->cloud.height * mesh->cloud.width;
+    int numTriangles = mesh->polygons.size();
 
     // Create a static geometry (the body) in our scene
     RTCGeometry rtcMesh = rtcNewGeometry(m_device, RTC_GEOMETRY_TYPE_TRIANGLE);
-    // Add vertices and faces (indices)
-    if (!isValid()) {
-      return;
-    }
+
     // Add the body's vertices to the Embree ray tracing device's vertex buffer
-    Vertex *vertices = (Vertex *)rtcSetNewGeometryBuffer(rtcMesh, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3, sizeof(Vertex), numberOfVertices());
-    for (int v = 0; v < numberOfVertices(); ++v) {
-      vertices[v].x = m_cloud.points[v].x;
-      vertices[v].y = m_cloud.points[v].y;
-      vertices[v].z = m_cloud.points[v].z;
+    Vertex *vertices = (Vertex *)rtcSetNewGeometryBuffer(rtcMesh, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3, sizeof(Vertex), numVertices);
+    for (int v = 0; v < numVertices; ++v) {
+      vertices[v].x = cloud.points[v].x;
+      vertices[v].y = cloud.points[v].y;
+      vertices[v].z = cloud.points[v].z;
+      vertices[v].a = 0.0;
+    }
+
+    Triangle *triangles = (Triangle *)rtcSetNewGeometryBuffer(rtcMesh, RTC_BUFFER_TYPE_INDEX, 0, RTC_FORMAT_UINT3, sizeof(Triangle), numTriangles);
+    // Add the body's face (vertex indices) to the Embree device's index buffer
+    for (int t = 0; t < numTriangles; ++t) {
+      triangles[t].v0 = mesh->polygons[t].vertices[0];
+      triangles[t].v1 = mesh->polygons[t].vertices[1];
+      triangles[t].v2 = mesh->polygons[t].vertices[2];
     }
 
+    // The buffers belong to the geometry, which the scene keeps
+    m_vertices = vertices;
+    m_triangles = triangles;
+    m_numVertices = numVertices;
+    m_numTriangles = numTriangles;
+
+    commitMesh(rtcMesh);
+  }
+
+
+  /**
+   * Internalize the vertices and triangles in a mapped mesh cache. Embree
+   * uses them in place, so they are not copied and the memory is shared with
+   * every other process using the same cache.
+   *
+   * @param cache The mapped mesh cache. It must stay mapped as long as the
+   *              target shape exists.
+   *
+   * @return @b bool True if the cache had a valid mesh. If it did not, nothing
+   *                 is changed.
+   */
+  bool EmbreeTargetShape::initMesh(ShapeMeshCache *cache) {
+    qint64 vertexBytes = cache->blockSize("vertices");
+    qint64 triangleBytes = cache->blockSize("triangles");
+    if (vertexBytes <= 0 || vertexBytes % sizeof(Vertex) != 0 ||
+        triangleBytes <= 0 || triangleBytes % sizeof(Triangle) != 0) {
+      return false;
+    }
+
+    const Vertex *vertices = (const Vertex *) cache->block("vertices");
+    const Triangle *triangles = (const Triangle *) cache->block("triangles");
+    int numVertices = vertexBytes / sizeof(Vertex);
+    int numTriangles = triangleBytes / sizeof(Triangle);
+
+    // A damaged cache must not send Embree outside of the vertex buffer
+    for (int t = 0; t < numTriangles; ++t) {
+      if (triangles[t].v0 < 0 || triangles[t].v0 >= numVertices ||
+          triangles[t].v1 < 0 || triangles[t].v1 >= numVertices ||
+          triangles[t].v2 < 0 || triangles[t].v2 >= numVertices) {
+        return false;
+      }
+    }
+
+    RTCGeometry rtcMesh = rtcNewGeometry(m_device, RTC_GEOMETRY_TYPE_TRIANGLE);
+    rtcSetSharedGeometryBuffer(rtcMesh, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3,
+                               vertices, 0, sizeof(Vertex), numVertices);
+    rtcSetSharedGeometryBuffer(rtcMesh, RTC_BUFFER_TYPE_INDEX, 0, RTC_FORMAT_UINT3,
+                               triangles, 0, sizeof(Triangle), numTriangles);
+
+    m_vertices = vertices;
+    m_triangles = triangles;
+    m_numVertices = numVertices;
+    m_numTriangles = numTriangles;
+
+    commitMesh(rtcMesh);
+    return true;
+  }
+
+
+  /**
+   * Write the internalized vertices and triangles to the mesh cache of a
+   * shape file, so the next process that uses it does not have to read the
+   * shape file. Failing to write the cache is not an error.
+   *
+   * @param shapeFile The shape file the target shape was created from.
+   */
+  void EmbreeTargetShape::writeMeshCache(const QString &shapeFile) const {
     if (!isValid()) {
       return;
     }
-    Triangle *triangles = (Triangle *)rtcSetNewGeometryBuffer(rtcMesh, RTC_BUFFER_TYPE_INDEX, 0, RTC_FORMAT_UINT3, sizeof(Triangle), numberOfPolygons());
-    // Add the body's face (vertex indices) to the Embree device's index buffer
-    for (int t = 0; t < numberOfPolygons(); ++t) {
-      triangles[t].v0 = m_mesh->polygons[t].vertices[0];
-      triangles[t].v1 = m_mesh->polygons[t].vertices[1];
-      triangles[t].v2 = m_mesh->polygons[t].vertices[2];
-    }
 
+    ShapeMeshCache cache(shapeFile, "embree", meshCacheEngineVersion());
+    cache.addBlock("vertices", m_vertices, (qint64) m_numVertices * sizeof(Vertex));
+    cache.addBlock("triangles", m_triangles, (qint64) m_numTriangles * sizeof(Triangle));
+    cache.write();
+  }
+
+
+  /**
+   * Add the filter functions to a triangle geometry, attach it to the scene
+   * and commit the scene. This builds the acceleration structure.
+   *
+   * @param rtcMesh The geometry holding the target's vertices and triangles.
+   */
+  void EmbreeTargetShape::commitMesh(RTCGeometry rtcMesh) {
     // Add the multi-hit filter
     rtcSetGeometryIntersectFilterFunction(rtcMesh, EmbreeTargetShape::multiHitFilter);
 
@@ -486,7 +632,7 @@ namespace Isis {
     rtcSetGeometryOccludedFilterFunction(rtcMesh, EmbreeTargetShape::occlusionFilter);
 
     rtcCommitGeometry(rtcMesh);
-    unsigned int geomID = rtcAttachGeometry(m_scene, rtcMesh);
+    rtcAttachGeometry(m_scene, rtcMesh);
     rtcReleaseGeometry(rtcMesh);
 
     // Done, now we can perform some ray tracing
@@ -562,7 +708,7 @@ namespace Isis {
    */
   int EmbreeTargetShape::numberOfPolygons() const {
     if (isValid()) {
-      return m_mesh->polygons.size();
+      return m_numTriangles;
     }
     return 0;
   }
@@ -576,7 +722,7 @@ namespace Isis {
    */
   int EmbreeTargetShape::numberOfVertices() const {
     if (isValid()) {
-      return m_mesh->cloud.height * m_mesh->cloud.width;
+      return m_numVertices;
     }
     return 0;
   }
@@ -656,8 +802,7 @@ namespace Isis {
    */
   void EmbreeTargetShape::intersectRay(RTCMultiHitRay &ray) {
     if (isValid()) {
-      RTCIntersectContext context;
-      rtcInitIntersectContext(&context);
+      RTCRayStreamContext context;
 
       rtcIntersect1(m_scene, &context, (RTCRayHit *)&ray);
     }
@@ -672,8 +817,7 @@ namespace Isis {
    * @see embree::rtcOccluded
    */
   bool EmbreeTargetShape::isOccluded(RTCOcclusionRay &ray) {
-    RTCIntersectContext context;
-    rtcInitIntersectContext(&context);
+    RTCRayStreamContext context;
 
     rtcOccluded1(m_scene,  &context, (RTCRay*)&ray);
 
@@ -685,6 +829,72 @@ namespace Isis {
   }
 
 
+  /**
+   * Intersect a stream of rays with the target shape. Unlike intersectRay,
+   * only the intersection closest to the origin of each ray is found. It is
+   * stored in the hit member of the ray. Rays that do not intersect the
+   * target are left with a geomID of RTC_INVALID_GEOMETRY_ID.
+   *
+   * The whole stream is traced with one call, so Embree can trace the rays
+   * in packets with the vector instructions of the processor. This is much
+   * faster than intersecting the rays one at a time when they come from
+   * neighboring pixels of an image.
+   *
+   * @param[in,out] rays The rays to intersect with the scene. The id of each
+   *                     ray is set to its index in the vector.
+   *
+   * @see embree::rtcIntersect1M
+   */
+  void EmbreeTargetShape::intersectRays(std::vector<RTCRayHit> &rays) {
+    if (!isValid() || rays.empty()) {
+      return;
+    }
+
+    for (size_t i = 0; i < rays.size(); i++) {
+      rays[i].ray.id = i;
+      rays[i].ray.flags = 0;
+    }
+
+    RTCRayStreamContext context(NULL);
+    rtcIntersect1M(m_scene, &context, rays.data(), rays.size(), sizeof(RTCRayHit));
+  }
+
+
+  /**
+   * Check if each ray in a stream intersects the target body. The primitive
+   * stored in the ignorePrimID member of each ray is ignored, like it is by
+   * isOccluded for a single ray.
+   *
+   * @param[in,out] rays The rays to check. The id of each ray is set to its
+   *                     index in the vector.
+   *
+   * @return @b std::vector<bool> If each ray intersects anything.
+   *
+   * @see embree::rtcOccluded1M
+   */
+  std::vector<bool> EmbreeTargetShape::isOccluded(std::vector<RTCOcclusionRay> &rays) {
+    std::vector<bool> occluded(rays.size(), false);
+    if (rays.empty()) {
+      return occluded;
+    }
+
+    for (size_t i = 0; i < rays.size(); i++) {
+      rays[i].ray.id = i;
+      rays[i].ray.flags = 0;
+    }
+
+    RTCRayStreamContext context(rays.data());
+    rtcOccluded1M(m_scene, &context, (RTCRay *)rays.data(), rays.size(),
+                  sizeof(RTCOcclusionRay));
+
+    // rtcOccluded sets the ray.tfar to -inf if the ray hits anything
+    for (size_t i = 0; i < rays.size(); i++) {
+      occluded[i] = isinf(rays[i].ray.tfar) && rays[i].ray.tfar < 0;
+    }
+    return occluded;
+  }
+
+
   /**
    * Extract the intersection point and unit surface normal from an
    * RTCMultiHitRay that has been intersected with the target shape. This
@@ -710,17 +920,53 @@ namespace Isis {
       throw IException(IException::Programmer, msg, _FILEINFO_);
     }
 
+    return hitInformation(ray.hitPrimIDs[hitIndex], ray.hitUs[hitIndex], ray.hitVs[hitIndex]);
+  }
+
+
+  /**
+   * Extract the intersection point and unit surface normal from a ray that
+   * has been intersected with the target shape by intersectRays. The same
+   * calculations as the multiple hit version are used.
+   *
+   * @param ray The ray to extract intersection information from.
+   *
+   * @return @b RayHitInformation The body-fixed intersection coordinate in
+   *                              kilometers and the unit surface normal at the
+   *                              intersection.
+   *
+   * @throws IException::Programmer
+   */
+  RayHitInformation EmbreeTargetShape::getHitInformation(const RTCRayHit &ray) {
+    if (ray.hit.geomID == RTC_INVALID_GEOMETRY_ID) {
+      QString msg = "The ray does not intersect the target.";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
+
+    return hitInformation(ray.hit.primID, ray.hit.u, ray.hit.v);
+  }
+
+
+  /**
+   * Compute the body-fixed intersection point from barycentric coordinates
+   * relative to a polygon and the unit normal vector of the polygon.
+   *
+   * @param primID The index of the intersected polygon.
+   * @param u The barycentric u coordinate of the intersection.
+   * @param v The barycentric v coordinate of the intersection.
+   *
+   * @return @b RayHitInformation The intersection and unit surface normal.
+   */
+  RayHitInformation EmbreeTargetShape::hitInformation(unsigned primID, float u, float v) {
     // Get the vertices of the triangle hit
-    pcl::PointXYZ v0 = m_cloud.points[m_mesh->polygons[ray.hitPrimIDs[hitIndex]].vertices[0]];
-    pcl::PointXYZ v1 = m_cloud.points[m_mesh->polygons[ray.hitPrimIDs[hitIndex]].vertices[1]];
-    pcl::PointXYZ v2 = m_cloud.points[m_mesh->polygons[ray.hitPrimIDs[hitIndex]].vertices[2]];
+    const Vertex &v0 = m_vertices[m_triangles[primID].v0];
+    const Vertex &v1 = m_vertices[m_triangles[primID].v1];
+    const Vertex &v2 = m_vertices[m_triangles[primID].v2];
 
     // The intersection location comes out in barycentric coordinates, (u, v, w).
     // Only u and v are returned because u + v + w = 1. If the coordinates of the
     // triangle vertices are v0, v1, and v2, then the cartesian coordinates are:
     //   w*v0 + u*v1 + v*v2
-    float u = ray.hitUs[hitIndex];
-    float v = ray.hitVs[hitIndex];
     float w = 1.0 - u - v;
 
     LinearAlgebra::Vector intersection(3);
@@ -742,7 +988,7 @@ namespace Isis {
 
     // The surface normal is not normalized so normalize it.
     surfaceNormal = LinearAlgebra::normalize(surfaceNormal);
-    return RayHitInformation(intersection, surfaceNormal, ray.hitPrimIDs[hitIndex]);
+    return RayHitInformation(intersection, surfaceNormal, primID);
   }
 
 
@@ -762,7 +1008,7 @@ namespace Isis {
    * @return @b bool If a mesh is internalized and the Embree scene is ready.
    */
   bool EmbreeTargetShape::isValid() const {
-    return m_mesh.get();
+    return m_vertices && m_triangles;
   }
 
 
@@ -780,6 +1026,11 @@ namespace Isis {
     if (args->context == nullptr)
       return;
 
+    // Streams only look for the closest hit, so every hit is accepted
+    if (((const RTCRayStreamContext *)args->context)->isStream) {
+      return;
+    }
+
     assert(args->N == 1);
     int *valid = args->valid;
     if (valid[0] != -1) {
@@ -819,6 +1070,21 @@ namespace Isis {
     if (args->context == nullptr)
       return;
 
+    // Rays in a stream are looked up by their id, which is their index in the stream
+    const RTCRayStreamContext *context = (const RTCRayStreamContext *)args->context;
+    if (context->isStream) {
+      for (unsigned int i = 0; i < args->N; i++) {
+        if (args->valid[i] != -1) {
+          continue;
+        }
+        const RTCOcclusionRay &ray = context->occlusionRays[RTCRayN_id(args->ray, args->N, i)];
+        if (RTCHitN_primID(args->hit, args->N, i) == ray.ignorePrimID) {
+          args->valid[i] = 0;
+        }
+      }
+      return;
+    }
+
     assert(args->N == 1);
     int *valid = args->valid;
     if (valid[0] != -1) {
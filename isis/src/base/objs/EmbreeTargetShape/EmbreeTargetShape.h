@@ -7,6 +7,9 @@ find files of those names at the top level of this repository. **/
 
 /* SPDX-License-Identifier: CC0-1.0 */
 
+#include <vector>
+
+#include <QScopedPointer>
 #include <QString>
 
 // Embree includes
@@ -27,6 +30,7 @@ find files of those names at the top level of this repository. **/
 
 #include "FileName.h"
 #include "LinearAlgebra.h"
+#include "ShapeMeshCache.h"
 
 namespace Isis {
 
@@ -107,6 +111,26 @@ namespace Isis {
   };
 
 
+  /**
+   * Intersection context for tracing a stream of rays with one call. Embree
+   * gathers the rays of a stream into packets of its own and the filter
+   * functions may not see the rays that were passed in, so they find them
+   * through the id of the ray instead of its address. The id of each ray is
+   * its index in the stream.
+   *
+   * @author 2026-10-16 ISIS Development Team
+   * @internal
+   *   @history 2026-10-16 ISIS Development Team - Original Version
+   */
+  struct RTCRayStreamContext : RTCIntersectContext {
+    RTCRayStreamContext();
+    RTCRayStreamContext(const RTCOcclusionRay *rays);
+
+    bool                   isStream;      //!< If a stream of rays is being traced
+    const RTCOcclusionRay *occlusionRays; //!< The stream of occlusion rays being traced
+  };
+
+
   /**
    * Container that holds the body fixed intersection point and unit surface
    * normal for a hit.
@@ -135,6 +159,15 @@ namespace Isis {
  * @author 2017-05-11 Jeannie Backer & Jesse Mapel
  * @internal 
  *   @history 2017-05-11 Jeannie Backer & Jesse Mapel - Original Version
+ *   @history 2026-10-16 ISIS Development Team - Added intersectRays and an
+ *                           isOccluded that trace streams of rays, so Embree
+ *                           can trace coherent rays in packets.
+ *   @history 2026-10-16 ISIS Development Team - The vertices and triangles are
+ *                           kept in the Embree buffers instead of a copy of the
+ *                           PointCloudLibrary mesh. They are read from a memory
+ *                           mapped ShapeMeshCache next to the shape file when
+ *                           one exists, and written to one when the
+ *                           ShapeMeshCache preference is ReadWrite.
  */
   class EmbreeTargetShape {
     public:
@@ -155,7 +188,11 @@ namespace Isis {
       void intersectRay(RTCMultiHitRay &ray);
       bool isOccluded(RTCOcclusionRay &ray);
 
+      void intersectRays(std::vector<RTCRayHit> &rays);
+      std::vector<bool> isOccluded(std::vector<RTCOcclusionRay> &rays);
+
       RayHitInformation getHitInformation(RTCMultiHitRay &ray, int hitIndex);
+      RayHitInformation getHitInformation(const RTCRayHit &ray);
 
       static void multiHitFilter(const RTCFilterFunctionNArguments *args);
       static void occlusionFilter(const RTCFilterFunctionNArguments *args);
@@ -164,8 +201,12 @@ namespace Isis {
       pcl::PolygonMesh::Ptr readDSK(FileName file);
       pcl::PolygonMesh::Ptr readPC(FileName file);
       void initMesh(pcl::PolygonMesh::Ptr mesh);
+      bool initMesh(ShapeMeshCache *cache);
+      void writeMeshCache(const QString &shapeFile) const;
       void addVertices(int geomID);
       void addIndices(int geomID);
+      RayHitInformation hitInformation(unsigned primID, float u, float v);
+      void commitMesh(RTCGeometry rtcMesh);
 
     private:
       /**
@@ -196,22 +237,25 @@ namespace Isis {
         int v2; //!< The index of the third vertex in the tin.
       };
 
-      QString                        m_name;   /**!< The name of the target. */
-      pcl::PolygonMesh::Ptr          m_mesh;   /**!< A boost shared pointer to
-                                                     the polygon mesh representation
-                                                     of the target. */
-      pcl::PointCloud<pcl::PointXYZ> m_cloud;  /**!< The point cloud representation
-                                                     of the target. This is also
-                                                     stored in the polygon mesh,
-                                                     but cannot be accessed, so
-                                                     it is duplicated here. */
-      RTCDevice                      m_device; /**!< The Embree device for rendering
-                                                     the scene. */
-      RTCScene                       m_scene;  /**!< The Embree scene that holds
-                                                     Embree's representation of
-                                                     the target body and the aabb
-                                                     tree used to accelerate ray
-                                                     tracing. */
+      QString         m_name;         /**!< The name of the target. */
+      const Vertex   *m_vertices;     /**!< The vertices of the target in the
+                                            Embree vertex buffer or the
+                                            mesh cache. */
+      const Triangle *m_triangles;    /**!< The triangles of the target in the
+                                            Embree index buffer or the
+                                            mesh cache. */
+      int             m_numVertices;  /**!< The number of vertices. */
+      int             m_numTriangles; /**!< The number of triangles. */
+      QScopedPointer<ShapeMeshCache> m_meshCache; /**!< The mapped mesh cache the
+                                                        vertices and triangles are
+                                                        shared from, if any. */
+      RTCDevice       m_device;       /**!< The Embree device for rendering
+                                            the scene. */
+      RTCScene        m_scene;        /**!< The Embree scene that holds
+                                            Embree's representation of
+                                            the target body and the aabb
+                                            tree used to accelerate ray
+                                            tracing. */
 
   };
 
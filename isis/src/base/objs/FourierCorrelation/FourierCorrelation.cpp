@@ -0,0 +1,360 @@
+/** This is free and unencumbered software released into the public domain.
+The authors of ISIS do not claim copyright on the contents of this file.
+For more details about the LICENSE terms and the AUTHORS, you will
+find files of those names at the top level of this repository. **/
+
+/* SPDX-License-Identifier: CC0-1.0 */
+#include "FourierCorrelation.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <complex>
+#include <vector>
+
+#include "Chip.h"
+#include "SpecialPixel.h"
+
+using namespace std;
+
+namespace Isis {
+  typedef complex<double> Complex;
+
+  namespace {
+    //! Variances this small compared to the whole chip are rounding error
+    const double VarianceTolerance = 1.0e-10;
+
+
+    /**
+     * @return @b int The index of an offset in a transform, negative offsets wrap
+     *         around to the end.
+     */
+    int wrap(int offset, int size) {
+      return (offset < 0) ? offset + size : offset;
+    }
+  }
+
+
+  /**
+   * Construct a FourierCorrelation.
+   *
+   * @param pvl The AutoRegistration template
+   * @param phase Do phase correlation instead of normalized cross-correlation
+   */
+  FourierCorrelation::FourierCorrelation(Pvl &pvl, bool phase) : MaximumCorrelation(pvl) {
+    m_phase = phase;
+  }
+
+
+  /**
+   * Computes the fits at every search position with fast Fourier transforms.
+   * The correlation of the pattern with the sub-search chip at a position needs
+   * the number of pixels valid in both, their sums, their sums of squares and
+   * the sum of their products. Each of those is a cross-correlation of the
+   * (masked) pattern with the (masked) search chip, and all of the
+   * cross-correlations are computed at once by multiplying their spectra.
+   *
+   * @param sChip Search chip
+   * @param pChip Pattern chip
+   * @param fChip Fit chip, the same size as the search chip and filled with
+   *              nulls
+   * @param startSamp Start sample
+   * @param endSamp End sample
+   * @param startLine Start line
+   * @param endLine End line
+   *
+   * @return @b bool Always true, the fits are always computed
+   */
+  bool FourierCorrelation::MatchFits(Chip &sChip, Chip &pChip, Chip &fChip, int startSamp,
+                                     int endSamp, int startLine, int endLine) {
+    int patternSamples = pChip.Samples();
+    int patternLines = pChip.Lines();
+    int searchSamples = sChip.Samples();
+    int searchLines = sChip.Lines();
+    int patternPixels = patternSamples * patternLines;
+
+    // The pattern tack is placed on each search position, so these are the
+    // offsets of the first pattern pixel in the search chip
+    int tackSample = (patternSamples - 1) / 2 + 1;
+    int tackLine = (patternLines - 1) / 2 + 1;
+    int minSampOffset = startSamp - tackSample;
+    int maxSampOffset = endSamp - tackSample;
+    int minLineOffset = startLine - tackLine;
+    int maxLineOffset = endLine - tackLine;
+
+    // Pad the transforms enough that the offsets we need do not wrap around
+    // onto offsets where the pattern overlaps the search chip
+    int samples = m_lineTransform.NextPowerOfTwo(
+        max(max(searchSamples - min(minSampOffset, 0), patternSamples),
+            maxSampOffset + patternSamples));
+    int lines = m_columnTransform.NextPowerOfTwo(
+        max(max(searchLines - min(minLineOffset, 0), patternLines),
+            maxLineOffset + patternLines));
+    int size = samples * lines;
+
+    // Remove the means so the sums of squares stay small enough to subtract
+    // accurately
+    double patternMean = 0.0;
+    int patternValid = 0;
+    for (int line = 1; line <= patternLines; line++) {
+      for (int samp = 1; samp <= patternSamples; samp++) {
+        if (IsValidPixel(pChip.GetValue(samp, line))) {
+          patternMean += pChip.GetValue(samp, line);
+          patternValid++;
+        }
+      }
+    }
+
+    double searchMean = 0.0;
+    int searchValid = 0;
+    for (int line = 1; line <= searchLines; line++) {
+      for (int samp = 1; samp <= searchSamples; samp++) {
+        if (IsValidPixel(sChip.GetValue(samp, line))) {
+          searchMean += sChip.GetValue(samp, line);
+          searchValid++;
+        }
+      }
+    }
+
+    if (patternValid == 0 || searchValid == 0) return true;
+    patternMean /= patternValid;
+    searchMean /= searchValid;
+
+    // Pack the masks and the pixels with their means removed in pairs
+    vector<Complex> patternMaskAndPattern(size, 0.0);
+    vector<Complex> searchMaskAndSearch(size, 0.0);
+    double patternSumSquares = 0.0;
+    double searchSumSquares = 0.0;
+    for (int line = 1; line <= patternLines; line++) {
+      for (int samp = 1; samp <= patternSamples; samp++) {
+        double dn = pChip.GetValue(samp, line);
+        if (IsValidPixel(dn)) {
+          patternMaskAndPattern[(line - 1) * samples + samp - 1] = Complex(1.0, dn - patternMean);
+          patternSumSquares += (dn - patternMean) * (dn - patternMean);
+        }
+      }
+    }
+    for (int line = 1; line <= searchLines; line++) {
+      for (int samp = 1; samp <= searchSamples; samp++) {
+        double dn = sChip.GetValue(samp, line);
+        if (IsValidPixel(dn)) {
+          searchMaskAndSearch[(line - 1) * samples + samp - 1] = Complex(1.0, dn - searchMean);
+          searchSumSquares += (dn - searchMean) * (dn - searchMean);
+        }
+      }
+    }
+
+    vector<Complex> patternMask, pattern, searchMask, search;
+    TransformPair(patternMaskAndPattern, samples, lines, patternMask, pattern);
+    TransformPair(searchMaskAndSearch, samples, lines, searchMask, search);
+
+    // The real parts of counts are the number of pixels valid in both chips.
+    // The imaginary parts are the phase correlation or the sum of the pattern.
+    vector<Complex> counts(size);
+    vector<Complex> sums;
+    vector<Complex> squares;
+    const Complex i(0.0, 1.0);
+
+    if (m_phase) {
+      vector<Complex> crossPower(size);
+      double maxMagnitude = 0.0;
+      for (int k = 0; k < size; k++) {
+        crossPower[k] = conj(pattern[k]) * search[k];
+        maxMagnitude = max(maxMagnitude, abs(crossPower[k]));
+      }
+
+      for (int k = 0; k < size; k++) {
+        double magnitude = abs(crossPower[k]);
+        if (magnitude > DBL_EPSILON * maxMagnitude) {
+          crossPower[k] /= magnitude;
+        }
+        else {
+          crossPower[k] = 0.0;
+        }
+        counts[k] = conj(patternMask[k]) * searchMask[k] + i * crossPower[k];
+      }
+      Transform(counts, samples, lines, true);
+    }
+    else {
+      // Pack the squares of the pattern and search chips in a pair too
+      vector<Complex> squaresPair(size, 0.0);
+      for (int line = 1; line <= patternLines; line++) {
+        for (int samp = 1; samp <= patternSamples; samp++) {
+          double dn = pChip.GetValue(samp, line);
+          if (IsValidPixel(dn)) {
+            squaresPair[(line - 1) * samples + samp - 1] =
+                Complex((dn - patternMean) * (dn - patternMean), 0.0);
+          }
+        }
+      }
+      for (int line = 1; line <= searchLines; line++) {
+        for (int samp = 1; samp <= searchSamples; samp++) {
+          double dn = sChip.GetValue(samp, line);
+          if (IsValidPixel(dn)) {
+            squaresPair[(line - 1) * samples + samp - 1] += Complex(0.0, (dn - searchMean) *
+                                                                         (dn - searchMean));
+          }
+        }
+      }
+
+      vector<Complex> patternSquared, searchSquared;
+      TransformPair(squaresPair, samples, lines, patternSquared, searchSquared);
+
+      // sums has the sums of the search chip and the squares of the pattern,
+      // squares has the squares of the search chip and the products
+      sums.resize(size);
+      squares.resize(size);
+      for (int k = 0; k < size; k++) {
+        Complex mask = conj(patternMask[k]);
+        Complex dn = conj(pattern[k]);
+        counts[k] = mask * searchMask[k] + i * (dn * searchMask[k]);
+        sums[k] = mask * search[k] + i * (conj(patternSquared[k]) * searchMask[k]);
+        squares[k] = mask * searchSquared[k] + i * (dn * search[k]);
+      }
+      Transform(counts, samples, lines, true);
+      Transform(sums, samples, lines, true);
+      Transform(squares, samples, lines, true);
+    }
+
+    // Count the valid pixels in each sub-search chip the same way Chip::IsValid
+    // does, with a summed area table
+    vector<int> valid((searchSamples + 1) * (searchLines + 1), 0);
+    for (int line = 1; line <= searchLines; line++) {
+      for (int samp = 1; samp <= searchSamples; samp++) {
+        valid[line * (searchSamples + 1) + samp] = (sChip.IsValid(samp, line) ? 1 : 0) +
+            valid[(line - 1) * (searchSamples + 1) + samp] +
+            valid[line * (searchSamples + 1) + samp - 1] -
+            valid[(line - 1) * (searchSamples + 1) + samp - 1];
+      }
+    }
+
+    for (int line = startLine; line <= endLine; line++) {
+      int lineOffset = line - tackLine;
+      int top = max(lineOffset, 0);
+      int bottom = min(lineOffset + patternLines, searchLines);
+
+      for (int samp = startSamp; samp <= endSamp; samp++) {
+        int sampOffset = samp - tackSample;
+        int left = max(sampOffset, 0);
+        int right = min(sampOffset + patternSamples, searchSamples);
+
+        int validCount = 0;
+        if (left < right && top < bottom) {
+          validCount = valid[bottom * (searchSamples + 1) + right] -
+                       valid[top * (searchSamples + 1) + right] -
+                       valid[bottom * (searchSamples + 1) + left] +
+                       valid[top * (searchSamples + 1) + left];
+        }
+        double validPercentage = 100.0 * (double) validCount / (double) patternPixels;
+        if (validPercentage < SubsearchValidPercent()) continue;
+
+        int k = wrap(lineOffset, lines) * samples + wrap(sampOffset, samples);
+        double n = floor(counts[k].real() + 0.5);
+        if (n <= 1.0) continue;
+        if (n / patternPixels * 100.0 < PatternValidPercent()) continue;
+
+        double fit;
+        if (m_phase) {
+          fit = counts[k].imag();
+        }
+        else {
+          double patternSum = counts[k].imag();
+          double searchSum = sums[k].real();
+          double patternSquares = sums[k].imag();
+          double searchSquares = squares[k].real();
+          double products = squares[k].imag();
+
+          double patternVariance = n * patternSquares - patternSum * patternSum;
+          double searchVariance = n * searchSquares - searchSum * searchSum;
+          if (patternVariance <= VarianceTolerance * n * patternSumSquares) continue;
+          if (searchVariance <= VarianceTolerance * n * searchSumSquares) continue;
+
+          double covariance = n * products - patternSum * searchSum;
+          fit = min(fabs(covariance) / sqrt(patternVariance * searchVariance), 1.0);
+        }
+
+        fChip.SetValue(samp, line, fit);
+      }
+    }
+
+    return true;
+  }
+
+
+  /**
+   * Two dimensional transform in place. The inverse is scaled by the number of
+   * elements. The lines and the columns each have a FourierTransform, so their
+   * tables are only computed again when the chip sizes change.
+   *
+   * @param data The elements to transform, one line after another.
+   * @param samples The number of samples in a line, a power of two.
+   * @param lines The number of lines, a power of two.
+   * @param inverse Do the inverse transform.
+   */
+  void FourierCorrelation::Transform(vector<Complex> &data, int samples, int lines,
+                                     bool inverse) {
+    for (int line = 0; line < lines; line++) {
+      if (inverse) {
+        m_lineTransform.Inverse(&data[line * samples], samples);
+      }
+      else {
+        m_lineTransform.Transform(&data[line * samples], samples);
+      }
+    }
+
+    vector<Complex> column(lines);
+    for (int samp = 0; samp < samples; samp++) {
+      for (int line = 0; line < lines; line++) {
+        column[line] = data[line * samples + samp];
+      }
+      if (inverse) {
+        m_columnTransform.Inverse(&column[0], lines);
+      }
+      else {
+        m_columnTransform.Transform(&column[0], lines);
+      }
+      for (int line = 0; line < lines; line++) {
+        data[line * samples + samp] = column[line];
+      }
+    }
+  }
+
+
+  /**
+   * Transform two real arrays at once. They are packed as the real and
+   * imaginary parts of the data and their spectra are separated using their
+   * symmetry.
+   *
+   * @param data The first array in the real parts and the second in the
+   *             imaginary parts. It is transformed in place.
+   * @param samples The number of samples in a line, a power of two.
+   * @param lines The number of lines, a power of two.
+   * @param first Set to the spectrum of the first array.
+   * @param second Set to the spectrum of the second array.
+   */
+  void FourierCorrelation::TransformPair(vector<Complex> &data, int samples, int lines,
+                                         vector<Complex> &first, vector<Complex> &second) {
+    Transform(data, samples, lines, false);
+
+    first.resize(data.size());
+    second.resize(data.size());
+    for (int line = 0; line < lines; line++) {
+      int mirrorLine = (lines - line) % lines;
+      for (int samp = 0; samp < samples; samp++) {
+        int mirrorSamp = (samples - samp) % samples;
+        Complex value = data[line * samples + samp];
+        Complex mirror = conj(data[mirrorLine * samples + mirrorSamp]);
+        first[line * samples + samp] = 0.5 * (value + mirror);
+        second[line * samples + samp] = Complex(0.0, -0.5) * (value - mirror);
+      }
+    }
+  }
+}
+
+extern "C" Isis::AutoReg *FourierCorrelationPlugin(Isis::Pvl &pvl) {
+  return new Isis::FourierCorrelation(pvl);
+}
+
+extern "C" Isis::AutoReg *PhaseCorrelationPlugin(Isis::Pvl &pvl) {
+  return new Isis::FourierCorrelation(pvl, true);
+}
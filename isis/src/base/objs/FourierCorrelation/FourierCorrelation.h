@@ -0,0 +1,95 @@
+#ifndef FourierCorrelation_h
+#define FourierCorrelation_h
+/** This is free and unencumbered software released into the public domain.
+The authors of ISIS do not claim copyright on the contents of this file.
+For more details about the LICENSE terms and the AUTHORS, you will
+find files of those names at the top level of this repository. **/
+
+/* SPDX-License-Identifier: CC0-1.0 */
+
+#include <complex>
+#include <vector>
+
+#include "FourierTransform.h"
+#include "MaximumCorrelation.h"
+
+namespace Isis {
+  class Pvl;
+  class Chip;
+
+  /**
+   * @brief Correlation pattern matching using fast Fourier transforms
+   *
+   * This class finds the same fits as MaximumCorrelation, but instead of
+   * extracting a sub-search chip at every position of the search chip and
+   * correlating it with the pattern chip, all of the sums the correlations need
+   * are computed at once as cross-correlations in the frequency domain.  The
+   * number of operations grows with the size of the search chip times its
+   * logarithm instead of with the size of the search chip times the size of the
+   * pattern chip, so large pattern and search chips register much faster.
+   * Special pixels are masked out of the sums, so each fit is the correlation
+   * coefficient of the pixels that are valid in both chips just like
+   * MaximumCorrelation.  The fits only differ from MaximumCorrelation by
+   * rounding.  Use the name FourierCorrelation in the Algorithm group.
+   *
+   * The same class also does phase correlation, selected with the name
+   * PhaseCorrelation.  The cross-power spectrum of the pattern and search chips
+   * is normalized to unit magnitude before it is transformed back, which gives
+   * a sharp peak at the offset of the pattern in the search chip that is
+   * insensitive to differences in brightness and contrast. The fits are the
+   * heights of the phase correlation surface, so the peak is usually well below
+   * 1.0 and the Tolerance has to be set lower than it would be for
+   * MaximumCorrelation.
+   *
+   * The transforms are padded to powers of two and done with FourierTransform.
+   * Each FourierCorrelation keeps the FourierTransform tables for its line and
+   * column sizes, so registering many points with the same chip sizes only
+   * computes them once. Nothing is shared between objects, so threads that
+   * register with their own AutoReg do not need to lock anything.
+   *
+   * @ingroup PatternMatching
+   *
+   * @see MaximumCorrelation AutoReg
+   *
+   * @author 2026-10-16 ISIS Development Team
+   *
+   * @internal
+   *   @history 2026-10-16 ISIS Development Team - Original version
+   *   @history 2026-10-17 ISIS Development Team - Replaced the transforms in this
+   *                           class and their global table cache with
+   *                           FourierTransform objects owned by each instance.
+   */
+  class FourierCorrelation : public MaximumCorrelation {
+    public:
+      FourierCorrelation(Pvl &pvl, bool phase = false);
+      virtual ~FourierCorrelation() {};
+
+      /**
+       * @return @b bool True if this does phase correlation instead of normalized
+       *         cross-correlation
+       */
+      bool PhaseCorrelation() const {
+        return m_phase;
+      };
+
+    protected:
+      virtual bool MatchFits(Chip &sChip, Chip &pChip, Chip &fChip, int startSamp,
+                             int endSamp, int startLine, int endLine);
+      virtual QString AlgorithmName() const {
+        return m_phase ? "PhaseCorrelation" : "FourierCorrelation";
+      };
+
+    private:
+      void Transform(std::vector< std::complex<double> > &data, int samples, int lines,
+                     bool inverse);
+      void TransformPair(std::vector< std::complex<double> > &data, int samples, int lines,
+                         std::vector< std::complex<double> > &first,
+                         std::vector< std::complex<double> > &second);
+
+      bool m_phase;                        //!< Do phase correlation instead of normalized cross-correlation
+      FourierTransform m_lineTransform;    //!< Transforms the lines of the chips
+      FourierTransform m_columnTransform;  //!< Transforms the columns of the chips
+  };
+};
+
+#endif
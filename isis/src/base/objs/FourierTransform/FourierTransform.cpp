@@ -7,6 +7,11 @@ find files of those names at the top level of this repository. **/
 
 #include "FourierTransform.h"
 
+#include <QString>
+
+#include "IException.h"
+#include "IString.h"
+
 using namespace std;
 
 namespace Isis {
@@ -89,6 +94,95 @@ namespace Isis {
     return output;
   }
 
+  /**
+   * Applies the Fourier transform to the data in place.
+   *
+   * @param data The data to be transformed.
+   * @param n The number of elements in data, a power of two.
+   */
+  void FourierTransform::Transform(std::complex<double> *data, int n) {
+    MakeTables(n);
+    Butterflies(data, false);
+  }
+
+
+  /**
+   * Applies the inverse Fourier transform to the data in place. Like the
+   * Inverse that returns a vector, the result is divided by n.
+   *
+   * @param data The data to be transformed.
+   * @param n The number of elements in data, a power of two.
+   */
+  void FourierTransform::Inverse(std::complex<double> *data, int n) {
+    MakeTables(n);
+    Butterflies(data, true);
+
+    double scale = 1.0 / n;
+    for(int i = 0; i < n; i++) {
+      data[i] *= scale;
+    }
+  }
+
+
+  /**
+   * Computes the bit reversal and twiddle factor tables for transforms of n
+   * elements, unless they were already computed for the last transform.
+   *
+   * @param n The number of elements to transform.
+   */
+  void FourierTransform::MakeTables(int n) {
+    if (n < 1 || !IsPowerOfTwo(n)) {
+      QString msg = "The number of elements to transform [" + toString(n) +
+                    "] is not a power of two";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
+    if ((int)m_reversed.size() == n) return;
+
+    int bits = lg(n);
+    m_reversed.resize(n);
+    for(int i = 0; i < n; i++) {
+      int reversed = 0;
+      for(int bit = 0; bit < bits; bit++) {
+        if(i & (1 << bit)) reversed |= 1 << (bits - 1 - bit);
+      }
+      m_reversed[i] = reversed;
+    }
+
+    m_twiddles.resize(n / 2);
+    for(int k = 0; k < n / 2; k++) {
+      m_twiddles[k] = polar(1.0, -2.0 * PI * k / n);
+    }
+  }
+
+
+  /**
+   * Does the iterative transform in place with the current tables. The inverse
+   * is not scaled.
+   *
+   * @param data The data to be transformed.
+   * @param inverse Do the inverse transform.
+   */
+  void FourierTransform::Butterflies(std::complex<double> *data, bool inverse) const {
+    int n = m_reversed.size();
+    for(int i = 0; i < n; i++) {
+      if(i < m_reversed[i]) swap(data[i], data[m_reversed[i]]);
+    }
+
+    for(int m = 1; m < n; m *= 2) {
+      int step = n / (2 * m);
+      for(int k = 0; k < n; k += 2 * m) {
+        for(int j = 0; j < m; j++) {
+          complex<double> W = inverse ? conj(m_twiddles[j * step]) : m_twiddles[j * step];
+          complex<double> t = W * data[k+j+m];
+          complex<double> u = data[k+j];
+          data[k+j] = u + t;
+          data[k+j+m] = u - t;
+        }
+      }
+    }
+  }
+
+
   /**
    * Checks to see if the input integer is a power of two
    *
@@ -26,9 +26,16 @@ namespace Isis {
    *
    * @ingroup Math and Statistics
    *
+   * The Transform and Inverse methods that take a pointer transform in place
+   * and keep the bit reversal and twiddle factor tables of the last size they
+   * were given, so transforming many arrays of the same size computes them
+   * once. The tables belong to the object, so use one object per thread.
+   *
    * @author 2005-11-28 Jacob Danton
    *
    * @internal
+   *   @history 2026-10-17 ISIS Development Team - Added in place transforms
+   *                           that keep their tables between calls.
    */
   class FourierTransform {
     public:
@@ -36,10 +43,19 @@ namespace Isis {
       ~FourierTransform();
       std::vector< std::complex<double> > Transform(std::vector< std::complex<double> > input);
       std::vector< std::complex<double> > Inverse(std::vector< std::complex<double> > input);
+      void Transform(std::complex<double> *data, int n);
+      void Inverse(std::complex<double> *data, int n);
       bool IsPowerOfTwo(int n);
       int lg(int n);
       int BitReverse(int n, int x);
       int NextPowerOfTwo(int n);
+
+    private:
+      void MakeTables(int n);
+      void Butterflies(std::complex<double> *data, bool inverse) const;
+
+      std::vector<int> m_reversed;                  //!< Each index with its bits reversed
+      std::vector< std::complex<double> > m_twiddles; //!< exp(-2 pi i k / n) for k < n / 2
   };
 }
 
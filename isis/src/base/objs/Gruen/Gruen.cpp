@@ -840,6 +840,38 @@ namespace Isis {
     return (pvl);
   }
 
+  /**
+   * @brief Add the statistics of another Gruen to these
+   *
+   * Adds the AutoReg statistics, the error counts and the Gruen statistics of
+   * another Gruen to this one, so registrations done with several Gruen
+   * objects are reported together.
+   *
+   * @param other A Gruen created from the same template
+   */
+  void Gruen::MergeStatistics(const AutoReg &other) {
+    AutoReg::MergeStatistics(other);
+
+    const Gruen *gruen = dynamic_cast<const Gruen *>(&other);
+    if (!gruen) return;
+
+    m_callCount += gruen->m_callCount;
+    m_totalIterations += gruen->m_totalIterations;
+    m_unclassified += gruen->m_unclassified;
+    for (int e = 0 ; e < gruen->m_errors.size() ; e++) {
+      const ErrorCounter &counter = gruen->m_errors.getNth(e);
+      if (m_errors.exists(counter.Errno())) {
+        m_errors.get(counter.Errno()).m_count += counter.Count();
+      }
+    }
+
+    m_eigenStat.MergeStatistics(gruen->m_eigenStat);
+    m_iterStat.MergeStatistics(gruen->m_iterStat);
+    m_shiftStat.MergeStatistics(gruen->m_shiftStat);
+    m_gainStat.MergeStatistics(gruen->m_gainStat);
+  }
+
+
   /**
    * @brief Create a PvlGroup with the Gruen specific statistics
    *
@@ -70,6 +70,8 @@ namespace Isis {
    *            setTransform to match changes in Chip class
    *   @history 2011-05-23 Kris Becker - Reworked major portions of
    *            implementation for a more modular support.
+   *   @history 2026-10-16 ISIS Development Team - Added MergeStatistics to
+   *            combine the Gruen statistics of several registration objects.
    */
   class Gruen : public AutoReg {
     public:
@@ -86,6 +88,8 @@ namespace Isis {
 
       void WriteSubsearchChips(const QString &pattern = "SubChip");
 
+      virtual void MergeStatistics(const AutoReg &other);
+
       AffineTolerance getAffineTolerance() const;
 
       /** Returns the SPICE tolerance constraint as read from config file */
@@ -68,6 +68,7 @@ namespace Isis {
     multiPolygon.seekg(0, std::ios::beg);
 
     p_polygon = PolygonTools::MakeMultiPolygon(geosReader.readHEX(multiPolygon).release());
+    p_area = -1.0;
   }
 
 
@@ -87,6 +88,7 @@ namespace Isis {
   void ImageOverlap::Init() {
     p_serialNumbers.clear();
     p_polygon = NULL;
+    p_area = -1.0;
   }
 
 
@@ -104,6 +106,7 @@ namespace Isis {
     }
 
     p_polygon = PolygonTools::CopyMultiPolygon(polygon);
+    p_area = -1.0;
   }
 
 
@@ -121,6 +124,7 @@ namespace Isis {
     }
 
     p_polygon = PolygonTools::CopyMultiPolygon(polygon);
+    p_area = -1.0;
   }
 
 
@@ -174,7 +178,10 @@ namespace Isis {
    *
    */
   double ImageOverlap::Area() {
-    return p_polygon->getArea();
+    if (p_area < 0.0) {
+      p_area = p_polygon->getArea();
+    }
+    return p_area;
   }
 
 
@@ -34,6 +34,7 @@ namespace Isis {
    *   @history 2008-11-03 Steven Lambright - Added the Read and Write methods
    *   @history 2010-05-25 Steven Lambright - Made HasAnySameSerialNumber and
    *                                          HasSerialNumber const
+   *   @history 2026-10-16 ISIS Development Team - Area() computes the area once per polygon.
    *
    */
 
@@ -81,6 +82,7 @@ namespace Isis {
 
       std::vector<QString> p_serialNumbers;
       geos::geom::MultiPolygon *p_polygon;
+      double p_area; //!< The area of p_polygon, negative until it is computed
 
       void Init();
 
@@ -4,6 +4,7 @@ For more details about the LICENSE terms and the AUTHORS, you will
 find files of those names at the top level of this repository. **/
 
 /* SPDX-License-Identifier: CC0-1.0 */
+#include <algorithm>
 #include <cmath>
 #include <iomanip>
 #include <iostream>
@@ -13,6 +14,8 @@ find files of those names at the top level of this repository. **/
 
 #include "Cube.h"
 #include "FileName.h"
+#include "geos/geom/Envelope.h"
+#include "geos/index/strtree/STRtree.h"
 #include "geos/operation/distance/DistanceOp.h"
 #include "geos/util/IllegalArgumentException.h"
 #include "geos/geom/Point.h"
@@ -26,6 +29,9 @@ find files of those names at the top level of this repository. **/
 #include "Progress.h"
 #include "SerialNumberList.h"
 
+#include <QHash>
+#include <QVector>
+
 #include "QMessageBox"
 
 using namespace std;
@@ -531,6 +537,289 @@ namespace Isis {
   }
 
 
+  /**
+   * Whether the envelopes of two polygons are far enough apart that the polygons can not
+   *   overlap or be equal. Envelopes closer than the precision PolygonTools::Equal compares
+   *   coordinates to are not considered apart, and neither are empty polygons.
+   *
+   * @param poly1 The first polygon
+   * @param poly2 The second polygon
+   *
+   * @return bool True if the polygons are apart
+   */
+  static bool EnvelopesApart(const geos::geom::MultiPolygon *poly1,
+                             const geos::geom::MultiPolygon *poly2) {
+    const geos::geom::Envelope *envelope1 = poly1->getEnvelopeInternal();
+    const geos::geom::Envelope *envelope2 = poly2->getEnvelopeInternal();
+
+    if (envelope1->isNull() || envelope2->isNull()) {
+      return false;
+    }
+
+    return envelope1->distance(*envelope2) > 1.0e-9;
+  }
+
+
+  /**
+   * Finds, in list order, the overlaps FindAllOverlaps has to compare an overlap with. The
+   *   envelopes of the overlaps are put into an STRtree when the pass starts, so the overlaps
+   *   near an outside overlap are found with a query instead of by looking at every later one.
+   *
+   * Overlaps only shrink during the pass, so the envelopes in the tree stay large enough. The
+   *   pieces split off during the pass are inside the overlap they were split from, so they are
+   *   found through that overlap's entry in the tree. Empty overlaps and overlaps with almost no
+   *   area are compared to every later overlap, because the pass throws them out even when
+   *   they are apart. The positions are kept up to date as the pass erases and inserts overlaps.
+   *
+   * @author 2026-10-17 ISIS Development Team
+   *
+   * @internal
+   *   @history 2026-10-17 ISIS Development Team - Original version
+   */
+  class ImageOverlapCandidates {
+    public:
+      /**
+       * Index the overlaps in a list.
+       *
+       * @param overlaps The overlaps FindAllOverlaps is going to compare
+       */
+      ImageOverlapCandidates(const QList<ImageOverlap *> &overlaps) : m_list(overlaps) {
+        m_outside = NULL;
+        m_outsideEntry = -1;
+        m_cursor = 0;
+
+        // The tree keeps pointers to the envelopes and items, so they can not move
+        m_treeEnvelopes.reserve(overlaps.size());
+        m_treeItems.resize(overlaps.size());
+
+        for (int i = 0; i < overlaps.size(); i++) {
+          addEntry(overlaps[i], i, i);
+
+          const geos::geom::MultiPolygon *polygon = overlaps[i]->Polygon();
+          if (polygon->isEmpty() || overlaps[i]->Area() < 1.0e-14) {
+            visitAlways(i);
+          }
+
+          const geos::geom::Envelope *envelope = polygon->getEnvelopeInternal();
+          if (!envelope->isNull()) {
+            m_treeEnvelopes.push_back(*envelope);
+            m_treeItems[i] = i;
+            m_tree.insert(&m_treeEnvelopes.back(), &m_treeItems[i]);
+          }
+        }
+      }
+
+
+      /**
+       * The position of the next overlap to compare the outside overlap with.
+       *
+       * @param outside The position of the outside overlap
+       * @param from The first position to look at
+       *
+       * @return int The position, or the size of the list if there are no more
+       */
+      int next(int outside, int from) {
+        // The last comparison may have emptied either overlap
+        noteEmpty(m_outsideEntry);
+        if (m_cursor < m_candidates.size()) {
+          noteEmpty(m_candidates[m_cursor]);
+        }
+
+        if (outside >= m_list.size() || from >= m_list.size()) {
+          return m_list.size();
+        }
+
+        if (m_list[outside] != m_outside) {
+          collect(outside);
+        }
+
+        while (m_cursor < m_candidates.size()) {
+          int position = m_positions[m_candidates[m_cursor]];
+          if (position >= from) {
+            return position;
+          }
+          m_cursor++;
+        }
+
+        return m_list.size();
+      }
+
+
+      /**
+       * Update the positions after an overlap was erased from the list.
+       *
+       * @param position The position the overlap was erased from
+       */
+      void erased(int position) {
+        for (int entry = 0; entry < m_positions.size(); entry++) {
+          if (m_positions[entry] == position) {
+            m_positions[entry] = -1;
+          }
+          else if (m_positions[entry] > position) {
+            m_positions[entry]--;
+          }
+        }
+      }
+
+
+      /**
+       * Update the positions after a piece was split off the overlap before it in the list.
+       *
+       * @param position The position the piece was inserted at
+       */
+      void inserted(int position) {
+        for (int entry = 0; entry < m_positions.size(); entry++) {
+          if (m_positions[entry] >= position) {
+            m_positions[entry]++;
+          }
+        }
+
+        int root = m_roots[m_entries.value(m_list[position - 1])];
+        int entry = m_positions.size();
+        addEntry(m_list[position], position, root);
+        m_pieces[root].append(entry);
+      }
+
+    private:
+      //! Copying is not allowed
+      ImageOverlapCandidates(const ImageOverlapCandidates &other);
+      //! Assigning is not allowed
+      ImageOverlapCandidates &operator=(const ImageOverlapCandidates &other);
+
+
+      /**
+       * Start keeping track of an overlap.
+       *
+       * @param overlap The overlap
+       * @param position Its position in the list
+       * @param root The entry whose envelope in the tree contains the overlap
+       */
+      void addEntry(ImageOverlap *overlap, int position, int root) {
+        m_entries.insert(overlap, m_positions.size());
+        m_overlaps.append(overlap);
+        m_positions.append(position);
+        m_roots.append(root);
+        m_pieces.append(QVector<int>());
+        m_alwaysVisited.append(false);
+      }
+
+
+      /**
+       * Compare an overlap to every later overlap from now on.
+       *
+       * @param entry The overlap's entry
+       */
+      void visitAlways(int entry) {
+        if (!m_alwaysVisited[entry]) {
+          m_alwaysVisited[entry] = true;
+          m_visitAlways.append(entry);
+        }
+      }
+
+
+      /**
+       * Compare an overlap to every later overlap if it is still in the list and is empty.
+       *
+       * @param entry The overlap's entry, or -1
+       */
+      void noteEmpty(int entry) {
+        if (entry >= 0 && m_positions[entry] >= 0 && !m_alwaysVisited[entry] &&
+            m_overlaps[entry]->Polygon()->isEmpty()) {
+          visitAlways(entry);
+        }
+      }
+
+
+      /**
+       * Find the overlaps after the outside overlap that it has to be compared with, sorted by
+       *   their position in the list.
+       *
+       * @param outside The position of the outside overlap
+       */
+      void collect(int outside) {
+        m_outside = m_list[outside];
+        m_outsideEntry = m_entries.value(m_outside);
+        m_candidates.clear();
+        m_cursor = 0;
+
+        // A little more than EnvelopesApart allows for, to cover rounding in the polygon math
+        const geos::geom::Envelope *envelope = m_outside->Polygon()->getEnvelopeInternal();
+        if (!envelope->isNull()) {
+          geos::geom::Envelope search(*envelope);
+          search.expandBy(1.0e-8);
+
+          std::vector<void *> hits;
+          m_tree.query(&search, hits);
+
+          for (unsigned int i = 0; i < hits.size(); i++) {
+            int root = *static_cast<int *>(hits[i]);
+            addCandidate(root, outside);
+
+            // Pieces that went before the outside overlap are not needed anymore
+            QVector<int> &pieces = m_pieces[root];
+            int kept = 0;
+            for (int piece = 0; piece < pieces.size(); piece++) {
+              if (m_positions[pieces[piece]] >= outside) {
+                pieces[kept++] = pieces[piece];
+                addCandidate(pieces[piece], outside);
+              }
+            }
+            pieces.resize(kept);
+          }
+        }
+
+        int kept = 0;
+        for (int i = 0; i < m_visitAlways.size(); i++) {
+          if (m_positions[m_visitAlways[i]] >= outside) {
+            m_visitAlways[kept++] = m_visitAlways[i];
+            addCandidate(m_visitAlways[i], outside);
+          }
+        }
+        m_visitAlways.resize(kept);
+
+        const QVector<int> &positions = m_positions;
+        std::sort(m_candidates.begin(), m_candidates.end(),
+                  [&positions](int entry1, int entry2) {
+                    return positions[entry1] < positions[entry2];
+                  });
+        m_candidates.erase(std::unique(m_candidates.begin(), m_candidates.end()),
+                           m_candidates.end());
+      }
+
+
+      /**
+       * Add an overlap to the candidates if it is after the outside overlap.
+       *
+       * @param entry The overlap's entry
+       * @param outside The position of the outside overlap
+       */
+      void addCandidate(int entry, int outside) {
+        if (m_positions[entry] > outside) {
+          m_candidates.append(entry);
+        }
+      }
+
+      const QList<ImageOverlap *> &m_list; //!< The overlaps being compared
+
+      QHash<ImageOverlap *, int> m_entries; //!< The entries of the overlaps in the list
+      QVector<ImageOverlap *> m_overlaps;  //!< The overlap of each entry
+      QVector<int> m_positions;            //!< The position of each entry, -1 once erased
+      QVector<int> m_roots;                //!< The entry in the tree that contains each entry
+      QVector< QVector<int> > m_pieces;    //!< The pieces split off each entry in the tree
+      QVector<bool> m_alwaysVisited;       //!< Whether each entry is in m_visitAlways
+      QVector<int> m_visitAlways;          //!< Entries compared to every later overlap
+
+      std::vector<geos::geom::Envelope> m_treeEnvelopes; //!< The envelopes in the tree
+      std::vector<int> m_treeItems;                      //!< The entries in the tree
+      geos::index::strtree::STRtree m_tree;             //!< The envelopes of the overlaps
+
+      ImageOverlap *m_outside;  //!< The outside overlap the candidates were found for
+      int m_outsideEntry;       //!< The entry of the outside overlap
+      QVector<int> m_candidates; //!< The entries to compare the outside overlap with
+      int m_cursor;             //!< The candidate the last position came from
+  };
+
+
   /**
    * Find the overlaps between all the existing ImageOverlap Objects
    *
@@ -549,6 +838,8 @@ namespace Isis {
 
     geos::geom::MultiPolygon *emptyPolygon = Isis::globalFactory->createMultiPolygon().release();
 
+    ImageOverlapCandidates candidates(p_lonLatOverlaps);
+
     // Compare each polygon with all of the others
     for (int outside = 0; outside < p_lonLatOverlaps.size() - 1; ++outside) {
       p_calculatedSoFar = outside - 1;
@@ -562,15 +853,35 @@ namespace Isis {
       }
 
       // Intersect the current polygon (from the outside loop) with all others
-      // below it
-      for (int inside = outside + 1; inside < p_lonLatOverlaps.size(); ++inside) {
+      // below it. Overlaps that can not touch it are skipped.
+      for (int inside = candidates.next(outside, outside + 1); inside < p_lonLatOverlaps.size();
+           inside = candidates.next(outside, inside + 1)) {
         try {
-          if (p_lonLatOverlaps.at(outside)->HasAnySameSerialNumber(*p_lonLatOverlaps.at(inside)))
-            continue;
+          ImageOverlap *outsideOverlap = p_lonLatOverlaps.at(outside);
+          ImageOverlap *insideOverlap = p_lonLatOverlaps.at(inside);
 
           // We know these are valid because they were filtered early on
-          const geos::geom::MultiPolygon *poly1 = p_lonLatOverlaps.at(outside)->Polygon();
-          const geos::geom::MultiPolygon *poly2 = p_lonLatOverlaps.at(inside)->Polygon();
+          const geos::geom::MultiPolygon *poly1 = outsideOverlap->Polygon();
+          const geos::geom::MultiPolygon *poly2 = insideOverlap->Polygon();
+
+          // Polygons whose envelopes are apart can be neither equal nor overlapping, so the
+          //   only thing left to do for them is throw out an empty inside polygon. The
+          //   candidates can include such pairs, because the envelopes in the tree do not
+          //   shrink with the polygons.
+          if (EnvelopesApart(poly1, poly2)) {
+            if (insideOverlap->Area() < 1.0e-14 &&
+                !outsideOverlap->HasAnySameSerialNumber(*insideOverlap)) {
+              p_lonLatOverlapsMutex.lock();
+              p_lonLatOverlaps.erase(p_lonLatOverlaps.begin() + inside);
+              p_lonLatOverlapsMutex.unlock();
+              candidates.erased(inside);
+              inside --;
+            }
+            continue;
+          }
+
+          if (outsideOverlap->HasAnySameSerialNumber(*insideOverlap))
+            continue;
 
           // Check to see if the two poygons are equivalent.
           // If they are, then we can get rid of one of them
@@ -579,6 +890,7 @@ namespace Isis {
             AddSerialNumbers(p_lonLatOverlaps[outside], p_lonLatOverlaps[inside]);
             p_lonLatOverlaps.erase(p_lonLatOverlaps.begin() + inside);
             p_lonLatOverlapsMutex.unlock();
+            candidates.erased(inside);
             inside --;
             continue;
           }
@@ -588,6 +900,7 @@ namespace Isis {
             p_lonLatOverlapsMutex.lock();
             p_lonLatOverlaps.erase(p_lonLatOverlaps.begin() + inside);
             p_lonLatOverlapsMutex.unlock();
+            candidates.erased(inside);
             inside --;
             continue;
           }
@@ -618,6 +931,7 @@ namespace Isis {
                 p_lonLatOverlapsMutex.lock();
                 p_lonLatOverlaps.erase(p_lonLatOverlaps.begin() + inside);
                 p_lonLatOverlapsMutex.unlock();
+                candidates.erased(inside);
                 inside --;
               }
               else {
@@ -626,6 +940,7 @@ namespace Isis {
                 p_lonLatOverlapsMutex.lock();
                 p_lonLatOverlaps.erase(p_lonLatOverlaps.begin() + outside);
                 p_lonLatOverlapsMutex.unlock();
+                candidates.erased(outside);
                 inside = outside;
               }
             }
@@ -637,6 +952,8 @@ namespace Isis {
               p_lonLatOverlaps.erase(p_lonLatOverlaps.begin() + inside);
               p_lonLatOverlaps.erase(p_lonLatOverlaps.begin() + outside);
               p_lonLatOverlapsMutex.unlock();
+              candidates.erased(inside);
+              candidates.erased(outside);
               inside = outside;
             }
 
@@ -710,6 +1027,7 @@ namespace Isis {
               p_lonLatOverlapsMutex.lock();
               p_lonLatOverlaps.erase(p_lonLatOverlaps.begin() + outside);
               p_lonLatOverlapsMutex.unlock();
+              candidates.erased(outside);
               inside = outside;
               continue;
             }
@@ -731,6 +1049,7 @@ namespace Isis {
               p_lonLatOverlapsMutex.lock();
               p_lonLatOverlaps.erase(p_lonLatOverlaps.begin() + inside);
               p_lonLatOverlapsMutex.unlock();
+              candidates.erased(inside);
               inside --;
               continue;
             }
@@ -773,7 +1092,10 @@ namespace Isis {
               int newSteps = newSize - oldSize;
               p.AddSteps(newSteps);
               foundOverlap = true;
-              if (newSize != oldSize) inside++;
+              if (newSize != oldSize) {
+                candidates.inserted(inside + 1);
+                inside++;
+              }
             }
           } // End of partial overlap else
         }
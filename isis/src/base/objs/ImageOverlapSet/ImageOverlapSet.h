@@ -81,6 +81,11 @@ namespace Isis {
    *                          undefined behavior caused by unlocking an unlocked mutex.
    *   @history 2017-05-23 Ian Humphrey - Added a tryLock() to FindAllOverlaps to prevent a
    *                           segfault from occuring on OSX with certain data. Fixes #4810.
+   *   @history 2026-10-16 ISIS Development Team - FindAllOverlaps skips pairs of polygons
+   *                           whose envelopes are apart before doing any polygon math.
+   *   @history 2026-10-17 ISIS Development Team - FindAllOverlaps queries an STRtree of the
+   *                           envelopes for the overlaps to compare instead of visiting every
+   *                           pair.
    *
    */
   class ImageOverlapSet : private QThread {
@@ -6,6 +6,13 @@ find files of those names at the top level of this repository. **/
 /* SPDX-License-Identifier: CC0-1.0 */
 
 #include <sstream>
+
+#include <QDateTime>
+#include <QFileInfo>
+#include <QMap>
+#include <QMutex>
+#include <QMutexLocker>
+
 #include <xercesc/util/PlatformUtils.hpp>
 #include <xercesc/util/TransService.hpp>
 #include <xercesc/sax2/XMLReaderFactory.hpp>
@@ -32,14 +39,49 @@ using namespace std;
  */
 namespace XERCES = XERCES_CPP_NAMESPACE;
 
+namespace {
+  /**
+   * An application XML file that has already been parsed.
+   */
+  struct ParsedAml {
+    //! When the file was last modified when it was parsed
+    QDateTime lastModified;
+    //! The parsed file, before any parameter values were set
+    IsisAmlData data;
+  };
+
+  //! Serializes access to parsedAmlFiles
+  QMutex parsedAmlMutex;
+  //! The application XML files parsed so far, by name
+  QMap<QString, ParsedAml> parsedAmlFiles;
+}
+
 /**
  * Constructs an IsisAml object and internalizes the XML data in the given file
- * name.
+ * name. Each file is only parsed once per process; later objects for the same
+ * file copy the parsed data unless the file was modified.
  *
  * @param xmlfile Indicates the pull path of the XML file to be parsed.
  */
 IsisAml::IsisAml(const QString &xmlfile) {
+  parser = NULL;
+  appHandler = NULL;
+
+  QDateTime lastModified = QFileInfo(xmlfile).lastModified();
+
+  QMutexLocker locker(&parsedAmlMutex);
+  QMap<QString, ParsedAml>::const_iterator parsed = parsedAmlFiles.constFind(xmlfile);
+  if (parsed != parsedAmlFiles.constEnd() && parsed->lastModified == lastModified) {
+    static_cast<IsisAmlData &>(*this) = parsed->data;
+    return;
+  }
+
   StartParser(xmlfile.toLatin1().data());
+
+  ParsedAml newParsed;
+  newParsed.lastModified = lastModified;
+  newParsed.data = *this;
+  parsedAmlFiles.insert(xmlfile, newParsed);
 }
 
 /**
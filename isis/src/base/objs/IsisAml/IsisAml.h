@@ -136,6 +136,8 @@ class QString;
  *                                         warnings in clang. Part of porting to OSX 10.11.
  *   @history 2017-08-08 Adam Goins - Added an additional catch statement to display the 
  *                                    file name of an XML file that threw an error while parsing.
+ *   @history 2026-10-16 ISIS Development Team - Each XML file is only parsed once per process.
+ *                                    Later objects for the same file copy the parsed data.
  */
 class IsisAml : protected IsisAmlData {
 
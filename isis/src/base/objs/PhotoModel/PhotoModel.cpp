@@ -128,8 +128,10 @@ namespace Isis {
     cema = max(-1.0, min(-xy * ye + z * ze, 1.0));
     ema4 = PhtAcos(cema) * (180.0 / Isis::PI);
 
-    d1 = (CalcSurfAlbedo(phase, inc1, ema1) - CalcSurfAlbedo(phase, inc2, ema2)) / eps;
-    d2 = (CalcSurfAlbedo(phase, inc3, ema3) - CalcSurfAlbedo(phase, inc4, ema4)) / eps;
+    // The photometric function is evaluated directly because the differences are too small
+    // for the lookup table to resolve
+    d1 = (PhotoModelAlgorithm(phase, inc1, ema1) - PhotoModelAlgorithm(phase, inc2, ema2)) / eps;
+    d2 = (PhotoModelAlgorithm(phase, inc3, ema3) - PhotoModelAlgorithm(phase, inc4, ema4)) / eps;
 
     //  Combine these two derivatives and return the gradient
     result = sqrt(max(1.0e-30, d1 * d1 + d2 * d2));
@@ -183,11 +185,48 @@ namespace Isis {
     //  throw iException::Message(iException::Programmer,msg,_FILEINFO_);
     //}
 
+    // Interpolate the photometric function if it has been tabulated. The parameters are
+    // different at standard conditions, so the table does not apply then.
+    double albedo;
+    if (!p_standardConditions && p_photoLookupTable.interpolate(pha, inc, ema, &albedo)) {
+      return albedo;
+    }
+
     // Apply photometric function
-    double albedo = PhotoModelAlgorithm(pha, inc, ema);
+    albedo = PhotoModelAlgorithm(pha, inc, ema);
     return albedo;
   }
 
+  /**
+   * Tabulates the photometric function with the current parameters so that CalcSurfAlbedo()
+   * can interpolate it. The table is sampled as CalcSurfAlbedo() meets new angles. This should
+   * be called once all of the parameters are set, and again if they are changed.
+   *
+   * @param tolerance The relative error the interpolated surface brightness is checked
+   *                  against, see PhotometricLookupTable. A tolerance of 0 discards the table.
+   *
+   * @throws IException::Programmer "The photometric function lookup table can not be built at
+   *                                  standard conditions"
+   */
+  void PhotoModel::SetLookupTolerance(double tolerance) {
+    p_photoLookupTable.clear();
+    if (tolerance <= 0.0) {
+      return;
+    }
+
+    if (p_standardConditions) {
+      QString msg = "The photometric function lookup table can not be built at standard "
+                    "conditions";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
+
+    p_photoLookupTable.build(
+        [this](double pha, double inc, double ema, double *albedo) {
+          *albedo = PhotoModelAlgorithm(pha, inc, ema);
+        },
+        tolerance);
+  }
+
   /**
    * Set the Lunar-Lambert function weight.  This is used to govern the
    * limb-darkening in the Lunar-Lambert photometric function.  Values of
@@ -12,6 +12,7 @@ find files of those names at the top level of this repository. **/
 
 #include <QString>
 #include "NumericalApproximation.h"
+#include "PhotometricLookupTable.h"
 #include "Pvl.h"
 
 namespace Isis {
@@ -37,6 +38,10 @@ namespace Isis {
    *                      this class and into children classes.
    *  @history 2008-11-05 Jeannie Walldren - Moved PhtAcos() from
    *                      NumericalMethods class.
+   *  @history 2026-10-16 ISIS Development Team - Added SetLookupTolerance(), which tabulates
+   *                      the photometric function so CalcSurfAlbedo() can interpolate it
+   *                      instead of evaluating it for every pixel. PhtTopder() still
+   *                      evaluates the function directly.
    */
   class PhotoModel {
     public:
@@ -63,6 +68,14 @@ namespace Isis {
       // Calculate the surface brightness
       double CalcSurfAlbedo(double pha, double inc, double ema);
 
+      // Tabulate the photometric function
+      void SetLookupTolerance(double tolerance);
+
+      //! Return the tolerance of the photometric function table, 0 if there is no table
+      double LookupTolerance() const {
+        return p_photoLookupTable.tolerance();
+      }
+
       virtual void SetPhotoL(const double l) {
         p_photoL = l;
       }
@@ -232,6 +245,8 @@ namespace Isis {
       QString p_photoAlgorithmName;
       //! Indicates whether standard conditions are used
       bool p_standardConditions;
+      //! Table of the photometric function, used when it has been built
+      PhotometricLookupTable p_photoLookupTable;
   };
 };
 
@@ -0,0 +1,476 @@
+/** This is free and unencumbered software released into the public domain.
+
+The authors of ISIS do not claim copyright on the contents of this file.
+For more details about the LICENSE terms and the AUTHORS, you will
+find files of those names at the top level of this repository. **/
+
+/* SPDX-License-Identifier: CC0-1.0 */
+
+#include "PhotometricLookupTable.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "IException.h"
+#include "IString.h"
+
+namespace Isis {
+
+  namespace {
+    //! The size of a block, and the coarsest spacing of its samples, in degrees
+    const double BlockSize = 4.0;
+    //! The finest spacing of the samples in degrees
+    const double MinimumStepSize = 1.0;
+  }
+
+
+  /**
+   * Constructs an empty table.
+   *
+   * @param valueCount The number of values the tabulated function computes
+   */
+  PhotometricLookupTable::PhotometricLookupTable(int valueCount) {
+    m_valueCount = valueCount;
+    m_tolerance = 0.0;
+    m_evaluationCount = 0;
+    m_phaseBlocks = 0;
+    m_incidenceBlocks = 0;
+    m_emissionBlocks = 0;
+  }
+
+
+  //! Destroys the table
+  PhotometricLookupTable::~PhotometricLookupTable() {
+  }
+
+
+  /**
+   * Prepares to tabulate a function. Nothing is sampled until interpolate() needs it, so the
+   * function must stay valid, and give the same values, until the table is cleared.
+   * Exceptions thrown by the function while sampling are caught, and the cells around the
+   * sample are left for the caller to evaluate.
+   *
+   * @param function The function to tabulate
+   * @param tolerance The relative difference between an interpolated value and the function
+   *                  that the checked points must be within
+   *
+   * @throws IException::Programmer "The tolerance of a photometric lookup table must be
+   *                                  positive"
+   */
+  void PhotometricLookupTable::build(const Function &function, double tolerance) {
+    if (!(tolerance > 0.0)) {
+      QString msg = "The tolerance of a photometric lookup table must be positive, not ["
+                    + toString(tolerance) + "]";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
+
+    clear();
+
+    m_function = function;
+    m_tolerance = tolerance;
+    m_phaseBlocks = (int) std::ceil(180.0 / BlockSize);
+    m_incidenceBlocks = (int) std::ceil(90.0 / BlockSize);
+    m_emissionBlocks = m_incidenceBlocks;
+
+    Block unsampled;
+    unsampled.stepSize = 0.0;
+    unsampled.nodeCount = 0;
+    m_blocks.assign(m_phaseBlocks * m_incidenceBlocks * m_emissionBlocks, unsampled);
+  }
+
+
+  //! Discards the table
+  void PhotometricLookupTable::clear() {
+    m_function = Function();
+    m_tolerance = 0.0;
+    m_evaluationCount = 0;
+    m_phaseBlocks = 0;
+    m_incidenceBlocks = 0;
+    m_emissionBlocks = 0;
+    m_blocks.clear();
+  }
+
+
+  /**
+   * Interpolates the values of the function at a set of angles, sampling the block of the
+   * table the angles are in if it has not been sampled yet.
+   *
+   * @param phase The phase angle in degrees
+   * @param incidence The incidence angle in degrees
+   * @param emission The emission angle in degrees
+   * @param values Set to the interpolated values if the table covers the angles
+   *
+   * @return @b bool False if the table is not built, the angles are outside of the table or
+   *                 they fall in a cell that missed the tolerance. The function must be
+   *                 evaluated directly in that case.
+   */
+  bool PhotometricLookupTable::interpolate(double phase, double incidence, double emission,
+                                           double *values) {
+    int index = blockIndex(phase, incidence, emission);
+    if (index < 0) {
+      return false;
+    }
+
+    if (m_blocks[index].stepSize <= 0.0) {
+      sample(index);
+    }
+
+    const Block &block = m_blocks[index];
+    int blockCount = m_incidenceBlocks * m_emissionBlocks;
+    double x = (phase - index / blockCount * BlockSize) / block.stepSize;
+    double y = (incidence - index / m_emissionBlocks % m_incidenceBlocks * BlockSize) /
+               block.stepSize;
+    double z = (emission - index % m_emissionBlocks * BlockSize) / block.stepSize;
+
+    int cellCount = block.nodeCount - 1;
+    int p = std::min((int) x, cellCount - 1);
+    int i = std::min((int) y, cellCount - 1);
+    int e = std::min((int) z, cellCount - 1);
+    if (block.exactCells[(p * cellCount + i) * cellCount + e]) {
+      return false;
+    }
+
+    interpolateBlock(block, x, y, z, values);
+    return true;
+  }
+
+
+  /**
+   * @param phase The phase angle in degrees
+   * @param incidence The incidence angle in degrees
+   * @param emission The emission angle in degrees
+   *
+   * @return @b double The spacing in degrees of the samples around the angles, or 0 if they
+   *                   have not been sampled
+   */
+  double PhotometricLookupTable::stepSize(double phase, double incidence,
+                                          double emission) const {
+    int index = blockIndex(phase, incidence, emission);
+    return index < 0 ? 0.0 : m_blocks[index].stepSize;
+  }
+
+
+  /**
+   * @return @b int The number of blocks that have been sampled
+   */
+  int PhotometricLookupTable::sampledBlockCount() const {
+    int count = 0;
+    for (const Block &block : m_blocks) {
+      if (block.stepSize > 0.0) {
+        count++;
+      }
+    }
+    return count;
+  }
+
+
+  /**
+   * @return @b int The number of cells in the blocks that have been sampled
+   */
+  int PhotometricLookupTable::cellCount() const {
+    int count = 0;
+    for (const Block &block : m_blocks) {
+      count += (int) block.exactCells.size();
+    }
+    return count;
+  }
+
+
+  /**
+   * @return @b int The number of cells in the blocks that have been sampled that missed the
+   *                tolerance and are evaluated directly
+   */
+  int PhotometricLookupTable::exactCellCount() const {
+    int count = 0;
+    for (const Block &block : m_blocks) {
+      count += (int) std::count(block.exactCells.begin(), block.exactCells.end(), true);
+    }
+    return count;
+  }
+
+
+  /**
+   * Finds the block of the table that holds a set of angles.
+   *
+   * @param phase The phase angle in degrees
+   * @param incidence The incidence angle in degrees
+   * @param emission The emission angle in degrees
+   *
+   * @return @b int The index of the block, or -1 if the table is not built or the angles are
+   *                outside of it
+   */
+  int PhotometricLookupTable::blockIndex(double phase, double incidence,
+                                         double emission) const {
+    if (m_tolerance <= 0.0) {
+      return -1;
+    }
+
+    // The comparisons are written so that NaN angles are refused as well
+    if (!(phase >= 0.0 && phase <= 180.0 && incidence >= 0.0 && incidence <= 90.0 &&
+          emission >= 0.0 && emission <= 90.0)) {
+      return -1;
+    }
+
+    int p = std::min((int) (phase / BlockSize), m_phaseBlocks - 1);
+    int i = std::min((int) (incidence / BlockSize), m_incidenceBlocks - 1);
+    int e = std::min((int) (emission / BlockSize), m_emissionBlocks - 1);
+    return (p * m_incidenceBlocks + i) * m_emissionBlocks + e;
+  }
+
+
+  /**
+   * Samples a block of the table. The block is sampled every 4 degrees and checked against
+   * samples halfway between those, then every 2 degrees and every 1 degree. Refining stops
+   * when no cell misses the tolerance, or when the largest error at the checked points is
+   * not at least halved, which happens where the function is not smooth or not defined and
+   * finer samples would not help. Each spacing reuses the samples used to check the one
+   * before it. The spacing where the smallest share of the block misses is kept, and the
+   * cells that miss and their neighbors in the block are marked as exact.
+   *
+   * @param index The index of the block
+   */
+  void PhotometricLookupTable::sample(int index) {
+    int blockCount = m_incidenceBlocks * m_emissionBlocks;
+    double phase0 = index / blockCount * BlockSize;
+    double incidence0 = index / m_emissionBlocks % m_incidenceBlocks * BlockSize;
+    double emission0 = index % m_emissionBlocks * BlockSize;
+
+    // The samples halfway between the nodes of the current spacing, which are the nodes of
+    // the next one
+    int halfCount = 3;
+    double halfStep = BlockSize / 2.0;
+    QVector<double> halfSteps(halfCount * halfCount * halfCount * m_valueCount);
+    double *halfSample = halfSteps.data();
+    for (int hp = 0; hp < halfCount; hp++) {
+      for (int hi = 0; hi < halfCount; hi++) {
+        for (int he = 0; he < halfCount; he++) {
+          evaluate(phase0 + hp * halfStep, incidence0 + hi * halfStep, emission0 + he * halfStep,
+                   halfSample);
+          halfSample += m_valueCount;
+        }
+      }
+    }
+
+    Block best;
+    double bestMissedShare = 2.0;
+    double lastLargestError = 0.0;
+    for (double stepSize = BlockSize; ; stepSize /= 2.0) {
+      Block candidate;
+      candidate.stepSize = stepSize;
+      candidate.nodeCount = (halfCount + 1) / 2;
+      candidate.values.resize(candidate.nodeCount * candidate.nodeCount *
+                              candidate.nodeCount * m_valueCount);
+      double *node = candidate.values.data();
+      for (int p = 0; p < halfCount; p += 2) {
+        for (int i = 0; i < halfCount; i += 2) {
+          for (int e = 0; e < halfCount; e += 2) {
+            const double *halfValues = halfSteps.constData() +
+                                       ((p * halfCount + i) * halfCount + e) * m_valueCount;
+            std::copy(halfValues, halfValues + m_valueCount, node);
+            node += m_valueCount;
+          }
+        }
+      }
+
+      double largestError = 0.0;
+      int missedCells = validate(candidate, halfSteps, largestError);
+      double missedShare = (double) missedCells / candidate.exactCells.size();
+      if (missedShare < bestMissedShare) {
+        best = candidate;
+        bestMissedShare = missedShare;
+      }
+      if (missedCells == 0 || stepSize / 2.0 < MinimumStepSize ||
+          (stepSize < BlockSize && !(largestError < lastLargestError / 2.0))) {
+        break;
+      }
+      lastLargestError = largestError;
+
+      // Sample halfway between the nodes of the next spacing, keeping the samples already made
+      int nextCount = 2 * halfCount - 1;
+      halfStep /= 2.0;
+      QVector<double> nextHalfSteps(nextCount * nextCount * nextCount * m_valueCount);
+      double *nextSample = nextHalfSteps.data();
+      for (int hp = 0; hp < nextCount; hp++) {
+        for (int hi = 0; hi < nextCount; hi++) {
+          for (int he = 0; he < nextCount; he++) {
+            if (hp % 2 == 0 && hi % 2 == 0 && he % 2 == 0) {
+              const double *halfValues = halfSteps.constData() +
+                  ((hp / 2 * halfCount + hi / 2) * halfCount + he / 2) * m_valueCount;
+              std::copy(halfValues, halfValues + m_valueCount, nextSample);
+            }
+            else {
+              evaluate(phase0 + hp * halfStep, incidence0 + hi * halfStep,
+                       emission0 + he * halfStep, nextSample);
+            }
+            nextSample += m_valueCount;
+          }
+        }
+      }
+      halfSteps.swap(nextHalfSteps);
+      halfCount = nextCount;
+    }
+
+    // Leave a margin around the cells that missed
+    int cellCount = best.nodeCount - 1;
+    std::vector<bool> missed = best.exactCells;
+    int cell = 0;
+    for (int p = 0; p < cellCount; p++) {
+      for (int i = 0; i < cellCount; i++) {
+        for (int e = 0; e < cellCount; e++, cell++) {
+          if (!missed[cell]) {
+            continue;
+          }
+          for (int np = std::max(p - 1, 0); np <= std::min(p + 1, cellCount - 1); np++) {
+            for (int ni = std::max(i - 1, 0); ni <= std::min(i + 1, cellCount - 1); ni++) {
+              for (int ne = std::max(e - 1, 0); ne <= std::min(e + 1, cellCount - 1); ne++) {
+                best.exactCells[(np * cellCount + ni) * cellCount + ne] = true;
+              }
+            }
+          }
+        }
+      }
+    }
+
+    m_blocks[index] = best;
+  }
+
+
+  /**
+   * Evaluates the function for the table, setting the values to NaN if it throws.
+   *
+   * @param phase The phase angle in degrees
+   * @param incidence The incidence angle in degrees
+   * @param emission The emission angle in degrees
+   * @param values Set to the values of the function
+   */
+  void PhotometricLookupTable::evaluate(double phase, double incidence, double emission,
+                                        double *values) {
+    m_evaluationCount++;
+    try {
+      m_function(phase, incidence, emission, values);
+    }
+    catch (IException &) {
+      std::fill(values, values + m_valueCount, std::numeric_limits<double>::quiet_NaN());
+    }
+  }
+
+
+  /**
+   * Compares the interpolated values of a block to the function halfway between the nodes:
+   * at the center of every cell, the centers of its faces and the midpoints of its edges. A
+   * point that misses the tolerance marks every cell it is on. The nodes are exact, and
+   * between them the error of trilinear interpolation is largest at these points for
+   * smoothly curving functions, but that is not true near the limb where the functions are
+   * not smooth. The points are held to a quarter of the tolerance to leave some margin for
+   * the rest of the cell.
+   *
+   * @param block The block to check. Its exact cells are set to the cells that missed.
+   * @param halfSteps The function sampled at every half step of the block
+   * @param largestError Set to the largest relative error at the points, leaving out the
+   *                     points where the function or the samples are not finite
+   *
+   * @return @b int The number of cells that missed the tolerance
+   */
+  int PhotometricLookupTable::validate(Block &block, const QVector<double> &halfSteps,
+                                       double &largestError) {
+    int cellCount = block.nodeCount - 1;
+    int halfCount = 2 * block.nodeCount - 1;
+    block.exactCells.assign(cellCount * cellCount * cellCount, false);
+    double pointTolerance = m_tolerance / 4.0;
+
+    std::vector<double> interpolated(m_valueCount);
+    int missedCells = 0;
+    largestError = 0.0;
+
+    // A point with an odd index along an axis is inside one cell along it, and a point with
+    // an even index is on the boundary of two.
+    for (int hp = 0; hp < halfCount; hp++) {
+      for (int hi = 0; hi < halfCount; hi++) {
+        for (int he = 0; he < halfCount; he++) {
+          if (hp % 2 == 0 && hi % 2 == 0 && he % 2 == 0) {
+            continue;
+          }
+
+          const double *exact = halfSteps.constData() +
+                                ((hp * halfCount + hi) * halfCount + he) * m_valueCount;
+          interpolateBlock(block, hp / 2.0, hi / 2.0, he / 2.0, interpolated.data());
+
+          bool withinTolerance = true;
+          for (int k = 0; k < m_valueCount; k++) {
+            if (interpolated[k] == exact[k]) {
+              continue;
+            }
+            // NaN samples fail this test as well
+            double error = fabs(interpolated[k] - exact[k]);
+            if (!(error <= pointTolerance * fabs(exact[k]))) {
+              withinTolerance = false;
+            }
+            if (std::isfinite(error) && exact[k] != 0.0) {
+              largestError = std::max(largestError, error / fabs(exact[k]));
+            }
+          }
+          if (withinTolerance) {
+            continue;
+          }
+
+          for (int p = std::max((hp - 1) / 2, 0); p <= std::min(hp / 2, cellCount - 1); p++) {
+            for (int i = std::max((hi - 1) / 2, 0); i <= std::min(hi / 2, cellCount - 1); i++) {
+              for (int e = std::max((he - 1) / 2, 0); e <= std::min(he / 2, cellCount - 1);
+                   e++) {
+                int cell = (p * cellCount + i) * cellCount + e;
+                if (!block.exactCells[cell]) {
+                  block.exactCells[cell] = true;
+                  missedCells++;
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+    return missedCells;
+  }
+
+
+  /**
+   * Interpolates trilinearly between the samples of a block.
+   *
+   * @param block The block
+   * @param x The phase angle from the start of the block, in steps
+   * @param y The incidence angle from the start of the block, in steps
+   * @param z The emission angle from the start of the block, in steps
+   * @param values Set to the interpolated values
+   */
+  void PhotometricLookupTable::interpolateBlock(const Block &block, double x, double y,
+                                                double z, double *values) const {
+    int cellCount = block.nodeCount - 1;
+    int p = std::min((int) x, cellCount - 1);
+    int i = std::min((int) y, cellCount - 1);
+    int e = std::min((int) z, cellCount - 1);
+    double tp = x - p;
+    double ti = y - i;
+    double te = z - e;
+
+    int emissionStride = m_valueCount;
+    int incidenceStride = block.nodeCount * emissionStride;
+    int phaseStride = block.nodeCount * incidenceStride;
+    const double *corner = block.values.constData() +
+                           p * phaseStride + i * incidenceStride + e * emissionStride;
+
+    for (int k = 0; k < m_valueCount; k++) {
+      const double *c = corner + k;
+      double c00 = c[0] + te * (c[emissionStride] - c[0]);
+      double c01 = c[incidenceStride] +
+                   te * (c[incidenceStride + emissionStride] - c[incidenceStride]);
+      double c10 = c[phaseStride] +
+                   te * (c[phaseStride + emissionStride] - c[phaseStride]);
+      double c11 = c[phaseStride + incidenceStride] +
+                   te * (c[phaseStride + incidenceStride + emissionStride] -
+                         c[phaseStride + incidenceStride]);
+      double c0 = c00 + ti * (c01 - c00);
+      double c1 = c10 + ti * (c11 - c10);
+      values[k] = c0 + tp * (c1 - c0);
+    }
+  }
+}
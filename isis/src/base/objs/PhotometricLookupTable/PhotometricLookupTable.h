@@ -0,0 +1,129 @@
+#ifndef PhotometricLookupTable_h
+#define PhotometricLookupTable_h
+/** This is free and unencumbered software released into the public domain.
+
+The authors of ISIS do not claim copyright on the contents of this file.
+For more details about the LICENSE terms and the AUTHORS, you will
+find files of those names at the top level of this repository. **/
+
+/* SPDX-License-Identifier: CC0-1.0 */
+
+#include <functional>
+#include <vector>
+
+#include <QVector>
+
+namespace Isis {
+
+  /**
+   * @brief A table of a photometric function of the phase, incidence and emission angles
+   *
+   * Photometric and atmospheric models compute powers, exponentials and arccosines for every
+   * pixel, but for a fixed set of parameters they are smooth functions of the three angles.
+   * This class samples such a function on a grid over phase angles from 0 to 180 degrees and
+   * incidence and emission angles from 0 to 90 degrees, and interpolates trilinearly between
+   * the samples.
+   *
+   * The angles are divided into 4 degree blocks, and a block is only sampled the first time
+   * interpolate() is asked for angles in it, so the function is only tabulated over the angles
+   * an image actually has. Each block is checked against the function halfway between its
+   * nodes, at the center of every cell and at the centers of its faces and edges, with a margin
+   * for the rest of the cell. A block that misses is sampled again at 2 and then 1 degree,
+   * until every point passes or the share of the block that misses stops shrinking. The cells
+   * that still miss, usually near the limb where the functions change quickly, and their
+   * neighbors in the block are marked so that interpolate() refuses them and the caller
+   * evaluates the function directly.
+   *
+   * The tolerance is only checked at those points, so it is a target rather than a bound.
+   * For the smooth functions the photometric models are away from the limb, the error
+   * between the points is smaller than at them.
+   *
+   * Because blocks are sampled as they are needed, interpolate() changes the table and must
+   * not be called from several threads at once.
+   *
+   * @ingroup RadiometricAndPhotometricCorrection
+   *
+   * @author 2026-10-16 ISIS Development Team
+   *
+   * @internal
+   *   @history 2026-10-16 ISIS Development Team - Original version
+   *   @history 2026-10-17 ISIS Development Team - The cells are checked at the centers of
+   *                           their faces and edges as well as their centers, and the
+   *                           documentation describes the tolerance as a target.
+   *   @history 2026-10-17 ISIS Development Team - The table is sampled in blocks as
+   *                           interpolate() needs them, and each block is refined on its own
+   *                           until it passes or stops improving, instead of refining the
+   *                           whole grid. Replaced stepSize() with stepSize(phase, incidence,
+   *                           emission) and added sampledBlockCount() and evaluationCount().
+   */
+  class PhotometricLookupTable {
+    public:
+      /**
+       * A function of the phase, incidence and emission angles, in degrees, that writes its
+       * values to the array
+       */
+      typedef std::function<void(double, double, double, double *)> Function;
+
+      PhotometricLookupTable(int valueCount = 1);
+      ~PhotometricLookupTable();
+
+      void build(const Function &function, double tolerance);
+      void clear();
+
+      bool interpolate(double phase, double incidence, double emission, double *values);
+
+      //! Returns true if the table has been built
+      bool isBuilt() const {
+        return m_tolerance > 0.0;
+      }
+
+      //! Returns the number of values the function computes
+      int valueCount() const {
+        return m_valueCount;
+      }
+
+      //! Returns the relative tolerance the table was built to
+      double tolerance() const {
+        return m_tolerance;
+      }
+
+      //! Returns the number of times the function has been evaluated to sample the table
+      int evaluationCount() const {
+        return m_evaluationCount;
+      }
+
+      double stepSize(double phase, double incidence, double emission) const;
+      int sampledBlockCount() const;
+      int cellCount() const;
+      int exactCellCount() const;
+
+    private:
+      /**
+       * The samples of one block of the table
+       */
+      struct Block {
+        double stepSize;  //!< The spacing of the samples in degrees, 0 if not sampled yet
+        int nodeCount;    //!< The number of samples along each angle
+        QVector<double> values;        //!< The samples, with the emission angle varying fastest
+        std::vector<bool> exactCells;  //!< True for the cells that are not interpolated
+      };
+
+      int blockIndex(double phase, double incidence, double emission) const;
+      void sample(int index);
+      void evaluate(double phase, double incidence, double emission, double *values);
+      int validate(Block &block, const QVector<double> &halfSteps, double &largestError);
+      void interpolateBlock(const Block &block, double x, double y, double z,
+                            double *values) const;
+
+      Function m_function;    //!< The tabulated function
+      int m_valueCount;       //!< The number of values at each sample
+      double m_tolerance;     //!< The relative tolerance, 0 if the table is not built
+      int m_evaluationCount;  //!< The number of function evaluations made to sample the table
+      int m_phaseBlocks;      //!< The number of blocks along the phase angle
+      int m_incidenceBlocks;  //!< The number of blocks along the incidence angle
+      int m_emissionBlocks;   //!< The number of blocks along the emission angle
+      std::vector<Block> m_blocks; //!< The blocks, with the emission angle varying fastest
+  };
+};
+
+#endif
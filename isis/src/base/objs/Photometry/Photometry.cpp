@@ -74,6 +74,25 @@ namespace Isis {
     p_phtNmodel->SetNormWavelength(wl);
   }
 
+  /**
+   * Tabulate the photometric and atmospheric models so that they are
+   * interpolated for each pixel instead of evaluated. The tables are
+   * sampled as the angles are met. This must be called after the models
+   * are created, because the normalization model sets their parameters.
+   *
+   * @param tolerance  The relative error the interpolated values are
+   *                   checked against, see PhotometricLookupTable. A
+   *                   tolerance of 0 discards the tables.
+   */
+  void Photometry::SetLookupTolerance(double tolerance) {
+    // The atmospheric model integrates the photometric function, so it
+    // is tabulated first to use the exact function
+    if (p_phtAmodel != NULL) {
+      p_phtAmodel->SetLookupTolerance(tolerance);
+    }
+    p_phtPmodel->SetLookupTolerance(tolerance);
+  }
+
   /**
    * Calculate the surface brightness using only ellipsoid
    *
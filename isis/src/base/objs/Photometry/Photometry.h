@@ -31,6 +31,8 @@ namespace Isis {
    *  @history 2008-07-09 Steven Lambright - Fixed unit test
    *  @history 2011-08-19 Sharmila Prasad - Implemented brentminimizer using GSL
    *  @history 2011-09-15 Sharmila Prasad - Implemented brent's root solver using GSL
+   *  @history 2026-10-16 ISIS Development Team - Added SetLookupTolerance to tabulate the
+   *                      photometric and atmospheric models.
    */
   class Photometry {
     public:
@@ -48,6 +50,9 @@ namespace Isis {
       //! Set the wavelength
       virtual void SetPhotomWl(double wl);
 
+      //! Tabulate the photometric and atmospheric models
+      void SetLookupTolerance(double tolerance);
+
       //! Double precision version of bracketing algorithm ported from Python.
       //! Solution bracketing for 1-D minimization routine.
       static void minbracket(double &xa, double &xb, double &xc, double &fa,
@@ -26,6 +26,7 @@ namespace Isis {
     p_inputBrickSizeSet = false;
     p_outputBrickSizeSet = false;
     p_wrapOption = false;
+    p_reentrant = false;
     p_reverse = false;
   }
 
@@ -421,6 +422,32 @@ void ProcessByBrick::SetOutputRequirements(int outputRequirements) {
   }
 
 
+  /**
+   * Declares that the functions passed into StartProcess are reentrant. A reentrant function only
+   * changes the buffers it is given and any other state it reads is not changed while processing,
+   * so it can be called for different bricks at the same time. StartProcess then reads, processes
+   * and writes bricks on several threads, the same way ProcessCube(), ProcessCubes() and
+   * ProcessCubeInPlace() do when threaded. The results are the same as processing the bricks one
+   * at a time. The function must not throw, since exceptions can not be passed back from the
+   * processing threads.
+   *
+   * @param reentrant Specifies whether StartProcess functions can run on several threads
+   */
+  void ProcessByBrick::SetReentrant(bool reentrant) {
+    p_reentrant = reentrant;
+  }
+
+
+  /**
+   * Returns true if the functions passed into StartProcess can run on several threads.
+   * @see SetReentrant()
+   * @return The value of the reentrant option
+   */
+  bool ProcessByBrick::Reentrant() const {
+    return p_reentrant;
+  }
+
+
   /**
    * Starts the systematic processing of the input cube by moving an arbitrarily-shaped
    * brick through the cube. This method requires that exactly one input
@@ -434,6 +461,11 @@ void ProcessByBrick::SetOutputRequirements(int outputRequirements) {
    * @throws iException::Programmer
    */
   void ProcessByBrick::StartProcess(void funct(Buffer &in)) {
+    if (p_reentrant) {
+      ProcessCubeInPlace(funct, true);
+      return;
+    }
+
     Cube *cube = NULL;
     Brick *brick = NULL;
 
@@ -474,6 +506,11 @@ void ProcessByBrick::SetOutputRequirements(int outputRequirements) {
    * @throws iException::Programmer
    */
   void ProcessByBrick::StartProcess(std::function<void(Buffer &in)> funct ) {
+    if (p_reentrant) {
+      ProcessCubeInPlace(funct, true);
+      return;
+    }
+
     Cube *cube = NULL;
     Brick *brick = NULL;
 
@@ -515,6 +552,11 @@ void ProcessByBrick::SetOutputRequirements(int outputRequirements) {
    * @throws iException::Programmer
    */
   void ProcessByBrick::StartProcess(void funct(Buffer &in, Buffer &out)) {
+    if (p_reentrant) {
+      ProcessCube(funct, true);
+      return;
+    }
+
     Brick *ibrick = NULL;
     Brick *obrick = NULL;
 
@@ -555,6 +597,11 @@ void ProcessByBrick::SetOutputRequirements(int outputRequirements) {
    * @throws iException::Programmer
    */
   void ProcessByBrick::StartProcess(std::function<void(Buffer &in, Buffer &out)> funct ) {
+    if (p_reentrant) {
+      ProcessCube(funct, true);
+      return;
+    }
+
     Brick *ibrick = NULL;
     Brick *obrick = NULL;
 
@@ -595,6 +642,11 @@ void ProcessByBrick::SetOutputRequirements(int outputRequirements) {
    */
   void ProcessByBrick::StartProcess(void funct(std::vector<Buffer *> &in,
                                                std::vector<Buffer *> &out)) {
+    if (p_reentrant) {
+      ProcessCubes(funct, true);
+      return;
+    }
+
     // Construct two vectors of brick buffer managers
     // The input buffer managers
     vector<Brick *> imgrs;
@@ -670,6 +722,11 @@ void ProcessByBrick::SetOutputRequirements(int outputRequirements) {
    */
   void ProcessByBrick::StartProcess(std::function<void(std::vector<Buffer *> &in,
                                                        std::vector<Buffer *> &out)> funct) {
+    if (p_reentrant) {
+      ProcessCubes(funct, true);
+      return;
+    }
+
     // Construct two vectors of brick buffer managers
     // The input buffer managers
     vector<Brick *> imgrs;
@@ -79,6 +79,9 @@ namespace Isis {
    *                          Fixes #4698.
    *   @history 2022-04-22 Jesse Mapel - Added std::function process method for multiple
    *                          input and output cubes.
+   *   @history 2026-10-16 ISIS Development Team - Added SetReentrant() so applications can
+   *                          declare the function given to StartProcess reentrant and have
+   *                          StartProcess run it on several threads like ProcessCube().
    */
   class ProcessByBrick : public Process {
     public:
@@ -131,6 +134,9 @@ namespace Isis {
       void SetWrap(bool wrap);
       bool Wraps();
 
+      void SetReentrant(bool reentrant);
+      bool Reentrant() const;
+
       using Isis::Process::StartProcess;  // make parents virtual function visable
       virtual void StartProcess(void funct(Buffer &in));
       virtual void StartProcess(std::function<void(Buffer &in)> funct );
@@ -824,6 +830,7 @@ namespace Isis {
                         objects when the Processing Direction is changed from
                         LinesFirst to BandsFirst*/
       bool p_wrapOption;    //!< Indicates whether the brick manager will wrap
+      bool p_reentrant;     //!< StartProcess functions can run on several threads
       bool p_inputBrickSizeSet;  /**< Indicates whether the brick size has been
                                       set*/
       bool p_outputBrickSizeSet; /**< Indicates whether the brick size has been
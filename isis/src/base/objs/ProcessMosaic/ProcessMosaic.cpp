@@ -4,6 +4,14 @@ For more details about the LICENSE terms and the AUTHORS, you will
 find files of those names at the top level of this repository. **/
 
 /* SPDX-License-Identifier: CC0-1.0 */
+#include <algorithm>
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPair>
+#include <QThreadPool>
+#include <QtConcurrentMap>
+
 #include "Preference.h"
 
 #include "Application.h"
@@ -38,6 +46,7 @@ namespace Isis {
     m_trackingEnabled    = false;
     m_trackingCube = NULL;
     m_createOutputMosaic   = false;
+    m_compositeMosaic = false;
     m_bandPriorityBandNumber  = 0;
     m_bandPriorityKeyName  = "";
     m_bandPriorityKeyValue = "";
@@ -182,9 +191,16 @@ namespace Isis {
       m_osb = 1;
     }
 
-    p_progress->SetMaximumSteps(
-        (int)InputCubes[0]->lineCount() * (int)InputCubes[0]->bandCount());
-    p_progress->CheckStatus();
+    // The mosaic values are kept in memory between inputs when compositing, so they have to be
+    // stored the same way the cube would store them
+    bool composite = m_compositeMosaic && OutputCubes[0]->pixelType() == Real &&
+                     OutputCubes[0]->base() == 0.0 && OutputCubes[0]->multiplier() == 1.0;
+
+    if (!composite) {
+      p_progress->SetMaximumSteps(
+          (int)InputCubes[0]->lineCount() * (int)InputCubes[0]->bandCount());
+      p_progress->CheckStatus();
+    }
 
     // Tracking is done for:
     // (1) Band priority,
@@ -363,15 +379,7 @@ namespace Isis {
 
     m_onb = OutputCubes[0]->bandCount();
 
-    if (m_trackingEnabled) {
-
-      // For mosaic creation, the input is copied onto mosaic by default
-      if (m_imageOverlay == UseBandPlacementCriteria && !m_createOutputMosaic) {
-        BandComparison(iss, isl, ins, inl,
-                       bandPriorityInputBandNumber, bandPriorityOutputBandNumber, iIndex);
-      }
-    }
-    else if (m_imageOverlay == AverageImageWithMosaic) {
+    if (!m_trackingEnabled && m_imageOverlay == AverageImageWithMosaic) {
       m_onb /= 2;
       if (m_onb < 1) {
         QString msg = "The mosaic cube needs a count band.";
@@ -379,10 +387,52 @@ namespace Isis {
       }
     }
 
+    Placement placement;
+    placement.fileName = InputCubes[0]->fileName();
+    for (int band = 1; band <= InputCubes[0]->bandCount(); band++) {
+      placement.bands.append(toString(InputCubes[0]->physicalBand(band)));
+    }
+    placement.iss = iss;
+    placement.isl = isl;
+    placement.isb = isb;
+    placement.ins = ins;
+    placement.inl = inl;
+    placement.inb = inb;
+    placement.oss = m_oss;
+    placement.osl = m_osl;
+    placement.osb = m_osb;
+    placement.onb = m_onb;
+    placement.inputCompareBand = bandPriorityInputBandNumber;
+    placement.outputCompareBand = bandPriorityOutputBandNumber;
+    placement.create = m_createOutputMosaic;
+    placement.tracking = m_trackingEnabled;
+    placement.trackingIndex = iIndex;
+    placement.imageOverlay = m_imageOverlay;
+    placement.useMaxValue = m_bandPriorityUseMaxValue;
+    placement.placeHighSatPixels = m_placeHighSatPixels;
+    placement.placeLowSatPixels = m_placeLowSatPixels;
+    placement.placeNullPixels = m_placeNullPixels;
+
+    // The pixels are placed with the rest of the inputs by EndProcess
+    if (composite) {
+      m_placements.append(placement);
+
+      if (m_trackingCube) {
+        m_trackingCube->close();
+        delete m_trackingCube;
+        m_trackingCube = NULL;
+      }
+      return;
+    }
+
+    // For mosaic creation, the input is copied onto mosaic by default
+    if (m_trackingEnabled && m_imageOverlay == UseBandPlacementCriteria && !m_createOutputMosaic) {
+      BandComparison(placement);
+    }
+
     // Process Band Priority with no tracking
     if (m_imageOverlay == UseBandPlacementCriteria && !m_trackingEnabled ) {
-      BandPriorityWithNoTracking(iss, isl, isb, ins, inl, inb, bandPriorityInputBandNumber,
-                                 bandPriorityOutputBandNumber);
+      BandPriorityWithNoTracking(placement);
     }
     else {
       // Create portal buffers for the input and output files
@@ -390,6 +440,10 @@ namespace Isis {
       Portal oPortal(ins, 1, OutputCubes[0]->pixelType());
       Portal countPortal(ins, 1, OutputCubes[0]->pixelType());
       Portal trackingPortal(ins, 1, PixelType::UnsignedInteger);
+      Portal iComparePortal(ins, 1, InputCubes[0]->pixelType());
+      Portal oComparePortal(ins, 1, OutputCubes[0]->pixelType());
+      bool compareBands = m_trackingEnabled && m_imageOverlay == UseBandPlacementCriteria &&
+                          !m_createOutputMosaic;
 
       for (int ib = isb, ob = m_osb; ib < (isb + inb) && ob <= m_onb; ib++, ob++) {
         for (int il = isl, ol = m_osl; il < isl + inl; il++, ol++) {
@@ -409,93 +463,20 @@ namespace Isis {
             OutputCubes[0]->read(countPortal);
           }
 
-          bool bChanged = false;
+          // Band Priority compares one band of the input and mosaic for every band
+          if (compareBands) {
+            iComparePortal.SetPosition(iss, il, bandPriorityInputBandNumber);
+            InputCubes[0]->read(iComparePortal);
+            oComparePortal.SetPosition(m_oss, ol, bandPriorityOutputBandNumber);
+            OutputCubes[0]->read(oComparePortal);
+          }
+
           // Move the input data to the output
-          for (int pixel = 0; pixel < oPortal.size(); pixel++) {
-            // Creating Mosaic, copy the input onto mosaic
-            // regardless of the priority
-            if (m_createOutputMosaic) {
-              oPortal[pixel] = iPortal[pixel];
-              if (m_trackingEnabled) {
-                trackingPortal[pixel] = iIndex;
-                bChanged = true;
-              }
-              else if (m_imageOverlay == AverageImageWithMosaic) {
-                if (IsValidPixel(iPortal[pixel])) {
-                  countPortal[pixel]=1;
-                  bChanged = true;
-                }
-              }
-            }
-            // Band Priority
-            else if (m_trackingEnabled && m_imageOverlay == UseBandPlacementCriteria) {
-              int iPixelOrigin = qRound(trackingPortal[pixel]);
-
-              Portal iComparePortal( ins, 1, InputCubes[0]->pixelType() );
-              Portal oComparePortal( ins, 1, OutputCubes[0]->pixelType() );
-              iComparePortal.SetPosition(iss, il, bandPriorityInputBandNumber);
-              InputCubes[0]->read(iComparePortal);
-              oComparePortal.SetPosition(m_oss, ol, bandPriorityOutputBandNumber);
-              OutputCubes[0]->read(oComparePortal);
-
-              if (iPixelOrigin == iIndex) {
-                if ( ( IsValidPixel(iComparePortal[pixel]) &&
-                       IsValidPixel(oComparePortal[pixel]) ) &&
-                     ( (!m_bandPriorityUseMaxValue &&
-                        iComparePortal[pixel] < oComparePortal[pixel]) ||
-                       (m_bandPriorityUseMaxValue &&
-                        iComparePortal[pixel] > oComparePortal[pixel]) ) ) {
-
-                  if ( IsValidPixel(iPortal[pixel]) ||
-                       ( m_placeHighSatPixels && IsHighPixel(iPortal[pixel]) ) ||
-                       ( m_placeLowSatPixels  && IsLowPixel (iPortal[pixel]) ) ||
-                       ( m_placeNullPixels    && IsNullPixel(iPortal[pixel]) ) ){
-                    oPortal[pixel] = iPortal[pixel];
-                    bChanged = true;
-                  }
-                }
-                else { //bad comparison
-                  if ( ( IsValidPixel(iPortal[pixel]) && !IsValidPixel(oPortal[pixel]) ) ||
-                       ( m_placeHighSatPixels && IsHighPixel(iPortal[pixel]) ) ||
-                       ( m_placeLowSatPixels  && IsLowPixel (iPortal[pixel]) ) ||
-                       ( m_placeNullPixels    && IsNullPixel(iPortal[pixel]) ) ) {
-                    oPortal[pixel] = iPortal[pixel];
-                    bChanged = true;
-                  }
-                }
-              }
-            }
-            // OnTop/Input Priority
-            else if (m_imageOverlay == PlaceImagesOnTop) {
-              if (IsNullPixel(oPortal[pixel])  ||
-                 IsValidPixel(iPortal[pixel]) ||
-                 (m_placeHighSatPixels && IsHighPixel(iPortal[pixel])) ||
-                 (m_placeLowSatPixels  && IsLowPixel(iPortal[pixel]))  ||
-                 (m_placeNullPixels    && IsNullPixel(iPortal[pixel]))) {
-                oPortal[pixel] = iPortal[pixel];
-                if (m_trackingEnabled) {
-                  trackingPortal[pixel] = iIndex;
-                  bChanged = true;
-                }
-              }
-            }
-            // AverageImageWithMosaic priority
-            else if (m_imageOverlay == AverageImageWithMosaic) {
-              bChanged |= ProcessAveragePriority(pixel, iPortal, oPortal, countPortal);
-            }
-            // Beneath/Mosaic Priority
-            else if (m_imageOverlay == PlaceImagesBeneath) {
-              if (IsNullPixel(oPortal[pixel])) {
-                oPortal[pixel] = iPortal[pixel];
-                // Set the origin if number of input bands equal to 1
-                // and if the track flag was set
-                if (m_trackingEnabled) {
-                  trackingPortal[pixel] = iIndex;
-                  bChanged = true;
-                }
-              }
-            }
-          } // End sample loop
+          bool bChanged = PlacePixels(placement, iPortal.DoubleBuffer(), oPortal.DoubleBuffer(),
+                                      countPortal.DoubleBuffer(),
+                                      trackingPortal.DoubleBuffer(),
+                                      iComparePortal.DoubleBuffer(),
+                                      oComparePortal.DoubleBuffer());
           if (bChanged) {
             if (m_trackingEnabled) {
               m_trackingCube->write(trackingPortal);
@@ -518,9 +499,12 @@ namespace Isis {
 
 
   /**
-   * Cleans up by closing input, output and tracking cubes
+   * Cleans up by closing input, output and tracking cubes. When compositing, the recorded inputs
+   * are placed in the mosaic first.
    */
   void ProcessMosaic::EndProcess() {
+    CompositePlacements();
+
     if (m_trackingCube) {
       m_trackingCube->close();
       delete m_trackingCube;
@@ -530,6 +514,342 @@ namespace Isis {
   }
 
 
+  /**
+   * The value a Real cube with no base or multiplier gives back after the value is written to it.
+   *
+   * @param dn The value written.
+   *
+   * @return @b double The value read back.
+   */
+  static double storedRealValue(double dn) {
+    if (dn >= VALID_MIN8) {
+      if (dn < (double) VALID_MIN4) {
+        return Lrs;
+      }
+      if (dn > (double) VALID_MAX4) {
+        return Hrs;
+      }
+      return (double) (float) dn;
+    }
+
+    if (dn == Null || dn == Lis || dn == Lrs || dn == His || dn == Hrs) {
+      return dn;
+    }
+    return Lrs;
+  }
+
+
+  /**
+   * Replace values with the values a Real cube with no base or multiplier gives back after they
+   * are written to it.
+   *
+   * @param values The values.
+   * @param count The number of values.
+   */
+  static void storeRealValues(double *values, int count) {
+    for (int i = 0; i < count; i++) {
+      values[i] = storedRealValue(values[i]);
+    }
+  }
+
+
+  //! The most inputs CompositePlacements keeps open at once
+  static const int MaxOpenCompositeInputs = 64;
+
+
+  /**
+   * Place every input recorded by StartProcess while compositing. The mosaic is built a batch of
+   * lines at a time. The inputs that cover a batch are found from their start lines and are
+   * placed on it in the order they were started, each one on all of its lines in parallel. Every
+   * mosaic line is read once and written once. Inputs stay open while they cover the batches
+   * being built, but no more than a fixed number are open at once.
+   *
+   * @throws IException::Message
+   */
+  void ProcessMosaic::CompositePlacements() {
+    if (m_placements.isEmpty()) {
+      return;
+    }
+
+    const QList<Placement> placements = m_placements;
+    m_placements.clear();
+
+    Cube *mosaic = OutputCubes[0];
+    int mosaicSamples = mosaic->sampleCount();
+    int mosaicBands = mosaic->bandCount();
+
+    int firstLine = mosaic->lineCount();
+    int lastLine = 1;
+    bool tracking = false;
+    for (int i = 0; i < placements.size(); i++) {
+      firstLine = min(firstLine, placements[i].osl);
+      lastLine = max(lastLine, placements[i].osl + placements[i].inl - 1);
+      tracking = tracking || placements[i].tracking;
+    }
+
+    // The inputs in the order they start in the mosaic
+    QVector<int> byStartLine(placements.size());
+    for (int i = 0; i < placements.size(); i++) {
+      byStartLine[i] = i;
+    }
+    std::stable_sort(byStartLine.begin(), byStartLine.end(),
+                     [&placements](int input1, int input2) {
+                       return placements[input1].osl < placements[input2].osl;
+                     });
+
+    Cube trackingCube;
+    if (tracking) {
+      QString trackingPath = FileName(mosaic->fileName()).path();
+      QString trackingFile = mosaic->group("Tracking").findKeyword("FileName")[0];
+      trackingCube.open(trackingPath + "/" + trackingFile, "rw");
+    }
+
+    // Enough lines to keep every thread busy, few enough to bound the memory
+    int threads = QThreadPool::globalInstance()->maxThreadCount();
+    qint64 lineBytes = (qint64) mosaicSamples * (mosaicBands + 1) * sizeof(double);
+    int batchSize = (int) max((qint64) threads,
+                              min((qint64) 16 * threads, 256 * 1024 * 1024 / lineBytes));
+
+    p_progress->SetText("Compositing mosaic");
+    p_progress->SetMaximumSteps(lastLine - firstLine + 1);
+    p_progress->CheckStatus();
+
+    // The open inputs, least recently used first
+    QList< QPair<int, Cube *> > openInputs;
+
+    try {
+      int nextStart = 0;
+      QVector<int> covering;
+
+      for (int batchStart = firstLine; batchStart <= lastLine; batchStart += batchSize) {
+        int batchEnd = min(batchStart + batchSize - 1, lastLine);
+
+        // The inputs that cover the batch, in the order they were started
+        for (; nextStart < byStartLine.size() &&
+               placements[byStartLine[nextStart]].osl <= batchEnd; nextStart++) {
+          covering.insert(std::lower_bound(covering.begin(), covering.end(),
+                                           byStartLine[nextStart]),
+                          byStartLine[nextStart]);
+        }
+
+        std::vector<int> lines;
+        for (int line = batchStart; line <= batchEnd; line++) {
+          lines.push_back(line);
+        }
+        std::vector< QVector< QVector<double> > > mosaicLines(lines.size());
+        std::vector< QVector<double> > trackingLines(lines.size());
+
+        QMutex errorMutex;
+        int errorLine = 0;
+        IException error;
+
+        QtConcurrent::blockingMap(lines,
+            [&](int &line) {
+              try {
+                QVector< QVector<double> > &mosaicLine = mosaicLines[line - batchStart];
+                QVector<double> &trackingLine = trackingLines[line - batchStart];
+
+                Portal portal(mosaicSamples, 1, mosaic->pixelType());
+                for (int band = 1; band <= mosaicBands; band++) {
+                  portal.SetPosition(1, line, band);
+                  mosaic->read(portal);
+                  mosaicLine.append(QVector<double>(portal.size()));
+                  std::copy(portal.DoubleBuffer(), portal.DoubleBuffer() + portal.size(),
+                            mosaicLine.last().begin());
+                }
+
+                if (tracking) {
+                  Portal trackingPortal(mosaicSamples, 1, PixelType::UnsignedInteger);
+                  trackingPortal.SetPosition(1, line, 1);
+                  trackingCube.read(trackingPortal);
+                  trackingLine.resize(trackingPortal.size());
+                  std::copy(trackingPortal.DoubleBuffer(),
+                            trackingPortal.DoubleBuffer() + trackingPortal.size(),
+                            trackingLine.begin());
+                }
+              }
+              catch (IException &e) {
+                QMutexLocker locker(&errorMutex);
+                if (errorLine == 0 || line < errorLine) {
+                  errorLine = line;
+                  error = e;
+                }
+              }
+            });
+
+        if (errorLine != 0) {
+          throw error;
+        }
+
+        for (int i = 0; i < covering.size(); i++) {
+          const Placement &placement = placements[covering[i]];
+
+          // Reuse the input if it is still open, otherwise make room for it
+          Cube *inputCube = NULL;
+          for (int open = 0; open < openInputs.size(); open++) {
+            if (openInputs[open].first == covering[i]) {
+              inputCube = openInputs[open].second;
+              openInputs.move(open, openInputs.size() - 1);
+              break;
+            }
+          }
+          if (!inputCube) {
+            if (openInputs.size() >= MaxOpenCompositeInputs) {
+              delete openInputs.takeFirst().second;
+            }
+            inputCube = new Cube;
+            openInputs.append(qMakePair(covering[i], inputCube));
+            inputCube->setVirtualBands(placement.bands);
+            inputCube->open(placement.fileName);
+          }
+
+          std::vector<int> inputLines;
+          for (int line = max(batchStart, placement.osl);
+               line <= min(batchEnd, placement.osl + placement.inl - 1); line++) {
+            inputLines.push_back(line);
+          }
+
+          QtConcurrent::blockingMap(inputLines,
+              [&](int &line) {
+                try {
+                  PlaceLine(placement, *inputCube, line, mosaicLines[line - batchStart],
+                            trackingLines[line - batchStart]);
+                }
+                catch (IException &e) {
+                  QMutexLocker locker(&errorMutex);
+                  if (errorLine == 0 || line < errorLine) {
+                    errorLine = line;
+                    error = e;
+                  }
+                }
+              });
+
+          if (errorLine != 0) {
+            throw error;
+          }
+        }
+
+        Portal portal(mosaicSamples, 1, mosaic->pixelType());
+        Portal trackingPortal(mosaicSamples, 1, PixelType::UnsignedInteger);
+        for (unsigned int i = 0; i < lines.size(); i++) {
+          for (int band = 1; band <= mosaicBands; band++) {
+            portal.SetPosition(1, lines[i], band);
+            std::copy(mosaicLines[i][band - 1].constBegin(), mosaicLines[i][band - 1].constEnd(),
+                      portal.DoubleBuffer());
+            mosaic->write(portal);
+          }
+
+          if (tracking) {
+            trackingPortal.SetPosition(1, lines[i], 1);
+            std::copy(trackingLines[i].constBegin(), trackingLines[i].constEnd(),
+                      trackingPortal.DoubleBuffer());
+            trackingCube.write(trackingPortal);
+          }
+          p_progress->CheckStatus();
+        }
+
+        // Inputs that end in this batch are done
+        int kept = 0;
+        for (int i = 0; i < covering.size(); i++) {
+          const Placement &placement = placements[covering[i]];
+          if (placement.osl + placement.inl - 1 > batchEnd) {
+            covering[kept++] = covering[i];
+          }
+          else {
+            for (int open = 0; open < openInputs.size(); open++) {
+              if (openInputs[open].first == covering[i]) {
+                delete openInputs.takeAt(open).second;
+                break;
+              }
+            }
+          }
+        }
+        covering.resize(kept);
+      }
+    }
+    catch (IException &e) {
+      for (int open = 0; open < openInputs.size(); open++) {
+        delete openInputs[open].second;
+      }
+      throw;
+    }
+
+    for (int open = 0; open < openInputs.size(); open++) {
+      delete openInputs[open].second;
+    }
+
+    if (trackingCube.isOpen()) {
+      trackingCube.close();
+    }
+  }
+
+
+  /**
+   * Place an input on one line of the mosaic with the same rules StartProcess uses. The values
+   * are kept the way a Real mosaic stores them, so the next input sees what it would have read
+   * from the cube.
+   *
+   * @param placement Where the input goes and how it is placed.
+   * @param inputCube The input cube.
+   * @param line The mosaic line. The input must cover it.
+   * @param mosaicLine The mosaic bands of the line, updated in place.
+   * @param trackingLine The tracking cube values of the line, updated in place.
+   */
+  void ProcessMosaic::PlaceLine(const Placement &placement, const Cube &inputCube, int line,
+                                QVector< QVector<double> > &mosaicLine,
+                                QVector<double> &trackingLine) {
+    int inputLine = placement.isl + line - placement.osl;
+    int offset = placement.oss - 1;
+    bool bandPriority = placement.imageOverlay == UseBandPlacementCriteria;
+
+    Portal iPortal(placement.ins, 1, inputCube.pixelType());
+    Portal iComparePortal(placement.ins, 1, inputCube.pixelType());
+    const double *oCompare = NULL;
+    if (bandPriority) {
+      iComparePortal.SetPosition(placement.iss, inputLine, placement.inputCompareBand);
+      inputCube.read(iComparePortal);
+      oCompare = mosaicLine[placement.outputCompareBand - 1].constData() + offset;
+    }
+
+    if (bandPriority && !placement.tracking) {
+      QVector<bool> results;
+      if (ChooseBandPriorityPixels(placement, iComparePortal.DoubleBuffer(), oCompare, results)) {
+        for (int ib = placement.isb, ob = placement.osb;
+             ib < (placement.isb + placement.inb) && ob <= placement.onb; ib++, ob++) {
+          iPortal.SetPosition(placement.iss, inputLine, ib);
+          inputCube.read(iPortal);
+          double *out = mosaicLine[ob - 1].data() + offset;
+          PlaceBandPriorityPixels(placement, results, iPortal.DoubleBuffer(), out);
+          storeRealValues(out, placement.ins);
+        }
+      }
+      return;
+    }
+
+    double *trackingValues = placement.tracking ? trackingLine.data() + offset : NULL;
+    if (bandPriority && placement.tracking && !placement.create) {
+      TrackBandPriority(placement, iComparePortal.DoubleBuffer(), oCompare, trackingValues);
+    }
+
+    for (int ib = placement.isb, ob = placement.osb;
+         ib < (placement.isb + placement.inb) && ob <= placement.onb; ib++, ob++) {
+      iPortal.SetPosition(placement.iss, inputLine, ib);
+      inputCube.read(iPortal);
+
+      double *out = mosaicLine[ob - 1].data() + offset;
+      double *count = NULL;
+      if (!placement.tracking && placement.imageOverlay == AverageImageWithMosaic) {
+        count = mosaicLine[ob + placement.onb - 1].data() + offset;
+      }
+
+      // Bands before this one already have this input on them, the same as in the cube
+      PlacePixels(placement, iPortal.DoubleBuffer(), out, count, trackingValues,
+                  iComparePortal.DoubleBuffer(), oCompare);
+      storeRealValues(out, placement.ins);
+    }
+  }
+
+
   /**
    * Accessor for the placed images and their locations.
    *
@@ -780,6 +1100,19 @@ namespace Isis {
   }
 
 
+  /**
+   * When true, StartProcess only records where each input goes and EndProcess places all of them
+   * in one pass over the mosaic. The result is the same as placing each input when it is started.
+   * Compositing needs a Real mosaic with no base or multiplier; other mosaics have each input
+   * placed when it is started.
+   *
+   * @param compositeMosaic Composite the inputs in EndProcess True/False
+   */
+  void ProcessMosaic::SetCompositeFlag(bool compositeMosaic) {
+    m_compositeMosaic = compositeMosaic;
+  }
+
+
   /**
    * When true, high saturation (HRS, HIS) will be considered valid data for the purposes of
    *   placing pixels in the output mosaic.
@@ -825,6 +1158,14 @@ namespace Isis {
   }
 
 
+  /**
+   * @see SetCompositeFlag()
+   */
+  bool ProcessMosaic::GetCompositeFlag() const {
+    return m_compositeMosaic;
+  }
+
+
   /**
    * @see SetHighSaturationFlag()
    */
@@ -1027,41 +1368,41 @@ namespace Isis {
 
   /**
    * Calculate DN value for a pixel for AverageImageWithMosaic priority and set the
-   * Count band portal
+   * Count band value
    *
    * @author Sharmila Prasad (1/13/2011)
    *
-   * @param piPixel     - Pixel index
-   * @param piPortal    - Input Portal
-   * @param poPortal    - Output Portal
-   * @param countPortal - Count Portal
+   * @param placement - How the input is placed
+   * @param input     - Input pixel
+   * @param mosaic    - Mosaic pixel
+   * @param count     - Count band pixel
    *
    * @return bool
    */
-  bool ProcessMosaic::ProcessAveragePriority(int piPixel, Portal& piPortal, Portal& poPortal,
-                                             Portal& countPortal)
+  bool ProcessMosaic::ProcessAveragePriority(const Placement &placement, double input,
+                                             double &mosaic, double &count)
   {
     bool bChanged=false;
-    if (IsValidPixel(piPortal[piPixel]) && IsValidPixel(poPortal[piPixel])) {
-      int iCount = (int)countPortal[piPixel];
-      double dNewDN = (poPortal[piPixel] * iCount + piPortal[piPixel]) / (iCount + 1);
-      poPortal[piPixel] = dNewDN;
-      countPortal[piPixel] =iCount +1;
+    if (IsValidPixel(input) && IsValidPixel(mosaic)) {
+      int iCount = (int)count;
+      double dNewDN = (mosaic * iCount + input) / (iCount + 1);
+      mosaic = dNewDN;
+      count = iCount +1;
       bChanged = true;
     }
     // Input-Valid, Mosaic-Special
-    else if (IsValidPixel(piPortal[piPixel])) {
-      poPortal[piPixel] = piPortal[piPixel];
-      countPortal[piPixel] = 1;
+    else if (IsValidPixel(input)) {
+      mosaic = input;
+      count = 1;
       bChanged = true;
     }
     // Input-Special, Flags-True
-    else if (IsSpecial(piPortal[piPixel])) {
-      if ((m_placeHighSatPixels && IsHighPixel(piPortal[piPixel])) ||
-         (m_placeLowSatPixels  && IsLowPixel (piPortal[piPixel]))  ||
-         (m_placeNullPixels    && IsNullPixel(piPortal[piPixel]))) {
-        poPortal[piPixel]    = piPortal[piPixel];
-        countPortal[piPixel] = 0;
+    else if (IsSpecial(input)) {
+      if ((placement.placeHighSatPixels && IsHighPixel(input)) ||
+         (placement.placeLowSatPixels  && IsLowPixel (input))  ||
+         (placement.placeNullPixels    && IsNullPixel(input))) {
+        mosaic = input;
+        count  = 0;
         bChanged = true;
       }
     }
@@ -1329,138 +1670,284 @@ namespace Isis {
    * input pixel is assigned to the output if the origin pixel equals the current
    * input file index
    *
-   * @param iss - Comparison start sample
-   * @param isl - Comparison start line
-   * @param ins - The number of samples to compare
-   * @param inl - The number of lines to compare
-   * @param bandPriorityInputBandNumber - The band in the input cube to use for comparison
-   * @param bandPriorityOutputBandNumber - The band in the output cube to use for comparison
-   * @param index - Tracking index for the input cube
+   * @param placement - Where the input goes, the bands to compare and its tracking index
    *
    * @author Sharmila Prasad (9/04/2009)
    */
-  void ProcessMosaic::BandComparison(int iss, int isl, int ins, int inl,
-      int bandPriorityInputBandNumber, int bandPriorityOutputBandNumber, int index) {
+  void ProcessMosaic::BandComparison(const Placement &placement) {
     //
     // Create portal buffers for the input and output files
-    Portal cIportal(ins, 1, InputCubes[0]->pixelType());
-    Portal cOportal(ins, 1, OutputCubes[0]->pixelType());
-    Portal trackingPortal(ins, 1, PixelType::UnsignedInteger);
+    Portal cIportal(placement.ins, 1, InputCubes[0]->pixelType());
+    Portal cOportal(placement.ins, 1, OutputCubes[0]->pixelType());
+    Portal trackingPortal(placement.ins, 1, PixelType::UnsignedInteger);
 
-    for (int iIL = isl, iOL = m_osl; iIL < isl + inl; iIL++, iOL++) {
+    for (int iIL = placement.isl, iOL = placement.osl; iIL < placement.isl + placement.inl;
+         iIL++, iOL++) {
       // Set the position of the portals in the input and output cubes
-      cIportal.SetPosition(iss, iIL, bandPriorityInputBandNumber);
+      cIportal.SetPosition(placement.iss, iIL, placement.inputCompareBand);
       InputCubes[0]->read(cIportal);
 
-      cOportal.SetPosition(m_oss, iOL, bandPriorityOutputBandNumber);
+      cOportal.SetPosition(placement.oss, iOL, placement.outputCompareBand);
       OutputCubes[0]->read(cOportal);
 
-      trackingPortal.SetPosition(m_oss, iOL, 1);
+      trackingPortal.SetPosition(placement.oss, iOL, 1);
       m_trackingCube->read(trackingPortal);
 
-      // Move the input data to the output
-      for (int iPixel = 0; iPixel < cOportal.size(); iPixel++) {
-        if ((m_placeHighSatPixels && IsHighPixel(cIportal[iPixel])) ||
-            (m_placeLowSatPixels  && IsLowPixel(cIportal[iPixel])) ||
-            (m_placeNullPixels    && IsNullPixel(cIportal[iPixel]))) {
-          trackingPortal[iPixel] = index;
+      TrackBandPriority(placement, cIportal.DoubleBuffer(), cOportal.DoubleBuffer(),
+                        trackingPortal.DoubleBuffer());
+      m_trackingCube->write(trackingPortal);
+    }
+  }
+
+
+  /**
+   * Assign the input as the origin of the pixels of a line where the specified band of the input
+   * wins the comparison with the mosaic.
+   *
+   * @param placement - How the input is placed
+   * @param inputCompare - The input's comparison band
+   * @param mosaicCompare - The mosaic's comparison band
+   * @param tracking - The origin of each pixel, updated in place
+   */
+  void ProcessMosaic::TrackBandPriority(const Placement &placement, const double *inputCompare,
+                                        const double *mosaicCompare, double *tracking) {
+    for (int iPixel = 0; iPixel < placement.ins; iPixel++) {
+      if ((placement.placeHighSatPixels && IsHighPixel(inputCompare[iPixel])) ||
+          (placement.placeLowSatPixels  && IsLowPixel(inputCompare[iPixel])) ||
+          (placement.placeNullPixels    && IsNullPixel(inputCompare[iPixel]))) {
+        tracking[iPixel] = placement.trackingIndex;
+      }
+      else {
+        if (IsValidPixel(inputCompare[iPixel])) {
+          if (IsSpecial(mosaicCompare[iPixel]) ||
+              (placement.useMaxValue == false && inputCompare[iPixel] < mosaicCompare[iPixel]) ||
+              (placement.useMaxValue == true && inputCompare[iPixel] > mosaicCompare[iPixel])) {
+            tracking[iPixel] = placement.trackingIndex;
+          }
         }
-        else {
-          if (IsValidPixel(cIportal[iPixel])) {
-            if (IsSpecial(cOportal[iPixel]) ||
-                (m_bandPriorityUseMaxValue == false  && cIportal[iPixel] < cOportal[iPixel]) ||
-                (m_bandPriorityUseMaxValue == true && cIportal[iPixel] > cOportal[iPixel])) {
-              trackingPortal[iPixel] = index;
+      }
+    }
+  }
+
+
+  /**
+   * Move one band of a line of the input onto the mosaic for every priority but Band Priority
+   * with no tracking.
+   *
+   * @param placement - How the input is placed
+   * @param input - The input band
+   * @param mosaic - The mosaic band, updated in place
+   * @param count - The count band, updated in place when averaging without tracking
+   * @param tracking - The origin of each pixel, updated in place when tracking
+   * @param inputCompare - The input's comparison band for Band Priority with tracking
+   * @param mosaicCompare - The mosaic's comparison band for Band Priority with tracking
+   *
+   * @return bool True if the count or tracking values have to be written
+   */
+  bool ProcessMosaic::PlacePixels(const Placement &placement, const double *input,
+                                  double *mosaic, double *count, double *tracking,
+                                  const double *inputCompare, const double *mosaicCompare) {
+    bool bChanged = false;
+    for (int pixel = 0; pixel < placement.ins; pixel++) {
+      // Creating Mosaic, copy the input onto mosaic
+      // regardless of the priority
+      if (placement.create) {
+        mosaic[pixel] = input[pixel];
+        if (placement.tracking) {
+          tracking[pixel] = placement.trackingIndex;
+          bChanged = true;
+        }
+        else if (placement.imageOverlay == AverageImageWithMosaic) {
+          if (IsValidPixel(input[pixel])) {
+            count[pixel]=1;
+            bChanged = true;
+          }
+        }
+      }
+      // Band Priority
+      else if (placement.tracking && placement.imageOverlay == UseBandPlacementCriteria) {
+        int iPixelOrigin = qRound(tracking[pixel]);
+
+        if (iPixelOrigin == placement.trackingIndex) {
+          if ( ( IsValidPixel(inputCompare[pixel]) &&
+                 IsValidPixel(mosaicCompare[pixel]) ) &&
+               ( (!placement.useMaxValue &&
+                  inputCompare[pixel] < mosaicCompare[pixel]) ||
+                 (placement.useMaxValue &&
+                  inputCompare[pixel] > mosaicCompare[pixel]) ) ) {
+
+            if ( IsValidPixel(input[pixel]) ||
+                 ( placement.placeHighSatPixels && IsHighPixel(input[pixel]) ) ||
+                 ( placement.placeLowSatPixels  && IsLowPixel (input[pixel]) ) ||
+                 ( placement.placeNullPixels    && IsNullPixel(input[pixel]) ) ){
+              mosaic[pixel] = input[pixel];
+              bChanged = true;
+            }
+          }
+          else { //bad comparison
+            if ( ( IsValidPixel(input[pixel]) && !IsValidPixel(mosaic[pixel]) ) ||
+                 ( placement.placeHighSatPixels && IsHighPixel(input[pixel]) ) ||
+                 ( placement.placeLowSatPixels  && IsLowPixel (input[pixel]) ) ||
+                 ( placement.placeNullPixels    && IsNullPixel(input[pixel]) ) ) {
+              mosaic[pixel] = input[pixel];
+              bChanged = true;
             }
           }
         }
       }
-      m_trackingCube->write(trackingPortal);
-    }
+      // OnTop/Input Priority
+      else if (placement.imageOverlay == PlaceImagesOnTop) {
+        if (IsNullPixel(mosaic[pixel])  ||
+           IsValidPixel(input[pixel]) ||
+           (placement.placeHighSatPixels && IsHighPixel(input[pixel])) ||
+           (placement.placeLowSatPixels  && IsLowPixel(input[pixel]))  ||
+           (placement.placeNullPixels    && IsNullPixel(input[pixel]))) {
+          mosaic[pixel] = input[pixel];
+          if (placement.tracking) {
+            tracking[pixel] = placement.trackingIndex;
+            bChanged = true;
+          }
+        }
+      }
+      // AverageImageWithMosaic priority
+      else if (placement.imageOverlay == AverageImageWithMosaic) {
+        bChanged |= ProcessAveragePriority(placement, input[pixel], mosaic[pixel], count[pixel]);
+      }
+      // Beneath/Mosaic Priority
+      else if (placement.imageOverlay == PlaceImagesBeneath) {
+        if (IsNullPixel(mosaic[pixel])) {
+          mosaic[pixel] = input[pixel];
+          // Set the origin if number of input bands equal to 1
+          // and if the track flag was set
+          if (placement.tracking) {
+            tracking[pixel] = placement.trackingIndex;
+            bChanged = true;
+          }
+        }
+      }
+    } // End sample loop
+    return bChanged;
   }
 
 
   /**
    * Mosaicking for Band Priority with no Tracking
    *
+   * @param placement - Where the input goes and the bands to compare
+   *
    * @author Sharmila Prasad (1/4/2012)
    */
-void ProcessMosaic::BandPriorityWithNoTracking(int iss, int isl, int isb, int ins, int inl,
-                                                 int inb, int bandPriorityInputBandNumber,
-                                                 int bandPriorityOutputBandNumber) {
+  void ProcessMosaic::BandPriorityWithNoTracking(const Placement &placement) {
     /*
      * specified band for comparison
      * Create portal buffers for the input and output files pointing to the
      */
-    Portal iComparePortal( ins, 1, InputCubes[0]->pixelType() );
-    Portal oComparePortal( ins, 1, OutputCubes[0]->pixelType() );
-    Portal resultsPortal ( ins, 1, OutputCubes[0]->pixelType() );
+    Portal iComparePortal( placement.ins, 1, InputCubes[0]->pixelType() );
+    Portal oComparePortal( placement.ins, 1, OutputCubes[0]->pixelType() );
+    QVector<bool> results;
 
     // Create portal buffers for the input and output files
-    Portal iPortal( ins, 1, InputCubes[0]->pixelType() );
-    Portal oPortal( ins, 1, OutputCubes[0]->pixelType() );
+    Portal iPortal( placement.ins, 1, InputCubes[0]->pixelType() );
+    Portal oPortal( placement.ins, 1, OutputCubes[0]->pixelType() );
 
-    for (int inLine = isl, outLine = m_osl; inLine < isl + inl; inLine++, outLine++) {
+    for (int inLine = placement.isl, outLine = placement.osl;
+         inLine < placement.isl + placement.inl; inLine++, outLine++) {
 //       Set the position of the portals in the input and output cubes
-      iComparePortal.SetPosition(iss, inLine, bandPriorityInputBandNumber);
+      iComparePortal.SetPosition(placement.iss, inLine, placement.inputCompareBand);
       InputCubes[0]->read(iComparePortal);
 
-      oComparePortal.SetPosition(m_oss, outLine, bandPriorityOutputBandNumber);
+      oComparePortal.SetPosition(placement.oss, outLine, placement.outputCompareBand);
       OutputCubes[0]->read(oComparePortal);
 
-      Portal iPortal( ins, 1, InputCubes[0]->pixelType() );
-      Portal oPortal( ins, 1, OutputCubes[0]->pixelType() );
+      if (ChooseBandPriorityPixels(placement, iComparePortal.DoubleBuffer(),
+                                   oComparePortal.DoubleBuffer(), results)) {
+        for (int ib = placement.isb, ob = placement.osb;
+             ib < (placement.isb + placement.inb) && ob <= placement.onb; ib++, ob++) {
+//           Set the position of the portals in the input and output cubes
+          iPortal.SetPosition(placement.iss, inLine, ib);
+          InputCubes[0]->read(iPortal);
+
+          oPortal.SetPosition(placement.oss, outLine, ob);
+          OutputCubes[0]->read(oPortal);
 
-      bool inCopy = false;
-//       Move the input data to the output
-      for (int iPixel = 0; iPixel < ins; iPixel++) {
-        resultsPortal[iPixel] = false;
-        if (m_createOutputMosaic) {
-          resultsPortal[iPixel] = true;
-          inCopy = true;
-        }
-        else if ( IsValidPixel(iComparePortal[iPixel]) && IsValidPixel(oComparePortal[iPixel]) ) {
-          if ( (m_bandPriorityUseMaxValue == false  &&
-                iComparePortal[iPixel] < oComparePortal[iPixel]) ||
-                (m_bandPriorityUseMaxValue == true &&
-                iComparePortal[iPixel] > oComparePortal[iPixel]) ) {
-            resultsPortal[iPixel] = true;
-            inCopy = true;
-          }
+          PlaceBandPriorityPixels(placement, results, iPortal.DoubleBuffer(),
+                                  oPortal.DoubleBuffer());
+          OutputCubes[0]->write(oPortal);
         }
-        else if (IsValidPixel(iComparePortal[iPixel]) && !IsValidPixel(oComparePortal[iPixel]) ) {
-          resultsPortal[iPixel] = true;
+      }
+    }
+  }
+
+
+  /**
+   * Choose the pixels of a line where the specified band of the input wins the comparison with
+   * the mosaic, for Band Priority with no Tracking.
+   *
+   * @param placement - How the input is placed
+   * @param inputCompare - The input's comparison band
+   * @param mosaicCompare - The mosaic's comparison band
+   * @param results - Set to whether each pixel is chosen
+   *
+   * @return bool True if any pixel is chosen
+   */
+  bool ProcessMosaic::ChooseBandPriorityPixels(const Placement &placement,
+                                               const double *inputCompare,
+                                               const double *mosaicCompare,
+                                               QVector<bool> &results) {
+    results.fill(false, placement.ins);
+
+    bool inCopy = false;
+//   Move the input data to the output
+    for (int iPixel = 0; iPixel < placement.ins; iPixel++) {
+      if (placement.create) {
+        results[iPixel] = true;
+        inCopy = true;
+      }
+      else if ( IsValidPixel(inputCompare[iPixel]) && IsValidPixel(mosaicCompare[iPixel]) ) {
+        if ( (placement.useMaxValue == false  &&
+              inputCompare[iPixel] < mosaicCompare[iPixel]) ||
+              (placement.useMaxValue == true &&
+              inputCompare[iPixel] > mosaicCompare[iPixel]) ) {
+          results[iPixel] = true;
           inCopy = true;
         }
       }
-      if (inCopy) {
-        for (int ib = isb, ob = m_osb; ib < (isb + inb) && ob <= m_onb; ib++, ob++) {
-//           Set the position of the portals in the input and output cubes
-          iPortal.SetPosition(iss, inLine, ib);
-          InputCubes[0]->read(iPortal);
+      else if (IsValidPixel(inputCompare[iPixel]) && !IsValidPixel(mosaicCompare[iPixel]) ) {
+        results[iPixel] = true;
+        inCopy = true;
+      }
+    }
+    return inCopy;
+  }
 
-          oPortal.SetPosition(m_oss, outLine, ob);
-          OutputCubes[0]->read(oPortal);
 
-          for (int iPixel = 0; iPixel < ins; iPixel++) {
-            if (resultsPortal[iPixel]) {
-              if (m_createOutputMosaic) {
-                oPortal[iPixel] = iPortal[iPixel];
-              }
-              else if ( IsValidPixel(iPortal[iPixel]) ||
-                        (m_placeHighSatPixels && IsHighPixel(iPortal[iPixel]) ) ||
-                        (m_placeLowSatPixels  && IsLowPixel (iPortal[iPixel]) ) ||
-                        (m_placeNullPixels    && IsNullPixel(iPortal[iPixel]) ) ) {
-                oPortal[iPixel] = iPortal[iPixel];
-              }
-            }
-            else if ( IsValidPixel(iPortal[iPixel])  && !IsValidPixel(oPortal[iPixel]) ) {
-              oPortal[iPixel] = iPortal[iPixel];
-            }
-          }
-          OutputCubes[0]->write(oPortal);
+  /**
+   * Move the chosen pixels of one band of a line of the input onto the mosaic, for Band Priority
+   * with no Tracking. Valid input pixels also fill mosaic pixels that are not valid.
+   *
+   * @param placement - How the input is placed
+   * @param results - Whether each pixel was chosen
+   * @param input - The input band
+   * @param mosaic - The mosaic band, updated in place
+   */
+  void ProcessMosaic::PlaceBandPriorityPixels(const Placement &placement,
+                                              const QVector<bool> &results,
+                                              const double *input, double *mosaic) {
+    for (int iPixel = 0; iPixel < placement.ins; iPixel++) {
+      if (results[iPixel]) {
+        if (placement.create) {
+          mosaic[iPixel] = input[iPixel];
+        }
+        else if ( IsValidPixel(input[iPixel]) ||
+                  (placement.placeHighSatPixels && IsHighPixel(input[iPixel]) ) ||
+                  (placement.placeLowSatPixels  && IsLowPixel (input[iPixel]) ) ||
+                  (placement.placeNullPixels    && IsNullPixel(input[iPixel]) ) ) {
+          mosaic[iPixel] = input[iPixel];
         }
       }
+      else if ( IsValidPixel(input[iPixel])  && !IsValidPixel(mosaic[iPixel]) ) {
+        mosaic[iPixel] = input[iPixel];
+      }
     }
   }
 
@@ -6,6 +6,9 @@ For more details about the LICENSE terms and the AUTHORS, you will
 find files of those names at the top level of this repository. **/
 
 /* SPDX-License-Identifier: CC0-1.0 */
+#include <QList>
+#include <QVector>
+
 #include "Process.h"
 
 namespace Isis {
@@ -189,6 +192,15 @@ namespace Isis {
    *   @history 2018-08-13 Summer Stapleton - Error now being thrown with appropriate message if
    *                           user attempts to add tracking capabilities to a mosaic that already
    *                           exists without tracking. Fixes #2052.
+   *   @history 2026-10-16 ISIS Development Team - Added SetCompositeFlag(). When compositing,
+   *                           StartProcess only records where each input goes and EndProcess
+   *                           places every input in one pass over the mosaic, building each
+   *                           mosaic line once from all of the inputs that cover it. Lines are
+   *                           built in parallel.
+   *   @history 2026-10-17 ISIS Development Team - StartProcess and compositing place pixels
+   *                           with the same per-line rules. Compositing finds the inputs that
+   *                           cover each batch of lines from their start lines and keeps a
+   *                           bounded number of inputs open.
    */
 
   class ProcessMosaic : public Process {
@@ -260,6 +272,7 @@ namespace Isis {
       void SetBandKeyword(QString bandPriorityKeyName, QString bandPriorityKeyValue);
       void SetBandNumber(int bandPriorityBandNumber);
       void SetBandUseMaxValue(bool useMax);
+      void SetCompositeFlag(bool compositeMosaic);
       void SetCreateFlag(bool createOutputMosaic);
       void SetHighSaturationFlag(bool placeHighSatPixels);
       void SetImageOverlay(ImageOverlay placement);
@@ -268,6 +281,7 @@ namespace Isis {
       void SetNullFlag(bool placeNullPixels);
       void SetTrackFlag(bool trackingEnabled);
 
+      bool GetCompositeFlag() const;
       bool GetHighSaturationFlag() const;
       ImageOverlay GetImageOverlay() const;
       bool GetLowSaturationFlag() const;
@@ -282,18 +296,67 @@ namespace Isis {
       static ImageOverlay StringToOverlay(QString);
 
     private:
+      /**
+       * Where an input goes in the mosaic and how it is placed. StartProcess places the input
+       * with these, or records them when compositing for EndProcess to place.
+       */
+      struct Placement {
+        QString fileName;          //!< The input cube
+        QList<QString> bands;      //!< The physical input bands, in virtual band order
+        int iss;                   //!< The starting sample within the input cube
+        int isl;                   //!< The starting line within the input cube
+        int isb;                   //!< The starting band within the input cube
+        int ins;                   //!< The number of samples from the input cube
+        int inl;                   //!< The number of lines from the input cube
+        int inb;                   //!< The number of bands from the input cube
+        int oss;                   //!< The starting sample within the mosaic
+        int osl;                   //!< The starting line within the mosaic
+        int osb;                   //!< The starting band within the mosaic
+        int onb;                   //!< The number of mosaic bands that get data
+        int inputCompareBand;      //!< The input band compared for band priority
+        int outputCompareBand;     //!< The mosaic band compared for band priority
+        bool create;               //!< The input is copied onto a new mosaic
+        bool tracking;             //!< The tracking cube is updated
+        int trackingIndex;         //!< The input's value in the tracking cube
+        ImageOverlay imageOverlay; //!< The priority
+        bool useMaxValue;          //!< Band priority uses the greater value
+        bool placeHighSatPixels;   //!< High saturation input pixels are placed
+        bool placeLowSatPixels;    //!< Low saturation input pixels are placed
+        bool placeNullPixels;      //!< Null input pixels are placed
+      };
+
+      // Place every recorded input in one pass over the mosaic
+      void CompositePlacements();
+
+      // Place an input on one line of the mosaic
+      static void PlaceLine(const Placement &placement, const Cube &inputCube, int line,
+                            QVector< QVector<double> > &mosaicLine,
+                            QVector<double> &trackingLine);
 
       //Compare the input and mosaic for the specified band based on the criteria and update the
       //  mosaic origin band.
-      void BandComparison(int iss, int isl, int ins, int inl,
-                          int bandPriorityInputBandNumber, int bandPriorityOutputBandNumber,
-                          int index);
+      void BandComparison(const Placement &placement);
+
+      // Update the origin of a line for Band Priority with Tracking
+      static void TrackBandPriority(const Placement &placement, const double *inputCompare,
+                                    const double *mosaicCompare, double *tracking);
 
       // Mosaicking for Band Priority with no Tracking
-      void BandPriorityWithNoTracking(int iss, int isl, int isb,
-                                      int ins, int inl, int inb,
-                                      int bandPriorityInputBandNumber,
-                                      int bandPriorityOutputBandNumber);
+      void BandPriorityWithNoTracking(const Placement &placement);
+
+      // Choose the pixels of a line for Band Priority with no Tracking
+      static bool ChooseBandPriorityPixels(const Placement &placement, const double *inputCompare,
+                                           const double *mosaicCompare, QVector<bool> &results);
+
+      // Place the chosen pixels of a line for Band Priority with no Tracking
+      static void PlaceBandPriorityPixels(const Placement &placement,
+                                          const QVector<bool> &results,
+                                          const double *input, double *mosaic);
+
+      // Place a line of one band for the other priorities
+      static bool PlacePixels(const Placement &placement, const double *input, double *mosaic,
+                              double *count, double *tracking, const double *inputCompare,
+                              const double *mosaicCompare);
 
       // Get the default origin value based on pixel type for the origin band
       int GetOriginDefaultByPixelType();
@@ -313,8 +376,8 @@ namespace Isis {
       // Mosaic exists, match the band with the input image
       void MatchBandBinGroup(int origIsb, int &inb);
 
-      bool ProcessAveragePriority(int piPixel, Portal& pInPortal, Portal& pOutPortal,
-                                  Portal& pOrigPortal);
+      static bool ProcessAveragePriority(const Placement &placement, double input,
+                                         double &mosaic, double &count);
 
       void ResetCountBands();
 
@@ -324,6 +387,8 @@ namespace Isis {
       bool m_trackingEnabled;         //!<
       Cube *m_trackingCube;           //!< Output tracking cube. NULL unless tracking is enabled.
       bool m_createOutputMosaic;      //!<
+      bool m_compositeMosaic;         //!< Inputs are placed in one pass by EndProcess
+      QList<Placement> m_placements;  //!< The inputs waiting to be placed when compositing
       int  m_bandPriorityBandNumber;  //!<
       QString m_bandPriorityKeyName;  //!<
       QString m_bandPriorityKeyValue; //!<
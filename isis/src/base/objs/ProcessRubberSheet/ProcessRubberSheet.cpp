@@ -8,7 +8,10 @@ find files of those names at the top level of this repository. **/
 #include <iomanip>
 #include <algorithm>
 
+#include <QMutexLocker>
+#include <QThreadPool>
 #include <QVector>
+#include <QtConcurrentMap>
 
 #include "Affine.h"
 #include "BasisFunction.h"
@@ -35,6 +38,7 @@ namespace Isis {
   ProcessRubberSheet::ProcessRubberSheet(int startSize, int endSize) {
 
     p_bandChangeFunct = NULL;
+    m_workerFailed = false;
 
     // Information used only in the tile transform method (StartProcess)
     p_forceSamp = Null;
@@ -52,6 +56,12 @@ namespace Isis {
   };
 
 
+  //! Destroys the RubberSheet object.
+  ProcessRubberSheet::~ProcessRubberSheet() {
+    clearWorkers();
+  }
+
+
   /**
    * This method allows the programmer to override the default values for patch
    * parameters used in the patch transform method (processPatchTransform)
@@ -112,6 +122,26 @@ namespace Isis {
   }
 
 
+  /**
+   * Enables threaded processing in StartProcess and processPatchTransform. The
+   * Transform given to those methods is not safe to share between threads, so
+   * every additional worker thread gets its own Transform from this factory.
+   * The factory is only ever called by one thread at a time, and the returned
+   * transforms are deleted when processing is done. The transforms must give the
+   * same results as the one passed to StartProcess or processPatchTransform.
+   *
+   * Threading is used when a factory is set, the global thread pool allows more
+   * than one thread and no BandChange function has been registered. Otherwise
+   * processing is done serially.
+   *
+   * @param factory A function returning a new, independent Transform. Pass an
+   *                empty function to turn threading back off.
+   */
+  void ProcessRubberSheet::setTransformFactory(std::function<Transform *()> factory) {
+    m_transformFactory = factory;
+  }
+
+
   /**
    * Applies a Transform and an Interpolator to every pixel in the output cube.
    * The output cube is written using an Tile and the input cube is read using
@@ -142,6 +172,11 @@ namespace Isis {
       throw IException(IException::Programmer, m, _FILEINFO_);
     }
 
+    if (useThreads()) {
+      threadedStartProcess(trans, interp);
+      return;
+    }
+
     // allocate the sampMap/lineMap vectors
     p_lineMap.resize(p_startQuadSize);
     p_sampMap.resize(p_startQuadSize);
@@ -181,7 +216,8 @@ namespace Isis {
             SlowGeom(otile, iportal, trans, interp);
           }
           else {
-            QuadTree(otile, iportal, trans, interp, useLastTileMap);
+            QuadTree(otile, iportal, trans, interp, useLastTileMap,
+                     p_lineMap, p_sampMap);
           }
 
           useLastTileMap = true;
@@ -206,7 +242,7 @@ namespace Isis {
           SlowGeom(otile, iportal, trans, interp);
         }
         else {
-          QuadTree(otile, iportal, trans, interp, false);
+          QuadTree(otile, iportal, trans, interp, false, p_lineMap, p_sampMap);
         }
 
         OutputCubes[0]->write(otile);
@@ -270,7 +306,9 @@ namespace Isis {
 
   void ProcessRubberSheet::QuadTree(TileManager &otile, Portal &iportal,
                                     Transform &trans, Interpolator &interp,
-                                    bool useLastTileMap) {
+                                    bool useLastTileMap,
+                                    std::vector< std::vector<double> > &lineMap,
+                                    std::vector< std::vector<double> > &sampMap) {
 
     // Initializations
     vector<Quad *> quadTree;
@@ -291,7 +329,7 @@ namespace Isis {
       // Loop and compute the input coordinates filling the maps
       // until the quad tree is empty
       while (quadTree.size() > 0) {
-        ProcessQuad(quadTree, trans, p_lineMap, p_sampMap);
+        ProcessQuad(quadTree, trans, lineMap, sampMap);
       }
     }
 
@@ -299,8 +337,8 @@ namespace Isis {
     int outputBand = otile.Band();
     for (int i = 0, line = 0; line < p_startQuadSize; line++) {
       for (int samp = 0; samp < p_startQuadSize; samp++, i++) {
-        double inputLine = p_lineMap[line][samp];
-        double inputSamp = p_sampMap[line][samp];
+        double inputLine = lineMap[line][samp];
+        double inputSamp = sampMap[line][samp];
         if (inputLine != NULL8) {
           iportal.SetPosition(inputSamp, inputLine, outputBand);
           InputCubes[0]->read(iportal);
@@ -797,6 +835,11 @@ namespace Isis {
       throw IException(IException::Programmer, m, _FILEINFO_);
     }
 
+    if (useThreads()) {
+      threadedPatchTransform(trans, interp);
+      return;
+    }
+
     // Create a portal buffer for reading from the input file
     Portal iportal(interp.Samples(), interp.Lines(),
                    InputCubes[0]->pixelType() ,
@@ -847,9 +890,15 @@ namespace Isis {
         for (int samp = m_patchStartSample;
               samp <= InputCubes[0]->sampleCount();
               samp += m_patchSampleIncrement, p_progress->CheckStatus()) {
+          std::vector<Brick *> patchBricks;
           transformPatch((double)samp, (double)(samp + m_patchSamples - 1),
                          (double)line, (double)(line + m_patchLines - 1),
-                         iportal, trans, interp);
+                         iportal, trans, interp, patchBricks);
+
+          for (unsigned int i = 0; i < patchBricks.size(); i++) {
+            writePatchBrick(*patchBricks[i]);
+            delete patchBricks[i];
+          }
         }
       }
     }
@@ -857,11 +906,15 @@ namespace Isis {
 
 
   // Private method to process a small patch of the input cube
+  //
+  // The output brick of the patch is appended to patchBricks rather than written,
+  // so patches can be computed on any thread and still be written in order.
   void ProcessRubberSheet::transformPatch(double ssamp, double esamp,
                                           double sline, double eline,
                                           Portal &iportal,
                                           Transform &trans,
-                                          Interpolator &interp) {
+                                          Interpolator &interp,
+                                          std::vector<Brick *> &patchBricks) {
     // Let's make sure our patch is contained in the input file
     // TODO:  Think about the image edges should I be adding 0.5
     if (esamp > InputCubes[0]->sampleCount()) {
@@ -921,7 +974,7 @@ namespace Isis {
 
     // If at least one of the 4 input tile corners did NOT transform, split it
     if (isamps.size() < 4) {
-      splitPatch(ssamp, esamp, sline, eline, iportal, trans, interp);
+      splitPatch(ssamp, esamp, sline, eline, iportal, trans, interp, patchBricks);
       return;
     }
 
@@ -964,11 +1017,11 @@ namespace Isis {
      */
 
     if (osampMax - osampMin + 1.0 > OutputCubes[0]->sampleCount() * 0.50) {
-      splitPatch(ssamp, esamp, sline, eline, iportal, trans, interp);
+      splitPatch(ssamp, esamp, sline, eline, iportal, trans, interp, patchBricks);
       return;
     }
     if (olineMax - olineMin + 1.0 > OutputCubes[0]->lineCount() * 0.50) {
-      splitPatch(ssamp, esamp, sline, eline, iportal, trans, interp);
+      splitPatch(ssamp, esamp, sline, eline, iportal, trans, interp, patchBricks);
       return;
     }
 
@@ -994,18 +1047,18 @@ namespace Isis {
       ilineLSQ.Solve(LeastSquares::QRD);
     }
     catch (IException &e) {
-      splitPatch(ssamp, esamp, sline, eline, iportal, trans, interp);
+      splitPatch(ssamp, esamp, sline, eline, iportal, trans, interp, patchBricks);
       return;
     }
 
     // If the fit at any corner isn't good enough break it down
     for (int i=0; i<isamps.size(); i++) {
       if (fabs(isampLSQ.Residual(i)) > 0.5) {
-        splitPatch(ssamp, esamp, sline, eline, iportal, trans, interp);
+        splitPatch(ssamp, esamp, sline, eline, iportal, trans, interp, patchBricks);
         return;
       }
       if (fabs(ilineLSQ.Residual(i)) > 0.5) {
-        splitPatch(ssamp, esamp, sline, eline, iportal, trans, interp);
+        splitPatch(ssamp, esamp, sline, eline, iportal, trans, interp, patchBricks);
         return;
       }
     }
@@ -1028,12 +1081,12 @@ namespace Isis {
       double err = (csamp - isamp) * (csamp - isamp) +
                    (cline - iline) * (cline - iline);
       if (err > 0.25) {
-        splitPatch(ssamp, esamp, sline, eline, iportal, trans, interp);
+        splitPatch(ssamp, esamp, sline, eline, iportal, trans, interp, patchBricks);
         return;
       }
     }
     else {
-      splitPatch(ssamp, esamp, sline, eline, iportal, trans, interp);
+      splitPatch(ssamp, esamp, sline, eline, iportal, trans, interp, patchBricks);
       return;
     }
 #endif
@@ -1049,11 +1102,10 @@ namespace Isis {
     // Now we can do our typical backwards geom. Loop over the output cube
     // coordinates and compute input cube coordinates for the corners of the current
     // buffer. The buffer is the same size as the current patch size.
-    Brick oBrick(*OutputCubes[0], osampMax-osampMin+1, olineMax-olineMin+1, 1);
-    oBrick.SetBasePosition(osampMin, olineMin, iportal.Band());
+    Brick *oBrick = new Brick(*OutputCubes[0], osampMax-osampMin+1, olineMax-olineMin+1, 1);
+    oBrick->SetBasePosition(osampMin, olineMin, iportal.Band());
 
     int brickIndex = 0;
-    bool foundNull = false;
     for (int oline = olineMin; oline <= olineMax; oline++) {
       double isamp = A * osampMin + B * oline + C;
       double iline = D * osampMin + E * oline + F;
@@ -1064,13 +1116,22 @@ namespace Isis {
         // Now read the data around the input coordinate and interpolate a DN
         iportal.SetPosition(isamp, iline, iportal.Band());
         InputCubes[0]->read(iportal);
-        double dn = interp.Interpolate(isamp, iline, iportal.DoubleBuffer());
-        oBrick[brickIndex] = dn;
-        if (dn == Null) foundNull = true;
+        (*oBrick)[brickIndex] = interp.Interpolate(isamp, iline, iportal.DoubleBuffer());
         brickIndex++;
       }
     }
 
+    patchBricks.push_back(oBrick);
+  }
+
+
+  // Private method to write a brick computed by transformPatch to the output cube
+  void ProcessRubberSheet::writePatchBrick(Brick &oBrick) {
+    bool foundNull = false;
+    for (int brickIndex = 0; brickIndex < oBrick.size() && !foundNull; brickIndex++) {
+      if (oBrick[brickIndex] == Null) foundNull = true;
+    }
+
     // If there are any special pixel Null values in this output brick, we may be
     // up against an edge of the input image where the interpolaters get Nulls from
     // outside the image. Since the patches have some overlap due to finding the
@@ -1083,10 +1144,10 @@ namespace Isis {
     // asynchronous write of buffers to the cube, where a race condition may have generated
     // different dns, not bad, but making testing more difficult.
     if (foundNull) {
-      Brick readBrick(*OutputCubes[0], osampMax-osampMin+1, olineMax-olineMin+1, 1);
-      readBrick.SetBasePosition(osampMin, olineMin, iportal.Band());
+      Brick readBrick(*OutputCubes[0], oBrick.SampleDimension(), oBrick.LineDimension(), 1);
+      readBrick.SetBasePosition(oBrick.Sample(), oBrick.Line(), oBrick.Band());
       OutputCubes[0]->read(readBrick);
-      for (brickIndex = 0; brickIndex<(osampMax-osampMin+1)*(olineMax-olineMin+1); brickIndex++) {
+      for (int brickIndex = 0; brickIndex < oBrick.size(); brickIndex++) {
         if (readBrick[brickIndex] != Null) {
           oBrick[brickIndex] = readBrick[brickIndex];
         }
@@ -1102,7 +1163,8 @@ namespace Isis {
   // process
   void ProcessRubberSheet::splitPatch(double ssamp, double esamp,
                                        double sline, double eline, Portal &iportal,
-                                       Transform &trans, Interpolator &interp) {
+                                       Transform &trans, Interpolator &interp,
+                                       std::vector<Brick *> &patchBricks) {
 
     // Is the input patch too small to even worry about transforming?
     if ((esamp - ssamp < 0.1) && (eline - sline < 0.1)) return;
@@ -1113,19 +1175,384 @@ namespace Isis {
 
     transformPatch(ssamp, midSamp,
                    sline, midLine,
-                   iportal, trans, interp);
+                   iportal, trans, interp, patchBricks);
     transformPatch(midSamp, esamp,
                    sline, midLine,
-                   iportal, trans, interp);
+                   iportal, trans, interp, patchBricks);
     transformPatch(ssamp, midSamp,
                    midLine, eline,
-                   iportal, trans, interp);
+                   iportal, trans, interp, patchBricks);
     transformPatch(midSamp, esamp,
                    midLine, eline,
-                   iportal, trans, interp);
+                   iportal, trans, interp, patchBricks);
 
     return;
   }
 
 
+  /**
+   * Constructs the private state of one worker thread.
+   *
+   * @param workerTransform The transform only this worker will use
+   * @param ownsWorkerTransform True if the worker should delete the transform
+   * @param workerInterp The interpolator to copy
+   * @param inputPixelType The pixel type of the input cube
+   */
+  ProcessRubberSheet::WorkerState::WorkerState(Transform *workerTransform,
+                                               bool ownsWorkerTransform,
+                                               const Interpolator &workerInterp,
+                                               PixelType inputPixelType) :
+      transform(workerTransform),
+      ownsTransform(ownsWorkerTransform),
+      interp(workerInterp),
+      iportal(interp.Samples(), interp.Lines(), inputPixelType,
+              interp.HotSample(), interp.HotLine()) {
+  }
+
+
+  //! Destroys the worker state, and the transform if the worker owns it.
+  ProcessRubberSheet::WorkerState::~WorkerState() {
+    if (ownsTransform) {
+      delete transform;
+    }
+    transform = NULL;
+  }
+
+
+  /**
+   * Tests whether StartProcess and processPatchTransform should be threaded.
+   *
+   * @return @b bool True if a transform factory was given, no band change
+   *                 function is registered and more than one thread is allowed.
+   */
+  bool ProcessRubberSheet::useThreads() const {
+    return m_transformFactory && p_bandChangeFunct == NULL &&
+           QThreadPool::globalInstance()->maxThreadCount() > 1;
+  }
+
+
+  /**
+   * The threaded version of StartProcess. Every spatial output tile, with all of
+   * its bands, is one unit of work for the global thread pool. The output tiles
+   * do not depend on each other so the order they are written in does not
+   * change the output.
+   *
+   * @param trans The transform used by the first worker
+   * @param interp The interpolator copied into every worker
+   */
+  void ProcessRubberSheet::threadedStartProcess(Transform &trans,
+                                                Interpolator &interp) {
+    TileManager otile(*OutputCubes[0], p_startQuadSize, p_startQuadSize);
+    long long int tilesPerBand = otile.Tiles() / OutputCubes[0]->bandCount();
+
+    p_progress->SetMaximumSteps(tilesPerBand);
+    p_progress->CheckStatus();
+
+    // Every thread reads its own area of the input cube, so give each of them
+    // the cache the serial algorithm would have had
+    int threadCount = QThreadPool::globalInstance()->maxThreadCount();
+    InputCubes[0]->addCachingAlgorithm(
+        new UniqueIOCachingAlgorithm(2 * InputCubes[0]->bandCount() * threadCount));
+    OutputCubes[0]->addCachingAlgorithm(new BoxcarCachingAlgorithm());
+
+    std::vector<long long int> tiles(tilesPerBand);
+    for (long long int tile = 0; tile < tilesPerBand; tile++) {
+      tiles[tile] = tile + 1;
+    }
+
+    m_workerFailed = false;
+    QFuture<void> future = QtConcurrent::map(tiles,
+        [this, &trans, &interp](long long int &tile) {
+          processTile(tile, trans, interp);
+        });
+    blockingReportProgress(future);
+    clearWorkers();
+
+    if (m_workerFailed) {
+      throw m_workerError;
+    }
+  }
+
+
+  /**
+   * Transforms every band of one spatial output tile and writes it. This runs
+   * on a thread from the global thread pool.
+   *
+   * @param tile The one-based index of the tile in the first band
+   * @param trans The transform given to StartProcess
+   * @param interp The interpolator given to StartProcess
+   */
+  void ProcessRubberSheet::processTile(long long int tile, Transform &trans,
+                                       Interpolator &interp) {
+    WorkerState *worker = NULL;
+
+    try {
+      worker = acquireWorker(trans, interp);
+
+      TileManager otile(*OutputCubes[0], p_startQuadSize, p_startQuadSize);
+      bool useLastTileMap = false;
+
+      for (int band = 1; band <= OutputCubes[0]->bandCount(); band++) {
+        otile.SetTile(tile, band);
+
+        if (p_startQuadSize <= 2 || min(OutputCubes[0]->lineCount(), OutputCubes[0]->sampleCount()) <= p_startQuadSize) {
+          SlowGeom(otile, worker->iportal, *worker->transform, worker->interp);
+        }
+        else {
+          QuadTree(otile, worker->iportal, *worker->transform, worker->interp,
+                   useLastTileMap, worker->lineMap, worker->sampMap);
+        }
+
+        useLastTileMap = true;
+
+        OutputCubes[0]->write(otile);
+      }
+    }
+    catch (IException &e) {
+      recordWorkerError(e);
+    }
+    catch (std::exception &e) {
+      recordWorkerError(IException(IException::Unknown, e.what(), _FILEINFO_));
+    }
+
+    if (worker) {
+      releaseWorker(worker);
+    }
+  }
+
+
+  /**
+   * The threaded version of processPatchTransform. The input patches are
+   * computed on the global thread pool in batches, but their output bricks are
+   * written by this thread in the same order the serial algorithm writes them.
+   * Overlapping patches therefore produce exactly the same output.
+   *
+   * @param trans The transform used by the first worker
+   * @param interp The interpolator copied into every worker
+   */
+  void ProcessRubberSheet::threadedPatchTransform(Transform &trans,
+                                                  Interpolator &interp) {
+    // The starting corner of every patch in a band, in serial order
+    std::vector<int> patchSamples;
+    std::vector<int> patchLines;
+    for (int line = m_patchStartLine; line <= InputCubes[0]->lineCount();
+          line += m_patchLineIncrement) {
+      for (int samp = m_patchStartSample;
+            samp <= InputCubes[0]->sampleCount();
+            samp += m_patchSampleIncrement) {
+        patchSamples.push_back(samp);
+        patchLines.push_back(line);
+      }
+    }
+
+    int patchesPerBand = (int) patchSamples.size();
+    p_progress->SetMaximumSteps(InputCubes[0]->bandCount() * patchesPerBand);
+    p_progress->CheckStatus();
+
+    // Large enough to keep every thread busy, small enough to bound the memory
+    // held by computed but unwritten bricks
+    int batchSize = 64 * QThreadPool::globalInstance()->maxThreadCount();
+
+    m_workerFailed = false;
+    for (int band = 1; band <= InputCubes[0]->bandCount(); band++) {
+      for (int batchStart = 0; batchStart < patchesPerBand; batchStart += batchSize) {
+        int batchEnd = min(batchStart + batchSize, patchesPerBand);
+
+        std::vector<int> batch;
+        for (int patch = batchStart; patch < batchEnd; patch++) {
+          batch.push_back(patch);
+        }
+        std::vector< std::vector<Brick *> > batchBricks(batch.size());
+
+        QtConcurrent::blockingMap(batch,
+            [&](int &patch) {
+              processPatch(patchSamples[patch], patchLines[patch], band,
+                           trans, interp, batchBricks[patch - batchStart]);
+            });
+
+        try {
+          for (unsigned int i = 0; i < batchBricks.size(); i++) {
+            for (unsigned int j = 0; j < batchBricks[i].size(); j++) {
+              if (!m_workerFailed) {
+                writePatchBrick(*batchBricks[i][j]);
+              }
+              delete batchBricks[i][j];
+              batchBricks[i][j] = NULL;
+            }
+            p_progress->CheckStatus();
+          }
+        }
+        catch (IException &e) {
+          for (unsigned int i = 0; i < batchBricks.size(); i++) {
+            for (unsigned int j = 0; j < batchBricks[i].size(); j++) {
+              delete batchBricks[i][j];
+            }
+          }
+          clearWorkers();
+          throw;
+        }
+
+        if (m_workerFailed) {
+          clearWorkers();
+          throw m_workerError;
+        }
+      }
+    }
+
+    clearWorkers();
+  }
+
+
+  /**
+   * Computes the output bricks of one input patch. This runs on a thread from
+   * the global thread pool.
+   *
+   * @param samp The starting sample of the patch
+   * @param line The starting line of the patch
+   * @param band The band being processed
+   * @param trans The transform given to processPatchTransform
+   * @param interp The interpolator given to processPatchTransform
+   * @param patchBricks The output bricks of the patch, in serial write order
+   */
+  void ProcessRubberSheet::processPatch(int samp, int line, int band,
+                                        Transform &trans, Interpolator &interp,
+                                        std::vector<Brick *> &patchBricks) {
+    WorkerState *worker = NULL;
+
+    try {
+      worker = acquireWorker(trans, interp);
+      worker->iportal.SetPosition(1, 1, band);
+
+      transformPatch((double)samp, (double)(samp + m_patchSamples - 1),
+                     (double)line, (double)(line + m_patchLines - 1),
+                     worker->iportal, *worker->transform, worker->interp,
+                     patchBricks);
+    }
+    catch (IException &e) {
+      recordWorkerError(e);
+    }
+    catch (std::exception &e) {
+      recordWorkerError(IException(IException::Unknown, e.what(), _FILEINFO_));
+    }
+
+    if (worker) {
+      releaseWorker(worker);
+    }
+  }
+
+
+  /**
+   * Takes an idle worker state, creating a new one if every existing worker
+   * state is in use. The first worker state uses the caller's transform, all
+   * others use a transform from the transform factory.
+   *
+   * @param trans The transform given to StartProcess or processPatchTransform
+   * @param interp The interpolator to copy into a new worker state
+   *
+   * @return @b WorkerState* A worker state no other thread is using
+   */
+  ProcessRubberSheet::WorkerState *ProcessRubberSheet::acquireWorker(Transform &trans,
+                                                                     Interpolator &interp) {
+    QMutexLocker locker(&m_workerMutex);
+
+    if (!m_idleWorkers.isEmpty()) {
+      return m_idleWorkers.takeLast();
+    }
+
+    Transform *workerTransform = &trans;
+    bool ownsTransform = false;
+    if (!m_workers.isEmpty()) {
+      workerTransform = m_transformFactory();
+      ownsTransform = true;
+
+      if (workerTransform == NULL) {
+        string msg = "The transform factory did not create a transform";
+        throw IException(IException::Programmer, msg, _FILEINFO_);
+      }
+    }
+
+    WorkerState *worker = new WorkerState(workerTransform, ownsTransform, interp,
+                                          InputCubes[0]->pixelType());
+    worker->lineMap.resize(p_startQuadSize, std::vector<double>(p_startQuadSize));
+    worker->sampMap.resize(p_startQuadSize, std::vector<double>(p_startQuadSize));
+    m_workers.append(worker);
+
+    return worker;
+  }
+
+
+  /**
+   * Returns a worker state so another thread can use it.
+   *
+   * @param worker The worker state taken with acquireWorker
+   */
+  void ProcessRubberSheet::releaseWorker(WorkerState *worker) {
+    QMutexLocker locker(&m_workerMutex);
+    m_idleWorkers.append(worker);
+  }
+
+
+  //! Deletes every worker state and the transforms they own.
+  void ProcessRubberSheet::clearWorkers() {
+    QMutexLocker locker(&m_workerMutex);
+
+    foreach (WorkerState *worker, m_workers) {
+      delete worker;
+    }
+
+    m_workers.clear();
+    m_idleWorkers.clear();
+  }
+
+
+  /**
+   * Keeps the first error thrown by a worker so it can be rethrown once all of
+   * the workers are done.
+   *
+   * @param error The error a worker caught
+   */
+  void ProcessRubberSheet::recordWorkerError(const IException &error) {
+    QMutexLocker locker(&m_workerMutex);
+
+    if (!m_workerFailed) {
+      m_workerFailed = true;
+      m_workerError = error;
+    }
+  }
+
+
+  /**
+   * Waits for the future to finish, reporting its progress through the Isis
+   * progress object.
+   *
+   * @param future The future to wait for
+   */
+  void ProcessRubberSheet::blockingReportProgress(QFuture<void> &future) {
+    int isisReportedProgress = 0;
+    int lastProgressValue = future.progressValue();
+
+    QMutex sleeper;
+    sleeper.lock();
+    while (!future.isFinished()) {
+      sleeper.tryLock(100);
+
+      if (future.progressValue() != lastProgressValue) {
+        lastProgressValue = future.progressValue();
+        while (isisReportedProgress < lastProgressValue) {
+          p_progress->CheckStatus();
+          isisReportedProgress++;
+        }
+      }
+    }
+
+    while (isisReportedProgress < future.progressValue()) {
+      p_progress->CheckStatus();
+      isisReportedProgress++;
+    }
+
+    // Need to unlock the mutex before it goes out of scope, otherwise Qt5 issues a warning
+    sleeper.unlock();
+  }
+
+
 } // end namespace isis
@@ -6,8 +6,15 @@ For more details about the LICENSE terms and the AUTHORS, you will
 find files of those names at the top level of this repository. **/
 
 /* SPDX-License-Identifier: CC0-1.0 */
+#include <functional>
+
+#include <QFuture>
+#include <QList>
+#include <QMutex>
+
 #include "Process.h"
 #include "Buffer.h"
+#include "IException.h"
 #include "Transform.h"
 #include "Interpolator.h"
 #include "Portal.h"
@@ -106,8 +113,7 @@ namespace Isis {
 
       ProcessRubberSheet(int startSize = 128, int endSize = 8);
 
-      //! Destroys the RubberSheet object.
-      virtual ~ProcessRubberSheet() {};
+      virtual ~ProcessRubberSheet();
 
       using Isis::Process::StartProcess;
       // Output driven processing method for one input and output cube
@@ -141,6 +147,9 @@ namespace Isis {
                                 int samples, int lines,
                                 int sampleIncrement, int lineIncrement);
 
+      // Enable threaded processing using private transforms per worker
+      virtual void setTransformFactory(std::function<Transform *()> factory);
+
 
     private:
 
@@ -159,6 +168,38 @@ namespace Isis {
           int esamp;     //!<
       };
 
+      /**
+       * The private state of one worker thread in the threaded rubber sheet.
+       * Nothing in here is shared with any other thread.
+       */
+      class WorkerState {
+        public:
+          WorkerState(Transform *workerTransform, bool ownsWorkerTransform,
+                      const Interpolator &workerInterp, PixelType inputPixelType);
+          ~WorkerState();
+
+          Transform *transform;      //!< The transform only this worker uses
+          bool ownsTransform;        //!< True if transform came from the factory
+          Interpolator interp;       //!< The worker's copy of the interpolator
+          Portal iportal;            //!< The worker's input portal
+          //! Input line for each output pixel in the current tile
+          std::vector< std::vector<double> > lineMap;
+          //! Input sample for each output pixel in the current tile
+          std::vector< std::vector<double> > sampMap;
+      };
+
+      bool useThreads() const;
+      void threadedStartProcess(Transform &trans, Interpolator &interp);
+      void threadedPatchTransform(Transform &trans, Interpolator &interp);
+      void processTile(long long tile, Transform &trans, Interpolator &interp);
+      void processPatch(int samp, int line, int band, Transform &trans,
+                        Interpolator &interp, std::vector<Brick *> &patchBricks);
+      WorkerState *acquireWorker(Transform &trans, Interpolator &interp);
+      void releaseWorker(WorkerState *worker);
+      void clearWorkers();
+      void recordWorkerError(const IException &error);
+      void blockingReportProgress(QFuture<void> &future);
+
       void ProcessQuad(std::vector<Quad *> &quadTree, Transform &trans,
                        std::vector< std::vector<double> > &lineMap,
                        std::vector< std::vector<double> > &sampMap);
@@ -175,7 +216,9 @@ namespace Isis {
                     Transform &trans, Interpolator &interp);
       void QuadTree(TileManager &otile, Portal &iportal,
                     Transform &trans, Interpolator &interp,
-                    bool useLastTileMap);
+                    bool useLastTileMap,
+                    std::vector< std::vector<double> > &lineMap,
+                    std::vector< std::vector<double> > &sampMap);
 
       bool TestLine(Transform &trans, int ssamp, int esamp, int sline,
                     int eline, int increment);
@@ -184,11 +227,15 @@ namespace Isis {
 
       void transformPatch (double startingSample, double endingSample,
                            double startingLine, double endingLine,
-                           Portal &iportal, Transform &trans, Interpolator &interp);
+                           Portal &iportal, Transform &trans, Interpolator &interp,
+                           std::vector<Brick *> &patchBricks);
 
       void splitPatch (double startingSample, double endingSample,
                        double startingLine, double endingLine,
-                       Portal &iportal, Transform &trans, Interpolator &interp);
+                       Portal &iportal, Transform &trans, Interpolator &interp,
+                       std::vector<Brick *> &patchBricks);
+
+      void writePatchBrick(Brick &oBrick);
 #if 0
       void transformPatch (double startingSample, double endingSample,
                            double startingLine, double endingLine);
@@ -213,6 +260,14 @@ namespace Isis {
       int m_patchSampleIncrement;
       int m_patchLineIncrement;
 
+      //! Creates the private transform of each additional worker thread
+      std::function<Transform *()> m_transformFactory;
+      QList<WorkerState *> m_workers;     //!< Every worker state created so far
+      QList<WorkerState *> m_idleWorkers; //!< Worker states not in use
+      QMutex m_workerMutex;               //!< Guards the worker lists and errors
+      bool m_workerFailed;                //!< True if any worker threw
+      IException m_workerError;           //!< The first error thrown by a worker
+
 #if 0
       Portal *m_iportal;
       Brick *m_obrick;
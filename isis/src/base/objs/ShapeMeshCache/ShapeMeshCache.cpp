@@ -0,0 +1,394 @@
+/** This is free and unencumbered software released into the public domain.
+The authors of ISIS do not claim copyright on the contents of this file.
+For more details about the LICENSE terms and the AUTHORS, you will
+find files of those names at the top level of this repository. **/
+
+/* SPDX-License-Identifier: CC0-1.0 */
+#include "ShapeMeshCache.h"
+
+#include <cstring>
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+
+#include "Environment.h"
+#include "FileName.h"
+#include "IException.h"
+#include "IString.h"
+#include "Preference.h"
+#include "PvlGroup.h"
+
+namespace Isis {
+  namespace {
+    //! Changes whenever the layout of the file or of any engine's blocks changes
+    const quint32 FormatVersion = 2;
+
+    //! Written in native byte order to detect files from other machines
+    const quint32 ByteOrderMark = 0x01020304;
+
+    //! Blocks start on multiples of this, so they can be used in place
+    const qint64 BlockAlignment = 64;
+
+    /**
+     * The start of a cache file
+     */
+    struct FileHeader {
+      char    magic[8];          //!< Always "ISISMESH"
+      quint32 version;           //!< The version of the format
+      quint32 byteOrder;         //!< ByteOrderMark in the byte order of the writer
+      quint32 pointerSize;       //!< The size of a pointer on the writer
+      quint32 blockCount;        //!< The number of blocks
+      char    engine[16];        //!< The engine the blocks are for
+      char    engineVersion[32]; //!< The version of the engine library that wrote them
+      char    isisVersion[64];   //!< The version of ISIS that wrote them
+      qint64  shapeFileSize;     //!< The size of the shape file the blocks were built from
+      qint64  shapeFileModified; //!< Its modification time in ms since the epoch
+    };
+
+    /**
+     * The location of a block, the header is followed by one for each block
+     */
+    struct BlockEntry {
+      char   name[24]; //!< The name of the block
+      qint64 offset;   //!< The offset of the block from the start of the file
+      qint64 size;     //!< The number of bytes in the block
+    };
+
+
+    /**
+     * @param offset An offset into the file
+     *
+     * @return @b qint64 The offset of the next block that can start at or after it
+     */
+    qint64 alignedOffset(qint64 offset) {
+      return (offset + BlockAlignment - 1) / BlockAlignment * BlockAlignment;
+    }
+
+
+    /**
+     * Copies a string into a fixed size field, truncating it if it does not fit.
+     * The rest of the field must already be zero.
+     *
+     * @param field The field
+     * @param fieldSize The size of the field, including a terminating zero
+     * @param value The string
+     */
+    void copyField(char *field, int fieldSize, const QString &value) {
+      QByteArray bytes = value.toLatin1().left(fieldSize - 1);
+      memcpy(field, bytes.constData(), bytes.size());
+    }
+
+
+    /**
+     * @return @b QString The version of ISIS, or an empty string if it is
+     *                    unknown. It is only read once.
+     */
+    QString isisVersion() {
+      static QString version;
+      static bool versionRead = false;
+      static QMutex versionMutex;
+
+      QMutexLocker locker(&versionMutex);
+      if (!versionRead) {
+        try {
+          version = Environment::isisVersion();
+        }
+        catch (IException &e) {
+          // Without a version file only the format version protects the cache
+        }
+        versionRead = true;
+      }
+      return version;
+    }
+
+
+    /**
+     * Fills in everything in a header but the block count.
+     *
+     * @param shapeFile The expanded name of the shape file
+     * @param engine The engine the blocks are for
+     * @param engineVersion The version of the engine library
+     *
+     * @return @b FileHeader The header
+     */
+    FileHeader expectedHeader(const QString &shapeFile, const QString &engine,
+                              const QString &engineVersion) {
+      FileHeader header;
+      memset(&header, 0, sizeof(header));
+      memcpy(header.magic, "ISISMESH", sizeof(header.magic));
+      header.version = FormatVersion;
+      header.byteOrder = ByteOrderMark;
+      header.pointerSize = sizeof(void *);
+      copyField(header.engine, sizeof(header.engine), engine);
+      copyField(header.engineVersion, sizeof(header.engineVersion), engineVersion);
+      copyField(header.isisVersion, sizeof(header.isisVersion), isisVersion());
+
+      QFileInfo shapeInfo(shapeFile);
+      header.shapeFileSize = shapeInfo.size();
+      header.shapeFileModified = shapeInfo.lastModified().toMSecsSinceEpoch();
+      return header;
+    }
+  }
+
+
+  /**
+   * Constructs the cache of a shape model. Nothing is read or written until
+   * map or write is called.
+   *
+   * @param shapeFile The name of the shape file, which can contain variables
+   * @param engine The name of the engine the data is for. Use a different name
+   *               for each layout of the data, such as the size of the floating
+   *               point numbers an engine was built with.
+   * @param engineVersion The version of the engine library. Caches written
+   *                      with another version are ignored.
+   */
+  ShapeMeshCache::ShapeMeshCache(const QString &shapeFile, const QString &engine,
+                                 const QString &engineVersion)
+      : m_shapeFile(FileName(shapeFile).expanded()),
+        m_engine(engine),
+        m_engineVersion(engineVersion),
+        m_mappedData(NULL) {
+    m_file.setFileName(fileName());
+  }
+
+
+  /**
+   * Unmaps the cache file. Nothing that points into the blocks may be used
+   * after the cache is destroyed.
+   */
+  ShapeMeshCache::~ShapeMeshCache() {
+    unmap();
+  }
+
+
+  /**
+   * @return @b QString The name of the cache file
+   */
+  QString ShapeMeshCache::fileName() const {
+    return m_shapeFile + "." + m_engine + ".meshcache";
+  }
+
+
+  /**
+   * Maps the cache file into memory if it exists and was written for the
+   * current shape file, engine and machine by the current versions of ISIS and
+   * the engine.
+   *
+   * @param copyOnWrite If the blocks will be modified in place. The changes
+   *                    are private to this process and only the pages that
+   *                    are modified are copied, the rest are still shared.
+   *
+   * @return @b bool True if the cache file was mapped. Files that are missing,
+   *                 damaged or stale are treated the same and ignored.
+   */
+  bool ShapeMeshCache::map(bool copyOnWrite) {
+    unmap();
+
+    if (!m_file.open(QIODevice::ReadOnly)) {
+      return false;
+    }
+
+    qint64 fileSize = m_file.size();
+    if (fileSize < (qint64) sizeof(FileHeader)) {
+      m_file.close();
+      return false;
+    }
+
+    m_mappedData = m_file.map(0, fileSize, copyOnWrite ? QFileDevice::MapPrivateOption :
+                                                        QFileDevice::NoOptions);
+    if (!m_mappedData) {
+      m_file.close();
+      return false;
+    }
+
+    FileHeader header;
+    memcpy(&header, m_mappedData, sizeof(header));
+    FileHeader expected = expectedHeader(m_shapeFile, m_engine, m_engineVersion);
+    expected.blockCount = header.blockCount;
+    if (memcmp(&header, &expected, sizeof(header)) != 0 ||
+        (qint64) sizeof(FileHeader) + header.blockCount * (qint64) sizeof(BlockEntry) > fileSize) {
+      unmap();
+      return false;
+    }
+
+    const BlockEntry *entries = (const BlockEntry *) (m_mappedData + sizeof(FileHeader));
+    for (quint32 i = 0; i < header.blockCount; i++) {
+      BlockEntry entry;
+      memcpy(&entry, &entries[i], sizeof(entry));
+      if (entry.offset % BlockAlignment != 0 || entry.offset < 0 || entry.size < 0 ||
+          entry.offset + entry.size > fileSize) {
+        unmap();
+        return false;
+      }
+      QString name = QString::fromLatin1(entry.name, strnlen(entry.name, sizeof(entry.name)));
+      m_blocks.insert(name, qMakePair(entry.offset, entry.size));
+    }
+
+    return true;
+  }
+
+
+  /**
+   * @return @b bool True if the cache file is mapped
+   */
+  bool ShapeMeshCache::isMapped() const {
+    return m_mappedData != NULL;
+  }
+
+
+  /**
+   * @param name The name of a block
+   *
+   * @return @b bool True if the mapped cache file has the block
+   */
+  bool ShapeMeshCache::hasBlock(const QString &name) const {
+    return m_blocks.contains(name);
+  }
+
+
+  /**
+   * @param name The name of a block
+   *
+   * @return @b uchar* The start of the block in the mapped cache file, or NULL
+   *                   if it does not have the block. Blocks start on 64 byte
+   *                   boundaries. Unless the cache was mapped copy on write,
+   *                   the block must not be modified.
+   */
+  uchar *ShapeMeshCache::block(const QString &name) const {
+    if (!m_blocks.contains(name)) {
+      return NULL;
+    }
+    return m_mappedData + m_blocks[name].first;
+  }
+
+
+  /**
+   * @param name The name of a block
+   *
+   * @return @b qint64 The number of bytes in the block, or 0 if the mapped
+   *                   cache file does not have the block
+   */
+  qint64 ShapeMeshCache::blockSize(const QString &name) const {
+    if (!m_blocks.contains(name)) {
+      return 0;
+    }
+    return m_blocks[name].second;
+  }
+
+
+  /**
+   * Adds a block to be written by the next call to write. The data is not
+   * copied, it must not change or be freed until write is called.
+   *
+   * @param name The name of the block, up to 23 characters
+   * @param data The bytes of the block
+   * @param size The number of bytes in the block
+   */
+  void ShapeMeshCache::addBlock(const QString &name, const void *data, qint64 size) {
+    PendingBlock block;
+    block.name = name;
+    block.data = (const char *) data;
+    block.size = size;
+    m_pendingBlocks.append(block);
+  }
+
+
+  /**
+   * Writes the blocks that were added to the cache file, replacing it if it
+   * exists. The cache file is only a copy of data that can be built from the
+   * shape file, so failing to write it, for example because the shape file is
+   * in a read-only data area, is not an error.
+   *
+   * @return @b bool True if the cache file was written
+   */
+  bool ShapeMeshCache::write() {
+    QList<PendingBlock> blocks = m_pendingBlocks;
+    m_pendingBlocks.clear();
+
+    FileHeader header = expectedHeader(m_shapeFile, m_engine, m_engineVersion);
+    header.blockCount = blocks.size();
+
+    QList<BlockEntry> entries;
+    qint64 offset = alignedOffset(sizeof(FileHeader) + blocks.size() * sizeof(BlockEntry));
+    foreach (const PendingBlock &block, blocks) {
+      BlockEntry entry;
+      memset(&entry, 0, sizeof(entry));
+      QByteArray name = block.name.toLatin1().left(sizeof(entry.name) - 1);
+      memcpy(entry.name, name.constData(), name.size());
+      entry.offset = offset;
+      entry.size = block.size;
+      entries.append(entry);
+      offset = alignedOffset(offset + block.size);
+    }
+
+    QSaveFile cacheFile(fileName());
+    if (!cacheFile.open(QIODevice::WriteOnly)) {
+      return false;
+    }
+
+    bool written = cacheFile.write((const char *) &header, sizeof(header)) == (qint64) sizeof(header);
+    qint64 position = sizeof(header);
+    foreach (const BlockEntry &entry, entries) {
+      written = written &&
+                cacheFile.write((const char *) &entry, sizeof(entry)) == (qint64) sizeof(entry);
+      position += sizeof(entry);
+    }
+
+    QByteArray padding(BlockAlignment, '\0');
+    for (int i = 0; i < blocks.size() && written; i++) {
+      qint64 paddingSize = entries[i].offset - position;
+      written = cacheFile.write(padding.constData(), paddingSize) == paddingSize &&
+                cacheFile.write(blocks[i].data, blocks[i].size) == blocks[i].size;
+      position = entries[i].offset + blocks[i].size;
+    }
+
+    if (!written) {
+      cacheFile.cancelWriting();
+      return false;
+    }
+    return cacheFile.commit();
+  }
+
+
+  /**
+   * Gets how cache files are used from the ShapeMeshCache keyword of the
+   * Performance preferences group.
+   *
+   * @return @b CacheMode How cache files are used. Read is the default.
+   */
+  ShapeMeshCache::CacheMode ShapeMeshCache::preferredMode() {
+    PvlGroup &performancePrefs = Preference::Preferences().findGroup("Performance");
+    if (!performancePrefs.hasKeyword("ShapeMeshCache")) {
+      return ReadCache;
+    }
+
+    IString mode = performancePrefs["ShapeMeshCache"][0];
+    mode.DownCase();
+    if (mode == "none") {
+      return NoCache;
+    }
+    if (mode == "readwrite") {
+      return ReadWriteCache;
+    }
+    return ReadCache;
+  }
+
+
+  /**
+   * Unmaps and closes the cache file.
+   */
+  void ShapeMeshCache::unmap() {
+    if (m_mappedData) {
+      m_file.unmap(m_mappedData);
+      m_mappedData = NULL;
+    }
+    if (m_file.isOpen()) {
+      m_file.close();
+    }
+    m_blocks.clear();
+  }
+}
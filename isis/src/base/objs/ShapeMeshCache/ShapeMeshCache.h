@@ -0,0 +1,107 @@
+#ifndef ShapeMeshCache_h
+#define ShapeMeshCache_h
+/** This is free and unencumbered software released into the public domain.
+The authors of ISIS do not claim copyright on the contents of this file.
+For more details about the LICENSE terms and the AUTHORS, you will
+find files of those names at the top level of this repository. **/
+
+/* SPDX-License-Identifier: CC0-1.0 */
+
+#include <QFile>
+#include <QList>
+#include <QMap>
+#include <QPair>
+#include <QString>
+
+namespace Isis {
+
+  /**
+   * @brief A file of prebuilt ray tracing data for a shape model
+   *
+   * Reading a large DSK and building the triangle mesh and bounding volume
+   * hierarchy the ray tracing engines need takes minutes for models with tens
+   * of millions of plates, and every process that uses the shape model does it
+   * again. This class stores that data in a cache file next to the shape file,
+   * named after the shape file and the engine, for example
+   * <code>itokawa.bds.bullet64.meshcache</code>.
+   *
+   * A cache file holds named blocks of raw bytes in the layout the engine uses
+   * them in. Opened cache files are memory mapped, so the blocks are used in
+   * place and the pages are shared with every other process using the same
+   * shape model. The file records the version of the format, the versions of
+   * ISIS and the engine library that wrote it, the byte order and pointer
+   * size of the machine that wrote it and the size and modification time of
+   * the shape file. Cache files that do not match are ignored, so a new
+   * delivery of a shape model or a new version of ISIS, Bullet or Embree never
+   * uses stale data.
+   *
+   * Caches are used according to the ShapeMeshCache keyword of the
+   * Performance preferences group. A cache file is written with a temporary
+   * name and renamed when it is complete, so other processes never see part
+   * of one.
+   *
+   * @ingroup Geometry
+   *
+   * @author 2026-10-16 ISIS Development Team
+   *
+   * @internal
+   *   @history 2026-10-16 ISIS Development Team - Original version
+   *   @history 2026-10-17 ISIS Development Team - Cache files record the versions
+   *                           of ISIS and the engine library and are ignored
+   *                           when either changes.
+   */
+  class ShapeMeshCache {
+    public:
+      /**
+       * How cache files are used
+       */
+      enum CacheMode {
+        NoCache,       //!< Always build the ray tracing data from the shape file
+        ReadCache,     //!< Use cache files that already exist
+        ReadWriteCache //!< Use cache files and write them when they do not exist
+      };
+
+      ShapeMeshCache(const QString &shapeFile, const QString &engine,
+                     const QString &engineVersion);
+      ~ShapeMeshCache();
+
+      QString fileName() const;
+
+      bool map(bool copyOnWrite = false);
+      bool isMapped() const;
+
+      bool hasBlock(const QString &name) const;
+      uchar *block(const QString &name) const;
+      qint64 blockSize(const QString &name) const;
+
+      void addBlock(const QString &name, const void *data, qint64 size);
+      bool write();
+
+      static CacheMode preferredMode();
+
+    private:
+      Q_DISABLE_COPY(ShapeMeshCache)
+
+      void unmap();
+
+      /**
+       * A block waiting to be written to the cache file
+       */
+      struct PendingBlock {
+        QString     name; //!< The name of the block
+        const char *data; //!< The bytes of the block, owned by the caller
+        qint64      size; //!< The number of bytes in the block
+      };
+
+      QString m_shapeFile;      //!< The expanded name of the shape file
+      QString m_engine;         //!< The engine the data is for
+      QString m_engineVersion;  //!< The version of the engine library
+      QFile   m_file;           //!< The cache file
+      uchar  *m_mappedData;     //!< The mapped cache file, or NULL if it is not mapped
+      QMap< QString, QPair<qint64, qint64> > m_blocks; /**!< The offset and size of
+                                                             each mapped block */
+      QList<PendingBlock> m_pendingBlocks; //!< The blocks added since the last write
+  };
+};
+
+#endif
@@ -10,6 +10,7 @@ find files of those names at the top level of this repository. **/
 #include <iomanip>
 
 #include <QDebug>
+#include <QScopedPointer>
 #include <QVector>
 
 #include <getSpkAbCorrState.hpp>
@@ -33,6 +34,7 @@ using json = nlohmann::json;
 #include "NaifStatus.h"
 #include "ShapeModel.h"
 #include "SpacecraftPosition.h"
+#include "SpiceCache.h"
 #include "Target.h"
 #include "Blob.h"
 
@@ -206,7 +208,27 @@ namespace Isis {
 
           props["kernels"] = kernel_pvl.str();
 
-          isd = ale::load(lab.fileName().toStdString(), props.dump(), "ale", false, false, true);
+          // Reuse the ISD from a previous run with the same kernels if there is one
+          QScopedPointer<SpiceCache> cache;
+          QString cacheKey;
+          QString cacheDirectory = SpiceCache::preferredDirectory();
+          if (!cacheDirectory.isEmpty()) {
+            try {
+              cache.reset(new SpiceCache(cacheDirectory));
+              cacheKey = cache->key(lab, kernels, QString::fromStdString(props.dump()));
+            }
+            catch (IException &e) {
+              // Without the cache the ISD is computed as usual
+              cache.reset();
+            }
+          }
+
+          if (cache.isNull() || !cache->find(cacheKey, isd)) {
+            isd = ale::load(lab.fileName().toStdString(), props.dump(), "ale", false, false, true);
+            if (!cache.isNull()) {
+              cache->insert(cacheKey, isd);
+            }
+          }
         }
 
         json aleNaifKeywords = isd["naif_keywords"];
@@ -279,6 +279,9 @@ namespace Isis {
    *  @history 2021-02-17 Kristin Berry, Jesse Mapel, and Stuart Sides - Made several methods virtual,
    *                           moved several member variables to protected, and added initialization
    *                           path for a sensor model without SPICE data.
+   *  @history 2026-10-16 ISIS Development Team - ALE ISDs are looked up in the SpiceCache
+   *                           before the kernels are evaluated, when the SpiceCache
+   *                           preference is set.
    */
   class Spice {
     public:
@@ -0,0 +1,238 @@
+/** This is free and unencumbered software released into the public domain.
+The authors of ISIS do not claim copyright on the contents of this file.
+For more details about the LICENSE terms and the AUTHORS, you will
+find files of those names at the top level of this repository. **/
+
+/* SPDX-License-Identifier: CC0-1.0 */
+#include "SpiceCache.h"
+
+#include <sstream>
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include "Environment.h"
+#include "FileName.h"
+#include "IException.h"
+#include "Preference.h"
+#include "Pvl.h"
+#include "PvlGroup.h"
+#include "PvlKeyword.h"
+#include "PvlObject.h"
+
+using json = nlohmann::json;
+
+namespace Isis {
+  /**
+   * Changes whenever the ISDs or the keys are computed differently, so old
+   * files are never read back.
+   */
+  static const char *FormatVersion = "IsisSpiceCache 2";
+
+  /**
+   * Constructs a cache of the ISDs in a directory. The directory is created if
+   * it does not exist.
+   *
+   * @param directory The name of the directory, which can contain variables
+   *
+   * @throws IException::Io "Unable to create the SPICE cache directory"
+   */
+  SpiceCache::SpiceCache(const QString &directory) {
+    m_directory = FileName(directory).expanded();
+
+    if (!QDir().mkpath(m_directory)) {
+      QString msg = "Unable to create the SPICE cache directory [" + m_directory + "]";
+      throw IException(IException::Io, msg, _FILEINFO_);
+    }
+  }
+
+
+  /**
+   * Destroys the cache object. The files stay in the directory.
+   */
+  SpiceCache::~SpiceCache() {
+  }
+
+
+  /**
+   * @return @b QString The expanded name of the cache directory
+   */
+  QString SpiceCache::directory() const {
+    return m_directory;
+  }
+
+
+  /**
+   * Computes the key of the ISD of an observation. The key is a checksum of
+   * the version of ISIS, the options given to ALE, the path, size and
+   * modification time of every kernel file named in the Kernels group and the
+   * cube labels. The Kernels group and
+   * where the data is stored in the cube are left out of the labels, the
+   * Kernels group is already part of the options and the other keywords do not
+   * change the ISD.
+   *
+   * @param label The labels of the cube
+   * @param kernels The Kernels group the ISD is computed with
+   * @param properties The options given to ALE
+   *
+   * @return @b QString The key
+   */
+  QString SpiceCache::key(Pvl &label, PvlGroup &kernels, const QString &properties) const {
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArray(FormatVersion));
+
+    try {
+      hash.addData(Environment::isisVersion().toUtf8());
+    }
+    catch (IException &e) {
+      // Without a version file the key only depends on the inputs
+    }
+
+    hash.addData(properties.toUtf8());
+
+    for (int i = 0; i < kernels.keywords(); i++) {
+      const PvlKeyword &keyword = kernels[i];
+      for (int j = 0; j < keyword.size(); j++) {
+        // Values that are not files, like Table or NaifFrameCode, are already
+        // part of the options
+        try {
+          if (keyword[j].isEmpty() || !FileName(keyword[j]).fileExists()) continue;
+        }
+        catch (IException &e) {
+          continue;
+        }
+
+        hash.addData(keyword.name().toUtf8());
+        hash.addData(kernelStamp(keyword[j]));
+      }
+    }
+
+    PvlObject cubeLabel = label.hasObject("IsisCube") ?
+                          label.findObject("IsisCube") : PvlObject(label);
+    if (cubeLabel.hasGroup("Kernels")) {
+      cubeLabel.deleteGroup("Kernels");
+    }
+    if (cubeLabel.hasObject("Core")) {
+      cubeLabel.findObject("Core").clear();
+    }
+
+    std::ostringstream cubeLabelText;
+    cubeLabelText << cubeLabel;
+    hash.addData(QByteArray(cubeLabelText.str().c_str()));
+
+    return QString(hash.result().toHex());
+  }
+
+
+  /**
+   * Reads an ISD from the cache.
+   *
+   * @param key The key of the ISD
+   * @param[out] isd The ISD, if it was found
+   *
+   * @return @b bool True if the ISD was found. Files that are unreadable or
+   *                 not valid JSON are treated as missing.
+   */
+  bool SpiceCache::find(const QString &key, json &isd) const {
+    QFile isdFile(isdFileName(key));
+    if (!isdFile.open(QIODevice::ReadOnly)) {
+      return false;
+    }
+
+    QByteArray isdText = isdFile.readAll();
+    json found = json::parse(isdText.constData(), isdText.constData() + isdText.size(),
+                             nullptr, false);
+    if (found.is_discarded() || !found.is_object()) {
+      return false;
+    }
+
+    isd = found;
+    return true;
+  }
+
+
+  /**
+   * Stores an ISD in the cache. It is written to a temporary file that is
+   * renamed when it is complete, so other processes never read part of it.
+   *
+   * @param key The key of the ISD
+   * @param isd The ISD
+   *
+   * @return @b bool True if the ISD was stored. Failing to store it is not an
+   *                 error, the ISD is just computed again next time.
+   */
+  bool SpiceCache::insert(const QString &key, const json &isd) const {
+    QSaveFile isdFile(isdFileName(key));
+    if (!isdFile.open(QIODevice::WriteOnly)) {
+      return false;
+    }
+
+    std::string isdText = isd.dump();
+    if (isdFile.write(isdText.c_str(), isdText.size()) != (qint64) isdText.size()) {
+      isdFile.cancelWriting();
+      return false;
+    }
+
+    return isdFile.commit();
+  }
+
+
+  /**
+   * Gets the cache directory from the SpiceCache keyword of the Performance
+   * preferences group.
+   *
+   * @return @b QString The directory, or an empty string if the cache is
+   *                    disabled
+   */
+  QString SpiceCache::preferredDirectory() {
+    PvlGroup &performancePrefs = Preference::Preferences().findGroup("Performance");
+    if (!performancePrefs.hasKeyword("SpiceCache")) {
+      return "";
+    }
+
+    QString directory = performancePrefs["SpiceCache"][0];
+    if (directory.isEmpty() || directory.toUpper() == "NONE") {
+      return "";
+    }
+    return directory;
+  }
+
+
+  /**
+   * Identifies a version of a kernel by its path, size and modification time.
+   * Kernels can be gigabytes, so reading their contents for every key would
+   * cost more than many of the ISDs it saves. Delivering a new version of a
+   * kernel rewrites the file, which changes its modification time.
+   *
+   * @param kernelFile The name of the kernel, which can contain variables
+   *
+   * @return @b QByteArray The path, size and modification time of the kernel
+   *
+   * @throws IException::Io "Unable to find kernel"
+   */
+  QByteArray SpiceCache::kernelStamp(const QString &kernelFile) {
+    QFileInfo fileInfo(FileName(kernelFile).expanded());
+    if (!fileInfo.exists()) {
+      QString msg = "Unable to find kernel [" + fileInfo.filePath() + "]";
+      throw IException(IException::Io, msg, _FILEINFO_);
+    }
+
+    QString stamp = fileInfo.absoluteFilePath() + " " + QString::number(fileInfo.size()) + " " +
+                    QString::number(fileInfo.lastModified().toMSecsSinceEpoch());
+    return stamp.toUtf8();
+  }
+
+
+  /**
+   * @param key The key of an ISD
+   *
+   * @return @b QString The name of the file the ISD is stored in
+   */
+  QString SpiceCache::isdFileName(const QString &key) const {
+    return m_directory + "/" + key + ".json";
+  }
+}
@@ -0,0 +1,73 @@
+#ifndef SpiceCache_h
+#define SpiceCache_h
+/** This is free and unencumbered software released into the public domain.
+The authors of ISIS do not claim copyright on the contents of this file.
+For more details about the LICENSE terms and the AUTHORS, you will
+find files of those names at the top level of this repository. **/
+
+/* SPDX-License-Identifier: CC0-1.0 */
+
+#include <QByteArray>
+#include <QString>
+
+#include <nlohmann/json.hpp>
+
+namespace Isis {
+  class Pvl;
+  class PvlGroup;
+
+  /**
+   * @brief A directory of ALE ISDs that have already been computed
+   *
+   * Computing an ISD evaluates the SPICE kernels of an observation at every
+   * cached time, which is most of the time spiceinit spends on an image. The
+   * result only depends on the kernels, the options given to ALE and the labels
+   * of the cube, so this class stores each ISD in a file named after a checksum
+   * of all three. When an observation is initialized again with the same
+   * kernels, even after the cube was reingested, the ISD is read back instead
+   * of being recomputed.
+   *
+   * The kernels are identified by their paths, sizes and modification times,
+   * not by their contents, so keys are cheap to compute even for very large
+   * kernels. Delivering a new version of a kernel under the same name changes
+   * its modification time and makes the ISDs that used it unreachable, as does
+   * copying the data area somewhere else. Nothing is ever removed from the
+   * directory; delete the files in it to clear the cache.
+   *
+   * The cache is enabled with the SpiceCache keyword of the Performance
+   * preferences group, which names the directory. Several processes can share
+   * the same directory, each file is written to a temporary file and renamed
+   * into place.
+   *
+   * @ingroup SpiceInstrumentsAndCameras
+   *
+   * @author 2026-10-16 ISIS Development Team
+   *
+   * @internal
+   *   @history 2026-10-16 ISIS Development Team - Original version
+   *   @history 2026-10-17 ISIS Development Team - Kernels are identified by their
+   *                           path, size and modification time instead of a
+   *                           checksum of their contents.
+   */
+  class SpiceCache {
+    public:
+      SpiceCache(const QString &directory);
+      ~SpiceCache();
+
+      QString directory() const;
+
+      QString key(Pvl &label, PvlGroup &kernels, const QString &properties) const;
+      bool find(const QString &key, nlohmann::json &isd) const;
+      bool insert(const QString &key, const nlohmann::json &isd) const;
+
+      static QString preferredDirectory();
+      static QByteArray kernelStamp(const QString &kernelFile);
+
+    private:
+      QString isdFileName(const QString &key) const;
+
+      QString m_directory; //!< The expanded name of the cache directory
+  };
+};
+
+#endif
@@ -341,6 +341,30 @@ namespace Isis {
   }
 
 
+  /**
+   * Add the data gathered by another Statistics object to this one, as if all of
+   * it had been added here. Both objects should have the same valid range.
+   *
+   * @param other The statistics to add to these.
+   */
+  void Statistics::MergeStatistics(const Statistics &other) {
+    m_sum += other.m_sum;
+    m_sumsum += other.m_sumsum;
+    if (other.m_minimum < m_minimum) m_minimum = other.m_minimum;
+    if (other.m_maximum > m_maximum) m_maximum = other.m_maximum;
+    m_totalPixels += other.m_totalPixels;
+    m_validPixels += other.m_validPixels;
+    m_nullPixels += other.m_nullPixels;
+    m_lisPixels += other.m_lisPixels;
+    m_lrsPixels += other.m_lrsPixels;
+    m_hrsPixels += other.m_hrsPixels;
+    m_hisPixels += other.m_hisPixels;
+    m_overRangePixels += other.m_overRangePixels;
+    m_underRangePixels += other.m_underRangePixels;
+    m_removedData = m_removedData || other.m_removedData;
+  }
+
+
   /**
    * Remove an array of doubles from the accumulators and counters.
    * Note that is invalidates the absolute minimum and maximum. They
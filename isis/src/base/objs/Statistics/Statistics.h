@@ -84,6 +84,8 @@ namespace Isis {
    *                           Statistics serialization/unserialization. References #2282.
    *   @history 2017-04-20 Makayla Shepherd - Removed the hdf5 code because we are using XML for
    *                           serialization. Fixes #4795.
+   *   @history 2026-10-16 ISIS Development Team - Added MergeStatistics() so statistics gathered
+   *                           separately, for example on different threads, can be combined.
    *
    *   @todo 2005-02-07 Deborah Lee Soltesz - add example using cube data to the class documentation
    *   @todo 2015-08-13 Jeannie Backer - Clean up header and implementation files once
@@ -110,6 +112,8 @@ namespace Isis {
       void RemoveData(const double *data, const unsigned int count);
       void RemoveData(const double data);
 
+      void MergeStatistics(const Statistics &other);
+
       void SetValidRange(const double minimum = Isis::ValidMinimum,
                          const double maximum = Isis::ValidMaximum);
 
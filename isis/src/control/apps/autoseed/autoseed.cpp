@@ -11,14 +11,20 @@ find files of those names at the top level of this repository. **/
 #include <map>
 #include <sstream>
 
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QMutexLocker>
 #include <QString>
+#include <QThreadPool>
+#include <QtConcurrentMap>
+#include <QVector>
 
 #include "geos/util/GEOSException.h"
 
 #include "Application.h"
 #include "Brick.h"
 #include "Camera.h"
-#include "CameraFactory.h"
 #include "ControlMeasure.h"
 #include "ControlNet.h"
 #include "ControlPoint.h"
@@ -46,6 +52,146 @@ find files of those names at the top level of this repository. **/
 using namespace std;
 
 namespace Isis {
+  namespace {
+
+    /**
+     * The seeder and projection that seed overlaps on one thread. In the
+     * SampleLine seed domain the ground map is used instead of the projection.
+     *
+     * @author 2026-10-16 ISIS Development Team
+     *
+     * @internal
+     */
+    struct OverlapSeeder {
+      PolygonSeeder *seeder;      //!< Seeds the overlap polygons
+      TProjection *proj;          //!< Converts between lon/lat and X/Y
+      UniversalGroundMap *ugmap;  //!< Converts between lon/lat and sample/line
+    };
+
+
+    /**
+     * The points seeded in one overlap
+     *
+     * @author 2026-10-16 ISIS Development Team
+     *
+     * @internal
+     */
+    struct SeededOverlap {
+      const ImageOverlap *overlap;              //!< The overlap
+      std::vector<geos::geom::Point *> seed;    //!< The seeded points in lon/lat
+      QString seedError;                        //!< The message of an exception thrown seeding
+      QString fatalError;                       //!< An error that stops autoseed
+    };
+
+
+    /**
+     * The seeders for the threads that seed overlaps. Each thread takes a seeder
+     * while it seeds an overlap; seeders are made from the seed definition when
+     * all of the others are in use.
+     *
+     * @author 2026-10-16 ISIS Development Team
+     *
+     * @internal
+     */
+    class OverlapSeederPool {
+      public:
+        OverlapSeederPool(Pvl &seedDef, Pvl &mapLabel) : m_seedDef(seedDef),
+                                                         m_mapLabel(mapLabel) { }
+
+        ~OverlapSeederPool() {
+          foreach (OverlapSeeder *seeder, m_seeders) {
+            delete seeder->seeder;
+            delete seeder->proj;
+            delete seeder;
+          }
+        }
+
+        OverlapSeeder *take() {
+          QMutexLocker locker(&m_mutex);
+          if (!m_idleSeeders.isEmpty()) {
+            return m_idleSeeders.takeLast();
+          }
+
+          OverlapSeeder *seeder = new OverlapSeeder;
+          seeder->seeder = PolygonSeederFactory::Create(m_seedDef);
+          seeder->proj = (TProjection *) ProjectionFactory::Create(m_mapLabel);
+          seeder->ugmap = NULL;
+          m_seeders.append(seeder);
+          return seeder;
+        }
+
+        void release(OverlapSeeder *seeder) {
+          QMutexLocker locker(&m_mutex);
+          m_idleSeeders.append(seeder);
+        }
+
+      private:
+        Pvl &m_seedDef;                       //!< The seed definition
+        Pvl &m_mapLabel;                      //!< The label of the X/Y projection
+        QMutex m_mutex;                       //!< Guards the lists of seeders
+        QList<OverlapSeeder *> m_seeders;     //!< Every seeder made
+        QList<OverlapSeeder *> m_idleSeeders; //!< The seeders not in use
+    };
+
+
+    /**
+     * A DN to check for a measure, read from its cube after the measures are
+     * made
+     *
+     * @author 2026-10-16 ISIS Development Team
+     *
+     * @internal
+     */
+    struct DnCheck {
+      ControlMeasure *measure; //!< The measure, ignored if the DN is out of range
+      int sample;              //!< The sample of the pixel
+      int line;                //!< The line of the pixel
+      int band;                //!< The band of the pixel
+      bool valid;              //!< The DN is in range
+    };
+
+
+    /**
+     * The DNs to check in one cube
+     *
+     * @author 2026-10-16 ISIS Development Team
+     *
+     * @internal
+     */
+    struct CubeDnChecks {
+      QString fileName;        //!< The cube
+      double minDN;            //!< The smallest valid DN
+      double maxDN;            //!< The largest valid DN
+      QVector<DnCheck> checks; //!< The pixels to check
+      QString error;           //!< The message of an exception thrown reading the cube
+    };
+
+
+    void seedOverlap(OverlapSeeder &seeder, SeedDomain seedDomain, SeededOverlap &seeded);
+    void checkDns(CubeDnChecks &cubeChecks);
+
+
+    /**
+     * Seeds an overlap on any thread with a seeder from a pool
+     *
+     * @author 2026-10-16 ISIS Development Team
+     *
+     * @internal
+     */
+    struct SeedOverlapFunctor {
+      typedef void result_type;
+
+      OverlapSeederPool *pool; //!< The seeders
+
+      void operator()(SeededOverlap &seeded) const {
+        OverlapSeeder *seeder = pool->take();
+        seedOverlap(*seeder, XY, seeded);
+        pool->release(seeder);
+      }
+    };
+
+  }
+
 
   void autoseed(UserInterface &ui, Pvl *log) {
     SerialNumberList serialNumbers(ui.GetFileName("FROMLIST"));
@@ -230,17 +376,20 @@ namespace Isis {
       for (int i = 0 ; i < precnet->GetNumPoints(); i ++) {
         ControlPoint *cp = precnet->GetPoint(i);
         ControlMeasure *cm = cp->GetRefMeasure();
-        QString c = serialNumbers.fileName(cm->GetCubeSerialNumber());
-        Cube cube(c);
-        Camera *cam = CameraFactory::Create(cube);
-        cam->SetImage(cm->GetSample(), cm->GetLine());
 
+        // Use the camera of the ground map made for the cube above instead of
+        // making a new camera for every point
+        UniversalGroundMap *gmap = gMaps[cm->GetCubeSerialNumber()];
+        if (!gmap) {
+          QString msg = "Unable to create a Universal Ground for Serial Number [";
+          msg += cm->GetCubeSerialNumber() + "] The associated image is more than ";
+          msg += "likely missing from your FROMLIST.";
+          throw IException(IException::User, msg, _FILEINFO_);
+        }
+        gmap->SetImage(cm->GetSample(), cm->GetLine());
 
         points.push_back(Isis::globalFactory->createPoint(geos::geom::Coordinate(
-                           cam->UniversalLongitude(), cam->UniversalLatitude())).release());
-
-        delete cam;
-        cam = NULL;
+                           gmap->UniversalLongitude(), gmap->UniversalLatitude())).release());
 
         progress.CheckStatus();
       }
@@ -255,186 +404,220 @@ namespace Isis {
     int cpIgnoredCount = 0;
     int cmIgnoredCount = 0;
 
-    for (int ov = 0; ov < overlaps.Size(); ++ov) {
-      progress.CheckStatus();
+    // Overlaps are taken in batches. The overlaps in the batch are seeded on
+    // all of the threads, each with a seeder and projection of its own. The
+    // measures are then made in overlap order with the ground maps, because
+    // cameras are not thread safe, and the DNs of the measures are read with
+    // one thread for each cube. Points are added to the network in overlap
+    // order, so it is the same as when the overlaps are seeded one at a time.
+    OverlapSeederPool seederPool(seedDef, maplab);
+    int batchSize = 16 * QThreadPool::globalInstance()->maxThreadCount();
+    int ov = 0;
+    while (ov < overlaps.Size()) {
+      QVector<SeededOverlap> batch;
+
+      for (; ov < overlaps.Size() && batch.size() < batchSize; ++ov) {
+        progress.CheckStatus();
 
-      if (overlaps[ov]->Size() == 1) {
-        stats_noOverlap++;
-        continue;
-      }
+        if (overlaps[ov]->Size() == 1) {
+          stats_noOverlap++;
+          continue;
+        }
 
-      // Checks if this overlap was already seeded
-      if (precnet) {
+        // Checks if this overlap was already seeded
+        if (precnet) {
 
-        // Grabs the Multipolygon's Envelope for Lat/Lon comparison
-        const geos::geom::MultiPolygon *lonLatPoly = overlaps[ov]->Polygon();
+          // Grabs the Multipolygon's Envelope for Lat/Lon comparison
+          const geos::geom::MultiPolygon *lonLatPoly = overlaps[ov]->Polygon();
 
-        bool overlapSeeded = false;
-        for (unsigned int j = 0; j < lonLatPoly->getNumGeometries()  &&  !overlapSeeded; j ++) {
-          const geos::geom::Geometry *lonLatGeom = lonLatPoly->getGeometryN(j);
+          bool overlapSeeded = false;
+          for (unsigned int j = 0; j < lonLatPoly->getNumGeometries()  &&  !overlapSeeded; j ++) {
+            const geos::geom::Geometry *lonLatGeom = lonLatPoly->getGeometryN(j);
 
-          // Checks if Control Point is in the MultiPolygon using Lon/Lat
-          for (unsigned int i = 0 ; i < points.size()  &&  !overlapSeeded; i ++) {
-            if (lonLatGeom->contains(points[i])) overlapSeeded = true;
+            // Checks if Control Point is in the MultiPolygon using Lon/Lat
+            for (unsigned int i = 0 ; i < points.size()  &&  !overlapSeeded; i ++) {
+              if (lonLatGeom->contains(points[i])) overlapSeeded = true;
+            }
           }
+
+          if (overlapSeeded) continue;
         }
 
-        if (overlapSeeded) continue;
+        SeededOverlap seeded;
+        seeded.overlap = overlaps[ov];
+        batch.append(seeded);
       }
 
-      // Seed this overlap with points
-      const geos::geom::MultiPolygon *polygonOverlaps = overlaps[ov]->Polygon();
-      std::vector<geos::geom::Point *> points;
-
-      try {
-        geos::geom::MultiPolygon *mp = NULL;
-        if (seedDomain == XY) {
-          mp = PolygonTools::LatLonToXY(*polygonOverlaps, proj);
-        }
-        else if (seedDomain == SampleLine) {
-          mp = PolygonTools::LatLonToSampleLine(*polygonOverlaps, ugmap);
+      // Seed the overlaps with points. The SampleLine domain uses a camera, so
+      // those are seeded in order.
+      if (seedDomain == XY) {
+        SeedOverlapFunctor seedFunctor;
+        seedFunctor.pool = &seederPool;
+        QtConcurrent::blockingMap(batch, seedFunctor);
+      }
+      else {
+        OverlapSeeder sampleLineSeeder;
+        sampleLineSeeder.seeder = seeder;
+        sampleLineSeeder.proj = proj;
+        sampleLineSeeder.ugmap = ugmap;
+        for (int b = 0; b < batch.size(); b++) {
+          seedOverlap(sampleLineSeeder, seedDomain, batch[b]);
         }
-        points = seeder->Seed(mp);
       }
-      catch (IException &e) {
 
-        if (ui.WasEntered("ERRORS")) {
+      QList<ControlPoint *> newPoints;
+      QMap<QString, CubeDnChecks> dnChecks;
 
-          if (errorNum > 0) {
-            errors << endl;
-          }
-          errorNum ++;
+      for (int b = 0; b < batch.size(); b++) {
+        const ImageOverlap *overlap = batch[b].overlap;
+        vector<geos::geom::Point *> &seed = batch[b].seed;
 
-          errors << e.toPvl().group(0).findKeyword("Message")[0];
-          for (int serNum = 0; serNum < overlaps[ov]->Size(); serNum++) {
-            if (serNum == 0) {
-              errors << ": ";
-            }
-            else {
-              errors << ", ";
-            }
-            errors << (*overlaps[ov])[serNum];
-          }
+        if (!batch[b].fatalError.isEmpty()) {
+          throw IException(IException::Unknown, batch[b].fatalError, _FILEINFO_);
         }
 
-        continue;
-      }
+        if (!batch[b].seedError.isEmpty()) {
 
-      // No points were seeded in this polygon, so collect some stats and move on
-      if (points.size() == 0) {
-        stats_tolerance++;
-        continue;
-      }
+          if (ui.WasEntered("ERRORS")) {
 
-      vector<geos::geom::Point *> seed;
-      if (seedDomain == XY) {
-        // Convert the X/Y points back to Lat/Lon points
-        for (unsigned int pt = 0; pt < points.size(); pt ++) {
-          if (proj->SetCoordinate(points[pt]->getX(), points[pt]->getY())) {
-            seed.push_back(Isis::globalFactory->createPoint(
-                             geos::geom::Coordinate(proj->UniversalLongitude(),
-                                                    proj->UniversalLatitude())).release());
-          }
-          else {
-            IString msg = "Unable to convert from X/Y to a (lon,lat)";
-            throw IException(IException::Unknown, msg, _FILEINFO_);
+            if (errorNum > 0) {
+              errors << endl;
+            }
+            errorNum ++;
+
+            errors << batch[b].seedError;
+            for (int serNum = 0; serNum < overlap->Size(); serNum++) {
+              if (serNum == 0) {
+                errors << ": ";
+              }
+              else {
+                errors << ", ";
+              }
+              errors << (*overlap)[serNum];
+            }
           }
+
+          continue;
         }
-      }
-      else if (seedDomain == SampleLine) {
-        // Convert the Sample/Line points back to Lat/Lon points
-        for (unsigned int pt = 0; pt < points.size(); pt ++) {
-          if (ugmap->SetImage(points[pt]->getX(), points[pt]->getY())) {
-            seed.push_back(Isis::globalFactory->createPoint(
-                             geos::geom::Coordinate(ugmap->UniversalLongitude(),
-                                                    ugmap->UniversalLatitude())).release());
-          }
-          else {
-            IString msg = "Unable to convert from Sample/Line to a (lon,lat)";
-            throw IException(IException::Unknown, msg, _FILEINFO_);
-          }
+
+        // No points were seeded in this polygon, so collect some stats and move on
+        if (seed.size() == 0) {
+          stats_tolerance++;
+          continue;
         }
-      }
 
-      //   Create a control point for each seeded point in this overlap
-      for (unsigned int point = 0; point < seed.size(); ++point) {
+        //   Create a control point for each seeded point in this overlap
+        for (unsigned int point = 0; point < seed.size(); ++point) {
 
-        ControlPoint *controlpt = new ControlPoint();
-        controlpt->SetId(pointId.Next());
-        controlpt->SetType(ControlPoint::Free);
+          ControlPoint *controlpt = new ControlPoint();
+          controlpt->SetId(pointId.Next());
+          controlpt->SetType(ControlPoint::Free);
 
-        // Create a measurment at this point for each image in the overlap area
-        for (int sn = 0; sn < overlaps[ov]->Size(); ++sn) {
-          bool ignore = false;
+          // Create a measurment at this point for each image in the overlap area
+          for (int sn = 0; sn < overlap->Size(); ++sn) {
+            bool ignore = false;
 
-          // Get the line/sample of the lat/lon for this cube
-          UniversalGroundMap *gmap = gMaps[(*overlaps[ov])[sn]];
+            // Get the line/sample of the lat/lon for this cube
+            UniversalGroundMap *gmap = gMaps[(*overlap)[sn]];
 
-          if (!gmap) {
-            QString msg = "Unable to create a Universal Ground for Serial Number [";
-            msg += (*overlaps[ov])[sn] + "] The associated image is more than ";
-            msg += "likely missing from your FROMLIST.";
-            throw IException(IException::User, msg, _FILEINFO_);
-          }
+            if (!gmap) {
+              QString msg = "Unable to create a Universal Ground for Serial Number [";
+              msg += (*overlap)[sn] + "] The associated image is more than ";
+              msg += "likely missing from your FROMLIST.";
+              throw IException(IException::User, msg, _FILEINFO_);
+            }
 
-          if (!gmap->SetUniversalGround(seed[point]->getY(), seed[point]->getX())) {
-            // This error is more than likely due to floating point roundoff
-            continue;
-          }
+            if (!gmap->SetUniversalGround(seed[point]->getY(), seed[point]->getX())) {
+              // This error is more than likely due to floating point roundoff
+              continue;
+            }
 
-          // Check the line/sample with the gmap for image edge
-          if (pixelsFromEdge > gmap->Sample() || pixelsFromEdge > gmap->Line()
-              || gmap->Sample() > gmap->Camera()->Samples() - pixelsFromEdge
-              || gmap->Line() > gmap->Camera()->Lines() - pixelsFromEdge) {
-            ignore = true;
-          }
+            // Check the line/sample with the gmap for image edge
+            if (pixelsFromEdge > gmap->Sample() || pixelsFromEdge > gmap->Line()
+                || gmap->Sample() > gmap->Camera()->Samples() - pixelsFromEdge
+                || gmap->Line() > gmap->Camera()->Lines() - pixelsFromEdge) {
+              ignore = true;
+            }
 
-          // Check the Emission/Incidence Angle with the camera from the gmap
-          if (gmap->Camera()->EmissionAngle() < minEmission ||
-              gmap->Camera()->EmissionAngle() > maxEmission) {
-            ignore = true;
-          }
-          if (gmap->Camera()->IncidenceAngle() < minIncidence ||
-              gmap->Camera()->IncidenceAngle() > maxIncidence) {
-            ignore = true;
-          }
+            // Check the Emission/Incidence Angle with the camera from the gmap
+            if (gmap->Camera()->EmissionAngle() < minEmission ||
+                gmap->Camera()->EmissionAngle() > maxEmission) {
+              ignore = true;
+            }
+            if (gmap->Camera()->IncidenceAngle() < minIncidence ||
+                gmap->Camera()->IncidenceAngle() > maxIncidence) {
+              ignore = true;
+            }
 
-          // Check the DNs with the cube, Note: this is costly to do
-          if (hasDNRestriction) {
-            Cube cube;
-            QString c = serialNumbers.fileName((*overlaps[ov])[sn]);
-            cube.open(c);
-            Brick brick(1, 1, 1, cube.pixelType());
-            brick.SetBasePosition((int)gmap->Camera()->Sample(), (int)gmap->Camera()->Line(), (int)gmap->Camera()->Band());
-            cube.read(brick);
-            if (Isis::IsSpecial(brick[0]) || brick[0] > maxDN || brick[0] < minDN) {
+            // Check the Resolution with the camera from the gmap
+            if (gmap->Resolution() < minResolution ||
+                (maxResolution > 0.0 && gmap->Resolution() > maxResolution)) {
               ignore = true;
             }
-          }
 
-          // Check the Resolution with the camera from the gmap
-          if (gmap->Resolution() < minResolution ||
-              (maxResolution > 0.0 && gmap->Resolution() > maxResolution)) {
-            ignore = true;
+            // Put the line/samp into a measurment
+            ControlMeasure *measurement = new ControlMeasure();
+            measurement->SetAprioriSample(gmap->Sample());
+            measurement->SetAprioriLine(gmap->Line());
+            measurement->SetCoordinate(gmap->Sample(), gmap->Line(),
+                                      ControlMeasure::Candidate);
+
+            measurement->SetType(ControlMeasure::Candidate);
+            measurement->SetCubeSerialNumber((*overlap)[sn]);
+            measurement->SetIgnored(ignore);
+
+            // Check the DNs with the cube after all of the measures in the
+            // batch are made, Note: this is costly to do
+            if (hasDNRestriction && !ignore) {
+              CubeDnChecks &cubeChecks = dnChecks[(*overlap)[sn]];
+              if (cubeChecks.fileName.isEmpty()) {
+                cubeChecks.fileName = serialNumbers.fileName((*overlap)[sn]);
+                cubeChecks.minDN = minDN;
+                cubeChecks.maxDN = maxDN;
+              }
+
+              DnCheck check;
+              check.measure = measurement;
+              check.sample = (int)gmap->Camera()->Sample();
+              check.line = (int)gmap->Camera()->Line();
+              check.band = (int)gmap->Camera()->Band();
+              check.valid = true;
+              cubeChecks.checks.append(check);
+            }
+
+            controlpt->Add(measurement); //controlpt takes ownership
+            measurement = NULL;
           }
 
-          // Put the line/samp into a measurment
-          ControlMeasure *measurement = new ControlMeasure();
-          measurement->SetAprioriSample(gmap->Sample());
-          measurement->SetAprioriLine(gmap->Line());
-          measurement->SetCoordinate(gmap->Sample(), gmap->Line(),
-                                    ControlMeasure::Candidate);
+          newPoints.append(controlpt);
+          delete seed[point];
 
-          measurement->SetType(ControlMeasure::Candidate);
-          measurement->SetCubeSerialNumber((*(overlaps[ov]))[sn]);
-          measurement->SetIgnored(ignore);
+        } // End of create control points loop
+      }
 
-          if (ignore) {
-            cmIgnoredCount ++;
+      // Read the DNs of each cube on its own thread and ignore the measures
+      // that are out of range
+      if (!dnChecks.isEmpty()) {
+        QList<CubeDnChecks> cubeChecks = dnChecks.values();
+        QtConcurrent::blockingMap(cubeChecks, checkDns);
+
+        foreach (const CubeDnChecks &checks, cubeChecks) {
+          if (!checks.error.isEmpty()) {
+            throw IException(IException::Unknown, checks.error, _FILEINFO_);
           }
+          foreach (const DnCheck &check, checks.checks) {
+            if (!check.valid) {
+              check.measure->SetIgnored(true);
+            }
+          }
+        }
+      }
 
-          controlpt->Add(measurement); //controlpt takes ownership
-          measurement = NULL;
+      foreach (ControlPoint *controlpt, newPoints) {
+        foreach (ControlMeasure *measurement, controlpt->getMeasures()) {
+          if (measurement->IsIgnored()) {
+            cmIgnoredCount ++;
+          }
         }
 
         if (controlpt->GetNumValidMeasures() < 2) {
@@ -445,9 +628,10 @@ namespace Isis {
         if (controlpt->GetNumMeasures() > 0) {
           cnet.AddPoint(controlpt); //cnet takes ownership
         }
-        delete seed[point];
-
-      } // End of create control points loop
+        else {
+          delete controlpt;
+        }
+      }
 
     } // End of seeding loop
 
@@ -533,4 +717,96 @@ namespace Isis {
     delete seeder;
     seeder = NULL;
   }
+
+
+  namespace {
+
+    /**
+     * Seeds an overlap with points and converts them back to lon/lat
+     *
+     * @param seeder The seeder and the projection or ground map of the seed
+     *               domain, used by one thread at a time
+     * @param seedDomain The domain the overlap is seeded in
+     * @param seeded The overlap, which gets the seeded points or the errors
+     */
+    void seedOverlap(OverlapSeeder &seeder, SeedDomain seedDomain, SeededOverlap &seeded) {
+      const geos::geom::MultiPolygon *polygonOverlaps = seeded.overlap->Polygon();
+      std::vector<geos::geom::Point *> points;
+
+      try {
+        try {
+          geos::geom::MultiPolygon *mp = NULL;
+          if (seedDomain == XY) {
+            mp = PolygonTools::LatLonToXY(*polygonOverlaps, seeder.proj);
+          }
+          else if (seedDomain == SampleLine) {
+            mp = PolygonTools::LatLonToSampleLine(*polygonOverlaps, seeder.ugmap);
+          }
+          points = seeder.seeder->Seed(mp);
+        }
+        catch (IException &e) {
+          seeded.seedError = e.toPvl().group(0).findKeyword("Message")[0];
+          return;
+        }
+
+        if (seedDomain == XY) {
+          // Convert the X/Y points back to Lat/Lon points
+          for (unsigned int pt = 0; pt < points.size(); pt ++) {
+            if (seeder.proj->SetCoordinate(points[pt]->getX(), points[pt]->getY())) {
+              seeded.seed.push_back(Isis::globalFactory->createPoint(
+                               geos::geom::Coordinate(seeder.proj->UniversalLongitude(),
+                                                      seeder.proj->UniversalLatitude())).release());
+            }
+            else {
+              seeded.fatalError = "Unable to convert from X/Y to a (lon,lat)";
+              return;
+            }
+          }
+        }
+        else if (seedDomain == SampleLine) {
+          // Convert the Sample/Line points back to Lat/Lon points
+          for (unsigned int pt = 0; pt < points.size(); pt ++) {
+            if (seeder.ugmap->SetImage(points[pt]->getX(), points[pt]->getY())) {
+              seeded.seed.push_back(Isis::globalFactory->createPoint(
+                               geos::geom::Coordinate(seeder.ugmap->UniversalLongitude(),
+                                                      seeder.ugmap->UniversalLatitude())).release());
+            }
+            else {
+              seeded.fatalError = "Unable to convert from Sample/Line to a (lon,lat)";
+              return;
+            }
+          }
+        }
+      }
+      catch (std::exception &e) {
+        seeded.fatalError = e.what();
+      }
+    }
+
+
+    /**
+     * Reads the DNs to check in a cube, opening the cube once for all of them
+     *
+     * @param cubeChecks The cube and the pixels to check
+     */
+    void checkDns(CubeDnChecks &cubeChecks) {
+      try {
+        Cube cube;
+        cube.open(cubeChecks.fileName);
+        Brick brick(1, 1, 1, cube.pixelType());
+        for (int i = 0; i < cubeChecks.checks.size(); i++) {
+          DnCheck &check = cubeChecks.checks[i];
+          brick.SetBasePosition(check.sample, check.line, check.band);
+          cube.read(brick);
+          if (Isis::IsSpecial(brick[0]) || brick[0] > cubeChecks.maxDN ||
+              brick[0] < cubeChecks.minDN) {
+            check.valid = false;
+          }
+        }
+      }
+      catch (IException &e) {
+        cubeChecks.error = e.toString();
+      }
+    }
+  }
 }
@@ -11,6 +11,8 @@ find files of those names at the top level of this repository. **/
 
 #include <cmath>
 #include <QList>
+#include <QMutex>
+#include <QMutexLocker>
 #include <QString>
 #include <QSharedPointer>
 
@@ -522,6 +524,9 @@ namespace Isis {
    *
    * @internal
    *   @history 2015-11-16 Kris Becker - Original Version
+   *   @history 2026-10-16 ISIS Development Team - Serialized the calls into the
+   *                           nn and triangle libraries, which keep global state,
+   *                           so values can be computed on several threads.
    */
   class NaturalNeighborRadius : public DatumFunctoid {
     public:
@@ -542,6 +547,9 @@ namespace Isis {
             getpoint(m.getPoint(i), &points[i]);
           }
 
+          // The nn and triangle libraries keep global state
+          static QMutex nnMutex;
+          QMutexLocker locker(&nnMutex);
           delaunay *d = delaunay_build(npts, &points[0], 0, 0, 0, 0);
           nnpi *nn = nnpi_create(d);
 
@@ -12,6 +12,8 @@ find files of those names at the top level of this repository. **/
 #include <QtGlobal>
 #include <QTextStream>
 #include <QScopedPointer>
+#include <QThreadPool>
+#include <QtConcurrentMap>
 #include <QVector>
 
 // boost library
@@ -132,6 +134,128 @@ typedef PointCloudTree<PointType, DistanceType>         CNetPointCloudTree;
 typedef PointCloudSearchResult<PointType, DistanceType> ResultType;
 
 
+/**
+ * The ground location of each pixel of an output tile and the values computed
+ * for it. The locations are found in the main thread, because projections are
+ * not thread safe, and the values on any thread.
+ *
+ * @author 2026-10-16 ISIS Development Team
+ *
+ * @internal
+ *   @history 2026-10-16 ISIS Development Team - Original version
+ *   @history 2026-10-17 ISIS Development Team - Keeps the exception itself, so
+ *                           it is reported as the cause of the failure.
+ */
+struct DemTile {
+  int brick;                  //!< The brick number of the tile in the output cube
+  QVector<double> latitudes;  //!< Universal latitude of each pixel, Null if it is not mapped
+  QVector<double> longitudes; //!< Universal longitude of each pixel
+  QVector<double> radii;      //!< Local radius of each pixel in meters
+  QVector<double> datums;     //!< The value of each band, in the order of the output brick
+  bool failed;                //!< If computing the values threw an exception
+  IException error;           //!< The exception thrown computing the values
+};
+
+
+/**
+ * Searches the point cloud around the pixels of a tile and computes the
+ * output values from the points found. The kd-tree and the functors are only
+ * read, so the same search is used for tiles on every thread.
+ *
+ * @author 2026-10-16 ISIS Development Team
+ *
+ * @internal
+ *   @history 2026-10-16 ISIS Development Team - Original version
+ */
+struct DemSearch {
+  CNetPointCloudTree *cloudTree; //!< The kd-tree of the control points
+  DatumFunctoidList functors;    //!< Computes the value of each band
+  bool bothSearches;             //!< Radius search, then neighbor search if too few are found
+  bool radialSearch;             //!< Radius search only, when bothSearches is false
+  double searchRadiusSq;         //!< The square of the search radius in meters
+  int neighbors;                 //!< The number of neighbors to search for
+  int minpoints;                 //!< The fewest points a radius search can find for both searches
+  bool doRadiusFilter;           //!< Remove points with outlying radii
+  double sigma;                  //!< The standard deviations of the radius filter
+
+  typedef void result_type;
+
+
+  /**
+   * Computes the values of every mapped pixel of a tile. Exceptions are saved
+   * in the tile and reported by the main thread.
+   *
+   * @param tile The tile
+   */
+  void operator()(DemTile &tile) const {
+    try {
+      int nbands = functors.size();
+      int npixels = tile.latitudes.size();
+      SurfacePoint point;
+
+      for ( int index = 0 ; index < npixels ; index++ ) {
+        if ( IsSpecial(tile.latitudes[index]) ) continue;
+
+        point.SetSphericalCoordinates(Latitude(tile.latitudes[index], Angle::Degrees),
+                                      Longitude(tile.longitudes[index], Angle::Degrees),
+                                      Distance(tile.radii[index], Distance::Meters));
+
+        // Search the PC cloud
+        ControlPoint pt;
+        pt.SetAprioriSurfacePoint(point);
+        ControlPointCloudPt cpt(&pt, ControlPointCloudPt::Ground,
+                                ControlPointCloudPt::Shared,
+                                "MapPoint");
+
+        // There are several combinations to consider
+        //    1) RADIAL search from RANGE <meters> at the lat/lon pixel center
+        //    2) NEIGHBOR search selecting the NEIGHBORS closest to the center
+        //    3) BOTH searches requested will apply the RADIAL search first, then
+        //        and only if MINPOINTS points resulting from the RADIAL
+        //        search are within RANGE <meters>, otherwise a NEIGHBOR
+        //        search is performed.
+        ResultType results;
+        if ( bothSearches ) {
+          results = cloudTree->radius_query(cpt, searchRadiusSq);
+          if ( minpoints > results.size() ) {
+            results = cloudTree->neighbor_query(cpt, neighbors);
+          }
+        }
+        else if ( radialSearch ) {
+          results = cloudTree->radius_query(cpt, searchRadiusSq);
+        }
+        else {  // ( neighbor_search == search_type)
+          results = cloudTree->neighbor_query(cpt, neighbors);
+        }
+
+        // Extract points and prepare for processing
+        MapPointCollector mpoint;
+        if ( ResultType::Radius == results.type() ) mpoint.setSearchType(MapPointCollector::Radius);
+        else                                        mpoint.setSearchType(MapPointCollector::NearestNeighbor);
+
+        // Extract point set and optionally apply noise filter
+        results.forEachPair(mpoint);
+        if ( doRadiusFilter ) {  mpoint.removeNoise(sigma); }
+
+        // Compute values for each functor, each band follows the last in
+        // the output brick
+        for ( int i = 0 ; i < nbands ; i++) {
+          tile.datums[index + i * npixels] = functors[i]->value(mpoint);
+        }
+      }
+    }
+    catch (IException &e) {
+      tile.error = e;
+      tile.failed = true;
+    }
+    catch (std::exception &e) {
+      tile.error = IException(IException::Unknown, e.what(), _FILEINFO_);
+      tile.failed = true;
+    }
+  }
+};
+
+
 void IsisMain() {
 
   // We will be processing by line
@@ -269,112 +393,92 @@ void IsisMain() {
   int tsamps = core["TileSamples"];
   int tlines = core["TileLines"];
   Brick tile(*ocube, tsamps, tlines, functors.size() );
-  int bOffset = tsamps * tlines;  // Index offset to next band (spectrum) value
 
   Progress mapper;
   mapper.SetText("mapping");
   mapper.SetMaximumSteps(tile.Bricks());
   mapper.CheckStatus();
 
- //  Process data using 3-D brick
+  DemSearch search;
+  search.cloudTree = &cloud_t;
+  search.functors = functors;
+  search.bothSearches = both_searches;
+  search.radialSearch = radial_search;
+  search.searchRadiusSq = search_radius_sq;
+  search.neighbors = neighbors;
+  search.minpoints = minpoints;
+  search.doRadiusFilter = do_radius_filter;
+  search.sigma = sigma;
+
+  //  Process data using 3-D brick. The tiles are taken in batches: the ground
+  //  location of each pixel in the batch is found in order, the point cloud is
+  //  searched for all of the tiles on all of the threads, and then the tiles
+  //  are written in order.
   int npixels = tsamps * tlines;
   int nbands = tile.BandDimension();
-  SurfacePoint point;
-
-  for ( int brick = 1 ; brick <= tile.Bricks() ; brick++ ) {
-    tile.SetBrick(brick);
-
-    // Tile processing...
-    for ( int index = 0 ; index < npixels ; index++ ) {
-
-      int samp, line, band;
-      tile.Position(index, samp, line, band);
-
-      // Intialize output spectrum to NULLs
-      QVector<double> datum(nbands, Null);
-
-      //  Map only valid projection translation
-      if ( (samp <= csamps) && (line <= clines) &&
-           ( tproj->SetWorld(samp, line) ) ) {
-#if 0
-        std::cout << "Line: " << line << "  Sample: " << samp << "\n";
-        std::cout << "Lat:  " << tproj->UniversalLatitude()
-                  << " Long: " << tproj->UniversalLongitude() << "\n";
-#endif
-
-        // Trim if requested
-        bool mapit(true);
-        if ( ( trim ) && ( tproj->HasGroundRange() ) ) {
-          if ( tproj->Latitude()  < tproj->MinimumLatitude()  ) mapit = false;
-          if ( tproj->Latitude()  > tproj->MaximumLatitude()  ) mapit = false;
-          if ( tproj->Longitude() < tproj->MinimumLongitude() ) mapit = false;
-          if ( tproj->Longitude() > tproj->MaximumLongitude() ) mapit = false;
-        }
-
-        // Plot it only if its within mapping boundary conditions
-        if ( mapit ) {
-          double lat = tproj->UniversalLatitude();
-          double lon = tproj->UniversalLongitude();
-          double radius = tproj->LocalRadius(lat);
-
-          point.SetSphericalCoordinates(Latitude(lat, Angle::Degrees),
-                                        Longitude(lon, Angle::Degrees),
-                                        Distance(radius, Distance::Meters));
-
-          // Search the PC cloud
-          ControlPoint pt;
-          pt.SetAprioriSurfacePoint(point);
-          ControlPointCloudPt cpt(&pt, ControlPointCloudPt::Ground,
-                                  ControlPointCloudPt::Shared,
-                                  "MapPoint");
-
-          // There are several combinations to consider
-          //    1) RADIAL search from RANGE <meters> at the lat/lon pixel center
-          //    2) NEIGHBOR search selecting the NEIGHBORS closest to the center
-          //    3) BOTH searches requested will apply the RADIAL search first, then
-          //        and only if MINPOINTS points resulting from the RADIAL
-          //        search are within RANGE <meters>, otherwise a NEIGHBOR
-          //        search is performed.
-          ResultType results;
-          if ( both_searches ) {
-            results = cloud_t.radius_query(cpt, search_radius_sq);
-            if ( minpoints > results.size() ) {
-              results = cloud_t.neighbor_query(cpt, neighbors);
-            }
-          }
-          else if ( radial_search ) {
-            results = cloud_t.radius_query(cpt, search_radius_sq);
-          }
-          else {  // ( neighbor_search == search_type)
-            results = cloud_t.neighbor_query(cpt, neighbors);
+  int batchSize = 2 * QThreadPool::globalInstance()->maxThreadCount();
+
+  for ( int firstBrick = 1 ; firstBrick <= tile.Bricks() ; firstBrick += batchSize ) {
+    int lastBrick = qMin(firstBrick + batchSize - 1, tile.Bricks());
+    QVector<DemTile> tiles(lastBrick - firstBrick + 1);
+
+    for ( int t = 0 ; t < tiles.size() ; t++ ) {
+      DemTile &demTile = tiles[t];
+      demTile.brick = firstBrick + t;
+      demTile.failed = false;
+      demTile.latitudes.fill(Null, npixels);
+      demTile.longitudes.fill(Null, npixels);
+      demTile.radii.fill(Null, npixels);
+      // Intialize output spectra to NULLs
+      demTile.datums.fill(Null, npixels * nbands);
+
+      tile.SetBrick(demTile.brick);
+      for ( int index = 0 ; index < npixels ; index++ ) {
+
+        int samp, line, band;
+        tile.Position(index, samp, line, band);
+
+        //  Map only valid projection translation
+        if ( (samp <= csamps) && (line <= clines) &&
+             ( tproj->SetWorld(samp, line) ) ) {
+
+          // Trim if requested
+          bool mapit(true);
+          if ( ( trim ) && ( tproj->HasGroundRange() ) ) {
+            if ( tproj->Latitude()  < tproj->MinimumLatitude()  ) mapit = false;
+            if ( tproj->Latitude()  > tproj->MaximumLatitude()  ) mapit = false;
+            if ( tproj->Longitude() < tproj->MinimumLongitude() ) mapit = false;
+            if ( tproj->Longitude() > tproj->MaximumLongitude() ) mapit = false;
           }
 
-          // Extract points and prepare for processing
-          MapPointCollector mpoint;
-          if ( ResultType::Radius == results.type() ) mpoint.setSearchType(MapPointCollector::Radius);
-          else                                        mpoint.setSearchType(MapPointCollector::NearestNeighbor);
-
-          // Extract point set and optionally apply noise filter
-          results.forEachPair(mpoint);
-          if ( do_radius_filter ) {  mpoint.removeNoise(sigma); }
-
-          // Compute values for each functor
-          for ( int i = 0 ; i < functors.size() ; i++) {
-            datum[i] = functors[i]->value(mpoint);
+          // Plot it only if its within mapping boundary conditions
+          if ( mapit ) {
+            double lat = tproj->UniversalLatitude();
+            demTile.latitudes[index] = lat;
+            demTile.longitudes[index] = tproj->UniversalLongitude();
+            demTile.radii[index] = tproj->LocalRadius(lat);
           }
         }
       }
+    }
+
+    QtConcurrent::blockingMap(tiles, search);
 
-      // Copy data values to output data brick
-      int ndx = index;
-      for (int v = 0 ; v < datum.size() ; v++) {
-        tile[ndx] = datum[v];
-        ndx += bOffset;
+    // Copy data values to the output data brick and write the tiles in order
+    for ( int t = 0 ; t < tiles.size() ; t++ ) {
+      if ( tiles[t].failed ) {
+        QString mess = "Unable to compute the values of output brick ["
+                       + toString(tiles[t].brick) + "]";
+        throw IException(tiles[t].error, tiles[t].error.errorType(), mess, _FILEINFO_);
       }
-    }
 
-    ocube->write(tile);
-    mapper.CheckStatus();
+      tile.SetBrick(tiles[t].brick);
+      for ( int i = 0 ; i < tile.size() ; i++ ) {
+        tile[i] = tiles[t].datums[i];
+      }
+      ocube->write(tile);
+      mapper.CheckStatus();
+    }
   }
 
   PvlKeyword fname("Name");
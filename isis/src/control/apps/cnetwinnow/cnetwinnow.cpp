@@ -257,7 +257,7 @@ namespace Isis {
 
 
     //we will also need to know how many islands we started with
-    int numInitialIslands = net.GetSerialConnections().size();
+    int numInitialIslands = net.getIslandCount();
 
     //user parameters for allowing measure rejection
     double hullReductionLimit = ui.GetDouble("HULL_REDUCTION_PERCENT")/100.0;
@@ -357,7 +357,7 @@ namespace Isis {
       }
 
       //if the number of islands has increased the network has split
-      if (net.GetSerialConnections().size() > numInitialIslands) {
+      if (net.getIslandCount() > numInitialIslands) {
         islandFlag = false; //test failed
       }
       else {
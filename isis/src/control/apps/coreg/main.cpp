@@ -10,6 +10,12 @@ find files of those names at the top level of this repository. **/
 
 #include "Isis.h"
 
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThreadPool>
+#include <QtConcurrentMap>
+
 #include "AutoReg.h"
 #include "AutoRegFactory.h"
 #include "Chip.h"
@@ -137,48 +143,117 @@ void IsisMain() {
     cn.SetTarget(*trans.label());
   }
 
+  // Register the grid points in batches on all of the threads. Each thread
+  // gets an AutoReg of its own, made from the same definition, and the results
+  // are added to the network in grid order.
+  struct GridRegistration {
+    int row;               // The row of the grid point
+    int column;            // The column of the grid point
+    int samp;              // The sample of the grid point in both cubes
+    int line;              // The line of the grid point in both cubes
+    bool success;          // The registration succeeded
+    double cubeSample;     // The registered sample in the FROM cube
+    double cubeLine;       // The registered line in the FROM cube
+    double goodnessOfFit;  // The goodness of fit of the registration
+  };
+
+  QList<AutoReg *> registrars;
+  QList<AutoReg *> idleRegistrars;
+  QMutex registrarMutex;
+  QMutex errorMutex;
+  int errorIndex = -1;
+  IException error;
+
   // Loop through grid of points and get statistics to compute
   // translation values
   Statistics sStats, lStats;
-  for (int r = 0; r < rows; r++) {
-    for (int c = 0; c < cols; c++) {
-      int line = (int)(lSpacing / 2.0 + lSpacing * r + 0.5);
-      int samp = (int)(sSpacing / 2.0 + sSpacing * c + 0.5);
-      ar->PatternChip()->TackCube(samp, line);
-      ar->PatternChip()->Load(match);
-      ar->SearchChip()->TackCube(samp, line);
-      ar->SearchChip()->Load(trans);
+  int batchSize = 16 * QThreadPool::globalInstance()->maxThreadCount();
+  for (int first = 0; first < rows * cols; first += batchSize) {
+    QList<GridRegistration> batch;
+    for (int i = first; i < rows * cols && i < first + batchSize; i++) {
+      GridRegistration point;
+      point.row = i / cols;
+      point.column = i % cols;
+      point.line = (int)(lSpacing / 2.0 + lSpacing * point.row + 0.5);
+      point.samp = (int)(sSpacing / 2.0 + sSpacing * point.column + 0.5);
+      point.success = false;
+      batch.append(point);
+    }
+
+    QtConcurrent::blockingMap(batch,
+        [&](GridRegistration &point) {
+          AutoReg *registrar = NULL;
+          {
+            QMutexLocker locker(&registrarMutex);
+            if (idleRegistrars.isEmpty()) {
+              registrars.append(AutoRegFactory::Create(regdef));
+              idleRegistrars.append(registrars.last());
+            }
+            registrar = idleRegistrars.takeLast();
+          }
+
+          try {
+            registrar->PatternChip()->TackCube(point.samp, point.line);
+            registrar->PatternChip()->Load(match);
+            registrar->SearchChip()->TackCube(point.samp, point.line);
+            registrar->SearchChip()->Load(trans);
+
+            registrar->Register();
+            point.success = registrar->Success();
+            point.cubeSample = registrar->CubeSample();
+            point.cubeLine = registrar->CubeLine();
+            point.goodnessOfFit = registrar->GoodnessOfFit();
+          }
+          catch (IException &e) {
+            // Report the error of the first grid point that failed
+            QMutexLocker locker(&errorMutex);
+            int index = point.row * cols + point.column;
+            if (errorIndex < 0 || index < errorIndex) {
+              errorIndex = index;
+              error = e;
+            }
+          }
+
+          QMutexLocker locker(&registrarMutex);
+          idleRegistrars.append(registrar);
+        });
+
+    if (errorIndex >= 0) {
+      qDeleteAll(registrars);
+      throw error;
+    }
+
+    for (int i = 0; i < batch.size(); i++) {
+      const GridRegistration &point = batch[i];
 
       // Set up ControlMeasure for cube to translate
       ControlMeasure * cmTrans = new ControlMeasure;
       cmTrans->SetCubeSerialNumber(serialTrans);
-      cmTrans->SetCoordinate(samp, line, ControlMeasure::Candidate);
+      cmTrans->SetCoordinate(point.samp, point.line, ControlMeasure::Candidate);
       cmTrans->SetChooserName("coreg");
 
       // Set up ControlMeasure for the pattern/Match cube
       ControlMeasure * cmMatch = new ControlMeasure;
       cmMatch->SetCubeSerialNumber(serialMatch);
-      cmMatch->SetCoordinate(samp, line, ControlMeasure::RegisteredPixel);
+      cmMatch->SetCoordinate(point.samp, point.line, ControlMeasure::RegisteredPixel);
       cmMatch->SetChooserName("coreg");
 
-      ar->Register();
-
       // Match found
-      if (ar->Success()) {
-        double sDiff = samp - ar->CubeSample();
-        double lDiff = line - ar->CubeLine();
+      if (point.success) {
+        double sDiff = point.samp - point.cubeSample;
+        double lDiff = point.line - point.cubeLine;
         sStats.AddData(&sDiff, (unsigned int)1);
         lStats.AddData(&lDiff, (unsigned int)1);
-        cmTrans->SetCoordinate(ar->CubeSample(), ar->CubeLine(),
+        cmTrans->SetCoordinate(point.cubeSample, point.cubeLine,
                               ControlMeasure::RegisteredPixel);
         cmTrans->SetResidual(sDiff, lDiff);
         cmTrans->SetLogData(ControlMeasureLogData(
               ControlMeasureLogData::GoodnessOfFit,
-              ar->GoodnessOfFit()));
+              point.goodnessOfFit));
       }
 
       // Add the measures to a control point
-      QString str = "Row_" + toString(r) + "_Column_" + toString(c);
+      QString str = "Row_" + toString(point.row) + "_Column_" + toString(point.column);
       ControlPoint * cp = new ControlPoint(str);
       cp->SetType(ControlPoint::Free);
       cp->Add(cmTrans);
@@ -190,6 +265,12 @@ void IsisMain() {
     }
   }
 
+  // Gather the statistics of the AutoRegs that registered the points
+  for (int i = 0; i < registrars.size(); i++) {
+    ar->MergeStatistics(*registrars[i]);
+  }
+  qDeleteAll(registrars);
+
   // Write translation to log
   PvlGroup results("Translation");
   double sMin = (int)(sStats.Minimum() * 100.0) / 100.0;
@@ -8,6 +8,12 @@ find files of those names at the top level of this repository. **/
 
 #include <sys/resource.h>
 
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThreadPool>
+#include <QtConcurrentMap>
+
 #include "pointreg.h"
 
 #include "AutoReg.h"
@@ -33,6 +39,10 @@ namespace Isis {
 
   AutoReg *ar;
   AutoReg *validator;
+  Pvl *regDef;
+  QList<AutoReg *> *registrars;
+  QList<AutoReg *> *idleRegistrars;
+  QMutex registrarMutex;
   CubeManager *cubeMgr;
   SerialNumberList *files;
   QList<QString> *falsePositives;
@@ -184,8 +194,35 @@ namespace Isis {
   };
 
 
+  /**
+   * A measure to register to the reference measure of its point. The chips are
+   * loaded in the main thread, because loading them uses the cameras, and then
+   * the measure is registered on any thread with an AutoReg of its own.
+   *
+   * @author 2026-10-16 ISIS Development Team
+   *
+   * @internal
+   */
+  struct MeasureRegistration {
+    ControlMeasure *measure;    //!< The measure being registered
+    Chip patternChip;           //!< The pattern chip from the reference measure's cube
+    Chip searchChip;            //!< The search chip from the measure's cube
+    bool failed;                //!< Loading or registering the chips threw an exception
+    AutoReg::RegisterStatus status; //!< What Register returned
+    bool success;               //!< The registration succeeded
+    double cubeSample;          //!< The registered sample in the measure's cube
+    double cubeLine;            //!< The registered line in the measure's cube
+    double goodnessOfFit;       //!< The goodness of fit of the registration
+    double zScoreMin;           //!< The minimum pattern chip z-score
+    double zScoreMax;           //!< The maximum pattern chip z-score
+  };
+
+  void loadMeasures(ControlPoint *outPoint, ControlMeasure *patternCM,
+      QString registerMeasures, QList<MeasureRegistration> &registrations);
+  void registerMeasure(MeasureRegistration &registration);
   void registerPoint(ControlPoint *outPoint, ControlMeasure *patternCM,
-      QString registerMeasures, bool outputFailed);
+      const QList<MeasureRegistration> &registrations, int first, int last,
+      bool outputFailed);
   void validatePoint(ControlPoint *point, ControlMeasure *reference,
       double shiftTolerance);
   Validation backRegister(ControlMeasure *measure, ControlMeasure *reference,
@@ -208,6 +245,9 @@ namespace Isis {
     // Initialize variables
     ar = NULL;
     validator = NULL;
+    regDef = NULL;
+    registrars = NULL;
+    idleRegistrars = NULL;
     cubeMgr = NULL;
     falsePositives = NULL;
 
@@ -251,6 +291,12 @@ namespace Isis {
     Pvl pvl(ui.GetFileName("DEFFILE"));
     ar = AutoRegFactory::Create(pvl);
 
+    // Measures are registered on several threads, each with an AutoReg made
+    // from the same template when it is first needed
+    regDef = new Pvl(pvl);
+    registrars = new QList<AutoReg *>;
+    idleRegistrars = new QList<AutoReg *>;
+
     Progress progress;
     progress.SetText("Registering Points");
     progress.SetMaximumSteps(outNet.GetNumPoints());
@@ -293,50 +339,76 @@ namespace Isis {
       resTolerance = ui.GetDouble("RESTOLERANCE");
     }
 
-    // Register the points and create a new
-    // ControlNet containing the refined measurements
+    // Register the points and create a new ControlNet containing the refined
+    // measurements. Points are taken in batches: the chips for every measure
+    // in the batch are loaded in order, the measures are registered on all of
+    // the threads, and then the results are applied to the network in order.
+    int batchSize = 16 * QThreadPool::globalInstance()->maxThreadCount();
     int i = 0;
     while (i < outNet.GetNumPoints()) {
+      QList<ControlPoint *> batch;
+      QList<int> firstRegistration;
+      QList<MeasureRegistration> registrations;
 
-      progress.CheckStatus();
+      while (batch.size() < batchSize && i < outNet.GetNumPoints()) {
 
-      ControlPoint * outPoint = outNet.GetPoint(i);
+        progress.CheckStatus();
 
-      // Establish whether or not we want to attempt to register this point.
-      bool wantToRegister = true;
-      if (outPoint->IsIgnored()) {
-        if (registerPoints == "NONIGNORED") wantToRegister = false;
-      }
-      else {
-        if (registerPoints == "IGNORED") wantToRegister = false;
-      }
+        ControlPoint * outPoint = outNet.GetPoint(i);
 
-      // Check if this is a point we wish to disregard.
-      if (!wantToRegister) {
-        // Keep track of how many ignored points we didn't register.
+        // Establish whether or not we want to attempt to register this point.
+        bool wantToRegister = true;
         if (outPoint->IsIgnored()) {
-          ignored++;
+          if (registerPoints == "NONIGNORED") wantToRegister = false;
+        }
+        else {
+          if (registerPoints == "IGNORED") wantToRegister = false;
+        }
 
-          // If the point is ignored and the user doesn't want them, delete it
-          if (!outputIgnored) {
-            outNet.DeletePoint(i);
-            continue;
+        // Check if this is a point we wish to disregard.
+        if (!wantToRegister) {
+          // Keep track of how many ignored points we didn't register.
+          if (outPoint->IsIgnored()) {
+            ignored++;
+
+            // If the point is ignored and the user doesn't want them, delete it
+            if (!outputIgnored) {
+              outNet.DeletePoint(i);
+              continue;
+            }
           }
         }
-      }
-      else {  // "Ignore" or "valid" point to be registered
-        if (outPoint->IsIgnored()) {
-          outPoint->SetIgnored(false);
+        else {  // "Ignore" or "valid" point to be registered
+          if (outPoint->IsIgnored()) {
+            outPoint->SetIgnored(false);
+          }
+
+          ControlMeasure * patternCM = outPoint->GetRefMeasure();
+
+          // In case this is an implicit reference, make it explicit since we'll be
+          // registering measures to it
+          outPoint->SetRefMeasure(patternCM);
+
+          batch.append(outPoint);
+          firstRegistration.append(registrations.size());
+          if (validate != "ONLY") {
+            loadMeasures(outPoint, patternCM, registerMeasures, registrations);
+          }
         }
 
-        ControlMeasure * patternCM = outPoint->GetRefMeasure();
+        i++;
+      }
+      firstRegistration.append(registrations.size());
 
-        // In case this is an implicit reference, make it explicit since we'll be
-        // registering measures to it
-        outPoint->SetRefMeasure(patternCM);
+      QtConcurrent::blockingMap(registrations, registerMeasure);
+
+      for (int b = 0; b < batch.size(); b++) {
+        ControlPoint * outPoint = batch[b];
+        ControlMeasure * patternCM = outPoint->GetRefMeasure();
 
         if (validate != "ONLY") {
-          registerPoint(outPoint, patternCM, registerMeasures, outputFailed);
+          registerPoint(outPoint, patternCM, registrations, firstRegistration[b],
+              firstRegistration[b + 1], outputFailed);
         }
         if (validate != "SKIP") {
           validatePoint(outPoint, patternCM, ui.GetDouble("SHIFT"));
@@ -348,16 +420,20 @@ namespace Isis {
         // 2008-11-14 Jeannie Walldren
         if (outPoint->IsIgnored()) {
           ignored++;
-          if (!outputIgnored) {
-            outNet.DeletePoint(i);
-            continue;
+
+          // The point comes before the next one to look at, so deleting it
+          // moves that one back
+          if (!outputIgnored &&
+              outNet.DeletePoint(outPoint->GetId()) == ControlPoint::Success) {
+            i--;
           }
         }
       }
+    }
 
-      // The point wasn't deleted, so the network size is the same and we should
-      // increment our index.
-      i++;
+    // Gather the statistics of the AutoRegs that registered the measures
+    for (int r = 0; r < registrars->size(); r++) {
+      ar->MergeStatistics(*(*registrars)[r]);
     }
 
     // If flatfile was entered, create the flatfile
@@ -514,6 +590,16 @@ namespace Isis {
     delete ar;
     ar = NULL;
 
+    qDeleteAll(*registrars);
+    delete registrars;
+    registrars = NULL;
+
+    delete idleRegistrars;
+    idleRegistrars = NULL;
+
+    delete regDef;
+    regDef = NULL;
+
     delete validator;
     validator = NULL;
 
@@ -528,8 +614,16 @@ namespace Isis {
   }
 
 
-  void registerPoint(ControlPoint *outPoint, ControlMeasure *patternCM,
-      QString registerMeasures, bool outputFailed) {
+  /**
+   * Load the chips for the measures of a point that need to be registered.
+   *
+   * @param outPoint The point
+   * @param patternCM The reference measure the others are registered to
+   * @param registerMeasures Which measures to register, CANDIDATES or ALL
+   * @param registrations The measures to register are appended to these
+   */
+  void loadMeasures(ControlPoint *outPoint, ControlMeasure *patternCM,
+      QString registerMeasures, QList<MeasureRegistration> &registrations) {
 
     Cube &patternCube = *cubeMgr->OpenCube(
         files->fileName(patternCM->GetCubeSerialNumber()));
@@ -545,9 +639,8 @@ namespace Isis {
       outPoint->SetRefMeasure(patternCM);
     }
 
-    // Register all the unlocked measurements
-    int j = 0;
-    while (j < outPoint->GetNumMeasures()) {
+    // Load all the unlocked measurements
+    for (int j = 0; j < outPoint->GetNumMeasures(); j++) {
       if (j != outPoint->IndexOfRefMeasure()) {
 
         ControlMeasure * measure = outPoint->GetMeasure(j);
@@ -568,107 +661,178 @@ namespace Isis {
           verifyCube(patternCube);
           verifyCube(searchCube);
 
+          MeasureRegistration registration;
+          registration.measure = measure;
+          registration.failed = false;
+
           try {
             ar->SearchChip()->Load(searchCube, *(ar->PatternChip()), patternCube);
+            registration.patternChip = *(ar->PatternChip());
+            registration.searchChip = *(ar->SearchChip());
+          }
+          catch (IException &e) {
+            registration.failed = true;
+          }
+          searchCube.clearIoCache();
+          patternCube.clearIoCache();
 
-            // If the measurements were correctly registered
-            // Write them to the new ControlNet
-            AutoReg::RegisterStatus res = ar->Register();
-            searchCube.clearIoCache();
-            patternCube.clearIoCache();
-
-            double score1, score2;
-            ar->ZScores(score1, score2);
-
-            // Set the minimum and maximum z-score values for the measure
-            measure->SetLogData(ControlMeasureLogData(
-                  ControlMeasureLogData::MinimumPixelZScore, score1));
-            measure->SetLogData(ControlMeasureLogData(
-                  ControlMeasureLogData::MaximumPixelZScore, score2));
-
-            if (ar->Success()) {
-              // Check to make sure the newly calculated measure position is on
-              // the surface of the planet
-              Camera *cam = searchCube.camera();
-              bool foundLatLon = cam->SetImage(ar->CubeSample(), ar->CubeLine());
-
-              if (foundLatLon) {
-                registered++;
-
-                if (res == AutoReg::SuccessSubPixel) {
-                  measure->SetType(ControlMeasure::RegisteredSubPixel);
-                }
-                else {
-                  measure->SetType(ControlMeasure::RegisteredPixel);
-                }
+          registrations.append(registration);
+        }
+      }
+    }
+  }
 
-                measure->SetLogData(ControlMeasureLogData(
-                      ControlMeasureLogData::GoodnessOfFit,
-                      ar->GoodnessOfFit()));
-
-                measure->SetAprioriSample(measure->GetSample());
-                measure->SetAprioriLine(measure->GetLine());
-                measure->SetCoordinate(ar->CubeSample(), ar->CubeLine());
-                measure->SetIgnored(false);
-
-                // We successfully registered the current measure to the
-                // reference, and since we set the current measure to be
-                // unignored, it follows that its reference should also be made
-                // unignored.
-                patternCM->SetIgnored(false);
+
+  /**
+   * Register a measure with an AutoReg that no other thread is using.
+   *
+   * @param registration The measure and its chips. The results are saved in it.
+   */
+  void registerMeasure(MeasureRegistration &registration) {
+    if (registration.failed) return;
+
+    AutoReg *registrar = NULL;
+    {
+      QMutexLocker locker(&registrarMutex);
+      if (idleRegistrars->isEmpty()) {
+        registrars->append(AutoRegFactory::Create(*regDef));
+        idleRegistrars->append(registrars->last());
+      }
+      registrar = idleRegistrars->takeLast();
+    }
+
+    try {
+      *(registrar->PatternChip()) = registration.patternChip;
+      *(registrar->SearchChip()) = registration.searchChip;
+
+      registration.status = registrar->Register();
+      registration.success = registrar->Success();
+      registration.cubeSample = registrar->CubeSample();
+      registration.cubeLine = registrar->CubeLine();
+      registration.goodnessOfFit = registrar->GoodnessOfFit();
+      registrar->ZScores(registration.zScoreMin, registration.zScoreMax);
+    }
+    catch (IException &e) {
+      registration.failed = true;
+    }
+
+    // The chips are not needed anymore
+    registration.patternChip = Chip();
+    registration.searchChip = Chip();
+
+    QMutexLocker locker(&registrarMutex);
+    idleRegistrars->append(registrar);
+  }
+
+
+  /**
+   * Save the results of registering the measures of a point in the network.
+   *
+   * @param outPoint The point
+   * @param patternCM The reference measure the others were registered to
+   * @param registrations The registered measures
+   * @param first The index of the point's first registration
+   * @param last One past the index of the point's last registration
+   * @param outputFailed Keep measures that failed to register as ignored
+   *                     candidates instead of deleting them
+   */
+  void registerPoint(ControlPoint *outPoint, ControlMeasure *patternCM,
+      const QList<MeasureRegistration> &registrations, int first, int last,
+      bool outputFailed) {
+
+    for (int r = first; r < last; r++) {
+      const MeasureRegistration &registration = registrations[r];
+      ControlMeasure * measure = registration.measure;
+
+      bool failed = registration.failed;
+      if (!failed) {
+        try {
+          // Set the minimum and maximum z-score values for the measure
+          measure->SetLogData(ControlMeasureLogData(
+                ControlMeasureLogData::MinimumPixelZScore, registration.zScoreMin));
+          measure->SetLogData(ControlMeasureLogData(
+                ControlMeasureLogData::MaximumPixelZScore, registration.zScoreMax));
+
+          if (registration.success) {
+            // Check to make sure the newly calculated measure position is on
+            // the surface of the planet
+            Cube &searchCube = *cubeMgr->OpenCube(files->fileName(
+                  measure->GetCubeSerialNumber()));
+            Camera *cam = searchCube.camera();
+            bool foundLatLon = cam->SetImage(registration.cubeSample, registration.cubeLine);
+
+            if (foundLatLon) {
+              registered++;
+
+              if (registration.status == AutoReg::SuccessSubPixel) {
+                measure->SetType(ControlMeasure::RegisteredSubPixel);
               }
               else {
-                notintersected++;
-
-                if (outputFailed) {
-                  measure->SetType(ControlMeasure::Candidate);
-                  measure->SetIgnored(true);
-                }
-                else {
-                  outPoint->Delete(j);
-                  continue;
-                }
+                measure->SetType(ControlMeasure::RegisteredPixel);
               }
+
+              measure->SetLogData(ControlMeasureLogData(
+                    ControlMeasureLogData::GoodnessOfFit,
+                    registration.goodnessOfFit));
+
+              measure->SetAprioriSample(measure->GetSample());
+              measure->SetAprioriLine(measure->GetLine());
+              measure->SetCoordinate(registration.cubeSample, registration.cubeLine);
+              measure->SetIgnored(false);
+
+              // We successfully registered the current measure to the
+              // reference, and since we set the current measure to be
+              // unignored, it follows that its reference should also be made
+              // unignored.
+              patternCM->SetIgnored(false);
             }
-            // Else use the original marked as "Candidate"
             else {
-              unregistered++;
+              notintersected++;
 
               if (outputFailed) {
                 measure->SetType(ControlMeasure::Candidate);
-
-                if (res == AutoReg::FitChipToleranceNotMet) {
-                  measure->SetLogData(ControlMeasureLogData(
-                        ControlMeasureLogData::GoodnessOfFit,
-                        ar->GoodnessOfFit()));
-                }
                 measure->SetIgnored(true);
               }
               else {
-                outPoint->Delete(j);
-                continue;
+                outPoint->Delete(measure);
               }
             }
           }
-          catch (IException &e) {
+          // Else use the original marked as "Candidate"
+          else {
             unregistered++;
 
             if (outputFailed) {
               measure->SetType(ControlMeasure::Candidate);
+
+              if (registration.status == AutoReg::FitChipToleranceNotMet) {
+                measure->SetLogData(ControlMeasureLogData(
+                      ControlMeasureLogData::GoodnessOfFit,
+                      registration.goodnessOfFit));
+              }
               measure->SetIgnored(true);
             }
             else {
-              outPoint->Delete(j);
-              continue;
+              outPoint->Delete(measure);
             }
           }
         }
+        catch (IException &e) {
+          failed = true;
+        }
       }
 
-      // If we made it here (without continuing on to the next measure),
-      // then the measure wasn't deleted and we should therefore increment
-      // the index of the measure we're looking at.
-      j++;
+      if (failed) {
+        unregistered++;
+
+        if (outputFailed) {
+          measure->SetType(ControlMeasure::Candidate);
+          measure->SetIgnored(true);
+        }
+        else {
+          outPoint->Delete(measure);
+        }
+      }
     }
 
     // Jeff Anderson put in this test (Dec 2, 2008) to allow for control
@@ -9,15 +9,21 @@ find files of those names at the top level of this repository. **/
 #include "BundleAdjust.h"
 
 // std lib
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
+#include <numeric>
 #include <sstream>
 
 // qt lib
 #include <QCoreApplication>
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QMutex>
+#include <QMutexLocker>
+#include <QThreadPool>
+#include <QtConcurrentMap>
 
 // boost lib
 #include <boost/lexical_cast.hpp>
@@ -62,6 +68,9 @@ using namespace boost::numeric::ublas;
 
 namespace Isis {
 
+  //! Bytes of the inverse of the normal equations held in memory at once by errorPropagation()
+  static const double ErrorPropagationMemoryLimit = 1024.0 * 1024.0 * 1024.0;
+
 
   /**
    * Custom error handler for CHOLMOD.
@@ -1187,7 +1196,7 @@ namespace Isis {
    * @return @b bool
    *
    * @see BundleAdjust::formMeasureNormals
-   * @see BundleAdjust::formPointNormals
+   * @see BundleAdjust::formBatchNormals
    * @see BundleAdjust::formWeightedNormals
    */
   bool BundleAdjust::formNormalEquations() {
@@ -1234,53 +1243,86 @@ namespace Isis {
 
     outputBundleStatus("\n\n");
 
-    for (int i = 0; i < num3DPoints; i++) {
-      emit(pointUpdate(i+1));
-      BundleControlPointQsp point = m_bundleControlPoints.at(i);
+    // The image point contributions to n1 are accumulated densely so that
+    // different threads can fill different parts of it
+    LinearAlgebra::Vector n1Points(m_rank);
+    n1Points.clear();
 
-      if (point->isRejected()) {
-        numRejected3DPoints++;
-        continue;
-      }
+    // Partials go through the cameras, which can't be shared between threads,
+    // so they are computed serially for a batch of points. The rest of the
+    // batch's normal equations are then formed in parallel.
+    int batchSize = 256 * QThreadPool::globalInstance()->maxThreadCount();
+    std::vector<PointNormals> batch;
 
-      if ( i != 0 ) {
-        N22.clear();
-        N12.wipe();
-        n2.clear();
-      }
+    for (int batchStart = 0; batchStart < num3DPoints; batchStart += batchSize) {
+      int batchEnd = std::min(batchStart + batchSize, num3DPoints);
+      batch.clear();
+      batch.reserve(batchEnd - batchStart);
 
-      // loop over measures for this point
-      int numMeasures = point->size();
-      for (int j = 0; j < numMeasures; j++) {
-        BundleMeasureQsp measure = point->at(j);
+      for (int i = batchStart; i < batchEnd; i++) {
+        emit(pointUpdate(i+1));
+        BundleControlPointQsp point = m_bundleControlPoints.at(i);
 
-        // flagged as "JigsawFail" implies this measure has been rejected
-        // TODO  IsRejected is obsolete -- replace code or add to ControlMeasure
-        if (measure->isRejected()) {
+        if (point->isRejected()) {
+          numRejected3DPoints++;
           continue;
         }
 
-        status = computePartials(coeffTarget, coeffImage, coeffPoint3D, coeffRHS, *measure,
-                                     *point);
+        batch.push_back(PointNormals());
+        PointNormals &pointNormals = batch.back();
+        pointNormals.point = point;
 
-        if (!status) {
-          // TODO should status be set back to true? JAM
-          // TODO this measure should be flagged as rejected.
-          continue;
-        }
+        // loop over measures for this point
+        int numMeasures = point->size();
+        for (int j = 0; j < numMeasures; j++) {
+          BundleMeasureQsp measure = point->at(j);
 
-        // increment number of observations
-        numObservations += 2;
+          // flagged as "JigsawFail" implies this measure has been rejected
+          // TODO  IsRejected is obsolete -- replace code or add to ControlMeasure
+          if (measure->isRejected()) {
+            continue;
+          }
 
-        formMeasureNormals(N22, N12, n1, n2, coeffTarget, coeffImage, coeffPoint3D, coeffRHS,
-                             measure->observationIndex());
+          status = computePartials(coeffTarget, coeffImage, coeffPoint3D, coeffRHS, *measure,
+                                       *point);
 
-      } // end loop over this points measures
+          if (!status) {
+            // TODO should status be set back to true? JAM
+            // TODO this measure should be flagged as rejected.
+            continue;
+          }
 
-      numConstrainedCoordinates += formPointNormals(N22, N12, n2, m_RHS, point);
+          // increment number of observations
+          numObservations += 2;
+
+          MeasurePartials partials;
+          partials.coeffTarget = coeffTarget;
+          partials.coeffImage = coeffImage;
+          partials.coeffPoint3D = coeffPoint3D;
+          partials.coeffRHS = coeffRHS;
+          partials.blockIndex = measure->observationIndex();
+          if (m_bundleSettings->solveTargetBody()) {
+            partials.blockIndex++;
+          }
+          pointNormals.measures.push_back(partials);
+
+        } // end loop over this points measures
 
-      numGood3DPoints++;
-  } // end loop over 3D points
+        numGood3DPoints++;
+      }
+
+      formBatchNormals(batch, n1Points);
+
+      for (unsigned int i = 0; i < batch.size(); i++) {
+        numConstrainedCoordinates += batch[i].numConstrainedCoordinates;
+      }
+    } // end loop over 3D points
+
+    for (int i = 0; i < m_rank; i++) {
+      if (n1Points(i) != 0.0) {
+        n1(i) = n1Points(i);
+      }
+    }
 
     m_bundleResults.setNumberConstrainedPointParameters(numConstrainedCoordinates);
     m_bundleResults.setNumberImageObservations(numObservations);
@@ -1443,27 +1485,186 @@ namespace Isis {
 
 
   /**
-   * Compute the Q matrix and NIC vector for a control point.  The inputs N22, N12, and n2
-   * come from calling formMeasureNormals() with the control point's measures.
-   * The Q matrix and NIC vector are stored in the BundleControlPoint.
-   * R = N12 x Q is accumulated into m_sparseNormals.
+   * Form the normal equations for a batch of control points whose partials have already been
+   * computed. Each point's own matrices are formed in parallel, then the points are accumulated
+   * into m_sparseNormals, n1 and m_RHS in parallel by block column. Every block column is
+   * accumulated by one thread in point order, so the result is exactly the same as forming the
+   * points one after another.
    *
-   * @param N22 The normal equation matrix for the point on the body.
-   * @param N12 The normal equation matrix for the camera and the target body.
-   * @param n2 The right hand side vector for the point on the body.
-   * @param nj The output right hand side vector.
-   * @param bundleControlPoint The control point that the Q matrixs are NIC vector
-   *                           are being formed for.
+   * @param batch The points to accumulate, in the order of m_bundleControlPoints.
+   * @param n1 The right hand side vector for the camera and the target body.
+   *
+   * @see BundleAdjust::formNormalEquations
+   */
+  void BundleAdjust::formBatchNormals(std::vector<PointNormals> &batch,
+                                      LinearAlgebra::Vector &n1) {
+    QMutex errorMutex;
+    bool failed = false;
+    IException error;
+
+    QtConcurrent::blockingMap(batch,
+        [&](PointNormals &pointNormals) {
+          try {
+            pointNormals.numConstrainedCoordinates = formPointNormals(pointNormals);
+          }
+          catch (IException &e) {
+            QMutexLocker locker(&errorMutex);
+            if (!failed) {
+              failed = true;
+              error = e;
+            }
+          }
+        });
+
+    if (failed) {
+      throw error;
+    }
+
+    // find the points contributing to each block column, in point order
+    QVector< QVector<int> > columnPoints(m_sparseNormals.size());
+    for (unsigned int i = 0; i < batch.size(); i++) {
+      const SparseBlockRowMatrix &Q = batch[i].point->cholmodQMatrix();
+      for (SparseBlockRowMatrix::const_iterator Qit = Q.constBegin(); Qit != Q.constEnd(); ++Qit) {
+        columnPoints[Qit.key()].append(i);
+      }
+    }
+
+    std::vector<int> columns;
+    for (int i = 0; i < columnPoints.size(); i++) {
+      if (!columnPoints[i].isEmpty()) {
+        columns.push_back(i);
+      }
+    }
+
+    QtConcurrent::blockingMap(columns,
+        [&](int &columnIndex) {
+          accumulateBlockColumn(batch, columnPoints[columnIndex], columnIndex, n1);
+        });
+  }
+
+
+  /**
+   * Accumulate the contributions of a batch of points to one block column of the reduced normal
+   * equations. This is what formMeasureNormals(), productAB() and accumProductAlphaAB() do for
+   * the column, and it only modifies the column and its parts of n1 and m_RHS.
+   *
+   * @param batch The points, with their normals formed by formPointNormals().
+   * @param points The indices in batch of the points that touch the column, in order.
+   * @param columnIndex The block column to accumulate.
+   * @param n1 The right hand side vector for the camera and the target body.
+   *
+   * @see BundleAdjust::formBatchNormals
+   */
+  void BundleAdjust::accumulateBlockColumn(const std::vector<PointNormals> &batch,
+                                           const QVector<int> &points,
+                                           int columnIndex,
+                                           LinearAlgebra::Vector &n1) {
+    SparseBlockColumnMatrix *column = m_sparseNormals.at(columnIndex);
+    int startColumn = column->startColumn();
+    bool solveTargetBody = m_bundleSettings->solveTargetBody();
+
+    for (int i = 0; i < points.size(); i++) {
+      const PointNormals &pointNormals = batch[points[i]];
+
+      // contributions of the point's measures
+      for (unsigned int j = 0; j < pointNormals.measures.size(); j++) {
+        const MeasurePartials &partials = pointNormals.measures[j];
+        int numImagePartials = partials.coeffImage.size2();
+
+        if (solveTargetBody) {
+          int numTargetPartials = partials.coeffTarget.size2();
+
+          if (columnIndex == 0) {
+            column->insertMatrixBlock(0, numTargetPartials, numTargetPartials);
+            (*(*column)[0]) += prod(trans(partials.coeffTarget), partials.coeffTarget);
+
+            vector_range<LinearAlgebra::Vector> n1_range(n1, range(0, numTargetPartials));
+            n1_range += prod(trans(partials.coeffTarget), partials.coeffRHS);
+          }
+
+          if (columnIndex == partials.blockIndex) {
+            column->insertMatrixBlock(0, numTargetPartials, numImagePartials);
+            (*(*column)[0]) += prod(trans(partials.coeffTarget), partials.coeffImage);
+          }
+        }
+
+        if (columnIndex == partials.blockIndex) {
+          column->insertMatrixBlock(columnIndex, numImagePartials, numImagePartials);
+          (*(*column)[columnIndex]) += prod(trans(partials.coeffImage), partials.coeffImage);
+
+          vector_range<LinearAlgebra::Vector> vr(
+                n1,
+                range(startColumn, startColumn + numImagePartials));
+          vr += prod(trans(partials.coeffImage), partials.coeffRHS);
+        }
+      }
+
+      const SparseBlockRowMatrix &Q = pointNormals.point->cholmodQMatrix();
+      const LinearAlgebra::Matrix *Qblock = Q.value(columnIndex);
+
+      // accumulate -R directly into reduced normal equations
+      SparseBlockColumnMatrix::const_iterator N12it;
+      for (N12it = pointNormals.N12.constBegin(); N12it != pointNormals.N12.constEnd(); ++N12it) {
+        int rowIndex = N12it.key();
+        if (rowIndex > columnIndex) {
+          break;
+        }
+
+        const LinearAlgebra::Matrix *N12block = N12it.value();
+        column->insertMatrixBlock(rowIndex, N12block->size1(), Qblock->size2());
+        (*(*column)[rowIndex]) -= prod(*N12block, *Qblock);
+      }
+
+      // accumulate -nj
+      LinearAlgebra::Vector blockProduct = prod(trans(*Qblock), pointNormals.n2);
+      for (unsigned j = 0; j < blockProduct.size(); j++) {
+        m_RHS(startColumn + j) += -1.0 * blockProduct(j);
+      }
+    }
+  }
+
+
+  /**
+   * Compute the Q matrix and NIC vector for a control point from the partials of its measures.
+   * N22, N12, and n2 are formed the same way formMeasureNormals() forms them and are left in
+   * pointNormals for accumulateBlockColumn(). The Q matrix and NIC vector are stored in the
+   * BundleControlPoint.
+   *
+   * This only modifies pointNormals and its control point, so it is safe to call for different
+   * points at the same time.
+   *
+   * @param pointNormals The point and the partials of its measures.
    *
    * @return @b int Number of constrained coordinates.
    *
-   * @see BundleAdjust::formNormalEquations
+   * @see BundleAdjust::formBatchNormals
    */
-  int BundleAdjust::formPointNormals(symmetric_matrix<double, upper>&N22,
-                                      SparseBlockColumnMatrix &N12,
-                                      vector<double> &n2,
-                                      vector<double> &nj,
-                                      BundleControlPointQsp &bundleControlPoint) {
+  int BundleAdjust::formPointNormals(PointNormals &pointNormals) {
+    LinearAlgebra::MatrixUpperTriangular &N22 = pointNormals.N22;
+    SparseBlockColumnMatrix &N12 = pointNormals.N12;
+    LinearAlgebra::Vector &n2 = pointNormals.n2;
+    BundleControlPointQsp &bundleControlPoint = pointNormals.point;
+
+    N22.resize(3, false);
+    N22.clear();
+    N12.wipe();
+    n2.resize(3, false);
+    n2.clear();
+
+    for (unsigned int i = 0; i < pointNormals.measures.size(); i++) {
+      const MeasurePartials &partials = pointNormals.measures[i];
+
+      if (m_bundleSettings->solveTargetBody()) {
+        N12.insertMatrixBlock(0, partials.coeffTarget.size2(), 3);
+        *N12[0] += prod(trans(partials.coeffTarget), partials.coeffPoint3D);
+      }
+
+      N12.insertMatrixBlock(partials.blockIndex, partials.coeffImage.size2(), 3);
+      *N12[partials.blockIndex] += prod(trans(partials.coeffImage), partials.coeffPoint3D);
+
+      N22 += prod(trans(partials.coeffPoint3D), partials.coeffPoint3D);
+      n2 += prod(trans(partials.coeffPoint3D), partials.coeffRHS);
+    }
 
     boost::numeric::ublas::bounded_vector<double, 3> &NIC = bundleControlPoint->nicVector();
     SparseBlockRowMatrix &Q = bundleControlPoint->cholmodQMatrix();
@@ -1512,12 +1713,6 @@ namespace Isis {
     // form product of N22(inverse) and n2; store in NIC
     NIC = prod(N22, n2);
 
-    // accumulate -R directly into reduced normal equations
-    productAB(N12, Q);
-
-    // accumulate -nj
-    accumProductAlphaAB(-1.0, Q, n2, nj);
-
     return numConstrainedCoordinates;
   }
 
@@ -2209,10 +2404,22 @@ namespace Isis {
     Statistics yResiduals;
     Statistics xyResiduals;
 
-    // vtpv for photo measures
-    for (int i = 0; i < m_bundleControlPoints.size(); i++) {
-      vtpv += m_bundleControlPoints.at(i)->vtpvMeasures();
-      vtpv += m_bundleControlPoints.at(i)->vtpv();
+    // vtpv for photo measures, evaluated in parallel and summed in point order
+    int numPoints = m_bundleControlPoints.size();
+    std::vector<int> pointIndices(numPoints);
+    std::iota(pointIndices.begin(), pointIndices.end(), 0);
+    std::vector<double> measuresVtpv(numPoints);
+    std::vector<double> pointsVtpv(numPoints);
+
+    QtConcurrent::blockingMap(pointIndices,
+        [&](int &i) {
+          measuresVtpv[i] = m_bundleControlPoints.at(i)->vtpvMeasures();
+          pointsVtpv[i] = m_bundleControlPoints.at(i)->vtpv();
+        });
+
+    for (int i = 0; i < numPoints; i++) {
+      vtpv += measuresVtpv[i];
+      vtpv += pointsVtpv[i];
     }
 
     // vtpv for lidar measures
@@ -2532,6 +2739,13 @@ namespace Isis {
    *                            errorPropagation to compute the sigmas via the variance/
    *                            covariance matrices instead of the sigmas.  This should produce
    *                            more accurate results.  References #4649 and #501.
+   *   @history 2026-10-16 ISIS Development Team - Block columns of the inverse are solved for
+   *                           in parallel, a whole block at a time, and point covariances are
+   *                           summed in parallel. Points after a rejected point now get their
+   *                           covariance too.
+   *   @history 2026-10-17 ISIS Development Team - Unless the inverse matrix is written out, the
+   *                           blocks of the inverse come from a selected inverse of the factor
+   *                           instead of column solves.
    */
   bool BundleAdjust::errorPropagation() {
     emit(statusBarUpdate("Error Propagation"));
@@ -2539,10 +2753,6 @@ namespace Isis {
     cholmod_l_free_triplet(&m_cholmodTriplet, &m_cholmodCommon);
     cholmod_l_free_sparse(&m_cholmodNormal, &m_cholmodCommon);
 
-    LinearAlgebra::Matrix T(3, 3);
-    // *** TODO ***
-    // Can any of the control point specific code be moved to BundleControlPoint?
-
     double sigma0Squared = m_bundleResults.sigma0() * m_bundleResults.sigma0();
 
     int numObjectPoints = m_bundleControlPoints.size();
@@ -2561,15 +2771,13 @@ namespace Isis {
       pointCovariances[d].clear();
     }
 
-    cholmod_dense *x;        // solution vector
-    cholmod_dense *b;        // right-hand side (column vectors of identity)
-
-    b = cholmod_l_zeros ( m_rank, 1, CHOLMOD_REAL, &m_cholmodCommon );
-    double *pb = (double*)b->x;
-
-    double *px = NULL;
-
-    SparseBlockColumnMatrix inverseMatrix;
+    // only points that were not rejected get a covariance
+    std::vector<int> pointIndices;
+    for (int j = 0; j < numObjectPoints; j++) {
+      if ( !m_bundleControlPoints.at(j)->isRejected() ) {
+        pointIndices.push_back(j);
+      }
+    }
 
     // Create unique file name
     FileName matrixFile(m_bundleSettings->outputFilePrefix() + "inverseMatrix.dat");
@@ -2585,291 +2793,504 @@ namespace Isis {
     }
     QDataStream outStream(&matrixOutput);
 
-    int i, j, k;
-    int columnIndex = 0;
-    int numColumns = 0;
+    // Block columns of the inverse are solved for in groups, one per thread. Each one is up
+    // to m_rank rows tall, so the size of a group is limited by the memory they need.
     int numBlockColumns = m_sparseNormals.size();
-    for (i = 0; i < numBlockColumns; i++) {
+    int maxColumns = 1;
+    for (int i = 0; i < numBlockColumns; i++) {
+      maxColumns = std::max(maxColumns, m_sparseNormals.at(i)->numberOfColumns());
+    }
+    double blockColumnBytes = 3.0 * sizeof(double) * m_rank * maxColumns;
+    int groupSize = std::max(1, std::min(QThreadPool::globalInstance()->maxThreadCount(),
+                                         int(ErrorPropagationMemoryLimit / blockColumnBytes)));
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // Image sigmas and point covariances only need the blocks of the inverse where the normals
+    // have blocks, and those are in the pattern of the factor. Writing out the inverse needs
+    // whole columns, which have to be solved for.
+    SelectedInverse selectedInverse;
+    bool useSelectedInverse = !m_bundleSettings->createInverseMatrix() &&
+                              computeSelectedInverse(selectedInverse);
+
+    for (int groupStart = 0; groupStart < numBlockColumns; groupStart += groupSize) {
+      int groupEnd = std::min(numBlockColumns, groupStart + groupSize);
+
+      std::vector<int> columns(groupEnd - groupStart);
+      std::iota(columns.begin(), columns.end(), groupStart);
+      std::vector<SparseBlockColumnMatrix> inverseColumns(columns.size());
+
+      QMutex errorMutex;
+      bool failed = false;
+      IException error;
+
+      QtConcurrent::blockingMap(columns,
+          [&](int &i) {
+            try {
+              if ( !useSelectedInverse ||
+                   !selectedInverseBlockColumn(selectedInverse, i,
+                                               inverseColumns[i - groupStart]) ) {
+                solveInverseBlockColumn(i, inverseColumns[i - groupStart]);
+              }
+            }
+            catch (IException &e) {
+              QMutexLocker locker(&errorMutex);
+              if (!failed) {
+                failed = true;
+                error = e;
+              }
+            }
+          });
 
-      // columns in this column block
-      SparseBlockColumnMatrix *normalsColumn = m_sparseNormals.at(i);
-      if (i == 0) {
-        numColumns = normalsColumn->numberOfColumns();
-        int numRows = normalsColumn->numberOfRows();
-        inverseMatrix.insertMatrixBlock(i, numRows, numColumns);
-        inverseMatrix.zeroBlocks();
+      if (failed) {
+        outputBundleStatus("\n\n");
+        throw error;
       }
-      else {
-        if (normalsColumn->numberOfColumns() == numColumns) {
-          int numRows = normalsColumn->numberOfRows();
-          inverseMatrix.insertMatrixBlock(i, numRows, numColumns);
-          inverseMatrix.zeroBlocks();
-        }
-        else {
-          numColumns = normalsColumn->numberOfColumns();
 
-          // reset inverseMatrix
-          inverseMatrix.wipe();
+      for (int i = groupStart; i < groupEnd; i++) {
+        SparseBlockColumnMatrix &inverseMatrix = inverseColumns[i - groupStart];
+        int numColumns = m_sparseNormals.at(i)->numberOfColumns();
 
-          // insert blocks
-          for (j = 0; j < (i+1); j++) {
-            SparseBlockColumnMatrix *normalsRow = m_sparseNormals.at(j);
-            int numRows = normalsRow->numberOfRows();
+        // save adjusted target body sigmas if solving for target
+        if (m_bundleSettings->solveTargetBody() && i == 0) {
+          vector< double > &adjustedSigmas = m_bundleTargetBody->adjustedSigmas();
+          matrix< double > *targetCovMatrix = inverseMatrix.value(i);
 
-            inverseMatrix.insertMatrixBlock(j, numRows, numColumns);
+          for (int z = 0; z < numColumns; z++)
+            adjustedSigmas[z] = sqrt((*targetCovMatrix)(z,z))*m_bundleResults.sigma0();
+        }
+        // save adjusted image sigmas
+        else {
+          BundleObservationQsp observation;
+          if (m_bundleSettings->solveTargetBody()) {
+            observation = m_bundleObservations.at(i-1);
           }
+          else {
+            observation = m_bundleObservations.at(i);
+          }
+          vector< double > &adjustedSigmas = observation->adjustedSigmas();
+          matrix< double > *imageCovMatrix = inverseMatrix.value(i);
+          for ( int z = 0; z < numColumns; z++) {
+            adjustedSigmas[z] = sqrt((*imageCovMatrix)(z,z))*m_bundleResults.sigma0();
+          }
+        }
+
+        // Output the inverse matrix if requested
+        if (m_bundleSettings->createInverseMatrix()) {
+          outStream << inverseMatrix;
         }
       }
 
-      int localCol = 0;
+      // sum the contributions of this group into the 3x3 point covariance matrices. Each point
+      // is summed by one thread, in block column order.
+      QtConcurrent::blockingMap(pointIndices,
+          [&](int &j) {
+            for (int i = groupStart; i < groupEnd; i++) {
+              if ( !accumulatePointCovariance(m_bundleControlPoints.at(j)->cholmodQMatrix(),
+                                              i, inverseColumns[i - groupStart],
+                                              pointCovariances[j]) ) {
+                QMutexLocker locker(&errorMutex);
+                failed = true;
+                return;
+              }
+            }
+          });
 
-      // solve for inverse for nCols
-      for (j = 0; j < numColumns; j++) {
-        if ( columnIndex > 0 ) {
-          pb[columnIndex - 1] = 0.0;
-        }
-        pb[columnIndex] = 1.0;
+      if (failed) {
+        outputBundleStatus("\n\n");
+        QString msg = "Input data and settings are not sufficiently stable "
+                      "for error propagation.";
+        throw IException(IException::User, msg, _FILEINFO_);
+      }
+
+      emit(pointUpdate(numObjectPoints));
+
+      // estimate the time left from the block columns done so far
+      double elapsedSeconds = timer.elapsed() / 1000.0;
+      double remainingSeconds = elapsedSeconds * (numBlockColumns - groupEnd) / groupEnd;
+
+      status = "\rError Propagation: Inverse Block ";
+      status.append(QString::number(groupEnd));
+      status.append(" of ");
+      status.append(QString::number(numBlockColumns));
+      status.append("; Estimated time remaining ");
+      status.append(QString::number(remainingSeconds, 'f', 0));
+      status.append(" seconds  ");
+      outputBundleStatus(status);
+    }
 
-        x = cholmod_l_solve ( CHOLMOD_A, m_L, b, &m_cholmodCommon );
-        px = (double*)x->x;
-        int rp = 0;
+    if (m_bundleSettings->createInverseMatrix()) {
+      // Close the file.
+      matrixOutput.close();
+      // Save the location of the "covariance" matrix
+      m_bundleResults.setCorrMatCovFileName(matrixFile);
+    }
 
-        // store solution in corresponding column of inverse
-        for (k = 0; k < inverseMatrix.size(); k++) {
-          LinearAlgebra::Matrix *matrix = inverseMatrix.value(k);
+    // can free sparse normals now
+    m_sparseNormals.wipe();
 
-          int sz1 = matrix->size1();
+    outputBundleStatus("\n\n");
 
-          for (int ii = 0; ii < sz1; ii++) {
-            (*matrix)(ii,localCol) = px[ii + rp];
+    currentTime = Isis::iTime::CurrentLocalTime().toLatin1().data();
+
+    status = "\rFilling point covariance matrices: Time ";
+    status.append(currentTime.c_str());
+    outputBundleStatus(status);
+    outputBundleStatus("\n\n");
+
+    // now loop over points again and set final covariance stuff
+    // *** TODO *** Can this loop go into BundleControlPoint
+    QtConcurrent::blockingMap(pointIndices,
+        [&](int &j) {
+          BundleControlPointQsp point = m_bundleControlPoints.at(j);
+
+          // get corresponding point covariance matrix
+          boost::numeric::ublas::symmetric_matrix<double> &covariance = pointCovariances[j];
+
+          // Update and reset the matrix
+          // Get the Limiting Error Propagation uncertainties:  sigmas for coordinate 1, 2, and 3
+          // in meters
+          //
+          SurfacePoint SurfacePoint = point->adjustedSurfacePoint();
+
+          // Get the TEP by adding the corresponding members of pCovar and covariance
+          boost::numeric::ublas::symmetric_matrix <double,boost::numeric::ublas::upper> pCovar;
+
+          if (m_bundleSettings->controlPointCoordTypeBundle() == SurfacePoint::Latitudinal) {
+            pCovar = SurfacePoint.GetSphericalMatrix(SurfacePoint::Kilometers);
           }
-          rp += matrix->size1();
-        }
+          else {
+            // Assume Rectangular coordinates
+            pCovar = SurfacePoint.GetRectangularMatrix(SurfacePoint::Kilometers);
+          }
+          pCovar += covariance;
+          pCovar *= sigma0Squared;
 
-        columnIndex++;
-        localCol++;
+          // Distance units are km**2
+          SurfacePoint.SetMatrix(m_bundleSettings->controlPointCoordTypeBundle(),pCovar);
+          point->setAdjustedSurfacePoint(SurfacePoint);
+        });
 
-        cholmod_l_free_dense(&x,&m_cholmodCommon);
-      }
+    return true;
+  }
 
-      // save adjusted target body sigmas if solving for target
-      if (m_bundleSettings->solveTargetBody() && i == 0) {
-        vector< double > &adjustedSigmas = m_bundleTargetBody->adjustedSigmas();
-        matrix< double > *targetCovMatrix = inverseMatrix.value(i);
 
-        for (int z = 0; z < numColumns; z++)
-          adjustedSigmas[z] = sqrt((*targetCovMatrix)(z,z))*m_bundleResults.sigma0();
-      }
-      // save adjusted image sigmas
-      else {
-        BundleObservationQsp observation;
-        if (m_bundleSettings->solveTargetBody()) {
-          observation = m_bundleObservations.at(i-1);
-        }
-        else {
-          observation = m_bundleObservations.at(i);
-        }
-        vector< double > &adjustedSigmas = observation->adjustedSigmas();
-        matrix< double > *imageCovMatrix = inverseMatrix.value(i);
-        for ( int z = 0; z < numColumns; z++) {
-          adjustedSigmas[z] = sqrt((*imageCovMatrix)(z,z))*m_bundleResults.sigma0();
+  /**
+   * Solve for one block column of the inverse of the normal equations matrix. Only the blocks
+   * on and above the diagonal are kept since those are all that errorPropagation() needs. All
+   * of the columns in the block are solved for at once, which lets CHOLMOD use its supernodal
+   * solve on the whole block.
+   *
+   * This only reads the factorization, so it can be called from several threads at once.
+   *
+   * @param columnBlock The block column to solve for.
+   * @param inverseColumn Filled with blocks 0 through columnBlock of the inverse.
+   *
+   * @throws IException::User "Input data and settings are not sufficiently stable
+   *                           for error propagation."
+   *
+   * @see BundleAdjust::errorPropagation
+   */
+  void BundleAdjust::solveInverseBlockColumn(int columnBlock,
+                                             SparseBlockColumnMatrix &inverseColumn) {
+    SparseBlockColumnMatrix *normalsColumn = m_sparseNormals.at(columnBlock);
+    int startColumn = normalsColumn->startColumn();
+    int numColumns = normalsColumn->numberOfColumns();
+
+    for (int k = 0; k <= columnBlock; k++) {
+      inverseColumn.insertMatrixBlock(k, m_sparseNormals.at(k)->numberOfRows(), numColumns);
+    }
+
+    // m_cholmodCommon holds the workspace for a solve, so each solve needs its own
+    cholmod_common common;
+    cholmod_l_start(&common);
+    common.error_handler = cholmodErrorHandler;
+
+    // right-hand side is the columns of the identity for this block
+    cholmod_dense *b = cholmod_l_zeros(m_rank, numColumns, CHOLMOD_REAL, &common);
+    double *pb = (double*)b->x;
+    for (int j = 0; j < numColumns; j++) {
+      pb[startColumn + j + j * b->d] = 1.0;
+    }
+
+    cholmod_dense *x = cholmod_l_solve(CHOLMOD_A, m_L, b, &common);
+    cholmod_l_free_dense(&b, &common);
+
+    if (!x) {
+      cholmod_l_finish(&common);
+      QString msg = "Input data and settings are not sufficiently stable "
+                    "for error propagation.";
+      throw IException(IException::User, msg, _FILEINFO_);
+    }
+
+    // store solution in corresponding columns of inverse
+    double *px = (double*)x->x;
+    for (int j = 0; j < numColumns; j++) {
+      double *column = px + j * x->d;
+      int rp = 0;
+
+      for (int k = 0; k <= columnBlock; k++) {
+        LinearAlgebra::Matrix *matrix = inverseColumn.value(k);
+
+        int sz1 = matrix->size1();
+
+        for (int ii = 0; ii < sz1; ii++) {
+          (*matrix)(ii,j) = column[ii + rp];
         }
+        rp += sz1;
       }
+    }
 
-      // Output the inverse matrix if requested
-      if (m_bundleSettings->createInverseMatrix()) {
-        outStream << inverseMatrix;
-      }
+    cholmod_l_free_dense(&x, &common);
+    cholmod_l_finish(&common);
+  }
 
-      // now loop over all object points to sum contributions into 3x3 point covariance matrix
-      int pointIndex = 0;
-      for (j = 0; j < numObjectPoints; j++) {
-        emit(pointUpdate(j+1));
-        BundleControlPointQsp point = m_bundleControlPoints.at(pointIndex);
-        if ( point->isRejected() ) {
-          continue;
-        }
 
-        // only update point every 100 points
-        if (j%100 == 0) {
-          QString status = "\rError Propagation: Inverse Block ";
-          status.append(QString::number(i+1));
-          status.append(" of ");
-          status.append(QString::number(numBlockColumns));
-          status.append("; Point ");
-          status.append(QString::number(j+1));
-          status.append(" of ");
-          status.append(QString::number(numObjectPoints));
-          outputBundleStatus(status);
-        }
+  /**
+   * Compute the entries of the inverse of the normal equations matrix that are in the sparsity
+   * pattern of its Cholesky factor, with the Takahashi recurrence. For A = L L' and Z = A^-1,
+   * working from the last column of L to the first:
+   *
+   * @code
+   *   Z(i,j) = -1/L(j,j) * sum over k > j of L(k,j) * Z(i,k)       for i > j
+   *   Z(j,j) = 1/L(j,j)^2 - 1/L(j,j) * sum over k > j of L(k,j) * Z(k,j)
+   * @endcode
+   *
+   * where k only runs over the rows of column j of L. Every Z(i,k) that is needed is in the
+   * pattern of L, so this never forms a whole column of the inverse. The factor is copied and
+   * converted to a simplicial LL' factor first, which leaves m_L as it is.
+   *
+   * @param inverse Filled with the selected inverse.
+   *
+   * @return @b bool False if the factor could not be converted, or does not have the pattern
+   *                 the recurrence needs. The caller should solve for columns instead.
+   *
+   * @see BundleAdjust::errorPropagation
+   */
+  bool BundleAdjust::computeSelectedInverse(SelectedInverse &inverse) {
+    cholmod_factor *L = cholmod_l_copy_factor(m_L, &m_cholmodCommon);
+    if ( !L ) {
+      return false;
+    }
 
-        // get corresponding Q matrix
-        // NOTE: we are getting a reference to the Q matrix stored
-        //       in the BundleControlPoint for speed (without the & it is dirt slow)
-        SparseBlockRowMatrix &Q = point->cholmodQMatrix();
+    if ( !cholmod_l_change_factor(CHOLMOD_REAL, true, false, true, true, L, &m_cholmodCommon) ) {
+      cholmod_l_free_factor(&L, &m_cholmodCommon);
+      return false;
+    }
 
-        T.clear();
+    long n = L->n;
+    long *Lp = (long*)L->p;
+    long *Li = (long*)L->i;
+    long *Lnz = (long*)L->nz;
+    double *Lx = (double*)L->x;
+    long *perm = (long*)L->Perm;
+
+    // copy the factor with each column sorted by row, so the diagonal comes first
+    inverse.columnStarts.assign(n + 1, 0);
+    for (long j = 0; j < n; j++) {
+      inverse.columnStarts[j + 1] = inverse.columnStarts[j] + Lnz[j];
+    }
+    long nnz = inverse.columnStarts[n];
+    inverse.rows.resize(nnz);
+    inverse.values.assign(nnz, 0.0);
+    std::vector<double> factor(nnz);
+
+    std::vector< std::pair<long, double> > column;
+    for (long j = 0; j < n; j++) {
+      column.clear();
+      for (long p = Lp[j]; p < Lp[j] + Lnz[j]; p++) {
+        column.push_back(std::make_pair(Li[p], Lx[p]));
+      }
+      std::sort(column.begin(), column.end());
 
-        // get corresponding point covariance matrix
-        boost::numeric::ublas::symmetric_matrix<double> &covariance = pointCovariances[pointIndex];
+      long start = inverse.columnStarts[j];
+      for (size_t p = 0; p < column.size(); p++) {
+        inverse.rows[start + p] = column[p].first;
+        factor[start + p] = column[p].second;
+      }
+    }
 
-        // get firstQBlock - index i is the key into Q for firstQBlock
-        LinearAlgebra::Matrix *firstQBlock = Q.value(i);
-        if (!firstQBlock) {
-          pointIndex++;
-          continue;
-        }
+    inverse.positions.resize(n);
+    for (long k = 0; k < n; k++) {
+      inverse.positions[perm ? perm[k] : k] = k;
+    }
 
-        // iterate over Q
-        // secondQBlock is current map value
-        QMapIterator< int, LinearAlgebra::Matrix * > it(Q);
-        while ( it.hasNext() ) {
-          it.next();
+    cholmod_l_free_factor(&L, &m_cholmodCommon);
 
-          int nKey = it.key();
+    const std::vector<long> &starts = inverse.columnStarts;
+    const std::vector<long> &rows = inverse.rows;
+    std::vector<double> &values = inverse.values;
 
-          if (it.key() > i) {
-            break;
-          }
+    for (long j = n - 1; j >= 0; j--) {
+      long start = starts[j];
+      long end = starts[j + 1];
+      if (end == start || rows[start] != j || factor[start] <= 0.0) {
+        return false;
+      }
 
-          LinearAlgebra::Matrix *secondQBlock = it.value();
+      // For each i in column j, Z(k,i) for the rows k >= i of column j are in column i. Walk
+      // both sorted columns together. Each Z(k,i) adds to Z(i,j), and to Z(k,j) when k != i.
+      for (long pi = start + 1; pi < end; pi++) {
+        long i = rows[pi];
+        long pk = pi;
+        long found = 0;
 
-          if ( !secondQBlock ) {// should never be NULL
+        for (long q = starts[i]; q < starts[i + 1] && pk < end; q++) {
+          if (rows[q] < rows[pk]) {
             continue;
           }
+          if (rows[q] > rows[pk]) {
+            return false;
+          }
 
-          LinearAlgebra::Matrix *inverseBlock = inverseMatrix.value(it.key());
-
-          if ( !inverseBlock ) {// should never be NULL
-            continue;
+          double z = values[q];
+          values[pi] += factor[pk] * z;
+          if (pk != pi) {
+            values[pk] += factor[pi] * z;
           }
+          found++;
+          pk++;
+        }
 
-          T = prod(*inverseBlock, trans(*firstQBlock));
-          T = prod(*secondQBlock,T);
+        if (found != end - pi) {
+          return false;
+        }
+      }
 
-          if (nKey != i) {
-            T += trans(T);
-          }
+      double diagonal = factor[start];
+      double sum = 0.0;
+      for (long p = start + 1; p < end; p++) {
+        values[p] = -values[p] / diagonal;
+        sum += factor[p] * values[p];
+      }
+      values[start] = 1.0 / (diagonal * diagonal) - sum / diagonal;
+    }
 
-          try {
-            covariance += T;
+    return true;
+  }
+
+
+  /**
+   * Fill one block column of the inverse of the normal equations matrix from a selected
+   * inverse. Only the blocks that the normals have in the block column are filled, which are
+   * the blocks that errorPropagation() needs.
+   *
+   * @param inverse The selected inverse from computeSelectedInverse().
+   * @param columnBlock The block column to fill.
+   * @param inverseColumn Filled with the blocks of the inverse.
+   *
+   * @return @b bool False if an entry is not in the selected inverse. The caller should solve
+   *                 for the block column instead.
+   *
+   * @see BundleAdjust::errorPropagation
+   */
+  bool BundleAdjust::selectedInverseBlockColumn(const SelectedInverse &inverse,
+                                                int columnBlock,
+                                                SparseBlockColumnMatrix &inverseColumn) {
+    SparseBlockColumnMatrix *normalsColumn = m_sparseNormals.at(columnBlock);
+    int startColumn = normalsColumn->startColumn();
+    int numColumns = normalsColumn->numberOfColumns();
+
+    QMapIterator< int, LinearAlgebra::Matrix * > it(*normalsColumn);
+    while ( it.hasNext() ) {
+      it.next();
+      int rowBlock = it.key();
+      int startRow = m_sparseNormals.at(rowBlock)->startColumn();
+      int numRows = m_sparseNormals.at(rowBlock)->numberOfRows();
+
+      inverseColumn.insertMatrixBlock(rowBlock, numRows, numColumns);
+      LinearAlgebra::Matrix *matrix = inverseColumn.value(rowBlock);
+
+      for (int ii = 0; ii < numRows; ii++) {
+        for (int jj = 0; jj < numColumns; jj++) {
+          long row = inverse.positions[startRow + ii];
+          long column = inverse.positions[startColumn + jj];
+          if (row < column) {
+            std::swap(row, column);
           }
 
-          catch (std::exception &e) {
-            outputBundleStatus("\n\n");
-            QString msg = "Input data and settings are not sufficiently stable "
-                          "for error propagation.";
-            throw IException(IException::User, msg, _FILEINFO_);
+          std::vector<long>::const_iterator first = inverse.rows.begin() +
+                                                    inverse.columnStarts[column];
+          std::vector<long>::const_iterator last = inverse.rows.begin() +
+                                                   inverse.columnStarts[column + 1];
+          std::vector<long>::const_iterator entry = std::lower_bound(first, last, row);
+          if (entry == last || *entry != row) {
+            inverseColumn.wipe();
+            return false;
           }
+
+          (*matrix)(ii,jj) = inverse.values[entry - inverse.rows.begin()];
         }
-        pointIndex++;
       }
     }
 
-    if (m_bundleSettings->createInverseMatrix()) {
-      // Close the file.
-      matrixOutput.close();
-      // Save the location of the "covariance" matrix
-      m_bundleResults.setCorrMatCovFileName(matrixFile);
-    }
+    return true;
+  }
 
-    // can free sparse normals now
-    m_sparseNormals.wipe();
 
-    // free b (right-hand side vector)
-    cholmod_l_free_dense(&b,&m_cholmodCommon);
+  /**
+   * Add the contribution of one block column of the inverse to a point's 3x3 covariance
+   * matrix.
+   *
+   * @param Q The point's Q matrix.
+   * @param columnBlock The block column of the inverse.
+   * @param inverseColumn Blocks 0 through columnBlock of the inverse's block column.
+   * @param covariance The point's covariance matrix to add to.
+   *
+   * @return @b bool False if the covariance could not be updated.
+   *
+   * @see BundleAdjust::errorPropagation
+   */
+  bool BundleAdjust::accumulatePointCovariance(const SparseBlockRowMatrix &Q,
+                                               int columnBlock,
+                                               const SparseBlockColumnMatrix &inverseColumn,
+                                               symmetric_matrix<double> &covariance) {
+    // get firstQBlock - index columnBlock is the key into Q for firstQBlock
+    LinearAlgebra::Matrix *firstQBlock = Q.value(columnBlock);
+    if (!firstQBlock) {
+      return true;
+    }
 
-    outputBundleStatus("\n\n");
+    LinearAlgebra::Matrix T(3, 3);
 
-    currentTime = Isis::iTime::CurrentLocalTime().toLatin1().data();
+    // iterate over Q
+    // secondQBlock is current map value
+    QMapIterator< int, LinearAlgebra::Matrix * > it(Q);
+    while ( it.hasNext() ) {
+      it.next();
 
-    status = "\rFilling point covariance matrices: Time ";
-    status.append(currentTime.c_str());
-    outputBundleStatus(status);
-    outputBundleStatus("\n\n");
+      int nKey = it.key();
 
-    // now loop over points again and set final covariance stuff
-    // *** TODO *** Can this loop go into BundleControlPoint
-    int pointIndex = 0;
-    for (j = 0; j < numObjectPoints; j++) {
+      if (nKey > columnBlock) {
+        break;
+      }
 
-      BundleControlPointQsp point = m_bundleControlPoints.at(pointIndex);
+      LinearAlgebra::Matrix *secondQBlock = it.value();
 
-      if ( point->isRejected() ) {
+      if ( !secondQBlock ) {// should never be NULL
         continue;
       }
 
-      if (j%100 == 0) {
-        status = "\rError Propagation: Filling point covariance matrices ";
-        status.append(QString("%1").arg(j+1));
-        status.append(" of ");
-        status.append(QString("%1").arg(numObjectPoints));
-        status.append("\r");
-        outputBundleStatus(status);
-      }
+      LinearAlgebra::Matrix *inverseBlock = inverseColumn.value(nKey);
 
-      // get corresponding point covariance matrix
-      boost::numeric::ublas::symmetric_matrix<double> &covariance = pointCovariances[pointIndex];
+      if ( !inverseBlock ) {// should never be NULL
+        continue;
+      }
 
-      // Update and reset the matrix
-      // Get the Limiting Error Propagation uncertainties:  sigmas for coordinate 1, 2, and 3 in meters
-      //
-      SurfacePoint SurfacePoint = point->adjustedSurfacePoint();
+      T = prod(*inverseBlock, trans(*firstQBlock));
+      T = prod(*secondQBlock,T);
 
-      // Get the TEP by adding the corresponding members of pCovar and covariance
-      boost::numeric::ublas::symmetric_matrix <double,boost::numeric::ublas::upper> pCovar;
+      if (nKey != columnBlock) {
+        T += trans(T);
+      }
 
-      if (m_bundleSettings->controlPointCoordTypeBundle() == SurfacePoint::Latitudinal) {
-        pCovar = SurfacePoint.GetSphericalMatrix(SurfacePoint::Kilometers);
+      try {
+        covariance += T;
+      }
+      catch (std::exception &e) {
+        return false;
       }
-      else {
-        // Assume Rectangular coordinates
-        pCovar = SurfacePoint.GetRectangularMatrix(SurfacePoint::Kilometers);
-      }
-      pCovar += covariance;
-      pCovar *= sigma0Squared;
-
-      // debug lines
-      // if (j < 3) {
-      //   std::cout << " Adjusted surface point ..." << std::endl;
-      //   std:: cout << "     sigmaLat (radians) = " << sqrt(pCovar(0,0)) << std::endl;
-      //   std:: cout << "     sigmaLon (radians) = " << sqrt(pCovar(1,1)) << std::endl;
-      //   std:: cout << "     sigmaRad (km) = " << sqrt(pCovar(2,2)) << std::endl;
-      // std::cout <<  "      Adjusted matrix = " << std::endl;
-      // std::cout << "       " << pCovar(0,0) << "   " << pCovar(0,1) << "   "
-      //           << pCovar(0,2) << std::endl;
-      // std::cout << "        " << pCovar(1,0) << "   " << pCovar(1,1) << "   "
-      //           << pCovar(1,2) << std::endl;
-      // std::cout << "        " << pCovar(2,0) << "   " << pCovar(2,1) << "   "
-      //           << pCovar(2,2) << std::endl;
-      // }
-      // end debug
-
-      // Distance units are km**2
-      SurfacePoint.SetMatrix(m_bundleSettings->controlPointCoordTypeBundle(),pCovar);
-      point->setAdjustedSurfacePoint(SurfacePoint);
-      // // debug lines
-      // if (j < 3) {
-      //   boost::numeric::ublas::symmetric_matrix <double,boost::numeric::ublas::upper> recCovar;
-      //   recCovar = SurfacePoint.GetRectangularMatrix(SurfacePoint::Meters);
-      //   std:: cout << "     sigmaLat (meters) = " <<
-      //     point->adjustedSurfacePoint().GetSigmaDistance(SurfacePoint::Latitudinal,
-      //     SurfacePoint::One).meters() << std::endl;
-      //   std:: cout << "     sigmaLon (meters) = " <<
-      //     point->adjustedSurfacePoint().GetSigmaDistance(SurfacePoint::Latitudinal,
-      //     SurfacePoint::Two).meters() << std::endl;
-      //   std:: cout << "   sigmaRad (km) = " << sqrt(pCovar(2,2)) << std::endl;
-      //   std::cout << "Rectangular matrix with radius in meters" << std::endl;
-      //   std::cout << "       " << recCovar(0,0) << "   " << recCovar(0,1) << "   "
-      //           << recCovar(0,2) << std::endl;
-      //   std::cout << "        " << recCovar(1,0) << "   " << recCovar(1,1) << "   "
-      //           << recCovar(1,2) << std::endl;
-      //   std::cout << "        " << recCovar(2,0) << "   " << recCovar(2,1) << "   "
-      //           << recCovar(2,2) << std::endl;
-      // }
-      // // end debug
-
-      pointIndex++;
     }
 
     return true;
@@ -325,6 +325,19 @@ namespace Isis {
    *                            adjustment.  In the future a control net diagnostic program might be
    *                            useful to detect any points not visible on an image based on the exterior
    *                            orientation of the image.  References #2591.
+   *   @history 2026-10-16 ISIS Development Team - formNormalEquations() forms the normals of
+   *                           batches of control points in parallel and computeVtpv()
+   *                           evaluates points in parallel. Results are identical to the
+   *                           serial versions.
+   *   @history 2026-10-16 ISIS Development Team - errorPropagation() solves for the inverse and
+   *                           sums point covariances in parallel, with a bound on the memory
+   *                           used by the inverse. Added solveInverseBlockColumn() and
+   *                           accumulatePointCovariance().
+   *   @history 2026-10-17 ISIS Development Team - Unless the full inverse is written out,
+   *                           errorPropagation() takes the blocks of the inverse it needs from a
+   *                           selected inverse of the Cholesky factor (the Takahashi recurrence)
+   *                           instead of solving for whole columns. Added SelectedInverse,
+   *                           computeSelectedInverse() and selectedInverseBlockColumn().
    */
   class BundleAdjust : public QObject {
       Q_OBJECT
@@ -404,6 +417,26 @@ namespace Isis {
       bool computeBundleStatistics();
       void applyParameterCorrections();
       bool errorPropagation();
+      void solveInverseBlockColumn(int columnBlock, SparseBlockColumnMatrix &inverseColumn);
+
+      /**
+       * The entries of the inverse of the normal equations matrix that are in the sparsity
+       * pattern of its Cholesky factor. They are stored by column of the factor, like the
+       * factor itself, with each column's rows sorted.
+       */
+      struct SelectedInverse {
+        std::vector<long> columnStarts; //!< Start of each factor column in rows and values
+        std::vector<long> rows;         //!< The factor rows of the entries, sorted per column
+        std::vector<double> values;     //!< The entries of the inverse
+        std::vector<long> positions;    //!< Factor row/column of each normals row/column
+      };
+      bool computeSelectedInverse(SelectedInverse &inverse);
+      bool selectedInverseBlockColumn(const SelectedInverse &inverse, int columnBlock,
+                                      SparseBlockColumnMatrix &inverseColumn);
+      bool accumulatePointCovariance(const SparseBlockRowMatrix &Q,
+                                     int columnBlock,
+                                     const SparseBlockColumnMatrix &inverseColumn,
+                                     boost::numeric::ublas::symmetric_matrix<double> &covariance);
       void computeResiduals();
       double computeVtpv();
       bool computeRejectionLimit();
@@ -427,11 +460,37 @@ namespace Isis {
                               LinearAlgebra::Matrix                &coeffPoint3D,
                               LinearAlgebra::Vector                &coeffRHS,
                               int                                  observationIndex);
-      int formPointNormals(LinearAlgebra::MatrixUpperTriangular &N22,
-                           SparseBlockColumnMatrix              &N12,
-                           LinearAlgebra::Vector                &n2,
-                           LinearAlgebra::Vector                &nj,
-                           BundleControlPointQsp                &point);
+      /**
+       * The partial derivatives of one measure, kept until the normal equations for its
+       * point are formed.
+       */
+      struct MeasurePartials {
+        LinearAlgebra::Matrix coeffTarget;  //!< Target body partial derivatives.
+        LinearAlgebra::Matrix coeffImage;   //!< Camera parameter partial derivatives.
+        LinearAlgebra::Matrix coeffPoint3D; //!< Point parameter partial derivatives.
+        LinearAlgebra::Vector coeffRHS;     //!< Weighted x,y residuals.
+        int blockIndex;                     //!< Block column of the measure's observation.
+      };
+
+      /**
+       * A control point's contribution to the normal equations.
+       */
+      struct PointNormals {
+        BundleControlPointQsp point;                  //!< The control point.
+        std::vector<MeasurePartials> measures;        //!< Partials of the point's good measures.
+        LinearAlgebra::MatrixUpperTriangular N22;     //!< Inverse of the point's normal matrix.
+        SparseBlockColumnMatrix N12;                  //!< Normals for the images and target.
+        LinearAlgebra::Vector n2;                     //!< Right hand side for the point.
+        int numConstrainedCoordinates;                //!< Number of constrained coordinates.
+      };
+
+      void formBatchNormals(std::vector<PointNormals> &batch,
+                            LinearAlgebra::Vector     &n1);
+      void accumulateBlockColumn(const std::vector<PointNormals> &batch,
+                                 const QVector<int>              &points,
+                                 int                             columnIndex,
+                                 LinearAlgebra::Vector           &n1);
+      int formPointNormals(PointNormals &pointNormals);
       int formLidarPointNormals(LinearAlgebra::MatrixUpperTriangular &N22,
                                 SparseBlockColumnMatrix              &N12,
                                 LinearAlgebra::Vector                &n2,
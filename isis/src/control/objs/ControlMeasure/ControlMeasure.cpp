@@ -17,6 +17,7 @@ find files of those names at the top level of this repository. **/
 #include "ControlMeasureLogData.h"
 #include "ControlNet.h"
 #include "ControlPoint.h"
+#include "ControlStringPool.h"
 #include "IString.h"
 #include "iTime.h"
 #include "SpecialPixel.h"
@@ -29,10 +30,6 @@ namespace Isis {
    */
   ControlMeasure::ControlMeasure() {
     InitializeToNull();
-    p_serialNumber = new QString;
-    p_chooserName = new QString;
-    p_dateTime = new QString;
-    p_loggedData = new QVector<ControlMeasureLogData>();
 
     p_measureType = Candidate;
     p_editLock = false;
@@ -50,11 +47,13 @@ namespace Isis {
   ControlMeasure::ControlMeasure(const ControlMeasure &other) {
     InitializeToNull();
 
-    p_serialNumber = new QString(*other.p_serialNumber);
-    p_chooserName = new QString(*other.p_chooserName);
-    p_dateTime = new QString(*other.p_dateTime);
+    p_serialNumber = other.p_serialNumber;
+    p_chooserName = other.p_chooserName;
+    p_dateTime = other.p_dateTime;
 
-    p_loggedData = new QVector<ControlMeasureLogData>(*other.p_loggedData);
+    if (other.p_loggedData) {
+      p_loggedData = new QVector<ControlMeasureLogData>(*other.p_loggedData);
+    }
 
     p_measureType = other.p_measureType;
     p_editLock = other.p_editLock;
@@ -79,9 +78,9 @@ namespace Isis {
     p_sample = Null;
     p_line = Null;
 
-    p_serialNumber = NULL;
-    p_chooserName = NULL;
-    p_dateTime = NULL;
+    p_serialNumber.clear();
+    p_chooserName.clear();
+    p_dateTime.clear();
     p_loggedData = NULL;
 
     p_diameter = Null;
@@ -108,21 +107,6 @@ namespace Isis {
    * Free the memory allocated by a control
    */
   ControlMeasure::~ControlMeasure() {
-    if (p_serialNumber) {
-      delete p_serialNumber;
-      p_serialNumber = NULL;
-    }
-
-    if (p_chooserName) {
-      delete p_chooserName;
-      p_chooserName = NULL;
-    }
-
-    if (p_dateTime) {
-      delete p_dateTime;
-      p_dateTime = NULL;
-    }
-
     if (p_loggedData) {
       delete p_loggedData;
       p_loggedData = NULL;
@@ -187,7 +171,7 @@ namespace Isis {
   ControlMeasure::Status ControlMeasure::SetCubeSerialNumber(QString newSerialNumber) {
     if (IsEditLocked())
       return MeasureLocked;
-    *p_serialNumber = newSerialNumber;
+    p_serialNumber = ControlStringPool::serialNumbers().intern(newSerialNumber);
     return Success;
   }
 
@@ -196,7 +180,7 @@ namespace Isis {
   ControlMeasure::Status ControlMeasure::SetChooserName() {
     if (IsEditLocked())
       return MeasureLocked;
-    *p_chooserName = "";
+    p_chooserName.clear();
     return Success;
   }
 
@@ -205,7 +189,7 @@ namespace Isis {
   ControlMeasure::Status ControlMeasure::SetChooserName(QString name) {
     if (IsEditLocked())
       return MeasureLocked;
-    *p_chooserName = name;
+    p_chooserName = ControlStringPool::chooserNames().intern(name);
     return Success;
   }
 
@@ -247,7 +231,7 @@ namespace Isis {
   ControlMeasure::Status ControlMeasure::SetDateTime() {
     if (IsEditLocked())
       return MeasureLocked;
-    *p_dateTime = Application::DateTime();
+    p_dateTime = Application::DateTime();
     return Success;
   }
 
@@ -256,7 +240,7 @@ namespace Isis {
   ControlMeasure::Status ControlMeasure::SetDateTime(QString datetime) {
     if (IsEditLocked())
       return MeasureLocked;
-    *p_dateTime = datetime;
+    p_dateTime = datetime;
     return Success;
   }
 
@@ -362,6 +346,9 @@ namespace Isis {
     // only update if there was a change in status
     if (oldStatus != p_ignore) {
       MeasureModified();
+      if (parentPoint && parentPoint->Parent()) {
+        parentPoint->Parent()->updateValidMeasureCount(GetCubeSerialNumber(), p_ignore ? -1 : 1);
+      }
       if (parentPoint && !parentPoint->IsIgnored() && parentPoint->Parent()) {
         ControlNet * cnet = parentPoint->Parent();
         p_ignore ? cnet->measureIgnored(this) : cnet->measureUnIgnored(this);
@@ -439,10 +426,17 @@ namespace Isis {
       throw IException(IException::Programmer, msg, _FILEINFO_);
     }
 
-    if (HasLogData(data.GetDataType()))
+    if (HasLogData(data.GetDataType())) {
       UpdateLogData(data);
-    else
+    }
+    else {
+      // Most measures never have log data, so the vector is only allocated
+      // when the first entry is added
+      if (!p_loggedData) {
+        p_loggedData = new QVector<ControlMeasureLogData>();
+      }
       p_loggedData->append(data);
+    }
   }
 
 
@@ -453,12 +447,21 @@ namespace Isis {
    * @param dataType A ControlMeasureLogData::NumericLogDataType
    */
   void ControlMeasure::DeleteLogData(long dataType) {
+    if (!p_loggedData) {
+      return;
+    }
+
     for (int i = p_loggedData->size()-1; i >= 0; i--) {
       ControlMeasureLogData logDataEntry = p_loggedData->at(i);
 
       if (logDataEntry.GetDataType() == dataType)
         p_loggedData->remove(i);
     }
+
+    if (p_loggedData->isEmpty()) {
+      delete p_loggedData;
+      p_loggedData = NULL;
+    }
   }
 
 
@@ -467,6 +470,10 @@ namespace Isis {
    *   should work for all types of log data.
    */
   QVariant ControlMeasure::GetLogValue(long dataType) const {
+    if (!p_loggedData) {
+      return QVariant();
+    }
+
     for (int i = 0; i < p_loggedData->size(); i++) {
       const ControlMeasureLogData &logDataEntry = p_loggedData->at(i);
 
@@ -484,6 +491,10 @@ namespace Isis {
    * @param dataType A ControlMeasureLogData::NumericLogDataType
    */
   bool ControlMeasure::HasLogData(long dataType) const {
+    if (!p_loggedData) {
+      return false;
+    }
+
     for (int i = 0; i < p_loggedData->size(); i++) {
       const ControlMeasureLogData &logDataEntry = p_loggedData->at(i);
 
@@ -504,7 +515,7 @@ namespace Isis {
   void ControlMeasure::UpdateLogData(ControlMeasureLogData newLogData) {
     bool updated = false;
 
-    for (int i = 0; i < p_loggedData->size(); i++) {
+    for (int i = 0; p_loggedData && i < p_loggedData->size(); i++) {
       ControlMeasureLogData logDataEntry = p_loggedData->at(i);
 
       if (logDataEntry.GetDataType() == newLogData.GetDataType()) {
@@ -540,8 +551,8 @@ namespace Isis {
 
   //! Return the chooser name
   QString ControlMeasure::GetChooserName() const {
-    if (*p_chooserName != "") {
-      return *p_chooserName;
+    if (!p_chooserName.isEmpty()) {
+      return p_chooserName;
     }
     else {
       return FileName(Application::Name()).name();
@@ -550,19 +561,19 @@ namespace Isis {
 
   //! Returns true if the choosername is not empty.
   bool ControlMeasure::HasChooserName() const {
-    return !p_chooserName->isEmpty();
+    return !p_chooserName.isEmpty();
   }
 
   //! Return the serial number of the cube containing the coordinate
   QString ControlMeasure::GetCubeSerialNumber() const {
-    return *p_serialNumber;
+    return p_serialNumber;
   }
 
 
   //! Return the date/time the coordinate was last changed
   QString ControlMeasure::GetDateTime() const {
-    if (*p_dateTime != "") {
-      return *p_dateTime;
+    if (!p_dateTime.isEmpty()) {
+      return p_dateTime;
     }
     else {
       return Application::DateTime();
@@ -571,7 +582,7 @@ namespace Isis {
 
   //! Returns true if the datetime is not empty.
   bool ControlMeasure::HasDateTime() const {
-    return !p_dateTime->isEmpty();
+    return !p_dateTime.isEmpty();
   }
 
 
@@ -775,7 +786,7 @@ namespace Isis {
     ControlMeasureLogData::NumericLogDataType typedDataType =
       (ControlMeasureLogData::NumericLogDataType)dataType;
 
-    while (foundIndex < p_loggedData->size()) {
+    while (p_loggedData && foundIndex < p_loggedData->size()) {
       const ControlMeasureLogData &logData = p_loggedData->at(foundIndex);
       if (logData.GetDataType() == typedDataType) {
         return logData;
@@ -863,15 +874,15 @@ namespace Isis {
     data.append(qsl);
     qsl.clear();
 
-    qsl << "ChooserName" << *p_chooserName;
+    qsl << "ChooserName" << p_chooserName;
     data.append(qsl);
     qsl.clear();
 
-    qsl << "CubeSerialNumber" << *p_serialNumber;
+    qsl << "CubeSerialNumber" << p_serialNumber;
     data.append(qsl);
     qsl.clear();
 
-    qsl << "DateTime" << *p_dateTime;
+    qsl << "DateTime" << p_dateTime;
     data.append(qsl);
     qsl.clear();
 
@@ -1002,38 +1013,27 @@ namespace Isis {
     if (this == &other)
       return *this;
 
-    if (p_serialNumber) {
-      delete p_serialNumber;
-      p_serialNumber = NULL;
-    }
-    if (p_chooserName) {
-      delete p_chooserName;
-      p_chooserName = NULL;
-    }
-    if (p_dateTime) {
-      delete p_dateTime;
-      p_dateTime = NULL;
-    }
     if (p_loggedData) {
       delete p_loggedData;
       p_loggedData = NULL;
     }
 
-    p_serialNumber = new QString;
-    p_chooserName = new QString;
-    p_dateTime = new QString;
-    p_loggedData = new QVector<ControlMeasureLogData>();
+    p_serialNumber.clear();
+    p_chooserName.clear();
+    p_dateTime.clear();
 
     bool oldLock = p_editLock;
     p_editLock = false;
 
     p_sample = other.p_sample;
     p_line = other.p_line;
-    *p_loggedData = *other.p_loggedData;
+    if (other.p_loggedData) {
+      p_loggedData = new QVector<ControlMeasureLogData>(*other.p_loggedData);
+    }
 
-    SetCubeSerialNumber(*other.p_serialNumber);
-    SetChooserName(*other.p_chooserName);
-    SetDateTime(*other.p_dateTime);
+    SetCubeSerialNumber(other.p_serialNumber);
+    SetChooserName(other.p_chooserName);
+    SetDateTime(other.p_dateTime);
     SetType(other.p_measureType);
     //  Call SetIgnored to update the ControlGraphNode.  However, SetIgnored
     //  will return if EditLock is true, so set to false temporarily.
@@ -1086,9 +1086,9 @@ namespace Isis {
    */
   bool ControlMeasure::operator==(const Isis::ControlMeasure &pMeasure) const {
     return pMeasure.p_measureType == p_measureType &&
-        *pMeasure.p_serialNumber == *p_serialNumber &&
-        *pMeasure.p_chooserName == *p_chooserName &&
-        *pMeasure.p_dateTime == *p_dateTime &&
+        pMeasure.p_serialNumber == p_serialNumber &&
+        pMeasure.p_chooserName == p_chooserName &&
+        pMeasure.p_dateTime == p_dateTime &&
         pMeasure.p_editLock == p_editLock &&
         pMeasure.p_ignore == p_ignore &&
         pMeasure.p_jigsawRejected == p_jigsawRejected &&
@@ -1110,7 +1110,7 @@ namespace Isis {
   }
 
   void ControlMeasure::MeasureModified() {
-    *p_dateTime = "";
-    *p_chooserName = "";
+    p_dateTime.clear();
+    p_chooserName.clear();
   }
 }
@@ -10,10 +10,10 @@ find files of those names at the top level of this repository. **/
 /* SPDX-License-Identifier: CC0-1.0 */
 
 #include <QObject>
+#include <QString>
 
 template< class A> class QVector;
 template< class A> class QList;
-class QString;
 class QStringList;
 class QVariant;
 
@@ -171,6 +171,16 @@ namespace Isis {
    *                           Fixes #5435.
    *  @history 2018-06-29 Adam Goins - Modified operator= to use setters when setting values
    *                           so that the proper signals/slots are called. Fixes #5435.
+   *  @history 2026-10-16 ISIS Development Team - Stored the serial number, chooser name and
+   *                           date time as strings interned in a ControlStringPool instead of
+   *                           allocating a QString for each, so the measures on a cube share
+   *                           one copy of its serial number. The log data is only allocated
+   *                           when a measure has some. Removed the unused p_comments member.
+   *  @history 2026-10-16 ISIS Development Team - SetIgnored() updates the number of valid
+   *                           measures on the cube in the parent network even when the parent
+   *                           point is ignored.
+   *  @history 2026-10-17 ISIS Development Team - Date times are no longer interned. Every
+   *                           second has its own, and pooled strings are never freed.
    */
   class ControlMeasure : public QObject {
 
@@ -343,18 +353,17 @@ namespace Isis {
       ControlPoint *parentPoint;  //!< Pointer to parent ControlPoint, may be null
       // structure connecting measures in an image
 
-      QString *p_serialNumber;
+      QString p_serialNumber; //!< Interned in ControlStringPool::serialNumbers()
       MeasureType p_measureType;
 
-      QVector<ControlMeasureLogData> * p_loggedData;
-      PvlGroup *p_comments;
+      QVector<ControlMeasureLogData> * p_loggedData; //!< NULL until log data is set
 
       /**
        * list the program used and the definition file or include the user
-       * name for qnet
+       * name for qnet, interned in ControlStringPool::chooserNames()
        */
-      QString *p_chooserName;
-      QString *p_dateTime;
+      QString p_chooserName;
+      QString p_dateTime;
       bool p_editLock;        //!< If true do not edit anything in measure.
       bool p_ignore;
       bool p_jigsawRejected;  //!< Status of measure for last bundle adjust iteration
@@ -52,6 +52,7 @@ namespace Isis {
     points = NULL;
     pointIds = NULL;
     m_mutex = NULL;
+    m_nextIsland = 0;
   }
 
   //!Creates an empty ControlNet object
@@ -194,6 +195,8 @@ namespace Isis {
 
     m_vertexMap.clear();
     m_controlGraph.clear();
+    m_islandSizes.clear();
+    m_nextIsland = 0;
 
     if (pointIds) {
       pointIds->clear();
@@ -397,11 +400,7 @@ namespace Isis {
       QString sn = point->GetMeasure(i)->GetCubeSerialNumber();
       // If the graph doesn't have the sn, add a node for it
       if (!m_vertexMap.contains(sn)) {
-        Image newImage;
-        newImage.serial = sn;
-        ImageVertex newVertex = boost::add_vertex(newImage, m_controlGraph);
-        m_vertexMap.insert(sn, newVertex);
-        emit networkModified(GraphModified);
+        addImageVertex(sn);
       }
     }
 
@@ -411,6 +410,9 @@ namespace Isis {
       // Add the measure to the corresponding node
       QString serial = measure->GetCubeSerialNumber();
       m_controlGraph[m_vertexMap[serial]].measures[measure->Parent()] = measure;
+      if (!measure->IsIgnored()) {
+        updateValidMeasureCount(serial, 1);
+      }
 
       // In this measure's node add connections to the other nodes reachable from
       // its point
@@ -449,6 +451,7 @@ namespace Isis {
                                                         m_controlGraph);
     m_controlGraph[connection].strength++;
     if (edgeAdded) {
+      joinIslands(m_vertexMap[sourceSerial], m_vertexMap[targetSerial]);
       emit networkModified(GraphModified);
     }
     return edgeAdded;
@@ -478,6 +481,7 @@ namespace Isis {
         boost::remove_edge(m_vertexMap[sourceSerial],
                            m_vertexMap[targetSerial],
                            m_controlGraph);
+        splitIslands(m_vertexMap[sourceSerial], m_vertexMap[targetSerial]);
         emit networkModified(GraphModified);
 
         return true;
@@ -487,6 +491,132 @@ namespace Isis {
   }
 
 
+  /**
+   * Adds a vertex for an image to the ControlNet graph. The new image is an island by itself
+   * until an edge connects it to another image.
+   *
+   * @param serial The serial number of the image
+   */
+  void ControlNet::addImageVertex(QString serial) {
+    Image newImage;
+    newImage.serial = serial;
+    newImage.island = m_nextIsland++;
+    ImageVertex newVertex = boost::add_vertex(newImage, m_controlGraph);
+    m_vertexMap.insert(serial, newVertex);
+    m_islandSizes.insert(newImage.island, 1);
+    emit networkModified(GraphModified);
+  }
+
+
+  /**
+   * Changes the number of valid measures on an image. This is called when a measure on the
+   * image is added, deleted, ignored or un-ignored.
+   *
+   * @param serial The serial number of the image
+   * @param change The amount to add to the number of valid measures
+   */
+  void ControlNet::updateValidMeasureCount(QString serial, int change) {
+    QHash<QString, ImageVertex>::const_iterator vertex = m_vertexMap.constFind(serial);
+    if (vertex != m_vertexMap.constEnd()) {
+      m_controlGraph[vertex.value()].validMeasures += change;
+    }
+  }
+
+
+  /**
+   * Merges the islands of the two ends of a new edge. The images of the smaller island are
+   * given the number of the larger one, so an image is renumbered at most log2(n) times as
+   * n images are joined.
+   *
+   * @param first One end of the new edge
+   * @param second The other end of the new edge
+   */
+  void ControlNet::joinIslands(ImageVertex first, ImageVertex second) {
+    int firstIsland = m_controlGraph[first].island;
+    int secondIsland = m_controlGraph[second].island;
+    if (firstIsland == secondIsland) {
+      return;
+    }
+
+    int firstSize = m_islandSizes.value(firstIsland);
+    int secondSize = m_islandSizes.value(secondIsland);
+    if (firstSize < secondSize) {
+      std::swap(first, second);
+      std::swap(firstIsland, secondIsland);
+    }
+
+    // Only the images still numbered as the smaller island are followed, so the search does
+    // not cross the new edge into the larger one
+    QList<ImageVertex> toVisit;
+    m_controlGraph[second].island = firstIsland;
+    toVisit.append(second);
+    while (!toVisit.isEmpty()) {
+      ImageVertex vertex = toVisit.takeLast();
+      AdjacencyIterator adjIt, adjEnd;
+      for (boost::tie(adjIt, adjEnd) = boost::adjacent_vertices(vertex, m_controlGraph);
+           adjIt != adjEnd; ++adjIt) {
+        if (m_controlGraph[*adjIt].island == secondIsland) {
+          m_controlGraph[*adjIt].island = firstIsland;
+          toVisit.append(*adjIt);
+        }
+      }
+    }
+
+    m_islandSizes[firstIsland] = firstSize + secondSize;
+    m_islandSizes.remove(secondIsland);
+  }
+
+
+  /**
+   * Checks if removing an edge split its island, and if it did gives the images that were cut
+   * off a new island number. The graph is searched from both ends of the removed edge, one
+   * image at a time from each. If the searches meet, the island is still connected. Otherwise
+   * the search that runs out of images first has found everything on its side of the split,
+   * so the cost of a split is proportional to the smaller of the two new islands.
+   *
+   * @param first One end of the removed edge
+   * @param second The other end of the removed edge
+   */
+  void ControlNet::splitIslands(ImageVertex first, ImageVertex second) {
+    QList<ImageVertex> searched[2];
+    QSet<ImageVertex> seen[2];
+    int next[2] = {0, 0};
+    searched[0].append(first);
+    seen[0].insert(first);
+    searched[1].append(second);
+    seen[1].insert(second);
+
+    while (true) {
+      for (int side = 0; side < 2; side++) {
+        if (next[side] == searched[side].size()) {
+          // This side is cut off from the other
+          int oldIsland = m_controlGraph[first].island;
+          int newIsland = m_nextIsland++;
+          foreach (ImageVertex vertex, searched[side]) {
+            m_controlGraph[vertex].island = newIsland;
+          }
+          m_islandSizes[oldIsland] -= searched[side].size();
+          m_islandSizes.insert(newIsland, searched[side].size());
+          return;
+        }
+
+        ImageVertex vertex = searched[side][next[side]++];
+        AdjacencyIterator adjIt, adjEnd;
+        for (boost::tie(adjIt, adjEnd) = boost::adjacent_vertices(vertex, m_controlGraph);
+             adjIt != adjEnd; ++adjIt) {
+          if (seen[1 - side].contains(*adjIt)) {
+            return;
+          }
+          if (!seen[side].contains(*adjIt)) {
+            seen[side].insert(*adjIt);
+            searched[side].append(*adjIt);
+          }
+        }
+      }
+    }
+  }
+
+
   /**
    * Used for verifying graph intergrity
    *
@@ -599,14 +729,13 @@ namespace Isis {
 
     // If the graph doesn't have the sn, add a node for it
     if (!m_vertexMap.contains(serial)) {
-      Image newImage;
-      newImage.serial = serial;
-      ImageVertex newVertex = boost::add_vertex(newImage, m_controlGraph);
-      m_vertexMap.insert(serial, newVertex);
-      emit networkModified(GraphModified);
+      addImageVertex(serial);
     }
 
     m_controlGraph[m_vertexMap[serial]].measures[measure->Parent()] = measure;
+    if (!measure->IsIgnored()) {
+      updateValidMeasureCount(serial, 1);
+    }
 
     // in this measure's node add connections to the other nodes reachable from
     // its point
@@ -760,6 +889,10 @@ namespace Isis {
       measureIgnored(measure);
     }
 
+    if (!measure->IsIgnored()) {
+      updateValidMeasureCount(serial, -1);
+    }
+
     // Remove the measure from the associated node.
     // Conceptually, I think this belongs in measureIgnored, but it isn't done
     // for the old graph.
@@ -961,35 +1094,77 @@ namespace Isis {
    * @returns A list of cube islands as serial numbers
    */
   QList< QList< QString > > ControlNet::GetSerialConnections() const {
+    QHash< int, int > islandIndices;
+    islandIndices.reserve(m_islandSizes.size());
+    QList< QList< QString > > islandStrings;
+    VertexIterator v, vend;
+    for (boost::tie(v, vend) = boost::vertices(m_controlGraph); v != vend; ++v) {
+      int island = m_controlGraph[*v].island;
+      QHash< int, int >::const_iterator index = islandIndices.constFind(island);
+      if (index == islandIndices.constEnd()) {
+        index = islandIndices.insert(island, islandStrings.size());
+        islandStrings.append(QList<QString>());
+        islandStrings.last().reserve(m_islandSizes.value(island));
+      }
+      islandStrings[index.value()].append(m_controlGraph[*v].serial);
+    }
+    return islandStrings;
+  }
+
+
+  /**
+   * Gets the number of islands in the network. An island is a group of images that are
+   * connected to each other through valid measures and are not connected to any other images.
+   * An image without any connections is an island by itself.
+   *
+   * @returns int The number of islands
+   */
+  int ControlNet::getIslandCount() const {
+    return m_islandSizes.size();
+  }
 
-    VertexIndexMap indexMap;
-    VertexIndexMapAdaptor indexMapAdaptor(indexMap);
 
-    // Needed to use connected_componenets
-    QList< QString> serials = m_vertexMap.keys();
-    for (int i = 0; i < serials.size(); i++) {
-      boost::put(indexMapAdaptor, m_vertexMap[serials[i]], i);
+  /**
+   * Gets the number of images in the island that an image belongs to.
+   *
+   * @param serialNumber The serial number of the image
+   *
+   * @returns int The number of images in the island, including the image itself
+   *
+   * @throws IException::Programmer "Cube Serial Number not found in the network"
+   */
+  int ControlNet::getIslandSize(QString serialNumber) const {
+    if (!ValidateSerialNumber(serialNumber)) {
+      IString msg = "Cube Serial Number [" + serialNumber + "] not found in "
+          "the network";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
     }
 
-    VertexIndexMap componentMap;
-    VertexIndexMapAdaptor componentAdaptor(componentMap);
-    int numComponents = boost::connected_components(m_controlGraph, componentAdaptor,
-                                                      boost::vertex_index_map(indexMapAdaptor));
+    return m_islandSizes.value(m_controlGraph[m_vertexMap[serialNumber]].island);
+  }
+
 
-    QList< QList< QString > > islandStrings;
-    for (int i = 0; i < numComponents; i++) {
-      QList<QString> tempList;
-      islandStrings.append(tempList);
-    }
-    std::map<ImageVertex, size_t>::iterator it = componentMap.begin();
-    while(it != componentMap.end())
-    {
-      QString serial = m_controlGraph[it->first].serial;
-      int group = (int) it->second;
-      islandStrings[group].append(serial);
-      ++it;
+  /**
+   * Checks if there is a path through valid measures between two images.
+   *
+   * @param firstSerial The serial number of the first image
+   * @param secondSerial The serial number of the second image
+   *
+   * @returns bool True if the images are in the same island, false otherwise
+   *
+   * @throws IException::Programmer "Cube Serial Number not found in the network"
+   */
+  bool ControlNet::areConnected(QString firstSerial, QString secondSerial) const {
+    foreach (QString serial, QStringList() << firstSerial << secondSerial) {
+      if (!ValidateSerialNumber(serial)) {
+        IString msg = "Cube Serial Number [" + serial + "] not found in "
+            "the network";
+        throw IException(IException::Programmer, msg, _FILEINFO_);
+      }
     }
-    return islandStrings;
+
+    return m_controlGraph[m_vertexMap[firstSerial]].island ==
+           m_controlGraph[m_vertexMap[secondSerial]].island;
   }
 
 
@@ -1409,7 +1584,13 @@ namespace Isis {
     if (p_cameraList.size() > 0) {
       return p_cameraValidMeasuresMap[serialNumber];
     }
-    return GetValidMeasuresInCube(serialNumber).size();
+
+    if (!ValidateSerialNumber(serialNumber)) {
+      IString msg = "Cube Serial Number [" + serialNumber + "] not found in "
+          "the network";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
+    return m_controlGraph[m_vertexMap[serialNumber]].validMeasures;
   }
 
 
@@ -1770,6 +1951,10 @@ namespace Isis {
     std::swap(p_cameraRejectedMeasuresMap, other.p_cameraRejectedMeasuresMap);
     std::swap(p_cameraList, other.p_cameraList);
 
+    // The island numbers of the images are swapped with the graphs
+    std::swap(m_islandSizes, other.m_islandSizes);
+    std::swap(m_nextIsland, other.m_nextIsland);
+
     // points have parent pointers that need to be updated too...
     QHashIterator< QString, ControlPoint * > i(*points);
     while (i.hasNext()) {
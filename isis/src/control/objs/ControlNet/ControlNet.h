@@ -254,6 +254,18 @@ namespace Isis {
    *                           conversions instead of the target equatorial and polar radii.
    *                           Fixes #5457.
    *   @history 2018-07-22 Kristin Berry - Updated swap to include the graph and vertex map.
+   *   @history 2026-10-16 ISIS Development Team - The islands of the graph and the number of
+   *                           valid measures on each image are now kept up to date as points
+   *                           and measures are added, ignored and deleted. Added
+   *                           getIslandCount(), getIslandSize() and areConnected(), which
+   *                           answer connectivity questions without searching the graph.
+   *                           GetSerialConnections() and GetNumberOfValidMeasuresInImage()
+   *                           use them.
+   *   @history 2026-10-17 ISIS Development Team - Each image records the number of its island
+   *                           instead of a union-find that had to be rebuilt from every edge
+   *                           after any edge was removed. Removing an edge searches from both
+   *                           of its ends and renumbers the smaller side if the island split.
+   *                           The island queries no longer modify the network.
    */
   class ControlNet : public QObject {
       Q_OBJECT
@@ -299,6 +311,9 @@ namespace Isis {
       QList< QString > GetCubeSerials() const;
       QString GraphToString() const;
       QList< QList< QString > > GetSerialConnections() const;
+      int getIslandCount() const;
+      int getIslandSize(QString serialNumber) const;
+      bool areConnected(QString firstSerial, QString secondSerial) const;
       int getEdgeCount() const;
       QList< QString > getAdjacentImages(QString serialNumber) const;
       QList< ControlMeasure * > GetMeasuresInCube(QString serialNumber);
@@ -394,6 +409,8 @@ namespace Isis {
       void pointAdded(ControlPoint *point);
       bool addEdge(QString sourceSerial, QString targetSerial);
       bool removeEdge(QString sourceSerial, QString targetSerial);
+      void addImageVertex(QString serial);
+      void updateValidMeasureCount(QString serial, int change);
 
     private: // graphing functions
       /**
@@ -426,9 +443,12 @@ namespace Isis {
 
       //! Used to define the verticies of the graph
       struct Image {
+        Image() : island(0), validMeasures(0) {}
         QString serial; //! The serial number associated with the image
+        int island; //! The number of the island the image is in
         //! The measures on the image, hashed by pointers to their parent ControlPoints
         QHash< ControlPoint *, ControlMeasure * > measures;
+        int validMeasures; //! The number of measures on the image that are not ignored
       };
 
       //! Used to define the edges of the graph.
@@ -461,6 +481,12 @@ namespace Isis {
 
       QHash<QString, ImageVertex> m_vertexMap; //! The serial number -> vertex hash used by the graph
       Network m_controlGraph; //! The ControlNet graph
+
+      void joinIslands(ImageVertex first, ImageVertex second);
+      void splitIslands(ImageVertex first, ImageVertex second);
+
+      QHash<int, int> m_islandSizes; //! The number of images in each island, by island number
+      int m_nextIsland; //! The number given to the next new island
       QStringList *pointIds;
       QMutex *m_mutex;
 
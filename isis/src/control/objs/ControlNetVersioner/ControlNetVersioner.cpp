@@ -11,8 +11,14 @@ find files of those names at the top level of this repository. **/
 #include <boost/numeric/ublas/symmetric.hpp>
 #include <boost/numeric/ublas/io.hpp>
 
+#include <algorithm>
+#include <numeric>
+
 #include <QDebug>
+#include <QMutex>
+#include <QMutexLocker>
 #include <QString>
+#include <QtConcurrentMap>
 
 #include "ControlNetFileHeaderV0002.pb.h"
 #include "ControlNetFileHeaderV0005.pb.h"
@@ -53,6 +59,12 @@ using namespace std;
 
 namespace Isis {
 
+  //! The most points read from a file and converted into ControlPoints at once
+  static const int PointBatchSize = 4096;
+
+  //! The most bytes of point messages read from a file at once
+  static const BigInt PointBatchBytes = 64 * 1024 * 1024;
+
   /**
    * Construct a ControlNetVersioner from a control network. This versioner can only be used to
    * write out the control points in the control network. It is expected that the control points
@@ -61,7 +73,9 @@ namespace Isis {
    * @param net A pointer to the network that will be written out.
    */
   ControlNetVersioner::ControlNetVersioner(ControlNet *net)
-      : m_ownsPoints(false) {
+      : m_ownsPoints(false), m_streamPoints(false), m_input(NULL), m_pointsBytesLeft(0),
+        m_pointsLeft(0), m_pointIndex(0), m_output(NULL), m_headerStartByte(0),
+        m_pointsBytes(0), m_pointsWritten(0), m_measuresWritten(0) {
     // Populate the internal list of points.
     m_points.append( net->GetPoints() );
 
@@ -84,11 +98,16 @@ namespace Isis {
    *
    * @param netFile The control network file to read in.
    * @param progress The progress object to track reading points.
+   * @param streamPoints If true, version 5 binary points are not read until they are taken
+   *                     with takeFirstPoint.
    *
    * @see ControlNetVersioner::Read
    */
-  ControlNetVersioner::ControlNetVersioner(const FileName netFile, Progress *progress)
-      : m_ownsPoints(true) {
+  ControlNetVersioner::ControlNetVersioner(const FileName netFile, Progress *progress,
+                                           bool streamPoints)
+      : m_ownsPoints(true), m_streamPoints(streamPoints), m_input(NULL), m_pointsBytesLeft(0),
+        m_pointsLeft(0), m_pointIndex(0), m_output(NULL), m_headerStartByte(0),
+        m_pointsBytes(0), m_pointsWritten(0), m_measuresWritten(0) {
     read(netFile, progress);
   }
 
@@ -98,6 +117,14 @@ namespace Isis {
    * they will also be deleted.
    */
   ControlNetVersioner::~ControlNetVersioner() {
+    closeInput();
+
+    if ( m_output ) {
+      m_output->close();
+      delete m_output;
+      m_output = NULL;
+    }
+
     if ( m_ownsPoints ) {
       while ( !m_points.isEmpty() ) {
         ControlPoint *unusedPoint = m_points.takeFirst();
@@ -169,12 +196,14 @@ namespace Isis {
 
 
   /**
-   * Returns the number of points that have been read in or are ready to write out.
+   * Returns the number of points that have been read in or are ready to write out. When
+   * streaming points, this includes the points that have not been read from the file yet if
+   * the file's label says how many points it has.
    *
    * @return @b int The number of control points stored internally.
    */
   int ControlNetVersioner::numPoints() const {
-    return m_points.size();
+    return m_points.size() + m_pointsLeft;
   }
 
 
@@ -182,11 +211,18 @@ namespace Isis {
    * Returns the first point stored in the versioner's internal list. This method passes ownership
    * of the point to the caller who is expected to delete it when done with it.
    *
+   * When streaming points, the next batch of points is read from the file if there are none in
+   * memory.
+   *
    * @return @b ControlPoint* A pointer to the control point. The caller assumes ownership of the
    *                          ControlPoint and is expected to delete it when done. If there are no
    *                          points to return, a NULL pointer is returned.
    */
   ControlPoint *ControlNetVersioner::takeFirstPoint() {
+    if ( m_points.isEmpty() && m_input ) {
+      readPointBatch();
+    }
+
     ControlPoint *point = NULL;
     if ( !m_points.isEmpty() ) {
       point = m_points.takeFirst();
@@ -1145,7 +1181,8 @@ namespace Isis {
 
   /**
    * Read a protobuf version 5 control network and prepare the data to be
-   *  converted into a control network.
+   *  converted into a control network. The points are read in batches by
+   *  readPointBatch(), right away or, when streaming, as they are taken.
    *
    * @param header The Pvl file header that contains byte offsets for the protobuf messages
    * @param netFile The filename of the control network file.
@@ -1154,7 +1191,6 @@ namespace Isis {
   void ControlNetVersioner::readProtobufV0005(const Pvl &header,
                                               const FileName netFile,
                                               Progress *progress) {
-
     // read the header protobuf object
     const PvlObject &protoBufferInfo = header.findObject("ProtoBuffer");
     const PvlObject &protoBufferCore = protoBufferInfo.findObject("Core");
@@ -1170,34 +1206,28 @@ namespace Isis {
     }
 
     input.seekg(headerStartPos, ios::beg);
-
     streampos filePos = input.tellg();
 
     ControlNetFileHeaderV0005 protoHeader;
     try {
-
       IstreamInputStream headerInStream(&input);
       CodedInputStream headerCodedInStream(&headerInStream);
-
       // max 512MB, warn at 400MB
       headerCodedInStream.SetTotalBytesLimit(1024 * 1024 * 512);
-
       CodedInputStream::Limit oldLimit = headerCodedInStream.PushLimit(headerLength);
-
       if ( !protoHeader.ParseFromCodedStream(&headerCodedInStream) ) {
         QString msg = "Failed to parse protobuf header from input control net file ["
                       + netFile.name() + "]";
         throw IException(IException::Io, msg, _FILEINFO_);
       }
-
       headerCodedInStream.PopLimit(oldLimit);
-
       filePos += headerLength;
     }
     catch (...) {
       QString msg = "An error occured while reading the protobuf control network header.";
       throw IException(IException::Io, msg, _FILEINFO_);
     }
+
     // initialize the header from the protobuf header
     try {
       ControlNetHeaderV0005 header;
@@ -1222,10 +1252,13 @@ namespace Isis {
     // read each protobuf control point and then initialize it
     // For some reason, reading the header causes the input stream to fail so reopen the file
     input.close();
-    input.open(netFile.expanded().toLatin1().data(), ios::in | ios::binary);
-    input.seekg(filePos, ios::beg);
-
-    IstreamInputStream pointInStream(&input);
+    m_input = new fstream(netFile.expanded().toLatin1().data(), ios::in | ios::binary);
+    if ( !m_input->is_open() ) {
+      closeInput();
+      QString msg = "Failed to open control network file" + netFile.name();
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
+    m_input->seekg(filePos, ios::beg);
 
     BigInt numberOfPoints = 0;
 
@@ -1242,53 +1275,152 @@ namespace Isis {
       }
     }
 
+    m_pointsBytesLeft = pointsLength;
+    m_pointsLeft = numberOfPoints;
+    m_pointIndex = 0;
+
+    // the points are read as they are taken
+    if ( m_streamPoints ) {
+      return;
+    }
+
     if (progress && numberOfPoints != 0) {
       progress->SetText("Reading Control Points...");
       progress->SetMaximumSteps(numberOfPoints);
       progress->CheckStatus();
     }
+    else {
+      progress = NULL;
+    }
 
-    Isis::EndianSwapper lsb("LSB");
-    int pointIndex = -1;
-    while (pointInStream.ByteCount() < pointsLength) {
-      pointIndex += 1;
-      QSharedPointer<ControlPointFileEntryV0002> newPoint(new ControlPointFileEntryV0002);
+    while ( m_input ) {
+      readPointBatch(progress);
+    }
+  }
 
-      try {
 
-        CodedInputStream pointCodedInStream(&pointInStream);
-        pointCodedInStream.SetTotalBytesLimit(1024 * 1024 * 512);
+  /**
+   * Read the next batch of version 5 protobuf control points from the input file and convert
+   * them into ControlPoints. The points are read one after another, then converted in
+   * parallel. The input file is closed once all of the points have been read.
+   *
+   * @param progress The progress object to track reading points.
+   *
+   * @return @b int The number of points read.
+   */
+  int ControlNetVersioner::readPointBatch(Progress *progress) {
+    if ( !m_input ) {
+      return 0;
+    }
 
-        uint32_t size;
-        pointCodedInStream.ReadRaw(reinterpret_cast<char *>(&size), sizeof(size));
+    Isis::EndianSwapper lsb("LSB");
+    int firstPointIndex = m_pointIndex;
+    QList<QByteArray> messages;
+    BigInt batchBytes = 0;
 
-        size = lsb.Uint32_t(&size);
+    while ( m_pointsBytesLeft > 0 && messages.size() < PointBatchSize &&
+            batchBytes < PointBatchBytes ) {
+      uint32_t size = 0;
+      m_input->read(reinterpret_cast<char *>(&size), sizeof(size));
+      size = lsb.Uint32_t(&size);
 
-        CodedInputStream::Limit oldPointLimit = pointCodedInStream.PushLimit(size);
-        newPoint->ParseFromCodedStream(&pointCodedInStream);
-        pointCodedInStream.PopLimit(oldPointLimit);
+      BigInt messageBytes = sizeof(size) + (BigInt) size;
+      QByteArray message;
+      if ( m_input->good() && messageBytes <= m_pointsBytesLeft ) {
+        message.resize(size);
+        m_input->read(message.data(), size);
       }
-      catch (...) {
+
+      if ( !m_input->good() || messageBytes > m_pointsBytesLeft ) {
+        closeInput();
         QString msg = "Failed to read protobuf version 2 control point at index ["
-                      + toString(pointIndex) + "].";
+                      + toString(m_pointIndex) + "].";
         throw IException(IException::Io, msg, _FILEINFO_);
       }
 
-      try {
-        ControlPointV0005 point(newPoint);
-        m_points.append( createPoint(point) );
+      messages.append(message);
+      m_pointsBytesLeft -= messageBytes;
+      batchBytes += messageBytes;
+      m_pointIndex++;
+    }
 
-        if (progress && numberOfPoints != 0) {
-          progress->CheckStatus();
-        }
+    std::vector<int> indices(messages.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    std::vector<ControlPoint *> points(messages.size(), NULL);
+
+    QMutex errorMutex;
+    int errorIndex = -1;
+    IException error;
+
+    QtConcurrent::blockingMap(indices,
+        [&](int &i) {
+          int pointIndex = firstPointIndex + i;
+          try {
+            QSharedPointer<ControlPointFileEntryV0002> newPoint(new ControlPointFileEntryV0002);
+            if ( !newPoint->ParseFromArray(messages[i].constData(), messages[i].size()) ) {
+              QString msg = "Failed to read protobuf version 2 control point at index ["
+                            + toString(pointIndex) + "].";
+              throw IException(IException::Io, msg, _FILEINFO_);
+            }
 
+            try {
+              ControlPointV0005 point(newPoint);
+              points[i] = createPoint(point);
+            }
+            catch (IException &e) {
+              QString msg = "Failed to convert protobuf version 2 control point at index ["
+                            + toString(pointIndex) + "] into a ControlPoint.";
+              throw IException(e, IException::Io, msg, _FILEINFO_);
+            }
+          }
+          catch (IException &e) {
+            // report the first bad point in the file, not the first one to fail
+            QMutexLocker locker(&errorMutex);
+            if ( errorIndex < 0 || i < errorIndex ) {
+              errorIndex = i;
+              error = e;
+            }
+          }
+        });
+
+    if ( errorIndex >= 0 ) {
+      for (unsigned int i = 0; i < points.size(); i++) {
+        delete points[i];
       }
-      catch (IException &e) {
-        QString msg = "Failed to convert protobuf version 2 control point at index ["
-                      + toString(pointIndex) + "] into a ControlPoint.";
-        throw IException(e, IException::Io, msg, _FILEINFO_);
+      closeInput();
+      throw error;
+    }
+
+    for (unsigned int i = 0; i < points.size(); i++) {
+      m_points.append(points[i]);
+
+      if (progress) {
+        progress->CheckStatus();
       }
     }
+
+    m_pointsLeft = std::max((BigInt) 0, m_pointsLeft - (BigInt) points.size());
+
+    if ( m_pointsBytesLeft <= 0 ) {
+      closeInput();
+    }
+
+    return points.size();
+  }
+
+
+  /**
+   * Close the file points are read from. Points that have not been read are dropped.
+   */
+  void ControlNetVersioner::closeInput() {
+    if ( m_input ) {
+      m_input->close();
+      delete m_input;
+      m_input = NULL;
+    }
+
+    m_pointsBytesLeft = 0;
+    m_pointsLeft = 0;
   }
 
 
@@ -1656,83 +1788,157 @@ namespace Isis {
    */
   void ControlNetVersioner::write(FileName netFile) {
     try {
+      beginWrite(netFile);
 
-      const int labelBytes = 65536;
-      fstream output(netFile.expanded().toLatin1().data(), ios::out | ios::trunc | ios::binary);
-      char *blankLabel = new char[labelBytes];
-      memset(blankLabel, 0, labelBytes);
-      output.write(blankLabel, labelBytes);
-      delete [] blankLabel;
+      while ( !m_points.isEmpty() ) {
+        ControlPoint *controlPoint = m_points.takeFirst();
+        writePoint(controlPoint);
 
-      int numMeasures = 0;
-      int numPoints = m_points.size();
-      foreach (ControlPoint *point, m_points) {
-        numMeasures += point->GetNumMeasures();
+        // Make sure that if the versioner owns the ControlPoint it is properly cleaned up.
+        if ( m_ownsPoints ) {
+          delete controlPoint;
+          controlPoint = NULL;
+        }
       }
 
-      streampos startCoreHeaderPos = output.tellp();
-
-      writeHeader(&output);
-
-      BigInt pointByteTotal = 0;
-      while ( !m_points.isEmpty() ) {
-         pointByteTotal += writeFirstPoint(&output);
+      endWrite();
+    }
+    catch (...) {
+      if ( m_output ) {
+        m_output->close();
+        delete m_output;
+        m_output = NULL;
       }
 
-      // Insert header at the beginning of the file once writing is done.
-      ControlNetFileHeaderV0005 protobufHeader;
+      QString msg = "Can't write control net file";
+      throw IException(IException::Io, msg, _FILEINFO_);
+    }
+  }
 
-      protobufHeader.set_networkid(m_header.networkID.toLatin1().data());
-      protobufHeader.set_targetname(m_header.targetName.toLatin1().data());
-      protobufHeader.set_created(m_header.created.toLatin1().data());
-      protobufHeader.set_lastmodified(m_header.lastModified.toLatin1().data());
-      protobufHeader.set_description(m_header.description.toLatin1().data());
-      protobufHeader.set_username(m_header.userName.toLatin1().data());
 
-      streampos coreHeaderSize = protobufHeader.ByteSizeLong();
+  /**
+   * Start writing a control network file one point at a time. This writes a blank space for the
+   * Pvl label and the protobuf header. The points are then written with writePoint and the file
+   * is finished with endWrite.
+   *
+   * @param netFile The output filename that will be written to
+   *
+   * @throws IException::Programmer "The versioner is already writing a control network file."
+   * @throws IException::Io "Failed to open control network file for writing."
+   */
+  void ControlNetVersioner::beginWrite(FileName netFile) {
+    if ( m_output ) {
+      QString msg = "The versioner is already writing a control network file.";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
 
-      Pvl p;
+    const int labelBytes = 65536;
+    m_output = new fstream(netFile.expanded().toLatin1().data(),
+                           ios::out | ios::trunc | ios::binary);
+    if ( !m_output->is_open() ) {
+      delete m_output;
+      m_output = NULL;
+      QString msg = "Failed to open control network file [" + netFile.name() + "] for writing.";
+      throw IException(IException::Io, msg, _FILEINFO_);
+    }
 
-      PvlObject protoObj("ProtoBuffer");
+    char *blankLabel = new char[labelBytes];
+    memset(blankLabel, 0, labelBytes);
+    m_output->write(blankLabel, labelBytes);
+    delete [] blankLabel;
 
-      PvlObject protoCore("Core");
-      protoCore.addKeyword(PvlKeyword("HeaderStartByte",
-                           toString((BigInt) startCoreHeaderPos)));
-      protoCore.addKeyword(PvlKeyword("HeaderBytes", toString((BigInt) coreHeaderSize)));
+    m_headerStartByte = (BigInt) m_output->tellp();
 
-      BigInt pointsStartByte = (BigInt) (startCoreHeaderPos + coreHeaderSize);
+    writeHeader(m_output);
 
-      protoCore.addKeyword(PvlKeyword("PointsStartByte", toString(pointsStartByte)));
+    m_pointsBytes = 0;
+    m_pointsWritten = 0;
+    m_measuresWritten = 0;
+  }
 
-      protoCore.addKeyword(PvlKeyword("PointsBytes",
-                           toString(pointByteTotal)));
-      protoObj.addObject(protoCore);
 
-      PvlGroup netInfo("ControlNetworkInfo");
-      netInfo.addComment("This group is for informational purposes only");
-      netInfo += PvlKeyword("NetworkId", protobufHeader.networkid().c_str());
-      netInfo += PvlKeyword("TargetName", protobufHeader.targetname().c_str());
-      netInfo += PvlKeyword("UserName", protobufHeader.username().c_str());
-      netInfo += PvlKeyword("Created", protobufHeader.created().c_str());
-      netInfo += PvlKeyword("LastModified", protobufHeader.lastmodified().c_str());
-      netInfo += PvlKeyword("Description", protobufHeader.description().c_str());
-      netInfo += PvlKeyword("NumberOfPoints", toString(numPoints));
-      netInfo += PvlKeyword("NumberOfMeasures", toString(numMeasures));
-      netInfo += PvlKeyword("Version", "5");
-      protoObj.addGroup(netInfo);
+  /**
+   * Write a control point to the file started with beginWrite. The versioner does not take
+   * ownership of the point, so it can be deleted as soon as this returns.
+   *
+   * @param point The control point to write.
+   *
+   * @throws IException::Programmer "The versioner is not writing a control network file."
+   */
+  void ControlNetVersioner::writePoint(ControlPoint *point) {
+    if ( !m_output ) {
+      QString msg = "The versioner is not writing a control network file.";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
 
-      p.addObject(protoObj);
+    m_pointsBytes += writeControlPoint(m_output, point);
+    m_pointsWritten++;
+    m_measuresWritten += point->GetNumMeasures();
+  }
 
-      output.seekp(0, ios::beg);
-      output << p;
-      output << '\n';
-      output.close();
 
+  /**
+   * Finish the file started with beginWrite by writing the Pvl label at the start of it.
+   *
+   * @throws IException::Programmer "The versioner is not writing a control network file."
+   */
+  void ControlNetVersioner::endWrite() {
+    if ( !m_output ) {
+      QString msg = "The versioner is not writing a control network file.";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
     }
-    catch (...) {
-      QString msg = "Can't write control net file";
-      throw IException(IException::Io, msg, _FILEINFO_);
-    }
+
+    // Insert header at the beginning of the file once writing is done.
+    ControlNetFileHeaderV0005 protobufHeader;
+
+    protobufHeader.set_networkid(m_header.networkID.toLatin1().data());
+    protobufHeader.set_targetname(m_header.targetName.toLatin1().data());
+    protobufHeader.set_created(m_header.created.toLatin1().data());
+    protobufHeader.set_lastmodified(m_header.lastModified.toLatin1().data());
+    protobufHeader.set_description(m_header.description.toLatin1().data());
+    protobufHeader.set_username(m_header.userName.toLatin1().data());
+
+    streampos coreHeaderSize = protobufHeader.ByteSizeLong();
+
+    Pvl p;
+
+    PvlObject protoObj("ProtoBuffer");
+
+    PvlObject protoCore("Core");
+    protoCore.addKeyword(PvlKeyword("HeaderStartByte",
+                         toString(m_headerStartByte)));
+    protoCore.addKeyword(PvlKeyword("HeaderBytes", toString((BigInt) coreHeaderSize)));
+
+    BigInt pointsStartByte = (BigInt) (m_headerStartByte + coreHeaderSize);
+
+    protoCore.addKeyword(PvlKeyword("PointsStartByte", toString(pointsStartByte)));
+
+    protoCore.addKeyword(PvlKeyword("PointsBytes",
+                         toString(m_pointsBytes)));
+    protoObj.addObject(protoCore);
+
+    PvlGroup netInfo("ControlNetworkInfo");
+    netInfo.addComment("This group is for informational purposes only");
+    netInfo += PvlKeyword("NetworkId", protobufHeader.networkid().c_str());
+    netInfo += PvlKeyword("TargetName", protobufHeader.targetname().c_str());
+    netInfo += PvlKeyword("UserName", protobufHeader.username().c_str());
+    netInfo += PvlKeyword("Created", protobufHeader.created().c_str());
+    netInfo += PvlKeyword("LastModified", protobufHeader.lastmodified().c_str());
+    netInfo += PvlKeyword("Description", protobufHeader.description().c_str());
+    netInfo += PvlKeyword("NumberOfPoints", toString(m_pointsWritten));
+    netInfo += PvlKeyword("NumberOfMeasures", toString(m_measuresWritten));
+    netInfo += PvlKeyword("Version", "5");
+    protoObj.addGroup(netInfo);
+
+    p.addObject(protoObj);
+
+    m_output->seekp(0, ios::beg);
+    *m_output << p;
+    *m_output << '\n';
+    m_output->close();
+
+    delete m_output;
+    m_output = NULL;
   }
 
  /**
@@ -1761,20 +1967,18 @@ namespace Isis {
 
 
  /**
-  * This will write the first control point to a file stream.
-  * The written point will be removed from the versioner and then deleted if the versioner
-  * has ownership of it.
+  * This will write a control point to a file stream.
   *
   * @param output A pointer to the fileStream that we are writing the point to.
+  * @param controlPoint The control point to write.
   *
-  * @return @b int The number of bytes written to the filestream.
+  * @return @b BigInt The number of bytes written to the filestream.
   */
-  int ControlNetVersioner::writeFirstPoint(fstream *output) {
+  BigInt ControlNetVersioner::writeControlPoint(fstream *output, ControlPoint *controlPoint) {
 
       BigInt startPos = output->tellp();
 
       ControlPointFileEntryV0002 protoPoint;
-      ControlPoint *controlPoint = m_points.takeFirst();
 
       if ( controlPoint->GetId().isEmpty() ) {
         QString msg = "Unbable to write first point of control net. "
@@ -2060,11 +2264,6 @@ namespace Isis {
         throw IException(IException::Programmer, err, _FILEINFO_);
       }
 
-      // Make sure that if the versioner owns the ControlPoint it is properly cleaned up.
-      if ( m_ownsPoints ) {
-        delete controlPoint;
-        controlPoint = NULL;
-      }
       BigInt currentPos = output->tellp();
       BigInt byteCount = currentPos - startPos;
 
@@ -9,12 +9,15 @@ find files of those names at the top level of this repository. **/
 
 /* SPDX-License-Identifier: CC0-1.0 */
 
+#include <fstream>
+
 #include <QString>
 
 #include <QList>
 #include <QSharedPointer>
 #include <QVector>
 
+#include "Constants.h"
 #include "ControlPoint.h"
 #include "ControlPointV0001.h"
 #include "ControlPointV0002.h"
@@ -79,6 +82,24 @@ namespace Isis {
    *   information about the control network can be accessed directly from the
    *   ControlNetVersioner.
    *
+   * Version 5 binary control points are read in batches and each batch is
+   *   converted into ControlPoints in parallel. If the versioner is
+   *   constructed with streamPoints set to true, only the header is read up
+   *   front and takeFirstPoint reads the next batch from the file when the
+   *   points in memory run out. This lets programs that look at one point at
+   *   a time work on networks that do not fit in memory:
+   *
+   * @code
+   *   ControlNetVersioner reader(netFile, NULL, true);
+   *   while ( ControlPoint *point = reader.takeFirstPoint() ) {
+   *     ...
+   *     delete point;
+   *   }
+   * @endcode
+   *
+   *   Other file formats can not be read one point at a time, so all of
+   *   their points are read up front either way.
+   *
    * <h3>Writing Control Network Files</h3>
    *
    * The protobuf file write routine is as follows:
@@ -107,6 +128,13 @@ namespace Isis {
    *        information about the control network.</li>
    * </ol>
    *
+   * The write method does all of this for the points stored in the versioner.
+   *   A network can also be written one point at a time with beginWrite,
+   *   writePoint and endWrite. In that case the versioner is constructed from
+   *   a ControlNet with no points in it that only holds the general
+   *   information about the network, and the points can be deleted as soon
+   *   as they are written.
+   *
    * Once the ControlNetVersioner is initialized from a file or a ControlNet,
    *   a Pvl formatted version of the control network can be created by the
    *   toPvl method. This will always output the control network in the latest
@@ -160,7 +188,7 @@ namespace Isis {
    *   method should be changed to write out the new protobuf format. If
    *   a new header container is added, the writeHeader method should be
    *   changed to write the new protobuf header to the file. If a new control
-   *   point container is added, the writeFirstPoint method should be changed
+   *   point container is added, the writeControlPoint method should be changed
    *   to write a new protobuf control point to the file.
    * </li>
    * <li>
@@ -408,12 +436,18 @@ namespace Isis {
    *                           for either coordinate type once the new header keyword is added.
    *
    *   @history 2018-07-03 Jesse Mapel - Removed target radii from versioner. References #5457.
+   *   @history 2026-10-16 ISIS Development Team - Version 5 binary points are read in batches
+   *                           that are converted in parallel. Added streaming reads with the
+   *                           streamPoints constructor argument, and beginWrite(), writePoint()
+   *                           and endWrite() to write a network one point at a time. Replaced
+   *                           writeFirstPoint() with writeControlPoint().
    */
   class ControlNetVersioner {
 
     public:
       ControlNetVersioner(ControlNet *net);
-      ControlNetVersioner(const FileName netFile, Progress *progress=NULL);
+      ControlNetVersioner(const FileName netFile, Progress *progress=NULL,
+                          bool streamPoints=false);
       ~ControlNetVersioner();
 
       QString netId() const;
@@ -429,6 +463,10 @@ namespace Isis {
       void write(FileName netFile);
       Pvl toPvl();
 
+      void beginWrite(FileName netFile);
+      void writePoint(ControlPoint *point);
+      void endWrite();
+
     private:
       // These three methods are private to ensure proper memory management
       //! Default constructor. Intentially un-implemented.
@@ -501,6 +539,8 @@ namespace Isis {
       void readProtobufV0001(const Pvl &header, const FileName netFile, Progress *progress=NULL);
       void readProtobufV0002(const Pvl &header, const FileName netFile, Progress *progress=NULL);
       void readProtobufV0005(const Pvl &header, const FileName netFile, Progress *progress=NULL);
+      int readPointBatch(Progress *progress=NULL);
+      void closeInput();
 
       ControlPoint *createPoint(ControlPointV0001 &point);
       ControlPoint *createPoint(ControlPointV0002 &point);
@@ -511,7 +551,7 @@ namespace Isis {
       void createHeader(const ControlNetHeaderV0001 header);
 
       void writeHeader(std::fstream *output);
-      int writeFirstPoint(std::fstream *output);
+      BigInt writeControlPoint(std::fstream *output, ControlPoint *controlPoint);
 
       ControlNetHeaderV0005 m_header; /**< Header containing information about
                                            the whole network.*/
@@ -522,6 +562,20 @@ namespace Isis {
                              This will be false when the versioner copied the points from an
                              esiting control network.*/
 
+      bool m_streamPoints; /**< Flag if points are read from the file as they are taken
+                                instead of all at once.*/
+      std::fstream *m_input; //!< The file points are read from, NULL when all have been read.
+      BigInt m_pointsBytesLeft; //!< The bytes of point messages that have not been read yet.
+      BigInt m_pointsLeft; /**< The points that have not been read yet, according to the file's
+                                label.*/
+      int m_pointIndex; //!< The index in the file of the next point to read.
+
+      std::fstream *m_output; //!< The file being written to by writePoint().
+      BigInt m_headerStartByte; //!< Where the protobuf header starts in the output file.
+      BigInt m_pointsBytes; //!< The bytes of point messages written so far.
+      int m_pointsWritten; //!< The number of points written so far.
+      int m_measuresWritten; //!< The number of measures written so far.
+
   };
 }
 #endif
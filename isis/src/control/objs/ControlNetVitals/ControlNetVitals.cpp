@@ -62,8 +62,6 @@ namespace Isis {
    */
   void ControlNetVitals::initializeVitals() {
 
-    m_islandList = m_controlNet->GetSerialConnections();
-
     m_numPoints = 0;
     m_numPointsIgnored = 0;
     m_numPointsLocked = 0;
@@ -495,7 +493,6 @@ namespace Isis {
         break;
       case ControlNet::GraphModified:
         emitHistoryEntry("Control Net Graph Modified", m_controlNet->GetNetworkId(), "", "");
-        m_islandList = m_controlNet->GetSerialConnections();
         break;
       default:
         // No operation.
@@ -530,7 +527,7 @@ namespace Isis {
    *  @return The number of islands present in the ControlNet Graph.
    */
   int ControlNetVitals::numIslands() {
-    return m_islandList.size();
+    return m_controlNet->getIslandCount();
   }
 
 
@@ -538,10 +535,13 @@ namespace Isis {
    *  This method is designed to return a QList containing each island present in the ControlNet.
    *
    *  Each island is composed of another QList containing the cube serials for all cubes in that island.
+   *  The lists are only built when they are asked for, because the network keeps track of its
+   *  islands as it is modified.
    *
    *  @return A QList containing a QList of cube serials for each island present in the Control Net.
    */
   const QList< QList<QString> > &ControlNetVitals::getIslands() {
+    m_islandList = m_controlNet->GetSerialConnections();
     return m_islandList;
   }
 
@@ -47,6 +47,9 @@ namespace Isis {
   *                            problem with numPointsBelowMeasureThreshold().
   *    @history 2018-07-03 Jesse Mapel - Fixed deleting control points not properly updating the
   *                            point counters.
+  *    @history 2026-10-16 ISIS Development Team - The number of islands comes from the network,
+  *                            which keeps it up to date, instead of listing the islands after
+  *                            every change to the graph. getIslands() lists them when called.
   */
   class ControlNetVitals : public QObject {
     Q_OBJECT
@@ -121,8 +124,8 @@ namespace Isis {
       //! The string providing details into the status of the network.
       QString m_statusDetails;
 
-      //! A QList containing every island in the net. Each island consists of a QList containing
-      //! All cube serials for that island.
+      //! A QList containing every island in the net the last time they were listed. Each island
+      //! consists of a QList containing all cube serials for that island.
       QList< QList< QString > > m_islandList;
 
       //! The measureCount maps track how many points/images have how many measures.
@@ -0,0 +1,135 @@
+/** This is free and unencumbered software released into the public domain.
+
+The authors of ISIS do not claim copyright on the contents of this file.
+For more details about the LICENSE terms and the AUTHORS, you will
+find files of those names at the top level of this repository. **/
+
+/* SPDX-License-Identifier: CC0-1.0 */
+
+#include "ControlStringPool.h"
+
+#include <QReadLocker>
+#include <QWriteLocker>
+
+#include "IException.h"
+
+namespace Isis {
+
+  /**
+   * Constructs an empty pool. Index 0 is always the empty string.
+   */
+  ControlStringPool::ControlStringPool() {
+    m_strings.append(QString());
+    m_indices.insert(QString(), 0);
+  }
+
+
+  /**
+   * Destroys the pool. Strings that were interned keep their data until the
+   * last copy of them is destroyed.
+   */
+  ControlStringPool::~ControlStringPool() {
+  }
+
+
+  /**
+   * Gets the pooled copy of a string, adding it to the pool if it is not
+   * already there.
+   *
+   * @param string The string to intern
+   *
+   * @return @b QString A string equal to the given one that shares its data
+   *                    with every other interned copy of it
+   */
+  QString ControlStringPool::intern(const QString &string) {
+    if (string.isEmpty()) {
+      return QString();
+    }
+    int stringIndex = index(string);
+    QReadLocker locker(&m_lock);
+    return m_strings[stringIndex];
+  }
+
+
+  /**
+   * Gets the index of a string, adding it to the pool if it is not already
+   * there.
+   *
+   * @param string The string to look up
+   *
+   * @return @b int The index of the string in the pool. The empty string is
+   *                always 0.
+   */
+  int ControlStringPool::index(const QString &string) {
+    if (string.isEmpty()) {
+      return 0;
+    }
+
+    {
+      QReadLocker locker(&m_lock);
+      QHash<QString, int>::const_iterator found = m_indices.constFind(string);
+      if (found != m_indices.constEnd()) {
+        return found.value();
+      }
+    }
+
+    QWriteLocker locker(&m_lock);
+    // Another thread may have added it while we waited for the lock
+    QHash<QString, int>::const_iterator found = m_indices.constFind(string);
+    if (found != m_indices.constEnd()) {
+      return found.value();
+    }
+
+    int newIndex = m_strings.size();
+    m_strings.append(string);
+    m_indices.insert(m_strings.last(), newIndex);
+    return newIndex;
+  }
+
+
+  /**
+   * @param index The index of a pooled string
+   *
+   * @return @b QString The pooled string
+   *
+   * @throws IException::Programmer "Invalid string pool index"
+   */
+  QString ControlStringPool::string(int index) const {
+    QReadLocker locker(&m_lock);
+    if (index < 0 || index >= m_strings.size()) {
+      QString msg = "Invalid string pool index [" + QString::number(index) + "], the pool has ["
+                    + QString::number(m_strings.size()) + "] strings";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
+    return m_strings[index];
+  }
+
+
+  /**
+   * @return @b int The number of strings in the pool, including the empty string
+   */
+  int ControlStringPool::size() const {
+    QReadLocker locker(&m_lock);
+    return m_strings.size();
+  }
+
+
+  /**
+   * @return @b ControlStringPool& The pool of cube serial numbers shared by all
+   *                               control networks
+   */
+  ControlStringPool &ControlStringPool::serialNumbers() {
+    static ControlStringPool pool;
+    return pool;
+  }
+
+
+  /**
+   * @return @b ControlStringPool& The pool of chooser names shared by all
+   *                               control networks
+   */
+  ControlStringPool &ControlStringPool::chooserNames() {
+    static ControlStringPool pool;
+    return pool;
+  }
+}
@@ -0,0 +1,69 @@
+#ifndef ControlStringPool_h
+#define ControlStringPool_h
+/** This is free and unencumbered software released into the public domain.
+
+The authors of ISIS do not claim copyright on the contents of this file.
+For more details about the LICENSE terms and the AUTHORS, you will
+find files of those names at the top level of this repository. **/
+
+/* SPDX-License-Identifier: CC0-1.0 */
+
+#include <QHash>
+#include <QReadWriteLock>
+#include <QString>
+#include <QVector>
+
+namespace Isis {
+
+  /**
+   * @brief An intern table for the strings stored in control networks
+   *
+   * A control network repeats the same few strings millions of times. Every
+   * measure on a cube has the same cube serial number, and the chooser names
+   * come from a handful of applications and definition files. Storing a copy
+   * of each one in every measure dominates the memory used by large networks.
+   *
+   * This class keeps one copy of each distinct string and gives it an integer
+   * index. Because QString is implicitly shared, the strings returned by
+   * intern share their data with the copy in the pool, so a string that is
+   * used by a million measures is stored once and each measure only holds a
+   * pointer to it. Copying an interned string does not allocate.
+   *
+   * Strings are never removed from a pool, so indices stay valid for the life
+   * of the program, and a long running program only uses as much memory for a
+   * pool as there are distinct strings. Only intern strings with few distinct
+   * values. Date times, which change every second, are not interned. All of
+   * the methods are thread safe.
+   *
+   * @ingroup ControlNetworks
+   *
+   * @author 2026-10-16 ISIS Development Team
+   *
+   * @internal
+   *   @history 2026-10-16 ISIS Development Team - Original version
+   *   @history 2026-10-17 ISIS Development Team - Renamed labels() to chooserNames(),
+   *                           date times are no longer pooled.
+   */
+  class ControlStringPool {
+    public:
+      ControlStringPool();
+      ~ControlStringPool();
+
+      QString intern(const QString &string);
+      int index(const QString &string);
+      QString string(int index) const;
+      int size() const;
+
+      static ControlStringPool &serialNumbers();
+      static ControlStringPool &chooserNames();
+
+    private:
+      Q_DISABLE_COPY(ControlStringPool)
+
+      mutable QReadWriteLock m_lock; //!< Guards the strings and indices
+      QVector<QString> m_strings;    //!< The pooled strings, in the order they were added
+      QHash<QString, int> m_indices; //!< The index of each pooled string
+  };
+};
+
+#endif
@@ -118,6 +118,9 @@ namespace Isis {
    *  @history 2020-06-09 Kristin Berry - Updated paintPixmap() to move getStretch out of inner
    *                          for loops. This provides a significant speed increase for qisis
    *                          applications with cube viewports.
+   *  @history 2026-10-17 ISIS Development Team - Added hasUnsavedChanges() so that
+   *                          the viewport buffer does not draw edited cubes from
+   *                          their overviews.
    */
   class CubeViewport : public QAbstractScrollArea {
       Q_OBJECT
@@ -220,6 +223,11 @@ namespace Isis {
         return p_cubeShown;
       };
 
+      //! @return if the cube has changes that have not been saved
+      bool hasUnsavedChanges() const {
+        return p_saveEnabled;
+      };
+
       //! @return the BandBin combo box count
       int comboCount() const {
         return p_comboCount;
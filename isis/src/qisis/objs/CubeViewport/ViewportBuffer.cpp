@@ -19,6 +19,7 @@ find files of those names at the top level of this repository. **/
 
 #include "Brick.h"
 #include "CubeDataThread.h"
+#include "CubeOverview.h"
 #include "CubeViewport.h"
 #include "SpecialPixel.h"
 #include "PixelType.h"
@@ -61,6 +62,9 @@ namespace Isis {
     p_requestedFillArea = 0.0;
     p_bricksOrdered = true;
 
+    p_overview = NULL;
+    p_overviewCube = NULL;
+
     connect(this, SIGNAL(ReadCube(int, int, int, int, int, int, void *)),
             p_dataThread, SLOT(ReadCube(int, int, int, int, int, int, void *)));
 
@@ -100,6 +104,9 @@ namespace Isis {
     }
 
     emptyBuffer(true);
+
+    delete p_overview;
+    p_overview = NULL;
   }
 
 
@@ -802,6 +809,12 @@ namespace Isis {
 
     action->started(true);
 
+    CubeOverview *fillOverview = overview();
+    if(fillOverview) {
+      fillFromOverview(action, fillOverview);
+      return;
+    }
+
     requestCubeLine(action);
 
     if(action->shouldRequestMore()) {
@@ -810,6 +823,85 @@ namespace Isis {
   }
 
 
+  /**
+   * Fills the entire rect of a fill action from an overview and removes the
+   * action from the queue. Nothing is requested from the cube data thread.
+   *
+   * @param action The fill action at the head of the queue
+   * @param overview The overview for the current scale
+   */
+  void ViewportBuffer::fillFromOverview(ViewportBufferFill *action,
+                                        CubeOverview *overview) {
+    const QRect *rect = action->getRect();
+    int physicalBand = p_viewport->cube()->physicalBand(p_band);
+
+    double maxSample = p_viewport->cubeSamples();
+    double maxLine = p_viewport->cubeLines();
+
+    for(int y = rect->top(); y <= rect->bottom(); y++) {
+      int yIndex = y - action->getTopmostPixelPosition();
+      if(yIndex < 0 || yIndex >= (int)p_buffer.size()) {
+        continue;
+      }
+
+      // Clamp to the cube like the brick reads do on the edges
+      double line = qBound(1.0, action->viewportToLine(y), maxLine);
+      vector<double> &bufferLine = p_buffer[yIndex];
+
+      for(int x = rect->left(); x <= rect->right(); x++) {
+        int xIndex = x - action->getLeftmostPixelPosition();
+        if(xIndex < 0 || xIndex >= (int)bufferLine.size()) {
+          continue;
+        }
+
+        double samp = qBound(1.0, action->viewportToSample(x), maxSample);
+        bufferLine[xIndex] = overview->cubeValue(samp, line, physicalBand);
+      }
+    }
+
+    p_actions->dequeue();
+    delete action;
+  }
+
+
+  /**
+   * Finds the overview to draw from at the viewport's current scale. The
+   * overview is read through the cube data thread the first time it is
+   * needed and kept until the scale calls for a different one, or until the
+   * cube no longer has it. Overviews are not used while the cube has unsaved
+   * edits, which they would not show.
+   *
+   * @return The overview, or NULL if the cube should be read instead
+   */
+  CubeOverview *ViewportBuffer::overview() {
+    Cube *cube = p_viewport->cube();
+    int scale = 0;
+    if(cube && !p_viewport->hasUnsavedChanges()) {
+      scale = CubeOverview::nearestScale(*cube, p_viewport->scale());
+    }
+
+    if(p_overview && (p_overviewCube != cube || p_overview->scale() != scale)) {
+      delete p_overview;
+      p_overview = NULL;
+      p_overviewCube = NULL;
+    }
+
+    if(!p_overview && scale > 0) {
+      try {
+        p_overview = p_dataThread->ReadOverview(p_cubeId, scale);
+        p_overviewCube = cube;
+      }
+      catch(IException &) {
+        // A damaged overview isn't worth failing the display over, the cube
+        //   itself is still there.
+        p_overview = NULL;
+      }
+    }
+
+    return p_overview;
+  }
+
+
   /**
    * Tells the cube viewport to restretch.
    *
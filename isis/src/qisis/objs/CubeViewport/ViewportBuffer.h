@@ -24,6 +24,7 @@ class QRect;
 
 namespace Isis {
   class CubeDataThread;
+  class CubeOverview;
   class Brick;
   class CubeViewport;
   class ViewportBufferAction;
@@ -59,6 +60,13 @@ namespace Isis {
    *                           and fill action creation
    *   @history 2011-06-20 Steven Lambright - Fixed panning issue where panning
    *                           beyond a full screen was a problem.
+   *   @history 2026-10-16 ISIS Development Team - Fill actions are satisfied
+   *                           from the cube's overviews, when it has them, if
+   *                           the viewport is zoomed out far enough.
+   *   @history 2026-10-17 ISIS Development Team - Overviews are read through
+   *                           the cube data thread.
+   *   @history 2026-10-17 ISIS Development Team - Overviews are not used while
+   *                           the cube has unsaved edits.
    */
   class ViewportBuffer : public QObject {
       Q_OBJECT
@@ -138,6 +146,8 @@ namespace Isis {
       void doTransformAction(ViewportBufferTransform *action);
       void doStretchAction(ViewportBufferStretch *action);
       void startFillAction(ViewportBufferFill *action);
+      void fillFromOverview(ViewportBufferFill *action, CubeOverview *overview);
+      CubeOverview *overview();
 
       ViewportBufferFill *createViewportBufferFill(QRect, bool);
 
@@ -200,6 +210,9 @@ namespace Isis {
       QQueue< ViewportBufferAction * > * p_actions;
 
       bool p_bricksOrdered;
+
+      CubeOverview *p_overview; //!< The overview for the current scale, if any
+      Cube *p_overviewCube; //!< The cube p_overview was read from
   };
 }
 
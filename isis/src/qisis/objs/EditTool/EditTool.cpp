@@ -23,6 +23,7 @@ find files of those names at the top level of this repository. **/
 
 #include "Brick.h"
 #include "Cube.h"
+#include "CubeOverview.h"
 #include "MdiCubeViewport.h"
 #include "RubberBandTool.h"
 #include "SpecialPixel.h"
@@ -789,6 +790,10 @@ m_container = container;
       }
       p_saveMarker[vp] = marker;
 
+      // The overviews no longer match the saved DNs. Until now they were
+      //   only set aside, so that discarding the edits keeps them.
+      CubeOverview::remove(*vp->cube());
+
       p_saveButton->setEnabled(false);
       vp->cubeChanged(false);
       vp->setCaption();
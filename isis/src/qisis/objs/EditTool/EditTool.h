@@ -66,6 +66,10 @@ namespace Isis {
    *                            attempting to open it with "rw" permission failed. This fixes an issue
    *                            where the cube would segfault if it was being edited without "w" permission.
    *                            Fixes # 2097
+   *   @history  2026-10-17 ISIS Development Team - Saving edited DNs removes the
+   *                            cube's overviews, which would no longer match them.
+   *                            Viewports do not draw from them while the edits are
+   *                            unsaved, and discarding the edits keeps them.
    */
   class EditTool : public Tool {
       Q_OBJECT
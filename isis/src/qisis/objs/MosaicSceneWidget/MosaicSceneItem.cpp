@@ -15,6 +15,7 @@
 #include <QStyleOptionGraphicsItem>
 #include <QTreeWidgetItem>
 
+#include "CubeOverview.h"
 #include "Directory.h"
 #include "DisplayProperties.h"
 #include "FileDialog.h"
@@ -687,23 +688,40 @@ namespace Isis {
    *
    * The first time this is called the stretch is calculated, later calls
    *   re-use the original object. Ownership remains at the class scope.
+   *   Large cubes with overviews are sampled from an overview, unless it can't
+   *   be read.
    */
   Stretch *MosaicSceneItem::getStretch() {
     if (m_cubeDnStretch != NULL || !m_image) return m_cubeDnStretch;
 
-    LineManager mgr(*m_image->cube());
-
-    mgr.begin();
     Statistics stats;
+    bool sampled = false;
 
-    const int skip = 0;
+    int overviewScale = CubeOverview::samplingScale(*m_image->cube());
+    if (overviewScale > 0) {
+      try {
+        CubeOverview overview = CubeOverview::read(*m_image->cube(), overviewScale);
 
-    while(mgr ++) {
-      m_image->cube()->read(mgr);
-      stats.AddData(mgr.DoubleBuffer(), mgr.size());
+        for (int band = 1; band <= overview.bandCount(); band++) {
+          QVector<double> values = overview.bandValues(band);
+          stats.AddData(values.constData(), values.size());
+        }
+        sampled = true;
+      }
+      catch (IException &) {
+        // Read the cube itself if the overview is damaged
+      }
+    }
+
+    if (!sampled) {
+      LineManager mgr(*m_image->cube());
 
-      for(int i = 0; i < skip; i++)
-        mgr ++;
+      mgr.begin();
+
+      while(mgr ++) {
+        m_image->cube()->read(mgr);
+        stats.AddData(mgr.DoubleBuffer(), mgr.size());
+      }
     }
 
     m_cubeDnStretch = new Stretch();
@@ -43,6 +43,10 @@ namespace Isis {
    *                          appear as 1 pixel wide on screen (Qt4 to Qt5).
    *  @history 2017-07-27 Makayla Shepherd - Fixed a segfault that occurred when closing a cube
    *                          footprint. Fixes #5050.
+   *  @history 2026-10-16 ISIS Development Team - getStretch() samples large cubes
+   *                          from an overview when the cube has them.
+   *  @history 2026-10-17 ISIS Development Team - getStretch() reads the cube in
+   *                          full when its overview is damaged.
    */
   class MosaicSceneItem : public QGraphicsObject {
       Q_OBJECT
@@ -20,6 +20,7 @@
 #include "AdvancedStretchDialog.h"
 #include "Brick.h"
 #include "Blob.h"
+#include "CubeOverview.h"
 #include "CubeViewport.h"
 #include "Histogram.h"
 #include "IException.h"
@@ -1531,7 +1532,8 @@ namespace Isis {
 
   /**
    * This method will calculate and return the statistics for a given cube and
-   * band.
+   * band. Large cubes with overviews are sampled from an overview instead of
+   * being read in full, unless the overview can't be read.
    *
    * @param cube
    * @param band
@@ -1540,6 +1542,21 @@ namespace Isis {
    */
   Statistics StretchTool::statsFromCube(Cube *cube, int band) {
     Statistics stats;
+
+    int overviewScale = CubeOverview::samplingScale(*cube);
+    if(overviewScale > 0) {
+      try {
+        QVector<double> values = CubeOverview::read(*cube, overviewScale).bandValues(
+            cube->physicalBand(band));
+        stats.AddData(values.constData(), values.size());
+        return stats;
+      }
+      catch(IException &) {
+        // A damaged overview isn't worth failing the stretch over, read the
+        //   cube itself instead
+      }
+    }
+
     Brick brick(cube->sampleCount(), 1, 1, cube->pixelType());
 
     for(int line = 0; line < cube->lineCount(); line++) {
@@ -1587,7 +1604,8 @@ namespace Isis {
 
   /**
    * This method will calculate and return the histogram for a given cube and
-   * band.
+   * band. Large cubes with overviews are sampled from an overview instead of
+   * being read in full, unless the overview can't be read.
    *
    * @param cube
    * @param band
@@ -1599,6 +1617,21 @@ namespace Isis {
   Histogram StretchTool::histFromCube(Cube *cube, int band,
       double min, double max) {
     Histogram hist(min, max);
+
+    int overviewScale = CubeOverview::samplingScale(*cube);
+    if(overviewScale > 0) {
+      try {
+        QVector<double> values = CubeOverview::read(*cube, overviewScale).bandValues(
+            cube->physicalBand(band));
+        hist.AddData(values.constData(), values.size());
+        return hist;
+      }
+      catch(IException &) {
+        // A damaged overview isn't worth failing the stretch over, read the
+        //   cube itself instead
+      }
+    }
+
     Brick brick(cube->sampleCount(), 1, 1, cube->pixelType());
 
     for(int line = 0; line < cube->lineCount(); line++) {
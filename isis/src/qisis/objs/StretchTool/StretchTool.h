@@ -81,6 +81,11 @@ namespace Isis {
    *                          to apply a stretch while the cube is still loading. This
    *                          crash was caused by an unhandled exception being thrown
    *                          in a connected slot. Fixes #2117.
+   *  @history 2026-10-16 ISIS Development Team - statsFromCube() and histFromCube()
+   *                          sample large cubes from an overview when the cube has
+   *                          them.
+   *  @history 2026-10-17 ISIS Development Team - statsFromCube() and histFromCube()
+   *                          read the cube in full when its overview is damaged.
    */
   class StretchTool : public Tool {
       Q_OBJECT
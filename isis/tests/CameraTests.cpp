@@ -1,5 +1,10 @@
 #include <iostream>
+#include <QFuture>
+#include <QList>
+#include <QPointF>
 #include <QTemporaryFile>
+#include <QVector>
+#include <QtConcurrent>
 
 
 #include "Cube.h"
@@ -9,6 +14,8 @@
 #include "Pvl.h"
 #include "PvlGroup.h"
 #include "PvlKeyword.h"
+#include "SpecialPixel.h"
+#include "SurfacePoint.h"
 #include "TestUtilities.h"
 #include "FileName.h"
 #include "Camera.h"
@@ -37,3 +44,107 @@ TEST_F(DemCube, CameraObliqueResolution) {
     EXPECT_NEAR(c->ObliqueDetectorResolution(false), 19.2788, 1e-4);
     EXPECT_NEAR(c->ObliqueDetectorResolution(), 19.3449, 1e-4);
 }
+
+
+TEST_F(DefaultCube, CameraBatchMatchesScalar) {
+  Camera *cam = testCube->camera();
+
+  QVector<QPointF> imagePoints;
+  imagePoints << QPointF(1, 1) << QPointF(200.5, 300.25) << QPointF(1056, 1204)
+              << QPointF(-5000, -5000);
+
+  cam->SetImage(7, 9);
+  double latitude = cam->UniversalLatitude();
+
+  QVector<SurfacePoint> groundPoints = cam->imageToGround(imagePoints);
+  ASSERT_EQ(imagePoints.size(), groundPoints.size());
+
+  // The camera is left where it was
+  EXPECT_DOUBLE_EQ(7, cam->Sample());
+  EXPECT_DOUBLE_EQ(9, cam->Line());
+  EXPECT_DOUBLE_EQ(latitude, cam->UniversalLatitude());
+
+  for (int i = 0; i < imagePoints.size(); i++) {
+    bool success = cam->SetImage(imagePoints[i].x(), imagePoints[i].y());
+    ASSERT_EQ(success, groundPoints[i].Valid()) << "Point " << i;
+    if (success) {
+      SurfacePoint expected = cam->GetSurfacePoint();
+      EXPECT_EQ(expected.GetX().meters(), groundPoints[i].GetX().meters());
+      EXPECT_EQ(expected.GetY().meters(), groundPoints[i].GetY().meters());
+      EXPECT_EQ(expected.GetZ().meters(), groundPoints[i].GetZ().meters());
+    }
+  }
+
+  QVector<SurfacePoint> validPoints;
+  validPoints << groundPoints[0] << groundPoints[1] << groundPoints[2];
+  QVector<QPointF> backToImage = cam->groundToImage(validPoints);
+  ASSERT_EQ(validPoints.size(), backToImage.size());
+
+  for (int i = 0; i < validPoints.size(); i++) {
+    ASSERT_TRUE(cam->SetGround(validPoints[i]));
+    EXPECT_EQ(cam->Sample(), backToImage[i].x());
+    EXPECT_EQ(cam->Line(), backToImage[i].y());
+  }
+}
+
+
+TEST_F(DefaultCube, CameraBatchKeepsGroundPosition) {
+  Camera *cam = testCube->camera();
+
+  ASSERT_TRUE(cam->SetImage(200.3, 300.7));
+  ASSERT_TRUE(cam->SetUniversalGround(cam->UniversalLatitude() + 0.001,
+                                      cam->UniversalLongitude() - 0.001));
+  double latitude = cam->UniversalLatitude();
+  double longitude = cam->UniversalLongitude();
+  double sample = cam->Sample();
+  double line = cam->Line();
+
+  QVector<QPointF> imagePoints;
+  imagePoints << QPointF(1, 1) << QPointF(500, 500);
+  cam->imageToGround(imagePoints);
+
+  EXPECT_EQ(latitude, cam->UniversalLatitude());
+  EXPECT_EQ(longitude, cam->UniversalLongitude());
+  EXPECT_DOUBLE_EQ(sample, cam->Sample());
+  EXPECT_DOUBLE_EQ(line, cam->Line());
+
+  QVector<SurfacePoint> groundPoints = cam->imageToGround(imagePoints);
+  ASSERT_TRUE(cam->SetGround(groundPoints[1]));
+  latitude = cam->UniversalLatitude();
+  longitude = cam->UniversalLongitude();
+  cam->groundToImage(groundPoints);
+
+  EXPECT_EQ(latitude, cam->UniversalLatitude());
+  EXPECT_EQ(longitude, cam->UniversalLongitude());
+}
+
+TEST_F(DefaultCube, CameraBatchFromThreads) {
+  Camera *cam = testCube->camera();
+
+  QVector<QPointF> imagePoints;
+  for (int line = 1; line <= 1000; line += 111) {
+    for (int sample = 1; sample <= 1000; sample += 111) {
+      imagePoints << QPointF(sample, line);
+    }
+  }
+  QVector<SurfacePoint> expected = cam->imageToGround(imagePoints);
+
+  // Several threads sharing one camera all get the serial answer
+  QList< QFuture< QVector<SurfacePoint> > > futures;
+  for (int i = 0; i < 4; i++) {
+    futures.append(QtConcurrent::run(cam, &Camera::imageToGround, imagePoints));
+  }
+
+  for (int i = 0; i < futures.size(); i++) {
+    QVector<SurfacePoint> groundPoints = futures[i].result();
+    ASSERT_EQ(expected.size(), groundPoints.size());
+    for (int j = 0; j < expected.size(); j++) {
+      EXPECT_EQ(expected[j].Valid(), groundPoints[j].Valid());
+      if (expected[j].Valid()) {
+        EXPECT_EQ(expected[j].GetX().meters(), groundPoints[j].GetX().meters());
+        EXPECT_EQ(expected[j].GetLatitude().degrees(),
+                  groundPoints[j].GetLatitude().degrees());
+      }
+    }
+  }
+}
@@ -0,0 +1,182 @@
+#include <QString>
+#include <QStringList>
+
+#include "ControlMeasure.h"
+#include "ControlNet.h"
+#include "ControlPoint.h"
+#include "IException.h"
+
+#include "gtest/gtest.h"
+
+using namespace Isis;
+
+namespace {
+  ControlPoint *makePoint(QString id, QStringList serials) {
+    ControlPoint *point = new ControlPoint(id);
+    foreach (QString serial, serials) {
+      ControlMeasure *measure = new ControlMeasure;
+      measure->SetCubeSerialNumber(serial);
+      point->Add(measure);
+    }
+    return point;
+  }
+}
+
+
+class ControlNetIslands : public ::testing::Test {
+  protected:
+    ControlNet net;
+
+    void SetUp() override {
+      net.AddPoint(makePoint("p0", QStringList() << "A" << "B"));
+      net.AddPoint(makePoint("p1", QStringList() << "B" << "C"));
+      net.AddPoint(makePoint("p2", QStringList() << "D" << "E"));
+    }
+
+    void expectIslands(int count) {
+      EXPECT_EQ(count, net.getIslandCount());
+      EXPECT_EQ(count, net.GetSerialConnections().size());
+    }
+};
+
+
+TEST_F(ControlNetIslands, Added) {
+  expectIslands(2);
+  EXPECT_EQ(3, net.getIslandSize("A"));
+  EXPECT_EQ(2, net.getIslandSize("E"));
+  EXPECT_TRUE(net.areConnected("A", "C"));
+  EXPECT_FALSE(net.areConnected("A", "D"));
+
+  // A measure added to a point that is already in the network
+  ControlMeasure *measure = new ControlMeasure;
+  measure->SetCubeSerialNumber("D");
+  net.GetPoint("p1")->Add(measure);
+  expectIslands(1);
+  EXPECT_EQ(5, net.getIslandSize("E"));
+  EXPECT_TRUE(net.areConnected("A", "E"));
+
+  // A cube that is only in a point by itself is an island
+  net.AddPoint(makePoint("p3", QStringList() << "F"));
+  expectIslands(2);
+  EXPECT_EQ(1, net.getIslandSize("F"));
+
+  EXPECT_THROW(net.getIslandSize("G"), IException);
+  EXPECT_THROW(net.areConnected("A", "G"), IException);
+}
+
+
+TEST_F(ControlNetIslands, IgnoredMeasures) {
+  ControlMeasure *measure = net.GetPoint("p1")->GetMeasure("C");
+  measure->SetIgnored(true);
+  expectIslands(3);
+  EXPECT_EQ(2, net.getIslandSize("A"));
+  EXPECT_FALSE(net.areConnected("B", "C"));
+  EXPECT_EQ(0, net.GetNumberOfValidMeasuresInImage("C"));
+  EXPECT_EQ(2, net.GetNumberOfValidMeasuresInImage("B"));
+
+  measure->SetIgnored(false);
+  expectIslands(2);
+  EXPECT_TRUE(net.areConnected("A", "C"));
+  EXPECT_EQ(1, net.GetNumberOfValidMeasuresInImage("C"));
+}
+
+
+TEST_F(ControlNetIslands, IgnoredPoints) {
+  ControlPoint *point = net.GetPoint("p0");
+  point->SetIgnored(true);
+  expectIslands(3);
+  EXPECT_FALSE(net.areConnected("A", "B"));
+  EXPECT_TRUE(net.areConnected("B", "C"));
+
+  // Measures on ignored points are still valid measures on their cubes
+  EXPECT_EQ(1, net.GetNumberOfValidMeasuresInImage("A"));
+  point->GetMeasure("A")->SetIgnored(true);
+  EXPECT_EQ(0, net.GetNumberOfValidMeasuresInImage("A"));
+  point->GetMeasure("A")->SetIgnored(false);
+
+  point->SetIgnored(false);
+  expectIslands(2);
+  EXPECT_TRUE(net.areConnected("A", "C"));
+}
+
+
+TEST_F(ControlNetIslands, Deleted) {
+  net.AddPoint(makePoint("p3", QStringList() << "C" << "D"));
+  expectIslands(1);
+
+  net.DeletePoint("p1");
+  expectIslands(2);
+  EXPECT_EQ(2, net.getIslandSize("A"));
+  EXPECT_EQ(3, net.getIslandSize("C"));
+  EXPECT_EQ(1, net.GetNumberOfValidMeasuresInImage("C"));
+
+  net.GetPoint("p3")->Delete("D");
+  expectIslands(3);
+  EXPECT_EQ(1, net.getIslandSize("C"));
+  EXPECT_EQ(1, net.GetNumberOfValidMeasuresInImage("C"));
+  EXPECT_EQ(1, net.GetNumberOfValidMeasuresInImage("D"));
+
+  // Images are not removed from the network when their measures are
+  EXPECT_EQ(5, net.GetCubeSerials().size());
+  EXPECT_THROW(net.GetNumberOfValidMeasuresInImage("G"), IException);
+}
+
+
+TEST_F(ControlNetIslands, Swapped) {
+  ControlNet other;
+  other.AddPoint(makePoint("q0", QStringList() << "X" << "Y"));
+  net.swap(other);
+  expectIslands(1);
+  EXPECT_TRUE(net.areConnected("X", "Y"));
+  EXPECT_EQ(2, other.getIslandCount());
+  EXPECT_TRUE(other.areConnected("A", "C"));
+
+  net.clear();
+  expectIslands(0);
+}
+
+
+TEST(ControlNetIslandsSplit, ChainOfImages) {
+  const int imageCount = 10;
+
+  ControlNet net;
+  for (int i = 0; i < imageCount - 1; i++) {
+    net.AddPoint(makePoint(QString("Point%1").arg(i),
+                           QStringList() << QString("Image%1").arg(i)
+                                         << QString("Image%1").arg(i + 1)));
+  }
+  EXPECT_EQ(1, net.getIslandCount());
+  EXPECT_EQ(imageCount, net.getIslandSize("Image0"));
+
+  // Closing the chain into a ring means no single break splits it
+  net.AddPoint(makePoint("Ring", QStringList() << QString("Image%1").arg(imageCount - 1)
+                                               << "Image0"));
+  net.GetPoint("Point4")->SetIgnored(true);
+  EXPECT_EQ(1, net.getIslandCount());
+  EXPECT_TRUE(net.areConnected("Image4", "Image5"));
+
+  // A second break does
+  net.GetPoint("Point1")->SetIgnored(true);
+  EXPECT_EQ(2, net.getIslandCount());
+  EXPECT_EQ(3, net.getIslandSize("Image2"));
+  EXPECT_EQ(imageCount - 3, net.getIslandSize("Image0"));
+  EXPECT_TRUE(net.areConnected("Image2", "Image4"));
+  EXPECT_FALSE(net.areConnected("Image1", "Image2"));
+  EXPECT_TRUE(net.areConnected("Image1", "Image5"));
+  EXPECT_EQ(2, net.GetSerialConnections().size());
+
+  // Mending either break joins them again
+  net.GetPoint("Point4")->SetIgnored(false);
+  EXPECT_EQ(1, net.getIslandCount());
+  EXPECT_EQ(imageCount, net.getIslandSize("Image2"));
+  net.GetPoint("Point1")->SetIgnored(false);
+  EXPECT_EQ(1, net.getIslandCount());
+
+  // Breaking every link leaves every image by itself
+  for (int i = 0; i < imageCount - 1; i++) {
+    net.GetPoint(QString("Point%1").arg(i))->SetIgnored(true);
+  }
+  net.GetPoint("Ring")->SetIgnored(true);
+  EXPECT_EQ(imageCount, net.getIslandCount());
+  EXPECT_EQ(1, net.getIslandSize("Image3"));
+}
@@ -0,0 +1,186 @@
+#include <QFile>
+#include <QString>
+
+#include "ControlMeasure.h"
+#include "ControlNet.h"
+#include "ControlNetVersioner.h"
+#include "ControlPoint.h"
+#include "FileName.h"
+#include "IException.h"
+#include "TempFixtures.h"
+
+#include "gtest/gtest.h"
+
+using namespace Isis;
+
+namespace {
+  // More than one batch of points so streaming has to go back to the file
+  const int NumPoints = 10000;
+
+  QString pointId(int index) {
+    return "Point" + QString::number(index);
+  }
+
+
+  QString writeNetwork(const QString &fileName) {
+    ControlNet net;
+    net.SetNetworkId("StreamTest");
+    net.SetTarget("Mars");
+    net.SetUserName("tester");
+    net.SetDescription("Network for streaming tests");
+
+    for (int i = 0; i < NumPoints; i++) {
+      ControlPoint *point = new ControlPoint(pointId(i));
+      point->SetType(ControlPoint::Free);
+      for (int j = 0; j < 3; j++) {
+        ControlMeasure *measure = new ControlMeasure;
+        measure->SetCubeSerialNumber("Image" + QString::number((i + j) % 25));
+        measure->SetCoordinate(i * 0.5 + j, i * 0.25 - j);
+        point->Add(measure);
+      }
+      net.AddPoint(point);
+    }
+
+    net.Write(fileName);
+    return fileName;
+  }
+}
+
+
+TEST_F(TempTestingFiles, ControlNetVersionerStreamRead) {
+  QString netFile = writeNetwork(tempDir.path() + "/stream.net");
+
+  ControlNetVersioner reader(FileName(netFile), NULL, true);
+  EXPECT_EQ("StreamTest", reader.netId());
+  EXPECT_EQ("Mars", reader.targetName());
+  EXPECT_EQ(NumPoints, reader.numPoints());
+
+  int index = 0;
+  while ( ControlPoint *point = reader.takeFirstPoint() ) {
+    ASSERT_EQ(pointId(index), point->GetId());
+    ASSERT_EQ(3, point->GetNumMeasures());
+    EXPECT_DOUBLE_EQ(index * 0.5 + 2, point->GetMeasure(2)->GetSample());
+    EXPECT_DOUBLE_EQ(index * 0.25 - 2, point->GetMeasure(2)->GetLine());
+    delete point;
+    index++;
+
+    EXPECT_EQ(NumPoints - index, reader.numPoints());
+  }
+
+  EXPECT_EQ(NumPoints, index);
+}
+
+
+TEST_F(TempTestingFiles, ControlNetVersionerIncrementalWrite) {
+  QString inFile = writeNetwork(tempDir.path() + "/in.net");
+  QString outFile = tempDir.path() + "/out.net";
+
+  {
+    ControlNetVersioner reader(FileName(inFile), NULL, true);
+
+    ControlNet header;
+    header.SetNetworkId(reader.netId());
+    header.SetTarget(reader.targetName());
+    header.SetUserName(reader.userName());
+    header.SetCreatedDate(reader.creationDate());
+    header.SetModifiedDate(reader.lastModificationDate());
+    header.SetDescription(reader.description());
+
+    ControlNetVersioner writer(&header);
+    writer.beginWrite(FileName(outFile));
+
+    int index = 0;
+    while ( ControlPoint *point = reader.takeFirstPoint() ) {
+      if (index % 2 == 0) {
+        writer.writePoint(point);
+      }
+      delete point;
+      index++;
+    }
+
+    writer.endWrite();
+  }
+
+  ControlNet filtered(outFile);
+  EXPECT_EQ("StreamTest", filtered.GetNetworkId());
+  EXPECT_EQ("Network for streaming tests", filtered.Description());
+  ASSERT_EQ(NumPoints / 2, filtered.GetNumPoints());
+  EXPECT_EQ(3 * NumPoints / 2, filtered.GetNumMeasures());
+  for (int i = 0; i < filtered.GetNumPoints(); i++) {
+    ASSERT_EQ(pointId(2 * i), filtered.GetPoint(i)->GetId());
+  }
+}
+
+
+TEST_F(TempTestingFiles, ControlNetVersionerTruncatedFile) {
+  QString netFile = writeNetwork(tempDir.path() + "/truncated.net");
+
+  QFile file(netFile);
+  ASSERT_TRUE(file.resize(file.size() - 100));
+
+  try {
+    ControlNetVersioner reader(FileName(netFile), NULL, true);
+    while ( ControlPoint *point = reader.takeFirstPoint() ) {
+      delete point;
+    }
+    FAIL() << "Expected an exception for a truncated network";
+  }
+  catch (IException &e) {
+    EXPECT_TRUE(e.toString().contains("Failed to read protobuf version 2 control point"))
+        << e.toString().toStdString();
+  }
+
+  // Reading all of the points up front reports the same problem
+  EXPECT_THROW(ControlNet net(netFile), IException);
+}
+
+
+TEST_F(TempTestingFiles, ControlNetVersionerReadsVersion2And5) {
+  // Version 2 stores the size of every point message in the header
+  QString version2File = "data/isisminer/cnetreader/Alph_VIS.net";
+  ControlNet version2(version2File);
+  EXPECT_EQ("THM_IMG_NET", version2.GetNetworkId());
+  EXPECT_EQ("Themis IR IMAGE NETWORK", version2.Description());
+  ASSERT_EQ(54, version2.GetNumPoints());
+  EXPECT_EQ(54, version2.GetNumMeasures());
+
+  // Version 2 can't be streamed, so the points are all read up front
+  {
+    ControlNetVersioner reader(FileName(version2File), NULL, true);
+    EXPECT_EQ(54, reader.numPoints());
+    int index = 0;
+    while ( ControlPoint *point = reader.takeFirstPoint() ) {
+      ASSERT_LT(index, version2.GetNumPoints());
+      EXPECT_EQ(version2.GetPoint(index)->GetId(), point->GetId());
+      delete point;
+      index++;
+    }
+    EXPECT_EQ(54, index);
+  }
+
+  // Version 5 prefixes every point message with its size
+  QString version5File = tempDir.path() + "/version5.net";
+  version2.Write(version5File);
+  ControlNet version5(version5File);
+  EXPECT_EQ(version2.GetNetworkId(), version5.GetNetworkId());
+  ASSERT_EQ(version2.GetNumPoints(), version5.GetNumPoints());
+  ASSERT_EQ(version2.GetNumMeasures(), version5.GetNumMeasures());
+  for (int i = 0; i < version2.GetNumPoints(); i++) {
+    ControlPoint *expected = version2.GetPoint(i);
+    ControlPoint *actual = version5.GetPoint(i);
+    ASSERT_EQ(expected->GetId(), actual->GetId());
+    ASSERT_EQ(expected->GetNumMeasures(), actual->GetNumMeasures());
+    for (int j = 0; j < expected->GetNumMeasures(); j++) {
+      EXPECT_EQ(expected->GetMeasure(j)->GetCubeSerialNumber(),
+                actual->GetMeasure(j)->GetCubeSerialNumber());
+      EXPECT_DOUBLE_EQ(expected->GetMeasure(j)->GetSample(), actual->GetMeasure(j)->GetSample());
+      EXPECT_DOUBLE_EQ(expected->GetMeasure(j)->GetLine(), actual->GetMeasure(j)->GetLine());
+    }
+  }
+
+  // A version 5 network written by an earlier release
+  ControlNet released("data/miniRFImage/Cabeus_Orbit400_withSS_AprioriPts.net");
+  EXPECT_EQ("Cabeus", released.GetNetworkId());
+  EXPECT_EQ(134, released.GetNumPoints());
+  EXPECT_EQ(330, released.GetNumMeasures());
+}
@@ -0,0 +1,213 @@
+#if defined(__linux__)
+#include <malloc.h>
+#endif
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QSet>
+#include <QString>
+
+#include "ControlMeasure.h"
+#include "ControlMeasureLogData.h"
+#include "ControlNet.h"
+#include "ControlPoint.h"
+#include "ControlStringPool.h"
+#include "IException.h"
+
+#include "gtest/gtest.h"
+
+using namespace Isis;
+
+namespace {
+  /**
+   * A synthetic network where every point has a measure on a run of
+   * consecutive cubes. The serial numbers are built separately for each
+   * measure, the way they are when a network is read from a file.
+   */
+  void fillNetwork(ControlNet &net, int pointCount, int measuresPerPoint, int cubeCount) {
+    for (int p = 0; p < pointCount; p++) {
+      ControlPoint *point = new ControlPoint(QString("Point%1").arg(p));
+      for (int m = 0; m < measuresPerPoint; m++) {
+        ControlMeasure *measure = new ControlMeasure;
+        measure->SetCubeSerialNumber(QString("Synthetic/Cube/%1").arg((p + m) % cubeCount));
+        measure->SetCoordinate(p % 1000 + 0.5, m + 0.5, ControlMeasure::RegisteredSubPixel);
+        measure->SetChooserName(QString("pointreg"));
+        measure->SetDateTime(QString("2026-10-16T12:00:00"));
+        point->Add(measure);
+      }
+      net.AddPoint(point);
+    }
+  }
+
+
+  /**
+   * The number of bytes allocated on the heap, or -1 where the C library
+   * cannot say.
+   */
+  double heapBytesInUse() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    return mallinfo2().uordblks;
+#elif defined(__GLIBC__)
+    return (unsigned int) mallinfo().uordblks;
+#else
+    return -1.0;
+#endif
+  }
+}
+
+
+TEST(ControlStringPool, InternShares) {
+  ControlStringPool pool;
+  EXPECT_EQ(1, pool.size());
+
+  QString first = pool.intern(QString("MRO/CTX/1234567890:123"));
+  QString second = pool.intern(QString("MRO/CTX/") + QString("1234567890:123"));
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(first.constData(), second.constData());
+  EXPECT_EQ(2, pool.size());
+
+  QString other = pool.intern("MRO/CTX/1234567890:124");
+  EXPECT_NE(first.constData(), other.constData());
+  EXPECT_EQ(3, pool.size());
+
+  EXPECT_TRUE(pool.intern("").isEmpty());
+  EXPECT_EQ(3, pool.size());
+}
+
+
+TEST(ControlStringPool, Indices) {
+  ControlStringPool pool;
+  EXPECT_EQ(0, pool.index(""));
+  EXPECT_EQ(0, pool.index(QString()));
+
+  int first = pool.index("first");
+  int second = pool.index("second");
+  EXPECT_EQ(1, first);
+  EXPECT_EQ(2, second);
+  EXPECT_EQ(first, pool.index("first"));
+  EXPECT_EQ("first", pool.string(first));
+  EXPECT_EQ("second", pool.string(second));
+  EXPECT_TRUE(pool.string(0).isEmpty());
+
+  EXPECT_THROW(pool.string(3), IException);
+  EXPECT_THROW(pool.string(-1), IException);
+}
+
+
+TEST(ControlStringPool, MeasuresShareStrings) {
+  ControlMeasure first;
+  ControlMeasure second;
+  first.SetCubeSerialNumber(QString("Test/Cube/") + QString::number(1));
+  second.SetCubeSerialNumber(QString("Test/Cube/1"));
+  first.SetChooserName("qnet");
+  second.SetChooserName(QString("q") + "net");
+
+  EXPECT_EQ(first.GetCubeSerialNumber().constData(), second.GetCubeSerialNumber().constData());
+  EXPECT_EQ(first.GetChooserName().constData(), second.GetChooserName().constData());
+
+  ControlMeasure copy(first);
+  EXPECT_EQ(first.GetCubeSerialNumber().constData(), copy.GetCubeSerialNumber().constData());
+  EXPECT_TRUE(copy == first);
+}
+
+
+TEST(ControlStringPool, LazyLogData) {
+  ControlMeasure measure;
+  EXPECT_TRUE(measure.GetLogDataEntries().isEmpty());
+  EXPECT_FALSE(measure.HasLogData(ControlMeasureLogData::GoodnessOfFit));
+  EXPECT_FALSE(measure.GetLogValue(ControlMeasureLogData::GoodnessOfFit).isValid());
+  EXPECT_FALSE(measure.GetLogData(ControlMeasureLogData::GoodnessOfFit).IsValid());
+  measure.DeleteLogData(ControlMeasureLogData::GoodnessOfFit);
+  EXPECT_THROW(measure.UpdateLogData(
+                   ControlMeasureLogData(ControlMeasureLogData::GoodnessOfFit, 0.5)),
+               IException);
+
+  measure.SetLogData(ControlMeasureLogData(ControlMeasureLogData::GoodnessOfFit, 0.5));
+  ASSERT_TRUE(measure.HasLogData(ControlMeasureLogData::GoodnessOfFit));
+  EXPECT_EQ(0.5, measure.GetLogValue(ControlMeasureLogData::GoodnessOfFit).toDouble());
+
+  ControlMeasure copy(measure);
+  ControlMeasure assigned;
+  assigned = measure;
+  measure.DeleteLogData(ControlMeasureLogData::GoodnessOfFit);
+  EXPECT_FALSE(measure.HasLogData(ControlMeasureLogData::GoodnessOfFit));
+  EXPECT_EQ(1, copy.GetLogDataEntries().size());
+  EXPECT_EQ(1, assigned.GetLogDataEntries().size());
+}
+
+
+TEST(ControlStringPool, NetworkSharesStrings) {
+  const int pointCount = 2000;
+  const int measuresPerPoint = 8;
+  const int cubeCount = 50;
+
+  ControlNet net;
+  fillNetwork(net, pointCount, measuresPerPoint, cubeCount);
+
+  // Every measure on a cube shares one copy of its serial number, and every
+  // measure shares the chooser name
+  QSet<const QChar *> serialData;
+  QSet<const QChar *> chooserData;
+  int measureCount = 0;
+  foreach (ControlPoint *point, net.GetPoints()) {
+    foreach (ControlMeasure *measure, point->getMeasures()) {
+      serialData.insert(measure->GetCubeSerialNumber().constData());
+      chooserData.insert(measure->GetChooserName().constData());
+      EXPECT_EQ("2026-10-16T12:00:00", measure->GetDateTime());
+      measureCount++;
+    }
+  }
+
+  EXPECT_EQ(pointCount * measuresPerPoint, measureCount);
+  EXPECT_EQ(cubeCount, serialData.size());
+  EXPECT_EQ(1, chooserData.size());
+  EXPECT_EQ(cubeCount, net.GetCubeSerials().size());
+}
+
+
+/**
+ * Microbenchmark for network storage. Disabled by default; run it with
+ * --gtest_also_run_disabled_tests --gtest_filter=*NetworkBenchmark and
+ * --gtest_output=xml to get the heap bytes used per measure of a synthetic
+ * network (glibc only) and the time to visit every measure, as test
+ * properties.
+ */
+TEST(ControlStringPool, DISABLED_NetworkBenchmark) {
+  const int pointCount = 50000;
+  const int measuresPerPoint = 8;
+  const int cubeCount = 500;
+  const int measureCount = pointCount * measuresPerPoint;
+
+  double heapBefore = heapBytesInUse();
+  ControlNet *net = new ControlNet;
+  fillNetwork(*net, pointCount, measuresPerPoint, cubeCount);
+  double heapAfter = heapBytesInUse();
+  if (heapBefore >= 0.0) {
+    RecordProperty("BytesPerMeasure", (int) ((heapAfter - heapBefore) / measureCount));
+  }
+
+  // Visit every measure the way a bundle adjustment or a filter does
+  const int passes = 10;
+  int visited = 0;
+  double sampleSum = 0.0;
+  QElapsedTimer timer;
+  timer.start();
+  for (int pass = 0; pass < passes; pass++) {
+    foreach (ControlPoint *point, net->GetPoints()) {
+      foreach (ControlMeasure *measure, point->getMeasures()) {
+        if (!measure->GetCubeSerialNumber().isEmpty() && !measure->IsIgnored()) {
+          sampleSum += measure->GetSample();
+          visited++;
+        }
+      }
+    }
+  }
+  qint64 elapsed = qMax(timer.nsecsElapsed(), (qint64) 1);
+
+  EXPECT_EQ(passes * measureCount, visited);
+  EXPECT_GT(sampleSum, 0.0);
+  RecordProperty("TraversalNanosecondsPerMeasure", (int) (elapsed / visited));
+  RecordProperty("TraversalMilliseconds", (int) (elapsed / 1000000));
+
+  delete net;
+}
@@ -0,0 +1,162 @@
+#include <QVector>
+
+#include "Calculator.h"
+#include "Cube.h"
+#include "CubeCalculator.h"
+#include "IException.h"
+#include "LineManager.h"
+#include "SpecialPixel.h"
+#include "TempFixtures.h"
+#include "TestUtilities.h"
+
+#include "gtest/gtest.h"
+
+using namespace Isis;
+
+namespace {
+  // A line of DNs with every kind of special pixel in it
+  double dn(int cube, int sample, int line) {
+    switch ((sample + line + cube) % 9) {
+      case 0: return Null;
+      case 1: return Lrs;
+      case 2: return His;
+      case 3: return Hrs;
+      case 4: return Lis;
+      default: return cube * 100.0 + sample * 0.75 - line;
+    }
+  }
+
+
+  Cube *createCube(const QString &fileName, int cube) {
+    Cube *testCube = new Cube;
+    testCube->setDimensions(37, 4, 1);
+    testCube->create(fileName);
+
+    LineManager line(*testCube);
+    for (line.begin(); !line.end(); line++) {
+      for (int i = 0; i < line.size(); i++) {
+        line[i] = dn(cube, line.Sample(i), line.Line());
+      }
+      testCube->write(line);
+    }
+
+    return testCube;
+  }
+
+
+  void expectSameResults(const QVector<double> &expected, const QVector<double> &actual) {
+    ASSERT_EQ(expected.size(), actual.size());
+    for (int i = 0; i < expected.size(); i++) {
+      if (IsSpecial(expected[i])) {
+        EXPECT_PRED_FORMAT2(AssertQStringsEqual, PixelToString(expected[i]),
+                            PixelToString(actual[i])) << "Sample " << i + 1;
+      }
+      else {
+        EXPECT_DOUBLE_EQ(expected[i], actual[i]) << "Sample " << i + 1;
+      }
+    }
+  }
+}
+
+
+TEST_F(TempTestingFiles, CubeCalculatorMatchesCalculator) {
+  Cube *cube1 = createCube(tempDir.path() + "/f1.cub", 1);
+  Cube *cube2 = createCube(tempDir.path() + "/f2.cub", 2);
+  QVector<Cube *> cubes = {cube1, cube2};
+
+  CubeCalculator calculator;
+  calculator.prepareCalculations("f1 f2 + 2 * sqrt f1 max sample line / - f2 1 << min",
+                                 cubes, cube1);
+  EXPECT_TRUE(calculator.isThreadSafe());
+
+  LineManager line1(*cube1);
+  LineManager line2(*cube2);
+  for (line1.begin(), line2.begin(); !line1.end(); line1++, line2++) {
+    cube1->read(line1);
+    cube2->read(line2);
+
+    QVector<Buffer *> cubeData = {&line1, &line2};
+    QVector<double> actual = calculator.runCalculations(cubeData, line1.Line(), line1.Band());
+
+    Calculator expected;
+    QVector<double> samples;
+    for (int i = 0; i < line1.size(); i++) {
+      samples.push_back(i + 1);
+    }
+
+    expected.Push(line1);
+    expected.Push(line2);
+    expected.Add();
+    expected.Push(2.0);
+    expected.Multiply();
+    expected.SquareRoot();
+    expected.Push(line1);
+    expected.MaximumPixel();
+    expected.Push(samples);
+    expected.Push(line1.Line());
+    expected.Divide();
+    expected.Subtract();
+    expected.Push(line2);
+    expected.Push(1.0);
+    expected.LeftShift();
+    expected.MinimumPixel();
+
+    expectSameResults(expected.Pop(true), actual);
+  }
+
+  delete cube1;
+  delete cube2;
+}
+
+
+TEST_F(TempTestingFiles, CubeCalculatorScalarResult) {
+  Cube *cube = createCube(tempDir.path() + "/f1.cub", 1);
+  QVector<Cube *> cubes = {cube};
+
+  CubeCalculator calculator;
+  calculator.prepareCalculations("f1 linemax f1 linemin - band +", cubes, cube);
+
+  LineManager line(*cube);
+  line.SetLine(2);
+  cube->read(line);
+  QVector<Buffer *> cubeData = {&line};
+
+  Calculator expected;
+  expected.Push(line);
+  expected.MaximumLine();
+  expected.Push(line);
+  expected.MinimumLine();
+  expected.Subtract();
+  expected.Push(1.0);
+  expected.Add();
+
+  expectSameResults(expected.Pop(true), calculator.runCalculations(cubeData, 2, 1));
+
+  delete cube;
+}
+
+
+TEST_F(TempTestingFiles, CubeCalculatorErrors) {
+  Cube *cube = createCube(tempDir.path() + "/f1.cub", 1);
+  QVector<Cube *> cubes = {cube};
+
+  LineManager line(*cube);
+  line.SetLine(1);
+  cube->read(line);
+  QVector<Buffer *> cubeData = {&line};
+
+  CubeCalculator calculator;
+
+  calculator.prepareCalculations("f1 1", cubes, cube);
+  EXPECT_FALSE(calculator.isThreadSafe());
+  EXPECT_THROW(calculator.runCalculations(cubeData, 1, 1), IException);
+
+  calculator.prepareCalculations("f1 +", cubes, cube);
+  EXPECT_THROW(calculator.runCalculations(cubeData, 1, 1), IException);
+
+  calculator.prepareCalculations("f1 40 <<", cubes, cube);
+  EXPECT_TRUE(calculator.isThreadSafe());
+  EXPECT_THROW(calculator.runCalculations(cubeData, 1, 1), IException);
+
+  delete cube;
+}
@@ -0,0 +1,214 @@
+#include <QFileInfo>
+
+#include "Brick.h"
+#include "Cube.h"
+#include "CubeAttribute.h"
+#include "LineManager.h"
+#include "OriginalLabel.h"
+#include "Pvl.h"
+#include "PvlGroup.h"
+#include "PvlKeyword.h"
+#include "PvlObject.h"
+#include "SpecialPixel.h"
+#include "TempFixtures.h"
+
+#include "gtest/gtest.h"
+
+using namespace Isis;
+
+namespace {
+  /**
+   * Expected DN of the test cubes. Everything outside of a small block in the
+   * middle of band 1 is NULL, like most mosaics.
+   */
+  double expectedDn(int sample, int line, int band) {
+    if (band == 1 && sample > 300 && sample <= 420 && line > 250 && line <= 330) {
+      return sample * 0.5 + line * 0.25;
+    }
+    return Null;
+  }
+
+
+  QString createCube(const QString &fileName, Cube::Format format) {
+    Cube cube;
+    cube.setDimensions(1000, 800, 2);
+    cube.setFormat(format);
+    cube.create(fileName);
+
+    LineManager line(cube);
+    for (line.begin(); !line.end(); line++) {
+      for (int i = 0; i < line.size(); i++) {
+        line[i] = expectedDn(line.Sample(i), line.Line(), line.Band());
+      }
+      cube.write(line);
+    }
+    cube.close();
+
+    return fileName;
+  }
+
+
+  void checkCube(Cube &cube) {
+    LineManager line(cube);
+    for (line.begin(); !line.end(); line++) {
+      cube.read(line);
+      for (int i = 0; i < line.size(); i++) {
+        ASSERT_EQ(expectedDn(line.Sample(i), line.Line(), line.Band()), line[i])
+            << "Sample " << line.Sample(i) << " Line " << line.Line();
+      }
+    }
+  }
+}
+
+
+TEST_F(TempTestingFiles, CompressedTileRoundTrip) {
+  QString compressedFile = createCube(tempDir.path() + "/compressed.cub", Cube::CompressedTile);
+  QString tileFile = createCube(tempDir.path() + "/tile.cub", Cube::Tile);
+
+  Cube cube(compressedFile);
+  EXPECT_EQ(Cube::CompressedTile, cube.format());
+
+  PvlObject &core = cube.label()->findObject("IsisCube").findObject("Core");
+  EXPECT_EQ("CompressedTile", core["Format"][0]);
+  EXPECT_EQ("Zlib", core["Compression"][0]);
+
+  checkCube(cube);
+
+  // Only the handful of tiles touching the block in the middle are stored
+  EXPECT_LT(QFileInfo(compressedFile).size() * 20, QFileInfo(tileFile).size());
+}
+
+
+TEST_F(TempTestingFiles, CompressedTileRewrite) {
+  QString fileName = createCube(tempDir.path() + "/rewrite.cub", Cube::CompressedTile);
+
+  // Grow a tile that was stored so it has to move, then NULL another one out
+  {
+    Cube cube(fileName, "rw");
+    Brick brick(cube, 16, 16, 1);
+    brick.SetBasePosition(301, 251, 1);
+    for (int i = 0; i < brick.size(); i++) {
+      brick[i] = i * 1.37;
+    }
+    cube.write(brick);
+
+    brick.SetBasePosition(1, 1, 2);
+    for (int i = 0; i < brick.size(); i++) {
+      brick[i] = -1.0;
+    }
+    cube.write(brick);
+    cube.close();
+  }
+
+  {
+    Cube cube(fileName, "rw");
+    Brick brick(cube, 16, 16, 1);
+    brick.SetBasePosition(1, 1, 2);
+    for (int i = 0; i < brick.size(); i++) {
+      brick[i] = Null;
+    }
+    cube.write(brick);
+    cube.close();
+  }
+
+  Cube cube(fileName);
+  Brick brick(cube, 16, 16, 1);
+  brick.SetBasePosition(301, 251, 1);
+  cube.read(brick);
+  for (int i = 0; i < brick.size(); i++) {
+    EXPECT_FLOAT_EQ(i * 1.37, brick[i]);
+  }
+
+  brick.SetBasePosition(1, 1, 2);
+  cube.read(brick);
+  for (int i = 0; i < brick.size(); i++) {
+    EXPECT_EQ(Null, brick[i]);
+  }
+}
+
+
+TEST_F(TempTestingFiles, CompressedTileBlobsAndTiles) {
+  QString fileName = tempDir.path() + "/blobs.cub";
+
+  CubeAttributeOutput attributes("+CompressedTile");
+  EXPECT_EQ(Cube::CompressedTile, attributes.fileFormat());
+
+  Cube cube;
+  cube.setDimensions(1000, 800, 2);
+  cube.setFormat(attributes.fileFormat());
+  cube.create(fileName);
+
+  // Tiles written after this blob must not overwrite it
+  Pvl labelPvl;
+  labelPvl.addGroup(PvlGroup("OriginalStuff"));
+  OriginalLabel originalLabel(labelPvl);
+  cube.write(originalLabel);
+
+  LineManager line(cube);
+  for (line.begin(); !line.end(); line++) {
+    for (int i = 0; i < line.size(); i++) {
+      line[i] = expectedDn(line.Sample(i), line.Line(), line.Band());
+    }
+    cube.write(line);
+  }
+  cube.close();
+
+  Cube reopened(fileName);
+  checkCube(reopened);
+  EXPECT_TRUE(reopened.readOriginalLabel().ReturnLabels().hasGroup("OriginalStuff"));
+}
+
+
+TEST_F(TempTestingFiles, CompressedTileReusesSpace) {
+  QString fileName = createCube(tempDir.path() + "/reuse.cub", Cube::CompressedTile);
+
+  // A blob after the tiles, which freed space must never be taken from
+  {
+    Cube cube(fileName, "rw");
+    Pvl labelPvl;
+    labelPvl.addGroup(PvlGroup("OriginalStuff"));
+    OriginalLabel originalLabel(labelPvl);
+    cube.write(originalLabel);
+    cube.close();
+  }
+
+  // Fill a tile that does not compress well, then NULL it out again, over and
+  // over. Once the first fill moved past the blob the file must stop growing.
+  qint64 fileSize = 0;
+  for (int pass = 0; pass < 4; pass++) {
+    {
+      Cube cube(fileName, "rw");
+      Brick brick(cube, 64, 64, 1);
+      brick.SetBasePosition(1, 1, 2);
+      unsigned int state = 12345;
+      for (int i = 0; i < brick.size(); i++) {
+        state = state * 1103515245u + 12345u;
+        brick[i] = (double)(state >> 8);
+      }
+      cube.write(brick);
+      cube.close();
+    }
+
+    if (pass == 0) {
+      fileSize = QFileInfo(fileName).size();
+    }
+    else {
+      EXPECT_EQ(fileSize, QFileInfo(fileName).size()) << "Pass " << pass;
+    }
+
+    {
+      Cube cube(fileName, "rw");
+      Brick brick(cube, 64, 64, 1);
+      brick.SetBasePosition(1, 1, 2);
+      for (int i = 0; i < brick.size(); i++) {
+        brick[i] = Null;
+      }
+      cube.write(brick);
+      cube.close();
+    }
+  }
+
+  Cube cube(fileName);
+  checkCube(cube);
+  EXPECT_TRUE(cube.readOriginalLabel().ReturnLabels().hasGroup("OriginalStuff"));
+}
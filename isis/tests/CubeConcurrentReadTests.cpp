@@ -0,0 +1,301 @@
+#include <cmath>
+#include <vector>
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QStringList>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include "Brick.h"
+#include "Cube.h"
+#include "Endian.h"
+#include "IException.h"
+#include "LineManager.h"
+#include "Preference.h"
+#include "PvlGroup.h"
+#include "PvlKeyword.h"
+#include "SpecialPixel.h"
+#include "TempFixtures.h"
+
+#include "gtest/gtest.h"
+
+using namespace Isis;
+
+namespace {
+  /**
+   * Creates cubes, by default in a byte order opposite to this machine's so
+   * that the concurrent path has to swap, and reads them back line by line.
+   */
+  class CubeConcurrentRead : public TempTestingFiles {
+    protected:
+      int originalThreadCount;
+
+      void SetUp() override {
+        TempTestingFiles::SetUp();
+        originalThreadCount = QThreadPool::globalInstance()->maxThreadCount();
+      }
+
+      void TearDown() override {
+        QThreadPool::globalInstance()->setMaxThreadCount(originalThreadCount);
+        setMemoryMap("Never");
+      }
+
+      void setMemoryMap(const QString &value) {
+        PvlGroup &performance = Preference::Preferences().findGroup("Performance");
+        performance.addKeyword(PvlKeyword("CubeMemoryMap", value), PvlContainer::Replace);
+      }
+
+      QString createCube(const QString &name, Cube::Format format,
+                         PixelType pixelType, int samples, int lines, int bands,
+                         bool swapped = true) {
+        Cube cube;
+        cube.setDimensions(samples, lines, bands);
+        cube.setFormat(format);
+        cube.setPixelType(pixelType);
+        if (swapped) {
+          cube.setByteOrder(IsLsb() ? Msb : Lsb);
+        }
+        if (pixelType != Real) {
+          cube.setBaseMultiplier(100.0, 0.01);
+        }
+
+        QString fileName = tempDir.path() + "/" + name + ".cub";
+        cube.create(fileName);
+
+        LineManager line(cube);
+        for (line.begin(); !line.end(); line++) {
+          for (int i = 0; i < line.size(); i++) {
+            int sample = line.Sample(i);
+            if ((sample + line.Line()) % 37 == 0) {
+              line[i] = Null;
+            }
+            else if ((sample + line.Line()) % 41 == 0) {
+              line[i] = Hrs;
+            }
+            else {
+              line[i] = sin(sample * 0.03) * 100.0 + line.Line() * 0.25 + line.Band();
+            }
+          }
+          cube.write(line);
+        }
+        cube.close();
+
+        return fileName;
+      }
+
+      /**
+       * Read every line of the cube with the given number of threads, last line
+       * first.
+       */
+      std::vector<double> readCube(Cube &cube, int threads) {
+        int samples = cube.sampleCount();
+        int lineCount = cube.lineCount() * cube.bandCount();
+        std::vector<double> result((size_t)samples * lineCount);
+
+        QList<int> lineIndices;
+        for (int i = lineCount; i >= 1; i--) {
+          lineIndices.append(i);
+        }
+
+        auto readLine = [&cube, &result, samples](const int &index) {
+          LineManager line(cube);
+          line.setpos(index - 1);
+          cube.read(line);
+          for (int i = 0; i < line.size(); i++) {
+            result[(size_t)(index - 1) * samples + i] = line[i];
+          }
+        };
+
+        if (threads > 1) {
+          QThreadPool::globalInstance()->setMaxThreadCount(threads);
+          QtConcurrent::blockingMap(lineIndices, readLine);
+        }
+        else {
+          for (int i = 0; i < lineIndices.size(); i++) {
+            readLine(lineIndices[i]);
+          }
+        }
+
+        return result;
+      }
+
+      void compareReads(const QString &fileName) {
+        Cube serialCube;
+        serialCube.open(fileName, "rw");
+        ASSERT_FALSE(serialCube.isReadOnly());
+        std::vector<double> serial = readCube(serialCube, 1);
+
+        Cube concurrentCube;
+        concurrentCube.open(fileName, "r");
+        concurrentCube.setConcurrentReads(true);
+        std::vector<double> concurrent = readCube(concurrentCube, 8);
+
+        ASSERT_EQ(serial.size(), concurrent.size());
+        for (size_t i = 0; i < serial.size(); i++) {
+          ASSERT_EQ(serial[i], concurrent[i]) << "Pixel " << i;
+        }
+      }
+  };
+}
+
+
+TEST_F(CubeConcurrentRead, TileMatchesSerial) {
+  compareReads(createCube("tile", Cube::Tile, Real, 700, 530, 3));
+}
+
+
+TEST_F(CubeConcurrentRead, BsqMatchesSerial) {
+  compareReads(createCube("bsq", Cube::Bsq, SignedWord, 411, 300, 2));
+}
+
+
+TEST_F(CubeConcurrentRead, CompressedTileMatchesSerial) {
+  compareReads(createCube("compressed", Cube::CompressedTile, UnsignedWord, 600, 333, 2));
+}
+
+
+TEST_F(CubeConcurrentRead, VirtualBandsAndOutOfBounds) {
+  QString fileName = createCube("vbands", Cube::Tile, UnsignedWord, 200, 150, 4);
+
+  QList<QString> virtualBands;
+  virtualBands << "3" << "1" << "3";
+
+  Cube serialCube;
+  serialCube.setVirtualBands(virtualBands);
+  serialCube.open(fileName, "rw");
+
+  Cube concurrentCube;
+  concurrentCube.setVirtualBands(virtualBands);
+  concurrentCube.open(fileName, "r");
+  concurrentCube.setConcurrentReads(true);
+
+  // Bricks hanging off the edge of the cube must be Null filled the same way
+  Brick serialBrick(serialCube, 64, 64, 3);
+  Brick concurrentBrick(concurrentCube, 64, 64, 3);
+  for (serialBrick.begin(), concurrentBrick.begin(); !serialBrick.end();
+       serialBrick++, concurrentBrick++) {
+    serialCube.read(serialBrick);
+    concurrentCube.read(concurrentBrick);
+    for (int i = 0; i < serialBrick.size(); i++) {
+      ASSERT_EQ(serialBrick[i], concurrentBrick[i]);
+    }
+  }
+}
+
+
+TEST_F(CubeConcurrentRead, OptIn) {
+  QString fileName = createCube("optIn", Cube::Tile, Real, 100, 100, 1);
+
+  Cube readOnlyCube;
+  readOnlyCube.open(fileName, "r");
+  EXPECT_FALSE(readOnlyCube.concurrentReads());
+  readOnlyCube.setConcurrentReads(true);
+  EXPECT_TRUE(readOnlyCube.concurrentReads());
+  readOnlyCube.setConcurrentReads(false);
+  EXPECT_FALSE(readOnlyCube.concurrentReads());
+
+  Cube readWriteCube;
+  readWriteCube.open(fileName, "rw");
+  EXPECT_THROW(readWriteCube.setConcurrentReads(true), IException);
+  EXPECT_FALSE(readWriteCube.concurrentReads());
+
+  Cube closedCube;
+  EXPECT_FALSE(closedCube.concurrentReads());
+  EXPECT_THROW(closedCube.setConcurrentReads(true), IException);
+
+  // The memory map preference needs concurrent reads, so it turns them on
+  setMemoryMap("ReadOnly");
+  Cube mappedCube;
+  mappedCube.open(fileName, "r");
+  EXPECT_TRUE(mappedCube.concurrentReads());
+}
+
+
+TEST_F(CubeConcurrentRead, BsqSpectraMatchSerial) {
+  QString fileName = createCube("spectra", Cube::Bsq, Real, 300, 200, 40);
+
+  Cube serialCube;
+  serialCube.open(fileName, "rw");
+
+  Cube concurrentCube;
+  concurrentCube.open(fileName, "r");
+  concurrentCube.setConcurrentReads(true);
+
+  // Every spectrum touches one chunk in each band, with the same stride
+  //   between them
+  int samples = serialCube.sampleCount();
+  int bands = serialCube.bandCount();
+  QList<int> spectra;
+  for (int i = 0; i < samples * serialCube.lineCount(); i += 7) {
+    spectra.append(i);
+  }
+
+  std::vector<double> serial((size_t)spectra.size() * bands);
+  std::vector<double> concurrent((size_t)spectra.size() * bands);
+  auto readSpectrum = [&](Cube &cube, std::vector<double> &result, int index) {
+    Brick spectrum(cube, 1, 1, bands);
+    spectrum.SetBasePosition(spectra[index] % samples + 1, spectra[index] / samples + 1, 1);
+    cube.read(spectrum);
+    for (int band = 0; band < bands; band++) {
+      result[(size_t)index * bands + band] = spectrum[band];
+    }
+  };
+
+  QList<int> indices;
+  for (int i = 0; i < spectra.size(); i++) {
+    indices.append(i);
+    readSpectrum(serialCube, serial, i);
+  }
+  QThreadPool::globalInstance()->setMaxThreadCount(8);
+  QtConcurrent::blockingMap(indices, [&](const int &index) {
+    readSpectrum(concurrentCube, concurrent, index);
+  });
+
+  for (size_t i = 0; i < serial.size(); i++) {
+    ASSERT_EQ(serial[i], concurrent[i]) << "Pixel " << i;
+  }
+}
+
+
+TEST_F(CubeConcurrentRead, MemoryMappedMatchesSerial) {
+  QString nativeFileName = createCube("mappedNative", Cube::Tile, Real, 700, 530, 2, false);
+  QString swappedFileName = createCube("mappedSwapped", Cube::Bsq, SignedWord, 411, 300, 2);
+
+  setMemoryMap("ReadOnly");
+  compareReads(nativeFileName);
+  compareReads(swappedFileName);
+}
+
+
+/**
+ * Microbenchmark for concurrent reads. Disabled by default; run it with
+ * --gtest_also_run_disabled_tests --gtest_filter=*ConcurrentReadScaling and
+ * --gtest_output=xml to get the read time of a 4096x4096 Real cube, in
+ * milliseconds, at increasing thread counts, with and without memory mapping,
+ * as test properties.
+ */
+TEST_F(CubeConcurrentRead, DISABLED_ConcurrentReadScaling) {
+  QString fileName = createCube("scaling", Cube::Tile, Real, 4096, 4096, 1, false);
+
+  QStringList memoryMapModes;
+  memoryMapModes << "Never" << "ReadOnly";
+  foreach (QString memoryMap, memoryMapModes) {
+    setMemoryMap(memoryMap);
+
+    for (int threads = 1; threads <= QThread::idealThreadCount(); threads *= 2) {
+      Cube cube;
+      cube.open(fileName, "r");
+      cube.setConcurrentReads(true);
+
+      QElapsedTimer timer;
+      timer.start();
+      readCube(cube, threads);
+      qint64 milliseconds = timer.elapsed();
+
+      QString name = QString("MemoryMap%1Threads%2Milliseconds").arg(memoryMap).arg(threads);
+      RecordProperty(name.toStdString(), (int) milliseconds);
+    }
+  }
+}
@@ -0,0 +1,206 @@
+#include <QList>
+#include <QVector>
+
+#include "Blob.h"
+#include "Cube.h"
+#include "CubeFixtures.h"
+#include "CubeOverview.h"
+#include "IException.h"
+#include "LineManager.h"
+#include "SpecialPixel.h"
+#include "TestUtilities.h"
+
+#include "gtest/gtest.h"
+
+using namespace Isis;
+
+TEST(CubeOverview, SetAndGet) {
+  CubeOverview overview(4, 3, 2, 2);
+  EXPECT_EQ(4, overview.scale());
+  EXPECT_EQ(3, overview.sampleCount());
+  EXPECT_EQ(2, overview.lineCount());
+  EXPECT_EQ(2, overview.bandCount());
+
+  // Everything starts out NULL
+  EXPECT_EQ(Null, overview.value(1, 1, 1));
+
+  overview.setValue(2, 1, 2, 7.5);
+  overview.setValue(3, 2, 2, Lrs);
+  EXPECT_EQ(7.5, overview.value(2, 1, 2));
+  EXPECT_EQ(Lrs, overview.value(3, 2, 2));
+
+  // Outside of the overview is NULL
+  EXPECT_EQ(Null, overview.value(4, 1, 1));
+  EXPECT_EQ(Null, overview.value(1, 0, 1));
+
+  // Cube samples 5 through 8 map to overview sample 2
+  EXPECT_EQ(7.5, overview.cubeValue(5.0, 1.0, 2));
+  EXPECT_EQ(7.5, overview.cubeValue(8.4, 4.4, 2));
+  EXPECT_EQ(Null, overview.cubeValue(8.6, 1.0, 2));
+  EXPECT_EQ(Null, overview.cubeValue(0.4, 1.0, 2));
+}
+
+
+TEST(CubeOverview, BlobRoundTrip) {
+  CubeOverview overview(2, 2, 2, 1);
+  overview.setValue(1, 1, 1, 1.25);
+  overview.setValue(2, 1, 1, His);
+  overview.setValue(1, 2, 1, -3.0);
+
+  Blob blob = overview.toBlob();
+  EXPECT_EQ(CubeOverview::blobName(2), blob.Name());
+  EXPECT_EQ("Overview", blob.Type());
+
+  CubeOverview copy(blob);
+  EXPECT_EQ(2, copy.scale());
+  EXPECT_EQ(1.25, copy.value(1, 1, 1));
+  EXPECT_EQ(His, copy.value(2, 1, 1));
+  EXPECT_EQ(-3.0, copy.value(1, 2, 1));
+  EXPECT_EQ(Null, copy.value(2, 2, 1));
+}
+
+
+TEST(CubeOverview, InvalidDimensions) {
+  QString message = "is not valid";
+  try {
+    CubeOverview overview(1, 10, 10, 1);
+    FAIL() << "Expected an exception";
+  }
+  catch (IException &e) {
+    EXPECT_PRED_FORMAT2(AssertIExceptionMessage, e, message);
+  }
+}
+
+
+TEST_F(SmallCube, CubeOverviewBuild) {
+  QList<int> scales;
+  scales << 2 << 4;
+  QList<CubeOverview> overviews = CubeOverview::build(*testCube, scales);
+  ASSERT_EQ(2, overviews.size());
+
+  // The small cube's DNs count up from 0 in sample, then line, then band
+  CubeOverview &half = overviews[0];
+  EXPECT_EQ(5, half.sampleCount());
+  EXPECT_EQ(5, half.lineCount());
+  EXPECT_EQ(10, half.bandCount());
+  EXPECT_DOUBLE_EQ((0 + 1 + 10 + 11) / 4.0, half.value(1, 1, 1));
+  EXPECT_DOUBLE_EQ((288 + 289 + 298 + 299) / 4.0, half.value(5, 5, 3));
+
+  // The last overview pixel only covers the cube's last two samples and lines
+  CubeOverview &quarter = overviews[1];
+  EXPECT_EQ(3, quarter.sampleCount());
+  EXPECT_EQ(3, quarter.lineCount());
+  EXPECT_DOUBLE_EQ((88 + 89 + 98 + 99) / 4.0, quarter.value(3, 3, 1));
+
+  QVector<double> band = quarter.bandValues(2);
+  ASSERT_EQ(9, band.size());
+  EXPECT_DOUBLE_EQ(quarter.value(1, 1, 2), band[0]);
+}
+
+
+TEST_F(SpecialSmallCube, CubeOverviewBuildSpecialPixels) {
+  QList<int> scales;
+  scales << 10;
+  CubeOverview overview = CubeOverview::build(*testCube, scales).first();
+
+  // Lines 3 through 7 of band 1 are special pixels and are left out of the
+  //   average. The valid pixels count up from 0 to 49 around them.
+  EXPECT_DOUBLE_EQ(24.5, overview.value(1, 1, 1));
+  EXPECT_DOUBLE_EQ(99.5, overview.value(1, 1, 2));
+
+  // A block of only special pixels keeps its first special pixel
+  scales.clear();
+  scales << 2;
+  CubeOverview half = CubeOverview::build(*testCube, scales).first();
+  EXPECT_EQ(Null, half.value(1, 2, 1));
+  EXPECT_EQ(Hrs, half.value(1, 3, 1));
+}
+
+
+TEST_F(SmallCube, CubeOverviewScales) {
+  EXPECT_TRUE(CubeOverview::scales(*testCube).isEmpty());
+  EXPECT_EQ(0, CubeOverview::nearestScale(*testCube, 0.1));
+  EXPECT_EQ(0, CubeOverview::samplingScale(*testCube, 10));
+
+  QList<int> scales;
+  scales << 4 << 2;
+  QList<CubeOverview> overviews = CubeOverview::build(*testCube, scales);
+  for (int i = 0; i < overviews.size(); i++) {
+    Blob blob = overviews[i].toBlob();
+    testCube->write(blob);
+  }
+
+  QList<int> expectedScales;
+  expectedScales << 2 << 4;
+  EXPECT_EQ(expectedScales, CubeOverview::scales(*testCube));
+
+  // Never draw from an overview with less than one pixel per screen pixel
+  EXPECT_EQ(0, CubeOverview::nearestScale(*testCube, 1.0));
+  EXPECT_EQ(0, CubeOverview::nearestScale(*testCube, 0.75));
+  EXPECT_EQ(2, CubeOverview::nearestScale(*testCube, 0.5));
+  EXPECT_EQ(2, CubeOverview::nearestScale(*testCube, 0.3));
+  EXPECT_EQ(4, CubeOverview::nearestScale(*testCube, 0.25));
+  EXPECT_EQ(4, CubeOverview::nearestScale(*testCube, 0.01));
+
+  // Small enough to read directly, then the finest overview that fits
+  EXPECT_EQ(0, CubeOverview::samplingScale(*testCube, 100));
+  EXPECT_EQ(2, CubeOverview::samplingScale(*testCube, 25));
+  EXPECT_EQ(4, CubeOverview::samplingScale(*testCube, 24));
+  EXPECT_EQ(4, CubeOverview::samplingScale(*testCube, 1));
+
+  CubeOverview read = CubeOverview::read(*testCube, 4);
+  EXPECT_DOUBLE_EQ(overviews[0].value(2, 2, 7), read.value(2, 2, 7));
+}
+
+
+TEST_F(SmallCube, CubeOverviewBuildVirtualBands) {
+  QList<int> scales;
+  scales << 2;
+  CubeOverview expected = CubeOverview::build(*testCube, scales).first();
+
+  // Overview bands are physical bands, whatever order the cube was opened in
+  QString path = testCube->fileName();
+  testCube->close();
+  QList<QString> virtualBands;
+  for (int band = 10; band >= 1; band--) {
+    virtualBands.append(QString::number(band));
+  }
+  testCube->setVirtualBands(virtualBands);
+  testCube->open(path, "r");
+
+  CubeOverview reversed = CubeOverview::build(*testCube, scales).first();
+  ASSERT_EQ(10, reversed.bandCount());
+  for (int band = 1; band <= 10; band++) {
+    EXPECT_DOUBLE_EQ(expected.value(3, 2, band), reversed.value(3, 2, band)) << "Band " << band;
+  }
+
+  // Bands that were not selected can't be filled in
+  testCube->close();
+  virtualBands.removeLast();
+  testCube->setVirtualBands(virtualBands);
+  testCube->open(path, "r");
+
+  try {
+    CubeOverview::build(*testCube, scales);
+    FAIL() << "Expected an exception";
+  }
+  catch (IException &e) {
+    EXPECT_PRED_FORMAT2(AssertIExceptionMessage, e, "need all of its [10] bands");
+  }
+}
+
+
+TEST_F(SmallCube, CubeOverviewRemove) {
+  QList<int> scales;
+  scales << 2 << 4;
+  QList<CubeOverview> overviews = CubeOverview::build(*testCube, scales);
+  for (int i = 0; i < overviews.size(); i++) {
+    Blob blob = overviews[i].toBlob();
+    testCube->write(blob);
+  }
+
+  EXPECT_EQ(2, CubeOverview::remove(*testCube));
+  EXPECT_TRUE(CubeOverview::scales(*testCube).isEmpty());
+  EXPECT_EQ(0, CubeOverview::nearestScale(*testCube, 0.1));
+  EXPECT_EQ(0, CubeOverview::remove(*testCube));
+}
@@ -0,0 +1,255 @@
+#include <cstring>
+#include <vector>
+
+#include <QElapsedTimer>
+#include <QString>
+
+#include "CubePixelConverter.h"
+#include "PixelType.h"
+#include "SpecialPixel.h"
+
+#include "gtest/gtest.h"
+
+using namespace Isis;
+
+namespace {
+  // Every 2 byte pattern, in native byte order
+  std::vector<char> allWords() {
+    std::vector<char> raw(65536 * 2);
+    for (int i = 0; i < 65536; i++) {
+      unsigned short word = i;
+      memcpy(&raw[2 * i], &word, 2);
+    }
+    return raw;
+  }
+
+
+  std::vector<char> someIntegers() {
+    std::vector<char> raw;
+    unsigned int value = 12345;
+    for (int i = 0; i < 10003; i++) {
+      // The special pixels and the ends of the valid range, then scattered values
+      unsigned int pixel = (i < 16) ? ((i < 8) ? i : 4294967295u - (i - 8)) : value;
+      value = value * 1664525u + 1013904223u;
+
+      char bytes[4];
+      memcpy(bytes, &pixel, 4);
+      raw.insert(raw.end(), bytes, bytes + 4);
+    }
+    return raw;
+  }
+
+
+  std::vector<char> someReals() {
+    float specials[] = {NULL4, LOW_INSTR_SAT4, LOW_REPR_SAT4, HIGH_INSTR_SAT4, HIGH_REPR_SAT4,
+                        VALID_MIN4, VALID_MAX4, -VALID_MAX4, 0.0f, -0.0f, 1.0e-40f};
+    std::vector<char> raw;
+    for (int i = 0; i < 10003; i++) {
+      float pixel = (i % 13 < 11) ? specials[i % 13] : (i - 5000) * 0.37f;
+      char bytes[4];
+      memcpy(bytes, &pixel, 4);
+      raw.insert(raw.end(), bytes, bytes + 4);
+    }
+    return raw;
+  }
+
+
+  std::vector<char> allBytes() {
+    std::vector<char> raw(256 * 3);
+    for (int i = 0; i < 256 * 3; i++) {
+      raw[i] = (char)(i % 256);
+    }
+    return raw;
+  }
+
+
+  /**
+   * Convert and swap the pixels with and without the vector kernels, starting
+   * at every offset into a group of four so unaligned starts and short ends
+   * are covered.
+   */
+  void compareKernels(PixelType pixelType, const std::vector<char> &raw,
+                      double base, double multiplier) {
+    CubePixelConverter scalar(pixelType, base, multiplier, false);
+    CubePixelConverter simd(pixelType, base, multiplier, true);
+    ASSERT_FALSE(scalar.usingSimd());
+    if (!simd.usingSimd()) {
+      GTEST_SKIP() << "This processor has no vector kernels";
+    }
+
+    int pixelSize = SizeOf(pixelType);
+    for (int offset = 0; offset < 4; offset++) {
+      const char *input = raw.data() + offset * pixelSize;
+      int count = raw.size() / pixelSize - offset;
+
+      std::vector<double> expected(count);
+      std::vector<double> actual(count);
+      scalar.toDouble(input, expected.data(), count);
+      simd.toDouble(input, actual.data(), count);
+      for (int i = 0; i < count; i++) {
+        if (IsSpecial(expected[i])) {
+          ASSERT_EQ(0, memcmp(&expected[i], &actual[i], sizeof(double))) << "Pixel " << i;
+        }
+        else {
+          ASSERT_DOUBLE_EQ(expected[i], actual[i]) << "Pixel " << i;
+        }
+      }
+
+      std::vector<char> expectedSwapped(count * pixelSize);
+      std::vector<char> actualSwapped(input, input + count * pixelSize);
+      scalar.swapBytes(input, expectedSwapped.data(), count);
+      simd.swapBytes(actualSwapped.data(), actualSwapped.data(), count);
+      ASSERT_EQ(expectedSwapped, actualSwapped);
+    }
+  }
+
+
+  /**
+   * Convert pixels of the same type and size the way CubeIoHandler does when
+   * reading from a cube in the other byte order.
+   */
+  double readRate(PixelType pixelType, bool useSimd) {
+    CubePixelConverter converter(pixelType, 10.0, 0.5, useSimd);
+    int count = 1 << 20;
+    std::vector<char> chunk(count * SizeOf(pixelType), 0x11);
+    std::vector<char> raw(chunk.size());
+    std::vector<double> doubles(count);
+
+    int repetitions = 20;
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < repetitions; i++) {
+      converter.swapBytes(chunk.data(), raw.data(), count);
+      converter.toDouble(raw.data(), doubles.data(), count);
+    }
+    qint64 elapsed = qMax(timer.nsecsElapsed(), (qint64) 1);
+
+    // Megapixels per second
+    return 1.0e3 * count * repetitions / elapsed;
+  }
+}
+
+
+TEST(CubePixelConverter, SpecialPixelsToDouble) {
+  short words[] = {NULL2, LOW_INSTR_SAT2, LOW_REPR_SAT2, HIGH_INSTR_SAT2, HIGH_REPR_SAT2,
+                   VALID_MIN2 - 1, VALID_MIN2, 100};
+  double expected[] = {NULL8, LOW_INSTR_SAT8, LOW_REPR_SAT8, HIGH_INSTR_SAT8, HIGH_REPR_SAT8,
+                       LOW_REPR_SAT8, VALID_MIN2 * 2.0 + 1.0, 201.0};
+
+  for (int useSimd = 0; useSimd < 2; useSimd++) {
+    CubePixelConverter converter(SignedWord, 1.0, 2.0, useSimd);
+    EXPECT_EQ(SignedWord, converter.pixelType());
+
+    double doubles[8];
+    converter.toDouble((const char *) words, doubles, 8);
+    for (int i = 0; i < 8; i++) {
+      EXPECT_EQ(0, memcmp(&expected[i], &doubles[i], sizeof(double))) << "Pixel " << i;
+    }
+  }
+
+  unsigned char bytes[] = {NULL1, HIGH_REPR_SAT1, 1, 254, 7};
+  for (int useSimd = 0; useSimd < 2; useSimd++) {
+    CubePixelConverter converter(UnsignedByte, 0.0, 1.0, useSimd);
+    double doubles[5];
+    converter.toDouble((const char *) bytes, doubles, 5);
+    EXPECT_EQ(NULL8, doubles[0]);
+    EXPECT_EQ(HIGH_REPR_SAT8, doubles[1]);
+    EXPECT_EQ(1.0, doubles[2]);
+    EXPECT_EQ(254.0, doubles[3]);
+    EXPECT_EQ(7.0, doubles[4]);
+  }
+}
+
+
+TEST(CubePixelConverter, ToRaw) {
+  double doubles[] = {NULL8, LOW_INSTR_SAT8, LOW_REPR_SAT8, HIGH_INSTR_SAT8, HIGH_REPR_SAT8,
+                      -1.0e10, 1.0e10, 100.4, 100.6};
+
+  CubePixelConverter words(SignedWord, 0.0, 1.0);
+  short wordPixels[9];
+  words.toRaw(doubles, (char *) wordPixels, 9);
+  short expectedWords[] = {NULL2, LOW_INSTR_SAT2, LOW_REPR_SAT2, HIGH_INSTR_SAT2, HIGH_REPR_SAT2,
+                           LOW_REPR_SAT2, HIGH_REPR_SAT2, 100, 101};
+  for (int i = 0; i < 9; i++) {
+    EXPECT_EQ(expectedWords[i], wordPixels[i]) << "Pixel " << i;
+  }
+
+  CubePixelConverter integers(UnsignedInteger, 10.0, 1.0);
+  unsigned int integerPixels[9];
+  integers.toRaw(doubles, (char *) integerPixels, 9);
+  unsigned int expectedIntegers[] = {NULLUI4, LOW_INSTR_SATUI4, LOW_REPR_SATUI4, HIGH_INSTR_SATUI4,
+                                     HIGH_REPR_SATUI4, LOW_REPR_SATUI4, HIGH_REPR_SATUI4, 90, 91};
+  for (int i = 0; i < 9; i++) {
+    EXPECT_EQ(expectedIntegers[i], integerPixels[i]) << "Pixel " << i;
+  }
+}
+
+
+TEST(CubePixelConverter, RoundTrip) {
+  // Everything above the valid range is written back as Hrs
+  std::vector<char> raw = allWords();
+  raw.resize((VALID_MAXU2 + 1) * 2);
+  int count = raw.size() / 2;
+
+  for (int useSimd = 0; useSimd < 2; useSimd++) {
+    CubePixelConverter converter(UnsignedWord, -5.0, 0.25, useSimd);
+    std::vector<double> doubles(count);
+    converter.toDouble(raw.data(), doubles.data(), count);
+
+    std::vector<char> back(raw.size());
+    converter.toRaw(doubles.data(), back.data(), count);
+    EXPECT_EQ(raw, back);
+  }
+}
+
+
+TEST(CubePixelConverter, SimdMatchesScalarSignedWord) {
+  compareKernels(SignedWord, allWords(), 0.0, 1.0);
+  compareKernels(SignedWord, allWords(), 12.5, 0.003);
+}
+
+
+TEST(CubePixelConverter, SimdMatchesScalarUnsignedWord) {
+  compareKernels(UnsignedWord, allWords(), 0.0, 1.0);
+  compareKernels(UnsignedWord, allWords(), -7.0, 1.7);
+}
+
+
+TEST(CubePixelConverter, SimdMatchesScalarUnsignedInteger) {
+  compareKernels(UnsignedInteger, someIntegers(), 0.0, 1.0);
+  compareKernels(UnsignedInteger, someIntegers(), 1000.0, 0.001);
+}
+
+
+TEST(CubePixelConverter, SimdMatchesScalarUnsignedByte) {
+  compareKernels(UnsignedByte, allBytes(), 0.0, 1.0);
+  compareKernels(UnsignedByte, allBytes(), 3.0, 0.5);
+}
+
+
+TEST(CubePixelConverter, SimdMatchesScalarReal) {
+  compareKernels(Real, someReals(), 0.0, 1.0);
+}
+
+
+/**
+ * Microbenchmark for the read conversion. Disabled by default; run it with
+ * --gtest_also_run_disabled_tests --gtest_filter=*ReadBenchmark and
+ * --gtest_output=xml to get the scalar and vector conversion rates of each
+ * pixel type, in megapixels per second, as test properties.
+ */
+TEST(CubePixelConverter, DISABLED_ReadBenchmark) {
+  RecordProperty("InstructionSet", CubePixelConverter::simdInstructionSet().toStdString());
+
+  PixelType pixelTypes[] = {UnsignedByte, SignedWord, UnsignedWord, UnsignedInteger, Real};
+  for (PixelType pixelType : pixelTypes) {
+    double scalarRate = readRate(pixelType, false);
+    double simdRate = readRate(pixelType, true);
+    EXPECT_GT(scalarRate, 0.0);
+    EXPECT_GT(simdRate, 0.0);
+
+    QString name = PixelTypeName(pixelType);
+    RecordProperty((name + "ScalarMegapixelsPerSecond").toStdString(), (int) scalarRate);
+    RecordProperty((name + "SimdMegapixelsPerSecond").toStdString(), (int) simdRate);
+  }
+}
@@ -0,0 +1,142 @@
+#include <vector>
+
+#include <QString>
+#include <QVector>
+
+#include "EmbreeShapeModel.h"
+#include "EmbreeTargetManager.h"
+#include "LinearAlgebra.h"
+#include "SurfacePoint.h"
+
+#include <gtest/gtest.h>
+
+using namespace Isis;
+
+namespace {
+  /**
+   * Look directions from an observer on the x axis through a grid around the
+   * center of the target, including some that miss it.
+   */
+  QVector< std::vector<double> > gridDirections(const std::vector<double> &observer) {
+    QVector< std::vector<double> > directions;
+    for (int line = -10; line <= 10; line++) {
+      for (int sample = -10; sample <= 10; sample++) {
+        LinearAlgebra::Vector toTarget = LinearAlgebra::vector(-observer[0],
+                                                               sample * 0.04 - observer[1],
+                                                               line * 0.04 - observer[2]);
+        toTarget = LinearAlgebra::normalize(toTarget);
+        directions.append(std::vector<double>(toTarget.begin(), toTarget.end()));
+      }
+    }
+    return directions;
+  }
+
+
+  std::vector<double> lookDirection(const std::vector<double> &from,
+                                    const LinearAlgebra::Vector &to) {
+    LinearAlgebra::Vector look = LinearAlgebra::normalize(
+        to - LinearAlgebra::vector(from[0], from[1], from[2]));
+    return std::vector<double>(look.begin(), look.end());
+  }
+
+
+  const QString dskfile("$ISISTESTDATA/isis/src/base/unitTestData/"
+                        "hay_a_amica_5_itokawashape_v1_0_64q.bds");
+}
+
+
+TEST(EmbreeShapeModel, IntersectSurfaces) {
+  EmbreeShapeModel itokawaModel(NULL, dskfile, EmbreeTargetManager::getInstance());
+
+  std::vector<double> observer(3);
+  observer[0] = 2.0;
+  observer[1] = 0.1;
+  observer[2] = -0.05;
+  QVector< std::vector<double> > directions = gridDirections(observer);
+
+  QVector<RayHitInformation> intersections;
+  QVector<bool> hasIntersections = itokawaModel.intersectSurfaces(observer, directions,
+                                                                  intersections);
+  ASSERT_EQ(directions.size(), hasIntersections.size());
+  ASSERT_EQ(directions.size(), intersections.size());
+
+  int hitCount = 0;
+  for (int i = 0; i < directions.size(); i++) {
+    ASSERT_EQ(itokawaModel.intersectSurface(observer, directions[i]), hasIntersections[i])
+        << "Ray " << i;
+    if (!hasIntersections[i]) {
+      continue;
+    }
+    hitCount++;
+
+    std::vector<double> expected(3);
+    itokawaModel.surfaceIntersection()->ToNaifArray(&expected[0]);
+    std::vector<double> expectedNormal = itokawaModel.normal();
+    for (int k = 0; k < 3; k++) {
+      EXPECT_NEAR(expected[k], intersections[i].intersection[k], 1e-10) << "Ray " << i;
+      EXPECT_NEAR(expectedNormal[k], intersections[i].surfaceNormal[k], 1e-10) << "Ray " << i;
+    }
+  }
+  EXPECT_GT(hitCount, 0);
+  EXPECT_LT(hitCount, directions.size());
+}
+
+
+TEST(EmbreeShapeModel, IsOccludedFrom) {
+  EmbreeShapeModel itokawaModel(NULL, dskfile, EmbreeTargetManager::getInstance());
+  itokawaModel.setTolerance(1.0e-5);
+
+  std::vector<double> observer(3);
+  observer[0] = 2.0;
+  observer[1] = 0.1;
+  observer[2] = -0.05;
+  QVector< std::vector<double> > directions = gridDirections(observer);
+
+  QVector<RayHitInformation> intersections;
+  QVector<bool> hasIntersections = itokawaModel.intersectSurfaces(observer, directions,
+                                                                  intersections);
+
+  // Every intersection is the first thing the observer sees along its ray
+  QVector<bool> occluded = itokawaModel.isOccludedFrom(observer, intersections,
+                                                       hasIntersections);
+  ASSERT_EQ(directions.size(), occluded.size());
+  for (int i = 0; i < directions.size(); i++) {
+    EXPECT_EQ(!hasIntersections[i], occluded[i]) << "Ray " << i;
+  }
+
+  // From off to the side, some of them are hidden behind the rest of the target
+  std::vector<double> position(3);
+  position[0] = 0.3;
+  position[1] = 2.0;
+  position[2] = 0.5;
+  occluded = itokawaModel.isOccludedFrom(position, intersections, hasIntersections);
+  ASSERT_EQ(directions.size(), occluded.size());
+
+  int occludedCount = 0;
+  int visibleCount = 0;
+  int disagreements = 0;
+  for (int i = 0; i < directions.size(); i++) {
+    if (!hasIntersections[i]) {
+      EXPECT_TRUE(occluded[i]) << "Ray " << i;
+      continue;
+    }
+    ASSERT_TRUE(itokawaModel.intersectSurface(observer, directions[i])) << "Ray " << i;
+    bool visible = itokawaModel.isVisibleFrom(position,
+                                              lookDirection(position,
+                                                            intersections[i].intersection));
+    if (occluded[i]) {
+      occludedCount++;
+    }
+    else {
+      visibleCount++;
+    }
+    // isVisibleFrom accepts a hit on a neighboring plate within the tolerance,
+    //   so the two can only differ right at the edge of a plate.
+    if (visible == occluded[i]) {
+      disagreements++;
+    }
+  }
+  EXPECT_GT(occludedCount, 0);
+  EXPECT_GT(visibleCount, 0);
+  EXPECT_LE(disagreements, 2);
+}
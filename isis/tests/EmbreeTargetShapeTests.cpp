@@ -0,0 +1,141 @@
+#include <cmath>
+#include <vector>
+
+#include <QString>
+
+#include "EmbreeTargetShape.h"
+#include "IException.h"
+#include "LinearAlgebra.h"
+
+#include <gtest/gtest.h>
+
+using namespace Isis;
+
+namespace {
+  /**
+   * Look directions from an observer on the x axis through a grid around the
+   * center of the target, including some that miss it.
+   */
+  std::vector<LinearAlgebra::Vector> gridDirections(LinearAlgebra::Vector &observer) {
+    std::vector<LinearAlgebra::Vector> directions;
+    for (int line = -10; line <= 10; line++) {
+      for (int sample = -10; sample <= 10; sample++) {
+        LinearAlgebra::Vector target = LinearAlgebra::vector(0.0, sample * 0.04, line * 0.04);
+        directions.push_back(LinearAlgebra::normalize(target - observer));
+      }
+    }
+    return directions;
+  }
+}
+
+
+TEST(EmbreeTargetShape, IntersectRays) {
+  QString dskfile("$ISISTESTDATA/isis/src/base/unitTestData/hay_a_amica_5_itokawashape_v1_0_64q.bds");
+  EmbreeTargetShape itokawaShape(dskfile);
+
+  LinearAlgebra::Vector observer = LinearAlgebra::vector(2.0, 0.1, -0.05);
+  std::vector<LinearAlgebra::Vector> directions = gridDirections(observer);
+
+  std::vector<RTCRayHit> rays(directions.size());
+  for (size_t i = 0; i < directions.size(); i++) {
+    RTCMultiHitRay ray(observer, directions[i]);
+    rays[i].ray = ray.ray;
+    rays[i].hit = ray.hit;
+  }
+  itokawaShape.intersectRays(rays);
+
+  int hitCount = 0;
+  for (size_t i = 0; i < directions.size(); i++) {
+    // The stream finds the hit closest to the observer
+    RTCMultiHitRay ray(observer, directions[i]);
+    itokawaShape.intersectRay(ray);
+    ASSERT_EQ(ray.lastHit >= 0, rays[i].hit.geomID != RTC_INVALID_GEOMETRY_ID) << "Ray " << i;
+    if (ray.lastHit < 0) {
+      EXPECT_THROW(itokawaShape.getHitInformation(rays[i]), IException);
+      continue;
+    }
+    hitCount++;
+
+    RayHitInformation closest = itokawaShape.getHitInformation(ray, 0);
+    for (int j = 1; j <= ray.lastHit; j++) {
+      RayHitInformation hit = itokawaShape.getHitInformation(ray, j);
+      if (LinearAlgebra::magnitude(hit.intersection - observer) <
+          LinearAlgebra::magnitude(closest.intersection - observer)) {
+        closest = hit;
+      }
+    }
+
+    RayHitInformation streamHit = itokawaShape.getHitInformation(rays[i]);
+    EXPECT_EQ(closest.primID, streamHit.primID) << "Ray " << i;
+    EXPECT_NEAR(closest.intersection[0], streamHit.intersection[0], 1e-6) << "Ray " << i;
+    EXPECT_NEAR(closest.intersection[1], streamHit.intersection[1], 1e-6) << "Ray " << i;
+    EXPECT_NEAR(closest.intersection[2], streamHit.intersection[2], 1e-6) << "Ray " << i;
+    EXPECT_NEAR(closest.surfaceNormal[0], streamHit.surfaceNormal[0], 1e-6) << "Ray " << i;
+    EXPECT_NEAR(closest.surfaceNormal[1], streamHit.surfaceNormal[1], 1e-6) << "Ray " << i;
+    EXPECT_NEAR(closest.surfaceNormal[2], streamHit.surfaceNormal[2], 1e-6) << "Ray " << i;
+  }
+
+  // The grid covers the target and the space around it
+  EXPECT_GT(hitCount, 0);
+  EXPECT_LT(hitCount, (int) directions.size());
+}
+
+
+TEST(EmbreeTargetShape, IsOccludedStream) {
+  QString dskfile("$ISISTESTDATA/isis/src/base/unitTestData/hay_a_amica_5_itokawashape_v1_0_64q.bds");
+  EmbreeTargetShape itokawaShape(dskfile);
+
+  LinearAlgebra::Vector observer = LinearAlgebra::vector(2.0, 0.1, -0.05);
+  std::vector<LinearAlgebra::Vector> directions = gridDirections(observer);
+
+  // Check the visible surface against the sun, off to the side of the target,
+  // so part of it is shadowed
+  LinearAlgebra::Vector sun = LinearAlgebra::vector(-0.5, 5.0, 0.3);
+  std::vector<RTCOcclusionRay> rays;
+  for (size_t i = 0; i < directions.size(); i++) {
+    RTCMultiHitRay ray(observer, directions[i]);
+    itokawaShape.intersectRay(ray);
+    if (ray.lastHit < 0) {
+      continue;
+    }
+
+    // Trace from each intersection on the visible surface and from the
+    // far side of the target
+    for (int j = 0; j <= ray.lastHit; j++) {
+      RayHitInformation hit = itokawaShape.getHitInformation(ray, j);
+      LinearAlgebra::Vector toSun = sun - hit.intersection;
+      RTCOcclusionRay occlusionRay(hit.intersection, LinearAlgebra::normalize(toSun));
+      occlusionRay.ray.tnear = 0.0005;
+      occlusionRay.ray.tfar = LinearAlgebra::magnitude(toSun);
+      occlusionRay.ignorePrimID = hit.primID;
+      rays.push_back(occlusionRay);
+    }
+  }
+  ASSERT_FALSE(rays.empty());
+
+  std::vector<RTCOcclusionRay> singleRays(rays);
+  std::vector<bool> occluded = itokawaShape.isOccluded(rays);
+  ASSERT_EQ(rays.size(), occluded.size());
+
+  int occludedCount = 0;
+  for (size_t i = 0; i < singleRays.size(); i++) {
+    EXPECT_EQ(itokawaShape.isOccluded(singleRays[i]), occluded[i]) << "Ray " << i;
+    if (occluded[i]) {
+      occludedCount++;
+    }
+  }
+  EXPECT_GT(occludedCount, 0);
+  EXPECT_LT(occludedCount, (int) occluded.size());
+}
+
+
+TEST(EmbreeTargetShape, EmptyStreams) {
+  EmbreeTargetShape emptyShape;
+
+  std::vector<RTCRayHit> rays;
+  emptyShape.intersectRays(rays);
+  EXPECT_TRUE(rays.empty());
+
+  std::vector<RTCOcclusionRay> occlusionRays;
+  EXPECT_TRUE(emptyShape.isOccluded(occlusionRays).empty());
+}
@@ -0,0 +1,126 @@
+#include <cmath>
+
+#include "AutoReg.h"
+#include "Chip.h"
+#include "FourierCorrelation.h"
+#include "IString.h"
+#include "MaximumCorrelation.h"
+#include "Pvl.h"
+#include "PvlGroup.h"
+#include "PvlKeyword.h"
+#include "PvlObject.h"
+#include "SpecialPixel.h"
+
+#include "gtest/gtest.h"
+
+using namespace Isis;
+
+namespace {
+  // Where the pattern was cut out of the search chip
+  const int PatternSampleOffset = 12;
+  const int PatternLineOffset = 9;
+
+  Pvl registrationTemplate(double tolerance, bool subpixel) {
+    PvlGroup algorithm("Algorithm");
+    algorithm += PvlKeyword("Name", "FourierCorrelation");
+    algorithm += PvlKeyword("Tolerance", toString(tolerance));
+    algorithm += PvlKeyword("SubpixelAccuracy", subpixel ? "True" : "False");
+
+    PvlGroup patternChip("PatternChip");
+    patternChip += PvlKeyword("Samples", "15");
+    patternChip += PvlKeyword("Lines", "13");
+    patternChip += PvlKeyword("ValidPercent", "50");
+
+    PvlGroup searchChip("SearchChip");
+    searchChip += PvlKeyword("Samples", "45");
+    searchChip += PvlKeyword("Lines", "41");
+    searchChip += PvlKeyword("SubchipValidPercent", "50");
+
+    PvlObject registration("AutoRegistration");
+    registration.addGroup(algorithm);
+    registration.addGroup(patternChip);
+    registration.addGroup(searchChip);
+
+    Pvl pvl;
+    pvl.addObject(registration);
+    return pvl;
+  }
+
+
+  double dn(int samp, int line) {
+    if ((samp * 7 + line * 13) % 53 == 0) {
+      return Null;
+    }
+    return 1000.0 + 50.0 * sin(samp * 0.3) * cos(line * 0.2) + (samp * 31 + line * 17) % 11;
+  }
+
+
+  void loadChips(AutoReg &reg) {
+    Chip *search = reg.SearchChip();
+    for (int line = 1; line <= search->Lines(); line++) {
+      for (int samp = 1; samp <= search->Samples(); samp++) {
+        search->SetValue(samp, line, dn(samp, line));
+      }
+    }
+
+    Chip *pattern = reg.PatternChip();
+    for (int line = 1; line <= pattern->Lines(); line++) {
+      for (int samp = 1; samp <= pattern->Samples(); samp++) {
+        // Not quite the same, so the fit is not ideal and the surface is modeled
+        double value = dn(samp + PatternSampleOffset, line + PatternLineOffset);
+        pattern->SetValue(samp, line, IsSpecial(value) ? value : value + (samp * line) % 3);
+      }
+    }
+  }
+}
+
+
+TEST(FourierCorrelation, MatchesMaximumCorrelation) {
+  Pvl pvl = registrationTemplate(0.3, true);
+  MaximumCorrelation expected(pvl);
+  FourierCorrelation actual(pvl);
+  EXPECT_FALSE(actual.PhaseCorrelation());
+  EXPECT_EQ("FourierCorrelation", static_cast<AutoReg &>(actual).AlgorithmName());
+
+  loadChips(expected);
+  loadChips(actual);
+  ASSERT_EQ(expected.Register(), actual.Register());
+  ASSERT_TRUE(actual.Success());
+
+  EXPECT_NEAR(expected.GoodnessOfFit(), actual.GoodnessOfFit(), 1.0e-10);
+  EXPECT_NEAR(expected.ChipSample(), actual.ChipSample(), 1.0e-8);
+  EXPECT_NEAR(expected.ChipLine(), actual.ChipLine(), 1.0e-8);
+
+  Chip *expectedFit = expected.FitChip();
+  Chip *actualFit = actual.FitChip();
+  ASSERT_EQ(expectedFit->Samples(), actualFit->Samples());
+  ASSERT_EQ(expectedFit->Lines(), actualFit->Lines());
+  for (int line = 1; line <= expectedFit->Lines(); line++) {
+    for (int samp = 1; samp <= expectedFit->Samples(); samp++) {
+      double expectedValue = expectedFit->GetValue(samp, line);
+      double actualValue = actualFit->GetValue(samp, line);
+      if (expectedValue == Null) {
+        EXPECT_EQ(Null, actualValue) << "Sample " << samp << " Line " << line;
+      }
+      else {
+        EXPECT_NEAR(expectedValue, actualValue, 1.0e-10) << "Sample " << samp << " Line " << line;
+      }
+    }
+  }
+}
+
+
+TEST(FourierCorrelation, PhaseCorrelation) {
+  Pvl pvl = registrationTemplate(0.05, false);
+  FourierCorrelation reg(pvl, true);
+  EXPECT_TRUE(reg.PhaseCorrelation());
+  EXPECT_EQ("PhaseCorrelation", static_cast<AutoReg &>(reg).AlgorithmName());
+
+  loadChips(reg);
+  reg.Register();
+  ASSERT_TRUE(reg.Success());
+
+  // The pattern tack is at (8, 7)
+  EXPECT_EQ(8 + PatternSampleOffset, reg.ChipSample());
+  EXPECT_EQ(7 + PatternLineOffset, reg.ChipLine());
+}
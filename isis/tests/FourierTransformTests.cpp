@@ -0,0 +1,48 @@
+#include <cmath>
+#include <complex>
+#include <vector>
+
+#include "FourierTransform.h"
+#include "IException.h"
+
+#include "gtest/gtest.h"
+
+using namespace Isis;
+
+TEST(FourierTransform, InPlaceMatchesVector) {
+  FourierTransform fft;
+  std::vector< std::complex<double> > input;
+  for (int i = 0; i < 16; i++) {
+    input.push_back(std::complex<double>(sin(0.3 * i) + i % 3, cos(0.7 * i)));
+  }
+  std::vector< std::complex<double> > expected = fft.Transform(input);
+
+  std::vector< std::complex<double> > data = input;
+  fft.Transform(&data[0], 16);
+  for (int i = 0; i < 16; i++) {
+    EXPECT_NEAR(expected[i].real(), data[i].real(), 1.0e-12);
+    EXPECT_NEAR(expected[i].imag(), data[i].imag(), 1.0e-12);
+  }
+
+  // The tables are rebuilt when the size changes
+  std::vector< std::complex<double> > half(input.begin(), input.begin() + 8);
+  std::vector< std::complex<double> > expectedHalf = fft.Transform(half);
+  fft.Transform(&half[0], 8);
+  for (int i = 0; i < 8; i++) {
+    EXPECT_NEAR(expectedHalf[i].real(), half[i].real(), 1.0e-12);
+    EXPECT_NEAR(expectedHalf[i].imag(), half[i].imag(), 1.0e-12);
+  }
+
+  fft.Inverse(&data[0], 16);
+  for (int i = 0; i < 16; i++) {
+    EXPECT_NEAR(input[i].real(), data[i].real(), 1.0e-12);
+    EXPECT_NEAR(input[i].imag(), data[i].imag(), 1.0e-12);
+  }
+}
+
+TEST(FourierTransform, InPlaceNotPowerOfTwo) {
+  FourierTransform fft;
+  std::vector< std::complex<double> > data(12);
+  EXPECT_THROW(fft.Transform(&data[0], 12), IException);
+  EXPECT_THROW(fft.Inverse(&data[0], 12), IException);
+}
@@ -0,0 +1,65 @@
+#include <QList>
+
+#include "Cube.h"
+#include "CubeFixtures.h"
+#include "CubeOverview.h"
+#include "Pvl.h"
+#include "PvlGroup.h"
+#include "TestUtilities.h"
+
+#include "cubeoverviews.h"
+#include "gmock/gmock.h"
+
+using namespace Isis;
+
+static QString APP_XML = FileName("$ISISROOT/bin/xml/cubeoverviews.xml").expanded();
+
+TEST_F(SmallCube, FunctionalTestCubeoverviewsDefault) {
+  QVector<QString> args = {"minsize=2"};
+  UserInterface options(APP_XML, args);
+  Pvl log;
+  cubeoverviews(testCube, options, &log);
+
+  // 10x10 halves to 5x5, 3x3 and then 2x2
+  QList<int> expectedScales;
+  expectedScales << 2 << 4 << 8;
+  EXPECT_EQ(expectedScales, CubeOverview::scales(*testCube));
+
+  PvlGroup &results = log.findGroup("Results");
+  EXPECT_EQ(3, results["Scales"].size());
+  EXPECT_EQ(8, toInt(results["Scales"][2]));
+
+  CubeOverview overview = CubeOverview::read(*testCube, 8);
+  EXPECT_EQ(2, overview.sampleCount());
+  EXPECT_DOUBLE_EQ((88 + 89 + 98 + 99) / 4.0, overview.value(2, 2, 1));
+}
+
+
+TEST_F(SmallCube, FunctionalTestCubeoverviewsReplace) {
+  QVector<QString> args = {"minscale=4", "minsize=2"};
+  UserInterface options(APP_XML, args);
+  cubeoverviews(testCube, options);
+
+  QVector<QString> newArgs = {"minscale=2", "minsize=5"};
+  UserInterface newOptions(APP_XML, newArgs);
+  cubeoverviews(testCube, newOptions);
+
+  // The scale 4 overview from the first run is not in the second one
+  QList<int> expectedScales;
+  expectedScales << 2;
+  EXPECT_EQ(expectedScales, CubeOverview::scales(*testCube));
+}
+
+
+TEST_F(SmallCube, FunctionalTestCubeoverviewsBadScale) {
+  QVector<QString> args = {"minscale=1"};
+
+  try {
+    UserInterface options(APP_XML, args);
+    cubeoverviews(testCube, options);
+    FAIL() << "Expected an exception";
+  }
+  catch (IException &e) {
+    EXPECT_THAT(e.what(), testing::HasSubstr("MINSCALE"));
+  }
+}
@@ -0,0 +1,126 @@
+#include <sstream>
+
+#include <QFile>
+#include <QString>
+#include <QTextStream>
+
+#include "campt.h"
+#include "CameraFixtures.h"
+#include "FileName.h"
+#include "isisd.h"
+#include "Preference.h"
+#include "Pvl.h"
+#include "PvlGroup.h"
+#include "PvlObject.h"
+#include "TempFixtures.h"
+#include "TestUtilities.h"
+#include "UserInterface.h"
+
+#include "gtest/gtest.h"
+
+using namespace Isis;
+
+static QString APP_XML = FileName("$ISISROOT/bin/xml/isisd.xml").expanded();
+
+TEST(Isisd, FunctionalTestIsisdUnknownApplication) {
+  Pvl response = isisdCommand("notanapp from=input.cub");
+  PvlObject &result = response.findObject("IsisdResult");
+
+  EXPECT_PRED_FORMAT2(AssertQStringsEqual, result["Application"][0], "notanapp");
+  EXPECT_PRED_FORMAT2(AssertQStringsEqual, result["Status"][0], "Error");
+  ASSERT_TRUE(result.hasGroup("Error"));
+  EXPECT_TRUE(result.findGroup("Error")["Message"][0].contains("can not be run by isisd"));
+}
+
+TEST(Isisd, FunctionalTestIsisdBadParameter) {
+  Pvl response = isisdCommand("campt nosuchparameter=5");
+  PvlObject &result = response.findObject("IsisdResult");
+
+  EXPECT_PRED_FORMAT2(AssertQStringsEqual, result["Application"][0], "campt");
+  EXPECT_PRED_FORMAT2(AssertQStringsEqual, result["Status"][0], "Error");
+  EXPECT_TRUE(result.hasGroup("Error"));
+}
+
+TEST(Isisd, FunctionalTestIsisdRestoresPreferences) {
+  PvlKeyword &progressBar = Preference::Preferences().findGroup("UserInterface")["ProgressBar"];
+  PvlKeyword &terminalOutput = Preference::Preferences().findGroup("SessionLog")["TerminalOutput"];
+  QString originalProgressBar = progressBar[0];
+  QString originalTerminalOutput = terminalOutput[0];
+  progressBar.setValue("On");
+  terminalOutput.setValue("On");
+
+  isisdCommand("campt nosuchparameter=5");
+  isisdCommand("notanapp from=input.cub");
+
+  EXPECT_PRED_FORMAT2(AssertQStringsEqual, progressBar[0], "On");
+  EXPECT_PRED_FORMAT2(AssertQStringsEqual, terminalOutput[0], "On");
+
+  progressBar.setValue(originalProgressBar);
+  terminalOutput.setValue(originalTerminalOutput);
+}
+
+TEST_F(DefaultCube, FunctionalTestIsisdMatchesApplication) {
+  Pvl response = isisdCommand("campt from='" + testCube->fileName() + "' sample=10 line=20");
+  PvlObject &result = response.findObject("IsisdResult");
+  ASSERT_PRED_FORMAT2(AssertQStringsEqual, result["Status"][0], "Success");
+
+  QVector<QString> args = {"from=" + testCube->fileName(), "sample=10", "line=20"};
+  UserInterface options(FileName("$ISISROOT/bin/xml/campt.xml").expanded(), args);
+  Pvl appLog;
+  campt(options, &appLog);
+
+  PvlGroup &isisdPoint = result.findGroup("GroundPoint");
+  PvlGroup &appPoint = appLog.findGroup("GroundPoint");
+  ASSERT_EQ(appPoint.keywords(), isisdPoint.keywords());
+  for (int i = 0; i < appPoint.keywords(); i++) {
+    EXPECT_PRED_FORMAT2(AssertQStringsEqual, appPoint[i].name(), isisdPoint[i].name());
+    ASSERT_EQ(appPoint[i].size(), isisdPoint[i].size());
+    for (int j = 0; j < appPoint[i].size(); j++) {
+      EXPECT_PRED_FORMAT2(AssertQStringsEqual, appPoint[i][j], isisdPoint[i][j]);
+    }
+  }
+}
+
+TEST_F(DefaultCube, FunctionalTestIsisdCommandFile) {
+  QString fromFile = tempDir.path() + "/commands.txt";
+  QString toFile = tempDir.path() + "/responses.pvl";
+
+  QFile commands(fromFile);
+  ASSERT_TRUE(commands.open(QIODevice::WriteOnly | QIODevice::Text));
+  QTextStream stream(&commands);
+  stream << "# Two good commands with a bad one between them\n"
+         << "campt from=" << testCube->fileName() << " sample=10 line=20\n"
+         << "\n"
+         << "campt from=" << tempDir.path() << "/missing.cub\n"
+         << "campt from=" << testCube->fileName() << " sample=30 line=40\n"
+         << "exit\n"
+         << "campt from=" << testCube->fileName() << "\n";
+  commands.close();
+
+  QVector<QString> args = {"from=" + fromFile, "to=" + toFile};
+  UserInterface options(APP_XML, args);
+  isisd(options);
+
+  // Each response is a Pvl ending with End, so read them back one at a time
+  QFile responses(toFile);
+  ASSERT_TRUE(responses.open(QIODevice::ReadOnly | QIODevice::Text));
+  QStringList statuses;
+  QString text;
+  QTextStream input(&responses);
+  while (!input.atEnd()) {
+    QString line = input.readLine();
+    text += line + "\n";
+    if (line.trimmed() == "End") {
+      Pvl response;
+      std::stringstream responseStream(text.toStdString());
+      responseStream >> response;
+      statuses.append(response.findObject("IsisdResult")["Status"][0]);
+      text.clear();
+    }
+  }
+
+  ASSERT_EQ(3, statuses.size());
+  EXPECT_PRED_FORMAT2(AssertQStringsEqual, statuses[0], "Success");
+  EXPECT_PRED_FORMAT2(AssertQStringsEqual, statuses[1], "Error");
+  EXPECT_PRED_FORMAT2(AssertQStringsEqual, statuses[2], "Success");
+}
@@ -2,8 +2,10 @@
 #include <cmath>
 
 #include <QtMath>
+#include <QDir>
 #include <QFile>
 #include <QScopedPointer>
+#include <QThreadPool>
 
 #include "Pvl.h"
 #include "PvlGroup.h"
@@ -222,6 +224,56 @@ TEST_F(ApolloNetwork, FunctionalTestJigsawApollo) {
   }
 }
 
+TEST_F(ApolloNetwork, FunctionalTestJigsawThreadCount) {
+  // The normal equations and error propagation run in parallel, but the
+  // solution and its sigmas must not depend on how many threads are used
+  int originalThreadCount = QThreadPool::globalInstance()->maxThreadCount();
+  QList<int> threadCounts = {1, 4};
+  QStringList pointsOutputs;
+  QStringList imagesOutputs;
+
+  for (int threadCount : threadCounts) {
+    QString prefix = tempDir.path() + "/threads" + QString::number(threadCount);
+    QDir().mkpath(prefix);
+
+    QVector<QString> args = {"radius=yes",
+                              "errorpropagation=yes",
+                              "spsolve=position",
+                              "camsolve=angles",
+                              "twist=yes",
+                              "update=no",
+                              "bundleout_txt=no",
+                              "cnet="+controlNetPath,
+                              "fromlist="+tempDir.path() + "/cubes.lis",
+                              "onet="+prefix+"/apollo_out.net",
+                              "file_prefix="+prefix+"/"};
+
+    UserInterface ui(APP_XML, args);
+
+    QThreadPool::globalInstance()->setMaxThreadCount(threadCount);
+    try {
+      jigsaw(ui);
+    }
+    catch (IException &e) {
+      QThreadPool::globalInstance()->setMaxThreadCount(originalThreadCount);
+      FAIL() << "Unable to bundle adjust with " << threadCount << " threads: " << e.what();
+    }
+    QThreadPool::globalInstance()->setMaxThreadCount(originalThreadCount);
+
+    QFile pointsFile(prefix + "/bundleout_points.csv");
+    ASSERT_TRUE(pointsFile.open(QIODevice::ReadOnly));
+    pointsOutputs.append(QString(pointsFile.readAll()));
+
+    QFile imagesFile(prefix + "/bundleout_images.csv");
+    ASSERT_TRUE(imagesFile.open(QIODevice::ReadOnly));
+    imagesOutputs.append(QString(imagesFile.readAll()));
+  }
+
+  EXPECT_EQ(pointsOutputs[0], pointsOutputs[1]);
+  EXPECT_EQ(imagesOutputs[0], imagesOutputs[1]);
+}
+
+
 TEST_F(ApolloNetwork, FunctionalTestJigsawBundleXYZ) {
   // Bundle Lat / Lat Bundleout
   QVector<QString> args = {"radius=yes",
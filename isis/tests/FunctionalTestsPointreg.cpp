@@ -1,9 +1,14 @@
+#include <QFile>
+#include <QThreadPool>
+
 #include "pointreg.h"
 
 #include "NetworkFixtures.h"
 #include "TestUtilities.h"
 #include "UserInterface.h"
+#include "ControlMeasure.h"
 #include "ControlNet.h"
+#include "ControlPoint.h"
 #include "LineManager.h"
 
 #include "gmock/gmock.h"
@@ -47,6 +52,79 @@ TEST_F(ThreeImageNetwork, FunctionalTestPointregDefault) {
   EXPECT_EQ(int(outNet.GetNumMeasures()), 41);
 }
 
+TEST_F(ThreeImageNetwork, FunctionalTestPointregThreadCount) {
+  // The measures are registered on several threads, but the output network,
+  // the flat file and the log must not depend on how many threads are used
+  int originalThreadCount = QThreadPool::globalInstance()->maxThreadCount();
+  QList<int> threadCounts = {1, 4};
+  QStringList flatFiles;
+  QList<Pvl> logs;
+  QList<ControlNet *> outNets;
+  QTemporaryDir prefix;
+
+  for (int threadCount : threadCounts) {
+    QString flatFilePath = prefix.path() + "/flatfile" + QString::number(threadCount) + ".csv";
+    QString outNetPath = prefix.path() + "/outNet" + QString::number(threadCount) + ".net";
+    QVector<QString> args = { "fromlist=" + cubeListFile,
+                              "cnet=" + networkFile,
+                              "deffile=data/threeImageNetwork/autoRegTemplate.def",
+                              "flatfile=" + flatFilePath,
+                              "onet=" + outNetPath,
+                              "outputfailed=yes" };
+    UserInterface options(APP_XML, args);
+    Pvl log;
+
+    QThreadPool::globalInstance()->setMaxThreadCount(threadCount);
+    try {
+      pointreg(options, &log);
+    }
+    catch (IException &e) {
+      QThreadPool::globalInstance()->setMaxThreadCount(originalThreadCount);
+      qDeleteAll(outNets);
+      FAIL() << "Unable to register with " << threadCount << " threads: " << e.what();
+    }
+    QThreadPool::globalInstance()->setMaxThreadCount(originalThreadCount);
+
+    QFile flatFile(flatFilePath);
+    ASSERT_TRUE(flatFile.open(QIODevice::ReadOnly));
+    flatFiles.append(QString(flatFile.readAll()));
+    logs.append(log);
+    outNets.append(new ControlNet(outNetPath));
+  }
+
+  EXPECT_EQ(flatFiles[0], flatFiles[1]);
+
+  ASSERT_EQ(logs[0].groups(), logs[1].groups());
+  for (int g = 0; g < logs[0].groups(); g++) {
+    const PvlGroup &serial = logs[0].group(g);
+    const PvlGroup &threaded = logs[1].group(g);
+    EXPECT_EQ(serial.name(), threaded.name());
+    ASSERT_EQ(serial.keywords(), threaded.keywords()) << serial.name().toStdString();
+    for (int k = 0; k < serial.keywords(); k++) {
+      EXPECT_EQ(serial[k][0], threaded[k][0]) << serial[k].name().toStdString();
+    }
+  }
+
+  ASSERT_EQ(outNets[0]->GetNumPoints(), outNets[1]->GetNumPoints());
+  for (int p = 0; p < outNets[0]->GetNumPoints(); p++) {
+    ControlPoint *serialPoint = outNets[0]->GetPoint(p);
+    ControlPoint *threadedPoint = outNets[1]->GetPoint(p);
+    EXPECT_EQ(serialPoint->GetId(), threadedPoint->GetId());
+    EXPECT_EQ(serialPoint->IsIgnored(), threadedPoint->IsIgnored());
+    ASSERT_EQ(serialPoint->GetNumMeasures(), threadedPoint->GetNumMeasures());
+    for (int m = 0; m < serialPoint->GetNumMeasures(); m++) {
+      const ControlMeasure *serialMeasure = serialPoint->GetMeasure(m);
+      const ControlMeasure *threadedMeasure = threadedPoint->GetMeasure(m);
+      EXPECT_EQ(serialMeasure->GetCubeSerialNumber(), threadedMeasure->GetCubeSerialNumber());
+      EXPECT_EQ(serialMeasure->GetType(), threadedMeasure->GetType());
+      EXPECT_EQ(serialMeasure->IsIgnored(), threadedMeasure->IsIgnored());
+      EXPECT_EQ(serialMeasure->GetSample(), threadedMeasure->GetSample());
+      EXPECT_EQ(serialMeasure->GetLine(), threadedMeasure->GetLine());
+    }
+  }
+  qDeleteAll(outNets);
+}
+
 TEST_F(ThreeImageNetwork, FunctionalTestPointregFailOptions) {
   Pvl log;
   QTemporaryDir prefix;
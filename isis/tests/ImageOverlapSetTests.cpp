@@ -0,0 +1,119 @@
+#include <memory>
+#include <vector>
+
+#include <QString>
+
+#include <geos/geom/MultiPolygon.h>
+#include <geos/geom/Point.h>
+#include <geos/io/WKTReader.h>
+
+#include "ImageOverlap.h"
+#include "ImageOverlapSet.h"
+#include "PolygonTools.h"
+
+#include "gtest/gtest.h"
+
+using namespace Isis;
+
+namespace {
+  geos::geom::MultiPolygon *square(double lon, double lat, double size) {
+    QString wkt = QString("MULTIPOLYGON(((%1 %2, %1 %4, %3 %4, %3 %2, %1 %2)))")
+                  .arg(lon).arg(lat).arg(lon + size).arg(lat + size);
+    geos::io::WKTReader reader(*globalFactory);
+    return PolygonTools::MakeMultiPolygon(reader.read(wkt.toStdString()).release());
+  }
+}
+
+
+TEST(ImageOverlapSet, ManyApartImages) {
+  std::vector<QString> sns;
+  std::vector<geos::geom::MultiPolygon *> polygons;
+
+  // Two overlapping images
+  sns.push_back("A");
+  polygons.push_back(square(0, 0, 2));
+  sns.push_back("B");
+  polygons.push_back(square(1, 0, 2));
+
+  // Lots of images that do not overlap anything, one of them touching B
+  for (int i = 0; i < 50; i++) {
+    sns.push_back("Apart" + QString::number(i));
+    polygons.push_back(square(3 + 2 * (i % 10), 3 * (i / 10), 1));
+  }
+
+  ImageOverlapSet overlaps(false, false);
+  overlaps.FindImageOverlaps(sns, polygons);
+
+  ASSERT_EQ(53, overlaps.Size());
+
+  int shared = 0;
+  double totalArea = 0.0;
+  for (int i = 0; i < overlaps.Size(); i++) {
+    const ImageOverlap *overlap = overlaps[i];
+    totalArea += overlap->Polygon()->getArea();
+
+    if (overlap->Size() == 2) {
+      shared++;
+      EXPECT_EQ("A", (*overlap)[0]);
+      EXPECT_EQ("B", (*overlap)[1]);
+      EXPECT_NEAR(2.0, overlap->Polygon()->getArea(), 1e-10);
+    }
+    else {
+      ASSERT_EQ(1, overlap->Size());
+    }
+  }
+
+  EXPECT_EQ(1, shared);
+  EXPECT_NEAR(6.0 + 50.0, totalArea, 1e-10);
+
+  for (unsigned int i = 0; i < polygons.size(); i++) {
+    delete polygons[i];
+  }
+}
+
+
+TEST(ImageOverlapSet, OverlappingGrid) {
+  std::vector<QString> sns;
+  std::vector<geos::geom::MultiPolygon *> polygons;
+
+  // Squares that overlap their neighbors, so most places are in four images, plus some far away
+  for (int i = 0; i < 24; i++) {
+    sns.push_back("Grid" + QString::number(i));
+    polygons.push_back(square(i % 6, i / 6, 2));
+  }
+  for (int i = 0; i < 10; i++) {
+    sns.push_back("Apart" + QString::number(i));
+    polygons.push_back(square(20 + 2 * i, 20, 1));
+  }
+
+  ImageOverlapSet overlaps(false, false);
+  overlaps.FindImageOverlaps(sns, polygons);
+
+  double totalArea = 0.0;
+  for (int i = 0; i < overlaps.Size(); i++) {
+    const geos::geom::MultiPolygon *polygon = overlaps[i]->Polygon();
+    totalArea += polygon->getArea();
+
+    // Every overlap has the images that cover it
+    std::unique_ptr<geos::geom::Point> point = polygon->getInteriorPoint();
+    int covering = 0;
+    for (unsigned int image = 0; image < polygons.size(); image++) {
+      if (polygons[image]->contains(point.get())) {
+        covering++;
+      }
+    }
+    EXPECT_EQ(covering, overlaps[i]->Size());
+
+    // and does not overlap any other
+    for (int j = i + 1; j < overlaps.Size(); j++) {
+      std::unique_ptr<geos::geom::Geometry> both = polygon->intersection(overlaps[j]->Polygon());
+      EXPECT_NEAR(0.0, both->getArea(), 1e-10);
+    }
+  }
+
+  EXPECT_NEAR(7.0 * 5.0 + 10.0, totalArea, 1e-10);
+
+  for (unsigned int i = 0; i < polygons.size(); i++) {
+    delete polygons[i];
+  }
+}
@@ -0,0 +1,251 @@
+#include <cmath>
+#include <random>
+
+#include "Constants.h"
+#include "Hapke.h"
+#include "IException.h"
+#include "IString.h"
+#include "LunarLambert.h"
+#include "PhotometricLookupTable.h"
+#include "Pvl.h"
+#include "PvlGroup.h"
+#include "PvlObject.h"
+
+#include "gtest/gtest.h"
+
+using namespace Isis;
+
+namespace {
+  // A smooth function with the limb darkening of a Lunar-Lambert model
+  void limbDarkening(double phase, double incidence, double emission, double *values) {
+    double mu0 = cos(incidence * PI / 180.0);
+    double mu = cos(emission * PI / 180.0);
+    values[0] = 0.3 * mu0 + 1.4 * mu0 / (mu0 + mu + 1.0e-3) * exp(-0.01 * phase);
+  }
+
+  Pvl hapkePvl() {
+    PvlGroup algorithm("Algorithm");
+    algorithm += PvlKeyword("Name", "HapkeHen");
+    algorithm += PvlKeyword("Wh", toString(0.52));
+    algorithm += PvlKeyword("B0", toString(1.0));
+    algorithm += PvlKeyword("Hh", toString(0.06));
+    algorithm += PvlKeyword("Theta", toString(30.0));
+    algorithm += PvlKeyword("Hg1", toString(0.213));
+    algorithm += PvlKeyword("Hg2", toString(1.0));
+
+    PvlObject model("PhotometricModel");
+    model.addGroup(algorithm);
+    Pvl pvl;
+    pvl.addObject(model);
+    return pvl;
+  }
+
+  Pvl lunarLambertPvl() {
+    PvlGroup algorithm("Algorithm");
+    algorithm += PvlKeyword("Name", "LunarLambert");
+    algorithm += PvlKeyword("L", toString(0.7));
+
+    PvlObject model("PhotometricModel");
+    model.addGroup(algorithm);
+    Pvl pvl;
+    pvl.addObject(model);
+    return pvl;
+  }
+
+  /**
+   * Compares a tabulated model to an untabulated one at random angles that are possible
+   * on a surface, and returns the largest relative difference.
+   */
+  double largestError(PhotoModel &tabulated, PhotoModel &exact, int sampleCount) {
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<double> angle(0.0, 85.0);
+    std::uniform_real_distribution<double> fraction(0.0, 1.0);
+
+    double largest = 0.0;
+    for (int k = 0; k < sampleCount; k++) {
+      double incidence = angle(generator);
+      double emission = angle(generator);
+      double phase = fabs(incidence - emission) + 2.0 * std::min(incidence, emission) *
+                     fraction(generator);
+      double expected = exact.CalcSurfAlbedo(phase, incidence, emission);
+      double actual = tabulated.CalcSurfAlbedo(phase, incidence, emission);
+      if (expected != 0.0) {
+        largest = std::max(largest, fabs(actual - expected) / fabs(expected));
+      }
+    }
+    return largest;
+  }
+}
+
+
+TEST(PhotometricLookupTable, Interpolates) {
+  PhotometricLookupTable table;
+  EXPECT_FALSE(table.isBuilt());
+  EXPECT_EQ(0, table.cellCount());
+
+  table.build(limbDarkening, 1.0e-3);
+  ASSERT_TRUE(table.isBuilt());
+  EXPECT_EQ(1.0e-3, table.tolerance());
+
+  // Nothing is sampled until it is needed
+  EXPECT_EQ(0, table.sampledBlockCount());
+  EXPECT_EQ(0, table.evaluationCount());
+  EXPECT_EQ(0.0, table.stepSize(40.0, 20.0, 20.0));
+
+  // The samples are reproduced at the nodes
+  double value;
+  double expected;
+  ASSERT_TRUE(table.interpolate(40.0, 20.0, 20.0, &value));
+  limbDarkening(40.0, 20.0, 20.0, &expected);
+  EXPECT_DOUBLE_EQ(expected, value);
+  EXPECT_EQ(1, table.sampledBlockCount());
+  EXPECT_GT(table.stepSize(40.0, 20.0, 20.0), 0.0);
+
+  std::mt19937 generator(1);
+  std::uniform_real_distribution<double> phase(0.0, 180.0);
+  std::uniform_real_distribution<double> angle(0.0, 90.0);
+  int interpolated = 0;
+  for (int k = 0; k < 100000; k++) {
+    double pha = phase(generator);
+    double inc = angle(generator);
+    double ema = angle(generator);
+    if (table.interpolate(pha, inc, ema, &value)) {
+      limbDarkening(pha, inc, ema, &expected);
+      EXPECT_NEAR(expected, value, 1.0e-3 * fabs(expected));
+      interpolated++;
+    }
+  }
+  EXPECT_GT(interpolated, 75000);
+  EXPECT_GT(table.cellCount(), 0);
+  EXPECT_LT(table.exactCellCount(), table.cellCount() / 4);
+
+  table.clear();
+  EXPECT_FALSE(table.isBuilt());
+  EXPECT_FALSE(table.interpolate(30.0, 20.0, 10.0, &value));
+}
+
+
+TEST(PhotometricLookupTable, SamplesOnlyNeededBlocks) {
+  PhotometricLookupTable table;
+  table.build(limbDarkening, 1.0e-3);
+
+  // Angles in two blocks along each angle
+  std::mt19937 generator(1);
+  std::uniform_real_distribution<double> phase(32.0, 40.0);
+  std::uniform_real_distribution<double> incidence(20.0, 28.0);
+  std::uniform_real_distribution<double> emission(12.0, 20.0);
+  double value;
+  for (int k = 0; k < 10000; k++) {
+    table.interpolate(phase(generator), incidence(generator), emission(generator), &value);
+  }
+
+  EXPECT_EQ(8, table.sampledBlockCount());
+  int evaluationCount = table.evaluationCount();
+  EXPECT_GT(evaluationCount, 0);
+  EXPECT_LE(evaluationCount, 8 * 17 * 17 * 17);
+
+  // The blocks are only sampled once
+  ASSERT_TRUE(table.interpolate(36.0, 24.0, 16.0, &value));
+  EXPECT_EQ(evaluationCount, table.evaluationCount());
+}
+
+
+TEST(PhotometricLookupTable, SeveralValues) {
+  PhotometricLookupTable table(2);
+  EXPECT_EQ(2, table.valueCount());
+  table.build([](double phase, double incidence, double emission, double *values) {
+                values[0] = 1.0 + phase + 2.0 * incidence + 3.0 * emission;
+                values[1] = 2.0 - incidence / 90.0;
+              },
+              1.0e-6);
+
+  double values[2];
+  ASSERT_TRUE(table.interpolate(33.3, 45.5, 12.25, values));
+  EXPECT_NEAR(1.0 + 33.3 + 91.0 + 36.75, values[0], 1.0e-9);
+  EXPECT_NEAR(2.0 - 45.5 / 90.0, values[1], 1.0e-12);
+  ASSERT_TRUE(table.interpolate(180.0, 90.0, 90.0, values));
+  EXPECT_NEAR(631.0, values[0], 1.0e-9);
+
+  // Linear functions are interpolated exactly, so the coarsest grid is enough
+  EXPECT_EQ(4.0, table.stepSize(33.3, 45.5, 12.25));
+  EXPECT_EQ(2, table.sampledBlockCount());
+  EXPECT_EQ(2, table.cellCount());
+  EXPECT_EQ(0, table.exactCellCount());
+}
+
+
+TEST(PhotometricLookupTable, Refused) {
+  PhotometricLookupTable table;
+  double value;
+  EXPECT_FALSE(table.interpolate(30.0, 20.0, 10.0, &value));
+
+  EXPECT_THROW(table.build(limbDarkening, 0.0), IException);
+  EXPECT_THROW(table.build(limbDarkening, -1.0), IException);
+  EXPECT_THROW(table.build(limbDarkening, NAN), IException);
+  EXPECT_FALSE(table.isBuilt());
+
+  table.build(limbDarkening, 1.0e-3);
+  EXPECT_FALSE(table.interpolate(NAN, 20.0, 10.0, &value));
+  EXPECT_FALSE(table.interpolate(-1.0, 20.0, 10.0, &value));
+  EXPECT_FALSE(table.interpolate(181.0, 20.0, 10.0, &value));
+  EXPECT_FALSE(table.interpolate(30.0, 90.5, 10.0, &value));
+  EXPECT_FALSE(table.interpolate(30.0, 20.0, -0.5, &value));
+}
+
+
+TEST(PhotometricLookupTable, ExceptionsAreExact) {
+  PhotometricLookupTable table;
+  table.build([](double phase, double incidence, double emission, double *values) {
+                if (phase > 100.0 && phase < 110.0) {
+                  throw IException(IException::Unknown, "Undefined", _FILEINFO_);
+                }
+                values[0] = 1.0 + incidence + emission;
+              },
+              1.0e-3);
+
+  double value;
+  EXPECT_FALSE(table.interpolate(105.0, 20.0, 10.0, &value));
+  EXPECT_GT(table.exactCellCount(), 0);
+  ASSERT_TRUE(table.interpolate(50.0, 20.0, 10.0, &value));
+  EXPECT_NEAR(31.0, value, 1.0e-9);
+}
+
+
+TEST(PhotometricLookupTable, Hapke) {
+  Pvl pvl = hapkePvl();
+  Hapke tabulated(pvl);
+  Hapke exact(pvl);
+
+  EXPECT_EQ(0.0, tabulated.LookupTolerance());
+  tabulated.SetLookupTolerance(1.0e-3);
+  EXPECT_EQ(1.0e-3, tabulated.LookupTolerance());
+  EXPECT_LE(largestError(tabulated, exact, 20000), 1.0e-3);
+
+  // The table does not apply at standard conditions
+  tabulated.SetStandardConditions(true);
+  exact.SetStandardConditions(true);
+  EXPECT_EQ(exact.CalcSurfAlbedo(37.3, 24.1, 15.7), tabulated.CalcSurfAlbedo(37.3, 24.1, 15.7));
+  EXPECT_THROW(tabulated.SetLookupTolerance(1.0e-3), IException);
+  EXPECT_EQ(0.0, tabulated.LookupTolerance());
+  tabulated.SetStandardConditions(false);
+  exact.SetStandardConditions(false);
+
+  // The failed build discarded the table
+  EXPECT_EQ(exact.CalcSurfAlbedo(52.1, 31.4, 27.9), tabulated.CalcSurfAlbedo(52.1, 31.4, 27.9));
+}
+
+
+TEST(PhotometricLookupTable, Discarded) {
+  Pvl pvl = lunarLambertPvl();
+  LunarLambert tabulated(pvl);
+  LunarLambert exact(pvl);
+
+  tabulated.SetLookupTolerance(1.0e-2);
+  EXPECT_EQ(1.0e-2, tabulated.LookupTolerance());
+  EXPECT_LE(largestError(tabulated, exact, 20000), 1.0e-2);
+
+  tabulated.SetLookupTolerance(0.0);
+  EXPECT_EQ(0.0, tabulated.LookupTolerance());
+  EXPECT_EQ(exact.CalcSurfAlbedo(37.3, 24.1, 15.7), tabulated.CalcSurfAlbedo(37.3, 24.1, 15.7));
+}
+
@@ -0,0 +1,116 @@
+#include <vector>
+
+#include <QString>
+
+#include "Buffer.h"
+#include "Cube.h"
+#include "CubeAttribute.h"
+#include "LineManager.h"
+#include "ProcessByLine.h"
+#include "SpecialPixel.h"
+#include "TempFixtures.h"
+
+#include "gtest/gtest.h"
+
+using namespace Isis;
+
+namespace {
+  QString createCube(const QString &fileName, int lines, int bands) {
+    Cube cube;
+    cube.setDimensions(50, lines, bands);
+    cube.setPixelType(Real);
+    cube.create(fileName);
+
+    LineManager line(cube);
+    for (line.begin(); !line.end(); line++) {
+      for (int i = 0; i < line.size(); i++) {
+        line[i] = (line.Sample(i) % 7 == 0) ? Null : line.Sample(i) * 0.5 + line.Line() +
+                                                      line.Band() * 100;
+      }
+      cube.write(line);
+    }
+    cube.close();
+
+    return fileName;
+  }
+
+
+  void scale(Buffer &in, Buffer &out) {
+    for (int i = 0; i < in.size(); i++) {
+      out[i] = IsSpecial(in[i]) ? in[i] : in[i] * 2.0 + in.Line();
+    }
+  }
+
+
+  void difference(std::vector<Buffer *> &in, std::vector<Buffer *> &out) {
+    for (int i = 0; i < in[0]->size(); i++) {
+      if (IsSpecial((*in[0])[i]) || IsSpecial((*in[1])[i])) {
+        (*out[0])[i] = Null;
+      }
+      else {
+        (*out[0])[i] = (*in[0])[i] - (*in[1])[i];
+      }
+    }
+  }
+
+
+  void compareCubes(const QString &expectedFile, const QString &actualFile) {
+    Cube expected(expectedFile);
+    Cube actual(actualFile);
+
+    LineManager expectedLine(expected);
+    LineManager actualLine(actual);
+    for (expectedLine.begin(), actualLine.begin(); !expectedLine.end();
+         expectedLine++, actualLine++) {
+      expected.read(expectedLine);
+      actual.read(actualLine);
+      for (int i = 0; i < expectedLine.size(); i++) {
+        ASSERT_EQ(expectedLine[i], actualLine[i])
+            << "Sample " << expectedLine.Sample(i) << " Line " << expectedLine.Line()
+            << " Band " << expectedLine.Band();
+      }
+    }
+  }
+}
+
+
+TEST_F(TempTestingFiles, ProcessByLineReentrant) {
+  QString inFile = createCube(tempDir.path() + "/in.cub", 300, 3);
+
+  QString files[] = {tempDir.path() + "/serial.cub", tempDir.path() + "/threaded.cub"};
+  for (int reentrant = 0; reentrant < 2; reentrant++) {
+    ProcessByLine p;
+    CubeAttributeInput inAtt;
+    p.SetInputCube(inFile, inAtt);
+    CubeAttributeOutput outAtt("+Real");
+    p.SetOutputCube(files[reentrant], outAtt, 50, 300, 3);
+    p.SetReentrant(reentrant);
+    EXPECT_EQ((bool) reentrant, p.Reentrant());
+    p.StartProcess(scale);
+    p.EndProcess();
+  }
+
+  compareCubes(files[0], files[1]);
+}
+
+
+TEST_F(TempTestingFiles, ProcessByLineReentrantCubes) {
+  QString inFile = createCube(tempDir.path() + "/in.cub", 300, 3);
+  // One line and band, so it wraps
+  QString darkFile = createCube(tempDir.path() + "/dark.cub", 1, 1);
+
+  QString files[] = {tempDir.path() + "/serial.cub", tempDir.path() + "/threaded.cub"};
+  for (int reentrant = 0; reentrant < 2; reentrant++) {
+    ProcessByLine p;
+    CubeAttributeInput inAtt;
+    p.SetInputCube(inFile, inAtt);
+    p.SetInputCube(darkFile, inAtt);
+    CubeAttributeOutput outAtt("+Real");
+    p.SetOutputCube(files[reentrant], outAtt, 50, 300, 3);
+    p.SetReentrant(reentrant);
+    p.StartProcess(difference);
+    p.EndProcess();
+  }
+
+  compareCubes(files[0], files[1]);
+}
@@ -0,0 +1,163 @@
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "Cube.h"
+#include "CubeAttribute.h"
+#include "FileName.h"
+#include "LineManager.h"
+#include "ProcessMosaic.h"
+#include "SpecialPixel.h"
+#include "TempFixtures.h"
+#include "UserInterface.h"
+
+#include "gtest/gtest.h"
+
+using namespace Isis;
+
+namespace {
+  const int MosaicSize = 40;
+
+  // Overlapping inputs, some hanging off of the mosaic
+  const int Offsets[][2] = { {1, 1}, {8, 5}, {-3, 12}, {15, 15}, {25, 30}, {12, -2}, {20, 8} };
+  const int NumInputs = 7;
+
+
+  QString createInput(const QString &fileName, int bands, int seed) {
+    Cube cube;
+    cube.setDimensions(15, 12, bands);
+    cube.setPixelType(Real);
+    cube.create(fileName);
+
+    LineManager line(cube);
+    for (line.begin(); !line.end(); line++) {
+      for (int i = 0; i < line.size(); i++) {
+        int sample = line.Sample(i);
+        if ((sample + line.Line() + seed) % 5 == 0) {
+          line[i] = Null;
+        }
+        else {
+          line[i] = ((sample * 7 + line.Line() * 3 + seed * 11) % 17) * 0.1 + line.Band() / 3.0;
+        }
+      }
+      cube.write(line);
+    }
+    cube.close();
+
+    return fileName;
+  }
+
+
+  QString createMosaic(const QString &fileName, int bands) {
+    Cube cube;
+    cube.setDimensions(MosaicSize, MosaicSize, bands);
+    cube.setPixelType(Real);
+    cube.create(fileName);
+    cube.close();
+    return fileName;
+  }
+
+
+  void runMosaic(const QString &mosaicFile, const QStringList &inputs,
+                 ProcessMosaic::ImageOverlay overlay, bool track, bool composite) {
+    QVector<QString> args = {"from=" + inputs[0], "mosaic=" + mosaicFile};
+    UserInterface ui(FileName("$ISISROOT/bin/xml/handmos.xml").expanded(), args);
+
+    ProcessMosaic p;
+    p.SetBandBinMatch(false);
+    p.SetImageOverlay(overlay);
+    p.SetTrackFlag(track);
+    p.SetCompositeFlag(composite);
+    if (overlay == ProcessMosaic::UseBandPlacementCriteria) {
+      p.SetBandNumber(2);
+      p.SetBandUseMaxValue(true);
+    }
+    p.SetCreateFlag(true);
+    p.SetOutputCube("MOSAIC", ui);
+
+    for (int i = 0; i < inputs.size(); i++) {
+      CubeAttributeInput att;
+      p.SetInputCube(inputs[i], att);
+      p.StartProcess(Offsets[i][0], Offsets[i][1], 1);
+      p.SetCreateFlag(false);
+      p.ClearInputCubes();
+    }
+    p.EndProcess();
+  }
+
+
+  void compareCubes(const QString &expectedFile, const QString &actualFile) {
+    Cube expected(expectedFile);
+    Cube actual(actualFile);
+    ASSERT_EQ(expected.bandCount(), actual.bandCount());
+
+    LineManager expectedLine(expected);
+    LineManager actualLine(actual);
+    for (expectedLine.begin(), actualLine.begin(); !expectedLine.end();
+         expectedLine++, actualLine++) {
+      expected.read(expectedLine);
+      actual.read(actualLine);
+      for (int i = 0; i < expectedLine.size(); i++) {
+        ASSERT_EQ(expectedLine[i], actualLine[i])
+            << "Sample " << expectedLine.Sample(i) << " Line " << expectedLine.Line()
+            << " Band " << expectedLine.Band();
+      }
+    }
+  }
+
+
+  /**
+   * Mosaic the same inputs one at a time and composited, and make sure the mosaics and the
+   * tracking cubes match.
+   */
+  void checkComposite(const QString &dir, ProcessMosaic::ImageOverlay overlay,
+                      int inputBands, int mosaicBands, bool track) {
+    QStringList inputs;
+    for (int i = 0; i < NumInputs; i++) {
+      inputs.append(createInput(dir + "/input" + QString::number(i) + ".cub", inputBands, i));
+    }
+
+    QString sequential = createMosaic(dir + "/sequential.cub", mosaicBands);
+    QString composite = createMosaic(dir + "/composite.cub", mosaicBands);
+
+    runMosaic(sequential, inputs, overlay, track, false);
+    runMosaic(composite, inputs, overlay, track, true);
+
+    compareCubes(sequential, composite);
+    if (track) {
+      compareCubes(dir + "/sequential_tracking.cub", dir + "/composite_tracking.cub");
+    }
+  }
+}
+
+
+TEST_F(TempTestingFiles, ProcessMosaicCompositeOnTop) {
+  checkComposite(tempDir.path(), ProcessMosaic::PlaceImagesOnTop, 2, 2, false);
+}
+
+
+TEST_F(TempTestingFiles, ProcessMosaicCompositeBeneath) {
+  checkComposite(tempDir.path(), ProcessMosaic::PlaceImagesBeneath, 2, 2, false);
+}
+
+
+TEST_F(TempTestingFiles, ProcessMosaicCompositeAverage) {
+  checkComposite(tempDir.path(), ProcessMosaic::AverageImageWithMosaic, 2, 4, false);
+}
+
+
+TEST_F(TempTestingFiles, ProcessMosaicCompositeBandPriority) {
+  checkComposite(tempDir.path(), ProcessMosaic::UseBandPlacementCriteria, 2, 2, false);
+}
+
+
+TEST_F(TempTestingFiles, ProcessMosaicCompositeTracking) {
+  checkComposite(tempDir.path(), ProcessMosaic::PlaceImagesOnTop, 1, 1, true);
+}
+
+
+TEST_F(TempTestingFiles, ProcessMosaicCompositeBandPriorityTracking) {
+  checkComposite(tempDir.path(), ProcessMosaic::UseBandPlacementCriteria, 2, 2, true);
+}
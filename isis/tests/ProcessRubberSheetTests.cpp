@@ -0,0 +1,155 @@
+#include <cmath>
+
+#include <QThreadPool>
+
+#include "Cube.h"
+#include "CubeAttribute.h"
+#include "Interpolator.h"
+#include "LineManager.h"
+#include "ProcessRubberSheet.h"
+#include "SpecialPixel.h"
+#include "TempFixtures.h"
+#include "Transform.h"
+
+#include "gtest/gtest.h"
+
+using namespace Isis;
+
+namespace {
+  /**
+   * A rotation and scale about the center of the image. Points near the corners
+   * fall outside the input so both the Null handling and the quad splitting get
+   * exercised.
+   */
+  class RotateTransform : public Transform {
+    public:
+      RotateTransform(int samples, int lines, double angle, double scale) :
+          m_samples(samples), m_lines(lines),
+          m_cos(cos(angle) * scale), m_sin(sin(angle) * scale) {}
+
+      int OutputSamples() const {
+        return m_samples;
+      }
+
+      int OutputLines() const {
+        return m_lines;
+      }
+
+      bool Xform(double &toSample, double &toLine,
+                 const double fromSample, const double fromLine) {
+        double x = fromSample - m_samples / 2.0;
+        double y = fromLine - m_lines / 2.0;
+        toSample = m_cos * x - m_sin * y + m_samples / 2.0;
+        toLine = m_sin * x + m_cos * y + m_lines / 2.0;
+        return toSample >= 0.5 && toLine >= 0.5 &&
+               toSample <= m_samples + 0.5 && toLine <= m_lines + 0.5;
+      }
+
+    private:
+      int m_samples;
+      int m_lines;
+      double m_cos;
+      double m_sin;
+  };
+
+
+  class ProcessRubberSheetThreads : public TempTestingFiles {
+    protected:
+      QString inputFileName;
+      int originalThreadCount;
+
+      void SetUp() override {
+        TempTestingFiles::SetUp();
+        originalThreadCount = QThreadPool::globalInstance()->maxThreadCount();
+
+        Cube cube;
+        cube.setDimensions(300, 280, 2);
+        inputFileName = tempDir.path() + "/input.cub";
+        cube.create(inputFileName);
+
+        LineManager line(cube);
+        for (line.begin(); !line.end(); line++) {
+          for (int i = 0; i < line.size(); i++) {
+            line[i] = sin(line.Sample(i) * 0.05) * 100.0 +
+                      cos(line.Line(i) * 0.07) * 50.0 + line.Band(i);
+          }
+          cube.write(line);
+        }
+        cube.close();
+      }
+
+      void TearDown() override {
+        QThreadPool::globalInstance()->setMaxThreadCount(originalThreadCount);
+      }
+
+      QString rubberSheet(const QString &name, bool patch, bool threaded) {
+        QString outputFileName = tempDir.path() + "/" + name + ".cub";
+
+        ProcessRubberSheet p(32, 4);
+        p.SetInputCube(inputFileName, CubeAttributeInput());
+        p.SetOutputCube(outputFileName, CubeAttributeOutput(), 300, 280, 2);
+
+        // The patch transform maps input to output, the tile transform output to input
+        double scale = patch ? 1.0 / 1.1 : 1.1;
+        RotateTransform trans(300, 280, 0.3, scale);
+        Interpolator interp(Interpolator::CubicConvolutionType);
+
+        if (threaded) {
+          QThreadPool::globalInstance()->setMaxThreadCount(4);
+          p.setTransformFactory([scale]() -> Transform * {
+            return new RotateTransform(300, 280, 0.3, scale);
+          });
+        }
+        else {
+          QThreadPool::globalInstance()->setMaxThreadCount(1);
+        }
+
+        if (patch) {
+          p.processPatchTransform(trans, interp);
+        }
+        else {
+          p.StartProcess(trans, interp);
+        }
+        p.EndProcess();
+
+        return outputFileName;
+      }
+
+      void compareCubes(const QString &serialFileName, const QString &threadedFileName) {
+        Cube serial(serialFileName);
+        Cube threaded(threadedFileName);
+
+        LineManager serialLine(serial);
+        LineManager threadedLine(threaded);
+        int validPixels = 0;
+        for (serialLine.begin(), threadedLine.begin(); !serialLine.end();
+             serialLine++, threadedLine++) {
+          serial.read(serialLine);
+          threaded.read(threadedLine);
+          for (int i = 0; i < serialLine.size(); i++) {
+            ASSERT_EQ(serialLine[i], threadedLine[i]) << "Sample " << serialLine.Sample(i)
+                << " Line " << serialLine.Line(i) << " Band " << serialLine.Band(i);
+            if (!IsSpecial(serialLine[i])) {
+              validPixels++;
+            }
+          }
+        }
+
+        EXPECT_GT(validPixels, 0);
+      }
+  };
+}
+
+
+TEST_F(ProcessRubberSheetThreads, StartProcessMatchesSerial) {
+  QString serial = rubberSheet("serialTile", false, false);
+  QString threaded = rubberSheet("threadedTile", false, true);
+  compareCubes(serial, threaded);
+}
+
+
+TEST_F(ProcessRubberSheetThreads, PatchTransformMatchesSerial) {
+  QString serial = rubberSheet("serialPatch", true, false);
+  QString threaded = rubberSheet("threadedPatch", true, true);
+  compareCubes(serial, threaded);
+}
@@ -0,0 +1,366 @@
+#include <cstring>
+#include <vector>
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "BulletDskShape.h"
+#include "BulletWorldManager.h"
+#include "EmbreeTargetShape.h"
+#include "FileName.h"
+#include "LinearAlgebra.h"
+#include "Preference.h"
+#include "PvlGroup.h"
+#include "PvlKeyword.h"
+#include "ShapeMeshCache.h"
+#include "TempFixtures.h"
+
+#include "gtest/gtest.h"
+
+using namespace Isis;
+
+namespace {
+  void writeFile(const QString &fileName, const QByteArray &contents) {
+    QFile file(fileName);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write(contents);
+  }
+
+
+  /**
+   * A copy of the Itokawa DSK in a temporary directory, so that the mesh
+   * caches written next to it are removed with it.
+   */
+  class ItokawaMeshCache : public TempTestingFiles {
+    protected:
+      QString shapeFile;
+      PvlKeyword originalMode;
+
+      void SetUp() override {
+        TempTestingFiles::SetUp();
+        PvlGroup &performance = Preference::Preferences().findGroup("Performance");
+        if (performance.hasKeyword("ShapeMeshCache")) {
+          originalMode = performance["ShapeMeshCache"];
+        }
+
+        shapeFile = tempDir.path() + "/itokawa.bds";
+        FileName dsk("$ISISTESTDATA/isis/src/base/unitTestData/"
+                     "hay_a_amica_5_itokawashape_v1_0_64q.bds");
+        ASSERT_TRUE(QFile::copy(dsk.expanded(), shapeFile));
+      }
+
+      void TearDown() override {
+        PvlGroup &performance = Preference::Preferences().findGroup("Performance");
+        if (originalMode.name().isEmpty()) {
+          performance.deleteKeyword("ShapeMeshCache");
+        }
+        else {
+          performance.addKeyword(originalMode, PvlContainer::Replace);
+        }
+      }
+
+      void setCacheMode(const QString &mode) {
+        PvlGroup &performance = Preference::Preferences().findGroup("Performance");
+        performance.addKeyword(PvlKeyword("ShapeMeshCache", mode), PvlContainer::Replace);
+      }
+
+      QStringList cacheFiles() {
+        return QDir(tempDir.path()).entryList(QStringList("*.meshcache"), QDir::Files);
+      }
+
+      /**
+       * Overwrites the DSK with zeros without changing its size or time, so a
+       * shape made from it afterwards can only have come from its cache.
+       */
+      void clobberShapeFile() {
+        QDateTime modified = QFileInfo(shapeFile).lastModified();
+        QFile file(shapeFile);
+        ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+        file.write(QByteArray(file.size(), '\0'));
+        ASSERT_TRUE(file.setFileTime(modified, QFileDevice::FileModificationTime));
+        file.close();
+      }
+  };
+
+
+  /**
+   * Rays from an observer on the x axis through a grid around the center of
+   * the target, including some that miss it.
+   */
+  std::vector<LinearAlgebra::Vector> gridTargets() {
+    std::vector<LinearAlgebra::Vector> targets;
+    for (int line = -10; line <= 10; line++) {
+      for (int sample = -10; sample <= 10; sample++) {
+        targets.push_back(LinearAlgebra::vector(0.0, sample * 0.04, line * 0.04));
+      }
+    }
+    return targets;
+  }
+
+
+  const LinearAlgebra::Vector observer = LinearAlgebra::vector(2.0, 0.1, -0.05);
+
+
+  //! The closest intersection of a ray with a Bullet shape
+  struct BulletHit {
+    bool hit;
+    btVector3 point;
+    btVector3 normal;
+  };
+
+
+  std::vector<BulletHit> bulletHits(BulletTargetShape &shape) {
+    BulletWorldManager world;
+    world.addTarget(&shape);
+
+    btVector3 start(observer[0], observer[1], observer[2]);
+    std::vector<BulletHit> hits;
+    foreach (LinearAlgebra::Vector target, gridTargets()) {
+      btVector3 end = start + 2.0 * (btVector3(target[0], target[1], target[2]) - start);
+      btCollisionWorld::ClosestRayResultCallback callback(start, end);
+      BulletHit hit;
+      hit.hit = world.raycast(start, end, callback);
+      hit.point = callback.m_hitPointWorld;
+      hit.normal = callback.m_hitNormalWorld;
+      hits.push_back(hit);
+    }
+    return hits;
+  }
+
+
+  //! Every intersection of a ray with an Embree shape
+  std::vector< std::vector<RayHitInformation> > embreeHits(EmbreeTargetShape &shape) {
+    std::vector< std::vector<RayHitInformation> > hits;
+    foreach (LinearAlgebra::Vector target, gridTargets()) {
+      RTCMultiHitRay ray(observer, LinearAlgebra::normalize(target - observer));
+      shape.intersectRay(ray);
+      std::vector<RayHitInformation> rayHits;
+      for (int j = 0; j <= ray.lastHit; j++) {
+        rayHits.push_back(shape.getHitInformation(ray, j));
+      }
+      hits.push_back(rayHits);
+    }
+    return hits;
+  }
+}
+
+
+TEST_F(TempTestingFiles, ShapeMeshCacheWriteMap) {
+  QString shapeFile = tempDir.path() + "/shape.bds";
+  writeFile(shapeFile, "not really a DSK");
+
+  QVector<double> vertices;
+  for (int i = 0; i < 301; i++) {
+    vertices.append(i * 0.25);
+  }
+  QVector<int> triangles;
+  for (int i = 0; i < 99; i++) {
+    triangles << i << i + 1 << i + 2;
+  }
+
+  ShapeMeshCache writer(shapeFile, "test", "1.0");
+  EXPECT_EQ(shapeFile + ".test.meshcache", writer.fileName());
+  EXPECT_FALSE(writer.map());
+
+  writer.addBlock("vertices", vertices.constData(), vertices.size() * sizeof(double));
+  writer.addBlock("triangles", triangles.constData(), triangles.size() * sizeof(int));
+  writer.addBlock("empty", NULL, 0);
+  ASSERT_TRUE(writer.write());
+
+  ShapeMeshCache reader(shapeFile, "test", "1.0");
+  ASSERT_TRUE(reader.map());
+  EXPECT_TRUE(reader.isMapped());
+  EXPECT_FALSE(reader.hasBlock("normals"));
+  EXPECT_TRUE(reader.block("normals") == NULL);
+  EXPECT_EQ(0, reader.blockSize("normals"));
+
+  ASSERT_TRUE(reader.hasBlock("vertices"));
+  ASSERT_EQ(vertices.size() * (qint64) sizeof(double), reader.blockSize("vertices"));
+  EXPECT_EQ(0, ((quintptr) reader.block("vertices")) % 64);
+  EXPECT_EQ(0, memcmp(vertices.constData(), reader.block("vertices"), reader.blockSize("vertices")));
+
+  ASSERT_TRUE(reader.hasBlock("triangles"));
+  ASSERT_EQ(triangles.size() * (qint64) sizeof(int), reader.blockSize("triangles"));
+  EXPECT_EQ(0, ((quintptr) reader.block("triangles")) % 64);
+  EXPECT_EQ(0, memcmp(triangles.constData(), reader.block("triangles"), reader.blockSize("triangles")));
+
+  EXPECT_TRUE(reader.hasBlock("empty"));
+  EXPECT_EQ(0, reader.blockSize("empty"));
+
+  // Caches of other engines are separate files
+  ShapeMeshCache otherEngine(shapeFile, "other", "1.0");
+  EXPECT_FALSE(otherEngine.map());
+}
+
+
+TEST_F(TempTestingFiles, ShapeMeshCacheCopyOnWrite) {
+  QString shapeFile = tempDir.path() + "/shape.obj";
+  writeFile(shapeFile, "v 0 0 0");
+
+  int values[] = {1, 2, 3, 4};
+  ShapeMeshCache writer(shapeFile, "test", "1.0");
+  writer.addBlock("values", values, sizeof(values));
+  ASSERT_TRUE(writer.write());
+
+  ShapeMeshCache reader(shapeFile, "test", "1.0");
+  ASSERT_TRUE(reader.map(true));
+  int *mappedValues = (int *) reader.block("values");
+  mappedValues[0] = 42;
+
+  // Changes stay in the process
+  ShapeMeshCache otherReader(shapeFile, "test", "1.0");
+  ASSERT_TRUE(otherReader.map());
+  EXPECT_EQ(1, ((const int *) otherReader.block("values"))[0]);
+}
+
+
+TEST_F(TempTestingFiles, ShapeMeshCacheStale) {
+  QString shapeFile = tempDir.path() + "/shape.bds";
+  writeFile(shapeFile, "first version of the shape");
+
+  double values[] = {1.0, 2.0};
+  ShapeMeshCache writer(shapeFile, "test", "1.0");
+  writer.addBlock("values", values, sizeof(values));
+  ASSERT_TRUE(writer.write());
+
+  // A new delivery of the shape model makes the cache stale
+  writeFile(shapeFile, "second version of the shape, which is longer");
+  ShapeMeshCache reader(shapeFile, "test", "1.0");
+  EXPECT_FALSE(reader.map());
+  EXPECT_FALSE(reader.isMapped());
+  EXPECT_FALSE(reader.hasBlock("values"));
+}
+
+
+TEST_F(TempTestingFiles, ShapeMeshCacheDamaged) {
+  QString shapeFile = tempDir.path() + "/shape.bds";
+  writeFile(shapeFile, "shape");
+
+  QVector<double> values(1000, 3.0);
+  ShapeMeshCache writer(shapeFile, "test", "1.0");
+  writer.addBlock("values", values.constData(), values.size() * sizeof(double));
+  ASSERT_TRUE(writer.write());
+
+  // Cut the file off in the middle of the block
+  QFile cacheFile(writer.fileName());
+  ASSERT_TRUE(cacheFile.resize(cacheFile.size() / 2));
+
+  ShapeMeshCache reader(shapeFile, "test", "1.0");
+  EXPECT_FALSE(reader.map());
+
+  writeFile(writer.fileName(), "ISISMESH");
+  EXPECT_FALSE(reader.map());
+}
+
+
+TEST_F(TempTestingFiles, ShapeMeshCacheEngineVersion) {
+  QString shapeFile = tempDir.path() + "/shape.bds";
+  writeFile(shapeFile, "shape");
+
+  double values[] = {1.0, 2.0};
+  ShapeMeshCache writer(shapeFile, "test", "1.0");
+  writer.addBlock("values", values, sizeof(values));
+  ASSERT_TRUE(writer.write());
+
+  // Caches written by another version of the engine are stale
+  ShapeMeshCache otherVersion(shapeFile, "test", "1.1");
+  EXPECT_EQ(writer.fileName(), otherVersion.fileName());
+  EXPECT_FALSE(otherVersion.map());
+
+  ShapeMeshCache sameVersion(shapeFile, "test", "1.0");
+  EXPECT_TRUE(sameVersion.map());
+}
+
+
+TEST_F(ItokawaMeshCache, BulletDskShapeFromCache) {
+  setCacheMode("None");
+  BulletDskShape uncached(shapeFile);
+  EXPECT_TRUE(cacheFiles().isEmpty());
+  std::vector<BulletHit> expected = bulletHits(uncached);
+
+  setCacheMode("ReadWrite");
+  {
+    BulletDskShape writer(shapeFile);
+    EXPECT_EQ(uncached.getNumTriangles(), writer.getNumTriangles());
+  }
+  ASSERT_EQ(1, cacheFiles().size());
+
+  clobberShapeFile();
+  setCacheMode("Read");
+  BulletDskShape cached(shapeFile);
+  EXPECT_EQ(uncached.getNumTriangles(), cached.getNumTriangles());
+  EXPECT_EQ(uncached.getNumVertices(), cached.getNumVertices());
+  EXPECT_DOUBLE_EQ(uncached.maximumDistance(), cached.maximumDistance());
+
+  // Bullet fixed up the hierarchy in the copy on write mapping, the file is
+  // unchanged and a second shape can use it too
+  BulletDskShape secondCached(shapeFile);
+
+  std::vector<BulletHit> actual = bulletHits(cached);
+  std::vector<BulletHit> secondActual = bulletHits(secondCached);
+  ASSERT_EQ(expected.size(), actual.size());
+  int hitCount = 0;
+  for (size_t i = 0; i < expected.size(); i++) {
+    ASSERT_EQ(expected[i].hit, actual[i].hit) << "Ray " << i;
+    ASSERT_EQ(expected[i].hit, secondActual[i].hit) << "Ray " << i;
+    if (!expected[i].hit) {
+      continue;
+    }
+    hitCount++;
+    for (int k = 0; k < 3; k++) {
+      EXPECT_EQ(expected[i].point[k], actual[i].point[k]) << "Ray " << i;
+      EXPECT_EQ(expected[i].normal[k], actual[i].normal[k]) << "Ray " << i;
+      EXPECT_EQ(expected[i].point[k], secondActual[i].point[k]) << "Ray " << i;
+    }
+  }
+  EXPECT_GT(hitCount, 0);
+  EXPECT_LT(hitCount, (int) expected.size());
+}
+
+
+TEST_F(ItokawaMeshCache, EmbreeTargetShapeFromCache) {
+  setCacheMode("None");
+  EmbreeTargetShape uncached(shapeFile);
+  EXPECT_TRUE(cacheFiles().isEmpty());
+  std::vector< std::vector<RayHitInformation> > expected = embreeHits(uncached);
+
+  setCacheMode("ReadWrite");
+  {
+    EmbreeTargetShape writer(shapeFile);
+    EXPECT_EQ(uncached.numberOfPolygons(), writer.numberOfPolygons());
+  }
+  ASSERT_EQ(1, cacheFiles().size());
+
+  clobberShapeFile();
+  setCacheMode("Read");
+  EmbreeTargetShape cached(shapeFile);
+  EmbreeTargetShape secondCached(shapeFile);
+  EXPECT_EQ(uncached.numberOfPolygons(), cached.numberOfPolygons());
+  EXPECT_EQ(uncached.numberOfVertices(), cached.numberOfVertices());
+  EXPECT_DOUBLE_EQ(uncached.maximumSceneDistance(), cached.maximumSceneDistance());
+
+  std::vector< std::vector<RayHitInformation> > actual = embreeHits(cached);
+  std::vector< std::vector<RayHitInformation> > secondActual = embreeHits(secondCached);
+  ASSERT_EQ(expected.size(), actual.size());
+  int hitCount = 0;
+  for (size_t i = 0; i < expected.size(); i++) {
+    ASSERT_EQ(expected[i].size(), actual[i].size()) << "Ray " << i;
+    ASSERT_EQ(expected[i].size(), secondActual[i].size()) << "Ray " << i;
+    for (size_t j = 0; j < expected[i].size(); j++) {
+      hitCount++;
+      EXPECT_EQ(expected[i][j].primID, actual[i][j].primID) << "Ray " << i;
+      EXPECT_EQ(expected[i][j].primID, secondActual[i][j].primID) << "Ray " << i;
+      for (int k = 0; k < 3; k++) {
+        EXPECT_EQ(expected[i][j].intersection[k], actual[i][j].intersection[k]) << "Ray " << i;
+        EXPECT_EQ(expected[i][j].surfaceNormal[k], actual[i][j].surfaceNormal[k])
+            << "Ray " << i;
+      }
+    }
+  }
+  EXPECT_GT(hitCount, 0);
+}
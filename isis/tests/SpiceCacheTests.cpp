@@ -0,0 +1,110 @@
+#include <QDateTime>
+#include <QFile>
+#include <QString>
+
+#include <nlohmann/json.hpp>
+
+#include "Pvl.h"
+#include "PvlGroup.h"
+#include "PvlKeyword.h"
+#include "PvlObject.h"
+#include "SpiceCache.h"
+#include "TempFixtures.h"
+
+#include "gtest/gtest.h"
+
+using json = nlohmann::json;
+using namespace Isis;
+
+namespace {
+  void writeFile(const QString &fileName, const QByteArray &contents) {
+    QFile file(fileName);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write(contents);
+  }
+
+
+  Pvl cubeLabel(const QString &kernelFile) {
+    PvlObject core("Core");
+    core += PvlKeyword("StartByte", "65537");
+    core += PvlKeyword("Format", "Tile");
+    PvlGroup dimensions("Dimensions");
+    dimensions += PvlKeyword("Samples", "1024");
+    dimensions += PvlKeyword("Lines", "2048");
+    dimensions += PvlKeyword("Bands", "1");
+    core.addGroup(dimensions);
+
+    PvlGroup instrument("Instrument");
+    instrument += PvlKeyword("SpacecraftName", "MARS_RECONNAISSANCE_ORBITER");
+    instrument += PvlKeyword("StartTime", "2008-02-08T12:08:53.843");
+
+    PvlGroup kernels("Kernels");
+    kernels += PvlKeyword("NaifFrameCode", "-74999");
+    kernels += PvlKeyword("InstrumentPointing", kernelFile);
+
+    PvlObject isisCube("IsisCube");
+    isisCube.addObject(core);
+    isisCube.addGroup(instrument);
+    isisCube.addGroup(kernels);
+
+    Pvl label;
+    label.addObject(isisCube);
+    return label;
+  }
+}
+
+
+TEST_F(TempTestingFiles, SpiceCacheKey) {
+  QString kernelFile = tempDir.path() + "/pointing.bc";
+  writeFile(kernelFile, "first version of the kernel");
+
+  SpiceCache cache(tempDir.path() + "/cache");
+  Pvl label = cubeLabel(kernelFile);
+  PvlGroup &kernels = label.findGroup("Kernels", Pvl::Traverse);
+  QString key = cache.key(label, kernels, "{}");
+  EXPECT_EQ(key, cache.key(label, kernels, "{}"));
+  EXPECT_NE(key, cache.key(label, kernels, "{\"nadir\":true}"));
+
+  // Where the data is stored does not change the ISD
+  label.findObject("IsisCube").findObject("Core")["StartByte"] = "131073";
+  EXPECT_EQ(key, cache.key(label, kernels, "{}"));
+
+  // The observation does
+  label.findGroup("Instrument", Pvl::Traverse)["StartTime"] = "2008-02-08T12:08:54.843";
+  QString otherTimeKey = cache.key(label, kernels, "{}");
+  EXPECT_NE(key, otherTimeKey);
+
+  // A new delivery of a kernel with the same name does too
+  writeFile(kernelFile, "second version of the kernel, which is longer");
+  QString newKernelKey = cache.key(label, kernels, "{}");
+  EXPECT_NE(otherTimeKey, newKernelKey);
+
+  // Kernels are identified by their modification times, not their contents
+  QFile kernel(kernelFile);
+  ASSERT_TRUE(kernel.open(QIODevice::ReadWrite));
+  ASSERT_TRUE(kernel.setFileTime(QDateTime::currentDateTime().addSecs(-3600),
+                                 QFileDevice::FileModificationTime));
+  kernel.close();
+  EXPECT_NE(newKernelKey, cache.key(label, kernels, "{}"));
+}
+
+
+TEST_F(TempTestingFiles, SpiceCacheFindInsert) {
+  SpiceCache cache(tempDir.path() + "/cache");
+  EXPECT_EQ(tempDir.path() + "/cache", cache.directory());
+
+  json isd;
+  isd["name_model"] = "USGS_ASTRO_LINE_SCANNER_SENSOR_MODEL";
+  isd["naif_keywords"]["BODY499_RADII"] = {3396.19, 3396.19, 3376.2};
+
+  json found;
+  EXPECT_FALSE(cache.find("0123456789abcdef", found));
+  EXPECT_TRUE(cache.insert("0123456789abcdef", isd));
+  ASSERT_TRUE(cache.find("0123456789abcdef", found));
+  EXPECT_EQ(isd, found);
+
+  // Damaged files are ignored
+  writeFile(cache.directory() + "/fedcba9876543210.json", "{\"name_model\": ");
+  EXPECT_FALSE(cache.find("fedcba9876543210", found));
+  EXPECT_EQ(isd, found);
+}
@@ -268,3 +268,27 @@ TEST(Statistics,XMLReadWrite) {
     EXPECT_STREQ(removedData.text().toStdString().c_str(), "No");
 
 }
+
+
+TEST(Statistics, MergeStatistics) {
+    double values[] = {1.0, Null, 5.0, -2.0, 8.0, Lrs, 3.5};
+
+    Statistics all;
+    all.AddData(values, 7);
+
+    Statistics first;
+    first.AddData(values, 3);
+    Statistics second;
+    second.AddData(values + 3, 4);
+    first.MergeStatistics(second);
+
+    EXPECT_DOUBLE_EQ(all.Sum(), first.Sum());
+    EXPECT_DOUBLE_EQ(all.SumSquare(), first.SumSquare());
+    EXPECT_DOUBLE_EQ(all.Minimum(), first.Minimum());
+    EXPECT_DOUBLE_EQ(all.Maximum(), first.Maximum());
+    EXPECT_DOUBLE_EQ(all.StandardDeviation(), first.StandardDeviation());
+    EXPECT_EQ(all.TotalPixels(), first.TotalPixels());
+    EXPECT_EQ(all.ValidPixels(), first.ValidPixels());
+    EXPECT_EQ(all.NullPixels(), first.NullPixels());
+    EXPECT_EQ(all.LrsPixels(), first.LrsPixels());
+}